@@ -64,6 +64,8 @@ extern "C" {
 #define SOFTBUS_SHUT_WR_ SHUT_WR
 #define SOFTBUS_SHUT_RDWR_ SHUT_RDWR
 
+#define SOFTBUS_MSG_DONTWAIT_ MSG_DONTWAIT
+
 /* netinet/in.h */
 #define SOFTBUS_IPPROTO_IP_ IPPROTO_IP
 #define SOFTBUS_IPPROTO_TCP_ IPPROTO_TCP
@@ -80,6 +80,50 @@ int32_t SoftBusDecryptDataWithSeq(AesGcmCipherKey *cipherKey, const unsigned cha
     
 uint32_t SoftBusCryptoRand(void);
 
+/*
+ * AES-GCM context with the key schedule computed once, create it when the session key is known and
+ * reuse it for every packet of the session. Calls on one context are serialized internally.
+ * Holders that use the context outside the lock of its owner take their own reference.
+ */
+typedef struct SoftBusCipherCtx SoftBusCipherCtx;
+
+SoftBusCipherCtx *SoftBusCreateCipherCtx(const unsigned char *key, uint32_t keyLen);
+
+SoftBusCipherCtx *SoftBusRefCipherCtx(SoftBusCipherCtx *ctx);
+
+void SoftBusUnrefCipherCtx(SoftBusCipherCtx *ctx);
+
+/*
+ * Output is iv | cipher text | tag. Encryption works in place when input is encryptData + GCM_IV_LEN,
+ * decryption when decryptData is input + GCM_IV_LEN.
+ */
+int32_t SoftBusEncryptDataByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *encryptData, uint32_t *encryptLen);
+
+int32_t SoftBusEncryptDataWithSeqByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *encryptData, uint32_t *encryptLen, int32_t seqNum);
+
+int32_t SoftBusDecryptDataByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *decryptData, uint32_t *decryptLen);
+
+typedef struct {
+    unsigned char *buf;
+    uint32_t len;
+} SoftBusCryptoIov;
+
+/* Called once per iov, in order, as soon as that iov is completely written. */
+typedef int32_t (*SoftBusCryptoIovDoneCb)(uint32_t index, void *arg);
+
+/*
+ * Same output as SoftBusEncryptDataWithSeqByCtx, but iv, cipher text and tag are scattered over outIov
+ * in order, so a caller can encrypt straight into several wire buffers.
+ * The iov lengths must add up to at least inLen + OVERHEAD_LEN.
+ * onIovDone may be NULL. It runs while ctx is locked, so it should only hand the buffer on;
+ * an error from it aborts the encryption.
+ */
+int32_t SoftBusEncryptDataWithSeqByCtxIov(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    const SoftBusCryptoIov *outIov, uint32_t iovCnt, int32_t seqNum, SoftBusCryptoIovDoneCb onIovDone, void *cbArg);
+
 #endif
 
 #ifdef __cplusplus
@@ -62,6 +62,8 @@ extern "C" {
 #define SOFTBUS_SHUT_WR SOFTBUS_SHUT_WR_
 #define SOFTBUS_SHUT_RDWR SOFTBUS_SHUT_RDWR_
 
+#define SOFTBUS_MSG_DONTWAIT SOFTBUS_MSG_DONTWAIT_
+
 /* netinet/in.h */
 #define SOFTBUS_IPPROTO_IP SOFTBUS_IPPROTO_IP_
 #define SOFTBUS_IPPROTO_TCP SOFTBUS_IPPROTO_TCP_
@@ -104,6 +106,13 @@ typedef struct {
     unsigned long fdsBits[SOFTBUS_FD_SETSIZE / 8 / sizeof(long)];
 } SoftBusFdSet;
 
+#define SOFTBUS_IOV_MAX 8
+
+typedef struct {
+    void *iovBase;
+    uint32_t iovLen;
+} SoftBusIovec;
+
 int32_t SoftBusSocketCreate(int32_t domain, int32_t type, int32_t protocol, int32_t *socketFd);
 int32_t SoftBusSocketSetOpt(int32_t socketFd, int32_t level, int32_t optName,  const void *optVal, int32_t optLen);
 int32_t SoftBusSocketGetOpt(int32_t socketFd, int32_t level, int32_t optName,  void *optVal, int32_t *optLen);
@@ -128,6 +137,8 @@ int32_t SoftBusSocketFcntl(int32_t socketFd, long cmd, long flag);
 int32_t SoftBusSocketSend(int32_t socketFd, const void *buf, uint32_t len, int32_t flags);
 int32_t SoftBusSocketSendTo(int32_t socketFd, const void *buf, uint32_t len, int32_t flags,
     const SoftBusSockAddr *toAddr, int32_t toAddrLen);
+/* gather send of at most SOFTBUS_IOV_MAX buffers in one call */
+int32_t SoftBusSocketSendIov(int32_t socketFd, const SoftBusIovec *iov, int32_t iovCnt);
 
 int32_t SoftBusSocketRecv(int32_t socketFd, void *buf, uint32_t len, int32_t flags);
 int32_t SoftBusSocketRecvFrom(int32_t socketFd, void *buf, uint32_t len, int32_t flags, SoftBusSockAddr *fromAddr,
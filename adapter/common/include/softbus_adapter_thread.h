@@ -65,6 +65,7 @@ typedef struct {
 typedef uintptr_t SoftBusThread;
 typedef uintptr_t SoftBusMutex;
 typedef uintptr_t SoftBusCond;
+typedef uintptr_t SoftBusRWLock;
 /* mutex */
 int32_t SoftBusMutexAttrInit(SoftBusMutexAttr *mutexAttr);
 int32_t SoftBusMutexInit(SoftBusMutex *mutex, SoftBusMutexAttr *mutexAttr);
@@ -72,6 +73,13 @@ int32_t SoftBusMutexLock(SoftBusMutex *mutex);
 int32_t SoftBusMutexUnlock(SoftBusMutex *mutex);
 int32_t SoftBusMutexDestroy(SoftBusMutex *mutex);
 
+/* rwlock */
+int32_t SoftBusRWLockInit(SoftBusRWLock *rwLock);
+int32_t SoftBusRWLockRdLock(SoftBusRWLock *rwLock);
+int32_t SoftBusRWLockWrLock(SoftBusRWLock *rwLock);
+int32_t SoftBusRWLockUnlock(SoftBusRWLock *rwLock);
+int32_t SoftBusRWLockDestroy(SoftBusRWLock *rwLock);
+
 /* pthread */
 int32_t SoftBusThreadAttrInit(SoftBusThreadAttr *threadAttr);
 int32_t SoftBusThreadCreate(SoftBusThread *thread, SoftBusThreadAttr *threadAttr, void *(*threadEntry)(void *),
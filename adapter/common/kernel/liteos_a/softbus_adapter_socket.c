@@ -24,6 +24,7 @@
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "endian.h" /* liteos_m htons */
 #include "softbus_adapter_errcode.h"
@@ -361,6 +362,26 @@ int32_t SoftBusSocketSend(int32_t socketFd, const void *buf, uint32_t len, int32
     return ret;
 }
 
+int32_t SoftBusSocketSendIov(int32_t socketFd, const SoftBusIovec *iov, int32_t iovCnt)
+{
+    if (iov == NULL || iovCnt <= 0 || iovCnt > SOFTBUS_IOV_MAX) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "iov is null or iovCnt[%{public}d] invalid", iovCnt);
+        return SOFTBUS_ADAPTER_INVALID_PARAM;
+    }
+    struct iovec sysIov[SOFTBUS_IOV_MAX];
+    for (int32_t i = 0; i < iovCnt; i++) {
+        sysIov[i].iov_base = iov[i].iovBase;
+        sysIov[i].iov_len = iov[i].iovLen;
+    }
+    int32_t ret = writev(socketFd, sysIov, iovCnt);
+    if (ret < 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "writev : %{public}s", strerror(errno));
+        return GetErrorCode();
+    }
+
+    return ret;
+}
+
 int32_t SoftBusSocketSendTo(int32_t socketFd, const void *buf, uint32_t len, int32_t flags,
     const SoftBusSockAddr *toAddr, int32_t toAddrLen)
 {
@@ -148,6 +148,139 @@ int32_t SoftBusMutexDestroy(SoftBusMutex *mutex)
     return SOFTBUS_OK;
 }
 
+/* rwlock */
+/*
+ * pthread rwlocks let new readers in while a writer waits, so a steady stream of readers
+ * can starve the writer. Readers queue behind a waiting writer here instead.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t readCond;
+    pthread_cond_t writeCond;
+    int32_t readerCnt;
+    int32_t writerWaitCnt;
+    bool isWriting;
+} SoftBusRWLockImpl;
+
+int32_t SoftBusRWLockInit(SoftBusRWLock *rwLock)
+{
+    if (rwLock == NULL) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is null");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusRWLockImpl *impl = (SoftBusRWLockImpl *)SoftBusCalloc(sizeof(SoftBusRWLockImpl));
+    if (impl == NULL) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock impl is null");
+        return SOFTBUS_MALLOC_ERR;
+    }
+    if (pthread_mutex_init(&impl->mutex, NULL) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock mutex init failed");
+        SoftBusFree(impl);
+        return SOFTBUS_ERR;
+    }
+    if (pthread_cond_init(&impl->readCond, NULL) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock read cond init failed");
+        (void)pthread_mutex_destroy(&impl->mutex);
+        SoftBusFree(impl);
+        return SOFTBUS_ERR;
+    }
+    if (pthread_cond_init(&impl->writeCond, NULL) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock write cond init failed");
+        (void)pthread_cond_destroy(&impl->readCond);
+        (void)pthread_mutex_destroy(&impl->mutex);
+        SoftBusFree(impl);
+        return SOFTBUS_ERR;
+    }
+    *rwLock = (SoftBusRWLock)impl;
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusRWLockRdLock(SoftBusRWLock *rwLock)
+{
+    if ((rwLock == NULL) || ((void *)(*rwLock) == NULL)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is null");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusRWLockImpl *impl = (SoftBusRWLockImpl *)*rwLock;
+    if (pthread_mutex_lock(&impl->mutex) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "SoftBusRWLockRdLock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    while (impl->isWriting || impl->writerWaitCnt > 0) {
+        (void)pthread_cond_wait(&impl->readCond, &impl->mutex);
+    }
+    impl->readerCnt++;
+    (void)pthread_mutex_unlock(&impl->mutex);
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusRWLockWrLock(SoftBusRWLock *rwLock)
+{
+    if ((rwLock == NULL) || ((void *)(*rwLock) == NULL)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is null");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusRWLockImpl *impl = (SoftBusRWLockImpl *)*rwLock;
+    if (pthread_mutex_lock(&impl->mutex) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "SoftBusRWLockWrLock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    impl->writerWaitCnt++;
+    while (impl->isWriting || impl->readerCnt > 0) {
+        (void)pthread_cond_wait(&impl->writeCond, &impl->mutex);
+    }
+    impl->writerWaitCnt--;
+    impl->isWriting = true;
+    (void)pthread_mutex_unlock(&impl->mutex);
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusRWLockUnlock(SoftBusRWLock *rwLock)
+{
+    if ((rwLock == NULL) || ((void *)(*rwLock) == NULL)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is null");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusRWLockImpl *impl = (SoftBusRWLockImpl *)*rwLock;
+    if (pthread_mutex_lock(&impl->mutex) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "SoftBusRWLockUnlock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (impl->isWriting) {
+        impl->isWriting = false;
+    } else if (impl->readerCnt > 0) {
+        impl->readerCnt--;
+    } else {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is not locked");
+        (void)pthread_mutex_unlock(&impl->mutex);
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (impl->writerWaitCnt > 0) {
+        if (impl->readerCnt == 0) {
+            (void)pthread_cond_signal(&impl->writeCond);
+        }
+    } else {
+        (void)pthread_cond_broadcast(&impl->readCond);
+    }
+    (void)pthread_mutex_unlock(&impl->mutex);
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusRWLockDestroy(SoftBusRWLock *rwLock)
+{
+    if ((rwLock == NULL) || ((void *)(*rwLock) == NULL)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "rwLock is null");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusRWLockImpl *impl = (SoftBusRWLockImpl *)*rwLock;
+    (void)pthread_cond_destroy(&impl->writeCond);
+    (void)pthread_cond_destroy(&impl->readCond);
+    (void)pthread_mutex_destroy(&impl->mutex);
+    SoftBusFree(impl);
+    *rwLock = (SoftBusRWLock)NULL;
+    return SOFTBUS_OK;
+}
+
 /* pthread */
 int32_t SoftBusThreadAttrInit(SoftBusThreadAttr *threadAttr)
 {
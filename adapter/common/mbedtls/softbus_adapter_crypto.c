@@ -25,6 +25,7 @@
 #include "mbedtls/platform.h"
 #include "softbus_adapter_file.h"
 #include "softbus_adapter_log.h"
+#include "softbus_adapter_mem.h"
 #include "softbus_errcode.h"
 
 #ifndef MBEDTLS_CTR_DRBG_C
@@ -45,6 +46,48 @@
 
 static pthread_mutex_t g_randomLock = PTHREAD_MUTEX_INITIALIZER;
 
+#define GCM_BLOCK_LEN 16
+
+struct SoftBusCipherCtx {
+    pthread_mutex_t lock; // one gcm operation at a time, mbedtls keeps per operation state in the context
+    uint32_t refCount;
+    mbedtls_gcm_context aesContext;
+};
+
+static int32_t GcmEncryptWithContext(mbedtls_gcm_context *aesContext, const unsigned char *iv,
+    const unsigned char *plainText, uint32_t plainTextSize, unsigned char *cipherText, uint32_t cipherTextLen)
+{
+    unsigned char tagBuf[TAG_LEN] = {0};
+    int32_t ret = mbedtls_gcm_crypt_and_tag(aesContext, MBEDTLS_GCM_ENCRYPT, plainTextSize, iv,
+        GCM_IV_LEN, NULL, 0, plainText, cipherText + GCM_IV_LEN, TAG_LEN, tagBuf);
+    if (ret != 0) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+
+    if (memcpy_s(cipherText, cipherTextLen, iv, GCM_IV_LEN) != 0) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+
+    if (memcpy_s(cipherText + GCM_IV_LEN + plainTextSize, cipherTextLen - GCM_IV_LEN - plainTextSize,
+        tagBuf, TAG_LEN) != 0) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return (plainTextSize + OVERHEAD_LEN);
+}
+
+static int32_t GcmDecryptWithContext(mbedtls_gcm_context *aesContext, const unsigned char *iv,
+    const unsigned char *cipherText, uint32_t cipherTextSize, unsigned char *plain)
+{
+    int32_t actualPlainLen = (int32_t)(cipherTextSize - OVERHEAD_LEN);
+    int32_t ret = mbedtls_gcm_auth_decrypt(aesContext, cipherTextSize - OVERHEAD_LEN, iv,
+        GCM_IV_LEN, NULL, 0, cipherText + actualPlainLen + GCM_IV_LEN, TAG_LEN, cipherText + GCM_IV_LEN, plain);
+    if (ret != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "[TRANS] Decrypt mbedtls_gcm_auth_decrypt fail.[%d]\n", ret);
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    return actualPlainLen;
+}
+
 static int32_t MbedAesGcmEncrypt(const AesGcmCipherKey *cipherkey, const unsigned char *plainText,
     uint32_t plainTextSize, unsigned char *cipherText, uint32_t cipherTextLen)
 {
@@ -55,7 +98,6 @@ static int32_t MbedAesGcmEncrypt(const AesGcmCipherKey *cipherkey, const unsigne
     }
 
     int32_t ret;
-    unsigned char tagBuf[TAG_LEN] = {0};
     mbedtls_gcm_context aesContext;
     mbedtls_gcm_init(&aesContext);
 
@@ -65,26 +107,9 @@ static int32_t MbedAesGcmEncrypt(const AesGcmCipherKey *cipherkey, const unsigne
         return SOFTBUS_ENCRYPT_ERR;
     }
 
-    ret = mbedtls_gcm_crypt_and_tag(&aesContext, MBEDTLS_GCM_ENCRYPT, plainTextSize, cipherkey->iv,
-        GCM_IV_LEN, NULL, 0, plainText, cipherText + GCM_IV_LEN, TAG_LEN, tagBuf);
-    if (ret != 0) {
-        mbedtls_gcm_free(&aesContext);
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-
-    if (memcpy_s(cipherText, cipherTextLen, cipherkey->iv, GCM_IV_LEN) != 0) {
-        mbedtls_gcm_free(&aesContext);
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-
-    if (memcpy_s(cipherText + GCM_IV_LEN + plainTextSize, cipherTextLen - GCM_IV_LEN - plainTextSize,
-        tagBuf, TAG_LEN) != 0) {
-        mbedtls_gcm_free(&aesContext);
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-
+    ret = GcmEncryptWithContext(&aesContext, cipherkey->iv, plainText, plainTextSize, cipherText, cipherTextLen);
     mbedtls_gcm_free(&aesContext);
-    return (plainTextSize + OVERHEAD_LEN);
+    return ret;
 }
 
 static int32_t MbedAesGcmDecrypt(const AesGcmCipherKey *cipherkey, const unsigned char *cipherText,
@@ -106,17 +131,9 @@ static int32_t MbedAesGcmDecrypt(const AesGcmCipherKey *cipherkey, const unsigne
         return SOFTBUS_DECRYPT_ERR;
     }
 
-    int32_t actualPlainLen = (int32_t)(cipherTextSize - OVERHEAD_LEN);
-    ret = mbedtls_gcm_auth_decrypt(&aesContext, cipherTextSize - OVERHEAD_LEN, cipherkey->iv,
-        GCM_IV_LEN, NULL, 0, cipherText + actualPlainLen + GCM_IV_LEN, TAG_LEN, cipherText + GCM_IV_LEN, plain);
-    if (ret != 0) {
-        HILOG_ERROR(SOFTBUS_HILOG_ID, "[TRANS] Decrypt mbedtls_gcm_auth_decrypt fail.[%d]\n", ret);
-        mbedtls_gcm_free(&aesContext);
-        return SOFTBUS_DECRYPT_ERR;
-    }
-
+    ret = GcmDecryptWithContext(&aesContext, cipherkey->iv, cipherText, cipherTextSize, plain);
     mbedtls_gcm_free(&aesContext);
-    return actualPlainLen;
+    return ret;
 }
 
 int32_t SoftBusBase64Encode(unsigned char *dst, size_t dlen,
@@ -284,6 +301,264 @@ int32_t SoftBusDecryptDataWithSeq(AesGcmCipherKey *cipherKey, const unsigned cha
     return SoftBusDecryptData(cipherKey, input, inLen, decryptData, decryptLen);
 }
 
+SoftBusCipherCtx *SoftBusCreateCipherCtx(const unsigned char *key, uint32_t keyLen)
+{
+    if (key == NULL || keyLen == 0 || keyLen > SESSION_KEY_LENGTH) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "create cipher ctx invalid para");
+        return NULL;
+    }
+    SoftBusCipherCtx *ctx = (SoftBusCipherCtx *)SoftBusCalloc(sizeof(SoftBusCipherCtx));
+    if (ctx == NULL) {
+        return NULL;
+    }
+    if (pthread_mutex_init(&ctx->lock, NULL) != 0) {
+        SoftBusFree(ctx);
+        return NULL;
+    }
+    mbedtls_gcm_init(&ctx->aesContext);
+    if (mbedtls_gcm_setkey(&ctx->aesContext, MBEDTLS_CIPHER_ID_AES, key, keyLen * KEY_BITS_UNIT) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "create cipher ctx setkey fail");
+        mbedtls_gcm_free(&ctx->aesContext);
+        (void)pthread_mutex_destroy(&ctx->lock);
+        SoftBusFree(ctx);
+        return NULL;
+    }
+    ctx->refCount = 1;
+    return ctx;
+}
+
+SoftBusCipherCtx *SoftBusRefCipherCtx(SoftBusCipherCtx *ctx)
+{
+    if (ctx == NULL || pthread_mutex_lock(&ctx->lock) != 0) {
+        return NULL;
+    }
+    ctx->refCount++;
+    (void)pthread_mutex_unlock(&ctx->lock);
+    return ctx;
+}
+
+void SoftBusUnrefCipherCtx(SoftBusCipherCtx *ctx)
+{
+    if (ctx == NULL || pthread_mutex_lock(&ctx->lock) != 0) {
+        return;
+    }
+    uint32_t refCount = --ctx->refCount;
+    (void)pthread_mutex_unlock(&ctx->lock);
+    if (refCount > 0) {
+        return;
+    }
+    mbedtls_gcm_free(&ctx->aesContext);
+    (void)pthread_mutex_destroy(&ctx->lock);
+    SoftBusFree(ctx);
+}
+
+static int32_t EncryptDataByCtx(SoftBusCipherCtx *ctx, unsigned char *iv, const unsigned char *input,
+    uint32_t inLen, unsigned char *encryptData, uint32_t *encryptLen)
+{
+    if (pthread_mutex_lock(&ctx->lock) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "lock mutex failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    int32_t result = GcmEncryptWithContext(&ctx->aesContext, iv, input, inLen, encryptData, inLen + OVERHEAD_LEN);
+    (void)pthread_mutex_unlock(&ctx->lock);
+    if (result <= 0) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    *encryptLen = (uint32_t)result;
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusEncryptDataByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *encryptData, uint32_t *encryptLen)
+{
+    if (ctx == NULL || input == NULL || inLen == 0 || encryptData == NULL || encryptLen == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    unsigned char iv[GCM_IV_LEN] = {0};
+    if (SoftBusGenerateRandomArray(iv, sizeof(iv)) != SOFTBUS_OK) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "generate random iv error.");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return EncryptDataByCtx(ctx, iv, input, inLen, encryptData, encryptLen);
+}
+
+int32_t SoftBusEncryptDataWithSeqByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *encryptData, uint32_t *encryptLen, int32_t seqNum)
+{
+    if (ctx == NULL || input == NULL || inLen == 0 || encryptData == NULL || encryptLen == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    unsigned char iv[GCM_IV_LEN] = {0};
+    if (SoftBusGenerateRandomArray(iv, sizeof(iv)) != SOFTBUS_OK) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "generate random iv error.");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    if (memcpy_s(iv, sizeof(int32_t), &seqNum, sizeof(int32_t)) != EOK) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return EncryptDataByCtx(ctx, iv, input, inLen, encryptData, encryptLen);
+}
+
+int32_t SoftBusDecryptDataByCtx(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *decryptData, uint32_t *decryptLen)
+{
+    if (ctx == NULL || input == NULL || inLen <= OVERHEAD_LEN || decryptData == NULL || decryptLen == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (pthread_mutex_lock(&ctx->lock) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "lock mutex failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    int32_t result = GcmDecryptWithContext(&ctx->aesContext, input, input, inLen, decryptData);
+    (void)pthread_mutex_unlock(&ctx->lock);
+    if (result <= 0) {
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    *decryptLen = (uint32_t)result;
+    return SOFTBUS_OK;
+}
+
+typedef struct {
+    const SoftBusCryptoIov *iov;
+    uint32_t cnt;
+    uint32_t idx;
+    uint32_t off;
+    uint32_t notified;
+    SoftBusCryptoIovDoneCb onDone;
+    void *cbArg;
+} CryptoIovCursor;
+
+/* report every iov that is now completely written, in order */
+static int32_t IovCursorNotify(CryptoIovCursor *cursor)
+{
+    uint32_t full = cursor->idx;
+    if (full < cursor->cnt && cursor->off >= cursor->iov[full].len) {
+        full++;
+    }
+    while (cursor->notified < full) {
+        if (cursor->onDone != NULL && cursor->onDone(cursor->notified, cursor->cbArg) != SOFTBUS_OK) {
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        cursor->notified++;
+    }
+    return SOFTBUS_OK;
+}
+
+static unsigned char *IovCursorPeek(CryptoIovCursor *cursor, uint32_t *avail)
+{
+    while (cursor->idx < cursor->cnt && cursor->off >= cursor->iov[cursor->idx].len) {
+        cursor->idx++;
+        cursor->off = 0;
+    }
+    if (cursor->idx >= cursor->cnt || cursor->iov[cursor->idx].buf == NULL) {
+        return NULL;
+    }
+    *avail = cursor->iov[cursor->idx].len - cursor->off;
+    return cursor->iov[cursor->idx].buf + cursor->off;
+}
+
+static int32_t IovCursorWrite(CryptoIovCursor *cursor, const unsigned char *data, uint32_t len)
+{
+    while (len > 0) {
+        uint32_t avail = 0;
+        unsigned char *dst = IovCursorPeek(cursor, &avail);
+        if (dst == NULL) {
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        uint32_t n = (avail < len) ? avail : len;
+        if (memcpy_s(dst, avail, data, n) != EOK) {
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        cursor->off += n;
+        data += n;
+        len -= n;
+    }
+    return IovCursorNotify(cursor);
+}
+
+static int32_t GcmUpdateToIov(mbedtls_gcm_context *aesContext, const unsigned char *input, uint32_t inLen,
+    CryptoIovCursor *cursor)
+{
+    unsigned char block[GCM_BLOCK_LEN];
+    uint32_t done = 0;
+    while (done < inLen) {
+        uint32_t avail = 0;
+        unsigned char *dst = IovCursorPeek(cursor, &avail);
+        if (dst == NULL) {
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        uint32_t left = inLen - done;
+        uint32_t n = (avail < left) ? avail : left;
+        if (n < left) {
+            // mbedtls only accepts a partial block in the last update
+            n -= n % GCM_BLOCK_LEN;
+        }
+        if (n > 0) {
+            if (mbedtls_gcm_update(aesContext, n, input + done, dst) != 0) {
+                return SOFTBUS_ENCRYPT_ERR;
+            }
+            cursor->off += n;
+            done += n;
+            if (IovCursorNotify(cursor) != SOFTBUS_OK) {
+                return SOFTBUS_ENCRYPT_ERR;
+            }
+            continue;
+        }
+        // the block straddles two iovs
+        n = (left < GCM_BLOCK_LEN) ? left : GCM_BLOCK_LEN;
+        if (mbedtls_gcm_update(aesContext, n, input + done, block) != 0 ||
+            IovCursorWrite(cursor, block, n) != SOFTBUS_OK) {
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        done += n;
+    }
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusEncryptDataWithSeqByCtxIov(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    const SoftBusCryptoIov *outIov, uint32_t iovCnt, int32_t seqNum, SoftBusCryptoIovDoneCb onIovDone, void *cbArg)
+{
+    if (ctx == NULL || input == NULL || inLen == 0 || outIov == NULL || iovCnt == 0) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    uint64_t outLen = 0;
+    for (uint32_t i = 0; i < iovCnt; i++) {
+        outLen += outIov[i].len;
+    }
+    if (outLen < (uint64_t)inLen + OVERHEAD_LEN) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "iov too short.");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    unsigned char iv[GCM_IV_LEN] = {0};
+    unsigned char tag[TAG_LEN] = {0};
+    if (SoftBusGenerateRandomArray(iv, sizeof(iv)) != SOFTBUS_OK) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "generate random iv error.");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    if (memcpy_s(iv, sizeof(int32_t), &seqNum, sizeof(int32_t)) != EOK) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    CryptoIovCursor cursor = {outIov, iovCnt, 0, 0, 0, onIovDone, cbArg};
+    if (pthread_mutex_lock(&ctx->lock) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "lock mutex failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    int32_t ret = SOFTBUS_ENCRYPT_ERR;
+    if (IovCursorWrite(&cursor, iv, GCM_IV_LEN) == SOFTBUS_OK &&
+        mbedtls_gcm_starts(&ctx->aesContext, MBEDTLS_GCM_ENCRYPT, iv, GCM_IV_LEN, NULL, 0) == 0 &&
+        GcmUpdateToIov(&ctx->aesContext, input, inLen, &cursor) == SOFTBUS_OK &&
+        mbedtls_gcm_finish(&ctx->aesContext, tag, TAG_LEN) == 0 &&
+        IovCursorWrite(&cursor, tag, TAG_LEN) == SOFTBUS_OK) {
+        ret = SOFTBUS_OK;
+    }
+    // every iov is handed out under the lock, so packets encrypted on one ctx never interleave
+    (void)pthread_mutex_unlock(&ctx->lock);
+    if (ret != SOFTBUS_OK) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "encrypt to iov fail");
+    }
+    return ret;
+}
+
 uint32_t SoftBusCryptoRand(void)
 {
     int32_t fd = SoftBusOpenFile("/dev/urandom", SOFTBUS_O_RDONLY);
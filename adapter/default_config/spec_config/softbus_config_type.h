@@ -49,6 +49,10 @@ typedef enum {
     SOFTBUS_INT_AUTH_MAX_MESSAGE_LENGTH, /* L1: 1K, L2: 4K */
     SOFTBUS_INT_AUTO_NETWORKING_SWITCH, /* support auto networking: true, not support: false */
     SOFTBUS_BOOL_SUPPORT_TOPO, /* support: true, not support: false */
+    SOFTBUS_INT_CONN_LISTENER_REACTOR_NUM, /* L2: 2 epoll reactors, others: 0 means select */
+    SOFTBUS_INT_SEQ_WINDOW_SIZE, /* anti-replay window in bits, power of 2 in [128, 4096], the default val is 1024 */
+    SOFTBUS_INT_MESSAGE_WINDOW_SIZE, /* async messages in flight per channel, [1, 512], the default val is 64 */
+    SOFTBUS_INT_DISC_FOUND_DEDUP_WINDOW, /* ms an unchanged device found report is not repeated, 0: off, default 1000 */
     SOFTBUS_CONFIG_TYPE_MAX,
 } ConfigType;
 
@@ -47,6 +47,7 @@ typedef struct {
     uint32_t sessionKeyLen;
     char peerUdid[UDID_BUF_LEN];
     AuthSideFlag side;
+    SoftBusCipherCtx *cipherCtx;
     ListNode node;
 } SessionKeyList;
 
@@ -24,6 +24,15 @@
 
 static ListNode g_sessionKeyListHead;
 
+static void AuthFreeSessionKeyNode(SessionKeyList *sessionKeyList)
+{
+    (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
+    SoftBusUnrefCipherCtx(sessionKeyList->cipherCtx);
+    sessionKeyList->cipherCtx = NULL;
+    ListDelete(&sessionKeyList->node);
+    SoftBusFree(sessionKeyList);
+}
+
 void AuthSessionKeyListInit(void)
 {
     ListInit(&g_sessionKeyListHead);
@@ -65,6 +74,8 @@ void AuthSetLocalSessionKey(const NecessaryDevInfo *devInfo, const char *peerUdi
         return;
     }
     sessionKeyList->sessionKeyLen = sessionKeyLen;
+    // NULL falls back to the per call key setup in AuthEncryptWithKey and AuthDecryptWithKey
+    sessionKeyList->cipherCtx = SoftBusCreateCipherCtx(sessionKey, sessionKeyLen);
     ListNodeInsert(&g_sessionKeyListHead, &sessionKeyList->node);
     SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_INFO, "auth add sessionkey, seq is:%d", sessionKeyList->seq);
 
@@ -74,9 +85,7 @@ void AuthSetLocalSessionKey(const NecessaryDevInfo *devInfo, const char *peerUdi
     if (listSize == MAX_KEY_LIST_SIZE) {
         item = GET_LIST_TAIL(&g_sessionKeyListHead);
         sessionKeyListTail = LIST_ENTRY(item, SessionKeyList, node);
-        (void)memset_s(sessionKeyListTail->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
-        ListDelete(&sessionKeyListTail->node);
-        SoftBusFree(sessionKeyListTail);
+        AuthFreeSessionKeyNode(sessionKeyListTail);
         sessionKeyListTail = NULL;
     }
 }
@@ -201,6 +210,41 @@ static SessionKeyList *AuthGetSessionKeyBySeq(int32_t seq)
     return NULL;
 }
 
+static int32_t AuthEncryptWithKey(const SessionKeyList *sessionKeyList, const uint8_t *data, uint32_t len,
+    uint8_t *out, uint32_t *outLen)
+{
+    if (sessionKeyList->cipherCtx != NULL) {
+        return SoftBusEncryptDataWithSeqByCtx(sessionKeyList->cipherCtx, data, len, out, outLen,
+            sessionKeyList->seq);
+    }
+    AesGcmCipherKey cipherKey = {0};
+    cipherKey.keyLen = sessionKeyList->sessionKeyLen;
+    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    int32_t ret = SoftBusEncryptDataWithSeq(&cipherKey, data, len, out, outLen, sessionKeyList->seq);
+    (void)memset_s(&cipherKey, sizeof(AesGcmCipherKey), 0, sizeof(AesGcmCipherKey));
+    return ret;
+}
+
+static int32_t AuthDecryptWithKey(const SessionKeyList *sessionKeyList, const uint8_t *data, uint32_t len,
+    uint8_t *out, uint32_t *outLen)
+{
+    if (sessionKeyList->cipherCtx != NULL) {
+        return SoftBusDecryptDataByCtx(sessionKeyList->cipherCtx, data, len, out, outLen);
+    }
+    AesGcmCipherKey cipherKey = {0};
+    cipherKey.keyLen = sessionKeyList->sessionKeyLen;
+    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    int32_t ret = SoftBusDecryptDataWithSeq(&cipherKey, data, len, out, outLen, sessionKeyList->seq);
+    (void)memset_s(&cipherKey, sizeof(AesGcmCipherKey), 0, sizeof(AesGcmCipherKey));
+    return ret;
+}
+
 int32_t AuthEncryptBySeq(int32_t seq, AuthSideFlag *side, uint8_t *data, uint32_t len, OutBuf *outBuf)
 {
     if (data == NULL || outBuf == NULL || outBuf->bufLen < (len + ENCRYPT_OVER_HEAD_LEN)) {
@@ -221,15 +265,8 @@ int32_t AuthEncryptBySeq(int32_t seq, AuthSideFlag *side, uint8_t *data, uint32_
         SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = sessionKeyList->sessionKeyLen;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusEncryptDataWithSeq(&cipherKey, data, len, outBuf->buf + MESSAGE_INDEX_LEN,
-        &outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusEncryptDataWithSeq failed");
+    if (AuthEncryptWithKey(sessionKeyList, data, len, outBuf->buf + MESSAGE_INDEX_LEN, &outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "AuthEncryptWithKey failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     outBuf->outLen = outLen + MESSAGE_INDEX_LEN;
@@ -265,15 +302,8 @@ int32_t AuthEncrypt(const ConnectOption *option, AuthSideFlag *side, uint8_t *da
         SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = sessionKeyList->sessionKeyLen;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusEncryptDataWithSeq(&cipherKey, data, len, outBuf->buf + MESSAGE_INDEX_LEN,
-        &outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusEncryptDataWithSeq failed");
+    if (AuthEncryptWithKey(sessionKeyList, data, len, outBuf->buf + MESSAGE_INDEX_LEN, &outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "AuthEncryptWithKey failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     outBuf->outLen = outLen + MESSAGE_INDEX_LEN;
@@ -310,15 +340,8 @@ int32_t AuthDecrypt(const ConnectOption *option, AuthSideFlag side, uint8_t *dat
         return SOFTBUS_ENCRYPT_ERR;
     }
 
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = sessionKeyList->sessionKeyLen;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusDecryptDataWithSeq(&cipherKey, data, len, outBuf->buf,
-        &outBuf->outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusDecryptDataWithSeq failed");
+    if (AuthDecryptWithKey(sessionKeyList, data, len, outBuf->buf, &outBuf->outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "AuthDecryptWithKey failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     return SOFTBUS_OK;
@@ -341,9 +364,7 @@ void AuthClearSessionKeyBySeq(int32_t seq)
     LIST_FOR_EACH_SAFE(item, tmp, &g_sessionKeyListHead) {
         sessionKeyList = LIST_ENTRY(item, SessionKeyList, node);
         if (sessionKeyList->seq == seq) {
-            (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
-            ListDelete(&sessionKeyList->node);
-            SoftBusFree(sessionKeyList);
+            AuthFreeSessionKeyNode(sessionKeyList);
             sessionKeyList = NULL;
         }
     }
@@ -359,9 +380,7 @@ void AuthClearAllSessionKey(void)
     ListNode *tmp = NULL;
     LIST_FOR_EACH_SAFE(item, tmp, &g_sessionKeyListHead) {
         sessionKeyList = LIST_ENTRY(item, SessionKeyList, node);
-        (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
-        ListDelete(&sessionKeyList->node);
-        SoftBusFree(sessionKeyList);
+        AuthFreeSessionKeyNode(sessionKeyList);
         sessionKeyList = NULL;
     }
     ListInit(&g_sessionKeyListHead);
@@ -16,6 +16,8 @@
 #ifndef BUS_CENTER_INFO_KEY_H
 #define BUS_CENTER_INFO_KEY_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -55,6 +57,12 @@ typedef enum {
     NUM_KEY_END,
 } InfoKey;
 
+typedef struct {
+    InfoKey key;
+    void *info; /* char buffer of len bytes for a string key, int32_t for a number key */
+    uint32_t len;
+} LnnRemoteInfoItem;
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,8 @@ int32_t LnnStopDiscDevice(const char *pkgName, int32_t subscribeId, bool isInner
 
 int32_t LnnGetRemoteStrInfo(const char *netWorkId, InfoKey key, char *info, uint32_t len);
 int32_t LnnGetRemoteNumInfo(const char *netWorkId, InfoKey key, int32_t *info);
+/* reads several keys of one node under a single ledger lock, stops at the first failing key */
+int32_t LnnGetRemoteInfoBatch(const char *netWorkId, LnnRemoteInfoItem *items, uint32_t itemNum);
 int32_t LnnSetLocalStrInfo(InfoKey key, const char *info);
 int32_t LnnSetLocalNumInfo(InfoKey key, int32_t info);
 int32_t LnnGetLocalStrInfo(InfoKey key, char *info, uint32_t len);
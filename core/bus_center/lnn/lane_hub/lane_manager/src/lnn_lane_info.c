@@ -162,10 +162,13 @@ static bool SetPeerIPInfo(const char *netWorkId, LnnLaneLinkType type, bool mode
 {
     int32_t ret;
     int32_t port = 0;
-    ret = LnnGetRemoteStrInfo(netWorkId, STRING_KEY_WLAN_IP,
-        g_lanes[type].laneInfo.conOption.info.ip.ip, IP_STR_MAX_LEN);
+    LnnRemoteInfoItem items[] = {
+        { STRING_KEY_WLAN_IP, g_lanes[type].laneInfo.conOption.info.ip.ip, IP_STR_MAX_LEN },
+        { mode ? NUM_KEY_PROXY_PORT : NUM_KEY_SESSION_PORT, &port, sizeof(port) },
+    };
+    ret = LnnGetRemoteInfoBatch(netWorkId, items, sizeof(items) / sizeof(items[0]));
     if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "LnnGetRemoteStrInfo error, ret = %d", ret);
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "LnnGetRemoteInfoBatch error, ret = %d", ret);
         return false;
     }
     if (strnlen(g_lanes[type].laneInfo.conOption.info.ip.ip, IP_STR_MAX_LEN) == 0 ||
@@ -173,15 +176,6 @@ static bool SetPeerIPInfo(const char *netWorkId, LnnLaneLinkType type, bool mode
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "Wlan ip not found.");
         return false;
     }
-    if (mode) {
-        ret = LnnGetRemoteNumInfo(netWorkId, NUM_KEY_PROXY_PORT, &port);
-    } else {
-        ret = LnnGetRemoteNumInfo(netWorkId, NUM_KEY_SESSION_PORT, &port);
-    }
-    if (ret < 0) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "LnnGetRemoteNumInfo error.");
-        return false;
-    }
     g_lanes[type].laneInfo.conOption.type = CONNECTION_ADDR_WLAN;
     g_lanes[type].laneInfo.conOption.info.ip.port = (uint16_t)port;
     g_lanes[type].laneInfo.isProxy = mode;
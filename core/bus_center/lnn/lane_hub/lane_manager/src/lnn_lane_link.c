@@ -479,19 +479,16 @@ static int32_t OpenAuthConnToDisconnectP2p(const char *networkId, int32_t pid)
 static int32_t CheckP2pRoleConflict(const char *networkId)
 {
     RoleIsConflictInfo info = {0};
-    if (LnnGetRemoteNumInfo(networkId, NUM_KEY_P2P_ROLE, (int32_t *)&info.peerRole) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get peer p2p role fail.");
+    LnnRemoteInfoItem items[] = {
+        { NUM_KEY_P2P_ROLE, &info.peerRole, sizeof(info.peerRole) },
+        { STRING_KEY_P2P_GO_MAC, info.peerGoMac, sizeof(info.peerGoMac) },
+        { STRING_KEY_P2P_MAC, info.peerMac, sizeof(info.peerMac) },
+    };
+    if (LnnGetRemoteInfoBatch(networkId, items, sizeof(items) / sizeof(items[0])) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get peer p2p info fail.");
         return SOFTBUS_ERR;
     }
     info.expectedRole = GetExpectedP2pRole();
-    if (LnnGetRemoteStrInfo(networkId, STRING_KEY_P2P_GO_MAC, info.peerGoMac, sizeof(info.peerGoMac)) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get peer p2p go mac fail.");
-        return SOFTBUS_ERR;
-    }
-    if (LnnGetRemoteStrInfo(networkId, STRING_KEY_P2P_MAC, info.peerMac, sizeof(info.peerMac)) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get peer p2p mac fail.");
-        return SOFTBUS_ERR;
-    }
     if (strnlen(info.peerMac, P2P_MAC_LEN) == 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "p2p mac is empty.");
         return SOFTBUS_ERR;
@@ -46,6 +46,8 @@ typedef struct {
     Map udidMap;
     Map ipMap;
     Map macMap;
+    Map networkIdMap; /* networkId -> udid, index of udidMap */
+    Map uuidMap; /* uuid -> udid, index of udidMap */
 } DoubleHashMap;
 
 typedef enum {
@@ -62,7 +64,12 @@ typedef struct {
     DoubleHashMap distributedInfo;
     ConnectionCode cnnCode;
     int countMax;
-    SoftBusMutex lock;
+    /*
+     * not recursive, unlike the mutex it replaced on LiteOS-M, and a reader queues behind a waiting writer, so
+     * even a nested read lock may deadlock. Only node accessors and map operations run with it held, none calls
+     * back into the ledger; PostOnlineNodesToCb calls out to its callback without it.
+     */
+    SoftBusRWLock lock;
     DistributedLedgerStatus status;
     int32_t laneCount[LNN_LINK_TYPE_BUTT];
 } DistributedNetLedger;
@@ -89,6 +96,74 @@ static NodeInfo *GetNodeInfoFromMap(const DoubleHashMap *map, const char *id)
     return NULL;
 }
 
+static Map *GetIdIndexMap(DoubleHashMap *map, IdCategory type)
+{
+    if (type == CATEGORY_NETWORK_ID) {
+        return &map->networkIdMap;
+    }
+    if (type == CATEGORY_UUID) {
+        return &map->uuidMap;
+    }
+    return NULL;
+}
+
+static const char *GetIndexId(const NodeInfo *info, IdCategory type)
+{
+    return (type == CATEGORY_NETWORK_ID) ? info->networkId : info->uuid;
+}
+
+static void AddIdIndexLocked(DoubleHashMap *map, const NodeInfo *info, const char *udid)
+{
+    char udidBuf[UDID_BUF_LEN] = {0};
+    if (strcpy_s(udidBuf, sizeof(udidBuf), udid) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "copy udid for id index fail");
+        return;
+    }
+    IdCategory types[] = { CATEGORY_NETWORK_ID, CATEGORY_UUID };
+    for (uint32_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        const char *id = GetIndexId(info, types[i]);
+        if (id[0] == '\0') {
+            continue;
+        }
+        if (LnnMapSet(GetIdIndexMap(map, types[i]), id, udidBuf, sizeof(udidBuf)) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "add id index fail, type=%d", types[i]);
+        }
+    }
+}
+
+static void RemoveIdIndexLocked(DoubleHashMap *map, const NodeInfo *info, const char *udid)
+{
+    IdCategory types[] = { CATEGORY_NETWORK_ID, CATEGORY_UUID };
+    for (uint32_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        Map *index = GetIdIndexMap(map, types[i]);
+        const char *id = GetIndexId(info, types[i]);
+        const char *indexUdid = (const char *)LnnMapGet(index, id);
+        /* the id may have been taken over by another node since, leave its entry alone */
+        if (indexUdid != NULL && strcmp(indexUdid, udid) == 0) {
+            (void)LnnMapErase(index, id);
+        }
+    }
+}
+
+static NodeInfo *GetNodeInfoFromIdIndex(DoubleHashMap *map, const char *id, IdCategory type)
+{
+    Map *index = GetIdIndexMap(map, type);
+    if (index == NULL) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "type error");
+        return NULL;
+    }
+    const char *udid = (const char *)LnnMapGet(index, id);
+    if (udid == NULL) {
+        return NULL;
+    }
+    NodeInfo *info = (NodeInfo *)LnnMapGet(&map->udidMap, udid);
+    if (info == NULL || strcmp(GetIndexId(info, type), id) != 0) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "id index out of date, type=%d", type);
+        return NULL;
+    }
+    return info;
+}
+
 static int32_t InitDistributedInfo(DoubleHashMap *map)
 {
     if (map == NULL) {
@@ -98,6 +173,8 @@ static int32_t InitDistributedInfo(DoubleHashMap *map)
     LnnMapInit(&map->udidMap);
     LnnMapInit(&map->ipMap);
     LnnMapInit(&map->macMap);
+    LnnMapInit(&map->networkIdMap);
+    LnnMapInit(&map->uuidMap);
     return SOFTBUS_OK;
 }
 
@@ -110,6 +187,8 @@ static void DeinitDistributedInfo(DoubleHashMap *map)
     LnnMapDelete(&map->udidMap);
     LnnMapDelete(&map->ipMap);
     LnnMapDelete(&map->macMap);
+    LnnMapDelete(&map->networkIdMap);
+    LnnMapDelete(&map->uuidMap);
 }
 
 static int32_t InitConnectionCode(ConnectionCode *cnnCode)
@@ -157,7 +236,7 @@ int32_t LnnInitDistributedLedger(void)
         return SOFTBUS_ERR;
     }
 
-    if (SoftBusMutexInit(&g_distributedNetLedger.lock, NULL) != SOFTBUS_OK) {
+    if (SoftBusRWLockInit(&g_distributedNetLedger.lock) != SOFTBUS_OK) {
         g_distributedNetLedger.status = DL_INIT_FAIL;
         return SOFTBUS_ERR;
     }
@@ -168,17 +247,17 @@ int32_t LnnInitDistributedLedger(void)
 
 void LnnDeinitDistributedLedger(void)
 {
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return;
     }
     g_distributedNetLedger.status = DL_INIT_UNKNOWN;
     DeinitDistributedInfo(&g_distributedNetLedger.distributedInfo);
     DeinitConnectionCode(&g_distributedNetLedger.cnnCode);
-    if (SoftBusMutexUnlock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockUnlock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "unlock mutex fail!");
     }
-    SoftBusMutexDestroy(&g_distributedNetLedger.lock);
+    SoftBusRWLockDestroy(&g_distributedNetLedger.lock);
 }
 
 static void NewWifiDiscovered(const NodeInfo *oldInfo, NodeInfo *newInfo)
@@ -241,23 +320,17 @@ static int32_t GetDLOnlineNodeNumLocked(int32_t *infoNum)
 {
     NodeInfo *info = NULL;
     DoubleHashMap *map = &g_distributedNetLedger.distributedInfo;
-    MapIterator *it = LnnMapInitIterator(&map->udidMap);
+    MapIterator it;
 
-    if (it == NULL) {
-        return SOFTBUS_ERR;
-    }
+    LnnMapResetIterator(&map->udidMap, &it);
     *infoNum = 0;
-    while (LnnMapHasNext(it)) {
-        it = LnnMapNext(it);
-        if (it == NULL) {
-            return SOFTBUS_ERR;
-        }
-        info = (NodeInfo *)it->node->value;
+    while (LnnMapHasNext(&it)) {
+        (void)LnnMapNext(&it);
+        info = (NodeInfo *)it.node->value;
         if (LnnIsNodeOnline(info)) {
             (*infoNum)++;
         }
     }
-    LnnMapDeinitIterator(it);
     return SOFTBUS_OK;
 }
 
@@ -265,26 +338,18 @@ static int32_t FillDLOnlineNodeInfoLocked(NodeBasicInfo *info, int32_t infoNum)
 {
     NodeInfo *nodeInfo = NULL;
     DoubleHashMap *map = &g_distributedNetLedger.distributedInfo;
-    MapIterator *it = LnnMapInitIterator(&map->udidMap);
+    MapIterator it;
     int32_t i = 0;
 
-    if (it == NULL) {
-        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "it is null");
-        return SOFTBUS_ERR;
-    }
-    while (LnnMapHasNext(it) && i < infoNum) {
-        it = LnnMapNext(it);
-        if (it == NULL) {
-            LnnMapDeinitIterator(it);
-            return SOFTBUS_ERR;
-        }
-        nodeInfo = (NodeInfo *)it->node->value;
+    LnnMapResetIterator(&map->udidMap, &it);
+    while (LnnMapHasNext(&it) && i < infoNum) {
+        (void)LnnMapNext(&it);
+        nodeInfo = (NodeInfo *)it.node->value;
         if (LnnIsNodeOnline(nodeInfo)) {
             ConvertNodeInfoToBasicInfo(nodeInfo, info + i);
             ++i;
         }
     }
-    LnnMapDeinitIterator(it);
     return SOFTBUS_OK;
 }
 
@@ -312,64 +377,29 @@ void PostOnlineNodesToCb(const INodeStateCb *callBack)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "onNodeOnline IS null!");
         return;
     }
-    MapIterator *it = LnnMapInitIterator(&map->udidMap);
-    if (it == NULL) {
-        return;
-    }
-    while (LnnMapHasNext(it)) {
-        it = LnnMapNext(it);
-        if (it == NULL) {
-            return;
-        }
-        info = (NodeInfo *)it->node->value;
+    MapIterator it;
+    LnnMapResetIterator(&map->udidMap, &it);
+    while (LnnMapHasNext(&it)) {
+        (void)LnnMapNext(&it);
+        info = (NodeInfo *)it.node->value;
         if (LnnIsNodeOnline(info)) {
             ConvertNodeInfoToBasicInfo(info, &basic);
             callBack->onNodeOnline(&basic);
         }
     }
-    LnnMapDeinitIterator(it);
 }
 
 NodeInfo *LnnGetNodeInfoById(const char *id, IdCategory type)
 {
-    NodeInfo *info = NULL;
     DoubleHashMap *map = &g_distributedNetLedger.distributedInfo;
     if (id == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "para error");
-        return info;
+        return NULL;
     }
     if (type == CATEGORY_UDID) {
         return GetNodeInfoFromMap(map, id);
     }
-    MapIterator *it = LnnMapInitIterator(&map->udidMap);
-    if (it == NULL) {
-        return info;
-    }
-    while (LnnMapHasNext(it)) {
-        it = LnnMapNext(it);
-        if (it == NULL) {
-            return info;
-        }
-        info = (NodeInfo *)it->node->value;
-        if (info == NULL) {
-            continue;
-        }
-        if (type == CATEGORY_NETWORK_ID) {
-            if (strcmp(info->networkId, id) == 0) {
-                LnnMapDeinitIterator(it);
-                return info;
-            }
-        } else if (type == CATEGORY_UUID) {
-            if (strcmp(info->uuid, id) == 0) {
-                LnnMapDeinitIterator(it);
-                return info;
-            }
-        } else {
-            SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "type error");
-        }
-    }
-    LnnMapDeinitIterator(it);
-    return NULL;
+    return GetNodeInfoFromIdIndex(map, id, type);
 }
 
 bool LnnGetOnlineStateById(const char *id, IdCategory type)
@@ -380,17 +410,17 @@ bool LnnGetOnlineStateById(const char *id, IdCategory type)
         return state;
     }
 
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return state;
     }
     NodeInfo *nodeInfo = LnnGetNodeInfoById(id, type);
     if (nodeInfo == NULL) {
-        (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return state;
     }
     state = (nodeInfo->status == STATUS_ONLINE) ? true : false;
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return state;
 }
 
@@ -767,7 +797,7 @@ ReportCategory LnnAddOnlineNode(NodeInfo *info)
 
     deviceId = LnnGetDeviceUdid(info);
     map = &g_distributedNetLedger.distributedInfo;
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return REPORT_NONE;
     }
@@ -788,9 +818,15 @@ ReportCategory LnnAddOnlineNode(NodeInfo *info)
         }
         MergeLnnRelation(oldInfo, info);
     }
+    if (oldInfo != NULL) {
+        /* the stored node is overwritten in place below, drop its old ids first */
+        RemoveIdIndexLocked(map, oldInfo, deviceId);
+    }
     LnnSetNodeConnStatus(info, STATUS_ONLINE);
-    LnnMapSet(&map->udidMap, deviceId, info, sizeof(NodeInfo));
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    if (LnnMapSet(&map->udidMap, deviceId, info, sizeof(NodeInfo)) == SOFTBUS_OK) {
+        AddIdIndexLocked(map, info, deviceId);
+    }
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     if (isOffline) {
         return REPORT_ONLINE;
     }
@@ -805,14 +841,14 @@ ReportCategory LnnSetNodeOffline(const char *udid, ConnectionAddrType type, int3
     NodeInfo *info = NULL;
 
     DoubleHashMap *map = &g_distributedNetLedger.distributedInfo;
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return REPORT_NONE;
     }
     info = (NodeInfo *)LnnMapGet(&map->udidMap, udid);
     if (info == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "PARA ERROR!");
-        SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return REPORT_NONE;
     }
     if (type != CONNECTION_ADDR_MAX && info->relation[type] > 0) {
@@ -825,12 +861,12 @@ ReportCategory LnnSetNodeOffline(const char *udid, ConnectionAddrType type, int3
     if (LnnHasDiscoveryType(info, DISCOVERY_TYPE_WIFI)) {
         if (info->authChannelId != authId) {
             SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_INFO, "not need to report offline.");
-            SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+            SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
             return REPORT_NONE;
         }
     }
     LnnSetNodeConnStatus(info, STATUS_OFFLINE);
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_INFO, "need to report offline.");
     return REPORT_OFFLINE;
 }
@@ -842,13 +878,13 @@ int32_t LnnGetBasicInfoByUdid(const char *udid, NodeBasicInfo *basicInfo)
         return SOFTBUS_INVALID_PARAM;
     }
     DoubleHashMap *map = &g_distributedNetLedger.distributedInfo;
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
     NodeInfo *info = (NodeInfo *)LnnMapGet(&map->udidMap, udid);
     int32_t ret = ConvertNodeInfoToBasicInfo(info, basicInfo);
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return ret;
 }
 
@@ -858,12 +894,16 @@ void LnnRemoveNode(const char *udid)
     if (udid == NULL) {
         return;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return;
     }
+    NodeInfo *info = (NodeInfo *)LnnMapGet(&map->udidMap, udid);
+    if (info != NULL) {
+        RemoveIdIndexLocked(map, info, udid);
+    }
     LnnMapErase(&map->udidMap, udid);
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
 }
 
 const char *LnnConvertDLidToUdid(const char *id, IdCategory type)
@@ -890,14 +930,14 @@ int32_t LnnConvertDlId(const char *srcId, IdCategory srcIdType, IdCategory dstId
     if (srcId == NULL || dstIdBuf == NULL) {
         return SOFTBUS_INVALID_PARAM;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail");
         return SOFTBUS_LOCK_ERR;
     }
     info = LnnGetNodeInfoById(srcId, srcIdType);
     if (info == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "no node info for: %d", srcIdType);
-        SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_NOT_FIND;
     }
     switch (dstIdType) {
@@ -911,14 +951,14 @@ int32_t LnnConvertDlId(const char *srcId, IdCategory srcIdType, IdCategory dstId
             id = info->networkId;
             break;
         default:
-            SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+            SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
             return SOFTBUS_INVALID_PARAM;
     }
     if (strcpy_s(dstIdBuf, dstIdBufLen, id) != EOK) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "copy id fail");
         rc = SOFTBUS_MEM_ERR;
     }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return rc;
 }
 
@@ -929,22 +969,22 @@ int32_t LnnGetLnnRelation(const char *id, IdCategory type, uint8_t *relation, ui
     if (id == NULL || relation == NULL) {
         return SOFTBUS_INVALID_PARAM;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail");
         return SOFTBUS_LOCK_ERR;
     }
     info = LnnGetNodeInfoById(id, type);
     if (info == NULL || !LnnIsNodeOnline(info)) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "node not online");
-        SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_NOT_FIND;
     }
     if (memcpy_s(relation, len, info->relation, CONNECTION_ADDR_MAX) != EOK) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "copy relation fail");
-        SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_MEM_ERR;
     }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return SOFTBUS_OK;
 }
 
@@ -956,7 +996,7 @@ bool LnnSetDLDeviceInfoName(const char *udid, const char *name)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "para error!");
         return false;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return false;
     }
@@ -967,17 +1007,17 @@ bool LnnSetDLDeviceInfoName(const char *udid, const char *name)
     }
     if (strcmp(LnnGetDeviceName(&info->deviceInfo), name) == 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_INFO, "devicename not change!");
-        SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return true;
     }
     if (LnnSetDeviceName(&info->deviceInfo, name) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "set device name error!");
         goto EXIT;
     }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return true;
 EXIT:
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return false;
 }
 
@@ -988,7 +1028,7 @@ bool LnnSetDLP2pInfo(const char *networkId, const P2pInfo *info)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "invalid param.");
         return false;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail.");
         return false;
     }
@@ -1003,16 +1043,29 @@ bool LnnSetDLP2pInfo(const char *networkId, const P2pInfo *info)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "set p2p info fail.");
         goto EXIT;
     }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return true;
 EXIT:
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return false;
 }
 
-int32_t LnnGetRemoteStrInfo(const char *networkId, InfoKey key, char *info, uint32_t len)
+static int32_t GetDLKeyInfoLocked(const char *networkId, InfoKey key, void *info, uint32_t len)
 {
     uint32_t i;
+    for (i = 0; i < sizeof(g_dlKeyTable) / sizeof(DistributedLedgerKey); i++) {
+        if (key == g_dlKeyTable[i].key) {
+            if (g_dlKeyTable[i].getInfo != NULL) {
+                return g_dlKeyTable[i].getInfo(networkId, info, len);
+            }
+        }
+    }
+    SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "KEY NOT exist.");
+    return SOFTBUS_ERR;
+}
+
+int32_t LnnGetRemoteStrInfo(const char *networkId, InfoKey key, char *info, uint32_t len)
+{
     int32_t ret;
     if (!IsValidString(networkId, ID_MAX_LEN)) {
         return SOFTBUS_INVALID_PARAM;
@@ -1025,27 +1078,17 @@ int32_t LnnGetRemoteStrInfo(const char *networkId, InfoKey key, char *info, uint
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "KEY error.");
         return SOFTBUS_INVALID_PARAM;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
-    for (i = 0; i < sizeof(g_dlKeyTable) / sizeof(DistributedLedgerKey); i++) {
-        if (key == g_dlKeyTable[i].key) {
-            if (g_dlKeyTable[i].getInfo != NULL) {
-                ret = g_dlKeyTable[i].getInfo(networkId, (void *)info, len);
-                SoftBusMutexUnlock(&g_distributedNetLedger.lock);
-                return ret;
-            }
-        }
-    }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
-    SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "KEY NOT exist.");
-    return SOFTBUS_ERR;
+    ret = GetDLKeyInfoLocked(networkId, key, (void *)info, len);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
+    return ret;
 }
 
 int32_t LnnGetRemoteNumInfo(const char *networkId, InfoKey key, int32_t *info)
 {
-    uint32_t i;
     int32_t ret;
     if (!IsValidString(networkId, ID_MAX_LEN)) {
         return SOFTBUS_INVALID_PARAM;
@@ -1058,22 +1101,44 @@ int32_t LnnGetRemoteNumInfo(const char *networkId, InfoKey key, int32_t *info)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "KEY error.");
         return SOFTBUS_INVALID_PARAM;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
-    for (i = 0; i < sizeof(g_dlKeyTable) / sizeof(DistributedLedgerKey); i++) {
-        if (key == g_dlKeyTable[i].key) {
-            if (g_dlKeyTable[i].getInfo != NULL) {
-                ret = g_dlKeyTable[i].getInfo(networkId, (void *)info, NUM_BUF_SIZE);
-                SoftBusMutexUnlock(&g_distributedNetLedger.lock);
-                return ret;
-            }
+    ret = GetDLKeyInfoLocked(networkId, key, (void *)info, NUM_BUF_SIZE);
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
+    return ret;
+}
+
+int32_t LnnGetRemoteInfoBatch(const char *networkId, LnnRemoteInfoItem *items, uint32_t itemNum)
+{
+    uint32_t i;
+    int32_t ret = SOFTBUS_OK;
+    if (!IsValidString(networkId, ID_MAX_LEN) || items == NULL || itemNum == 0) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "invalid param");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    for (i = 0; i < itemNum; i++) {
+        if (items[i].info == NULL || items[i].key >= NUM_KEY_END ||
+            (items[i].key >= STRING_KEY_END && items[i].key < NUM_KEY_BEGIN)) {
+            SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "invalid item %u", i);
+            return SOFTBUS_INVALID_PARAM;
         }
     }
-    SoftBusMutexUnlock(&g_distributedNetLedger.lock);
-    SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "KEY NOT exist.");
-    return SOFTBUS_ERR;
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
+        return SOFTBUS_ERR;
+    }
+    for (i = 0; i < itemNum; i++) {
+        uint32_t len = (items[i].key >= NUM_KEY_BEGIN) ? NUM_BUF_SIZE : items[i].len;
+        ret = GetDLKeyInfoLocked(networkId, items[i].key, items[i].info, len);
+        if (ret != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get key %d fail", items[i].key);
+            break;
+        }
+    }
+    SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
+    return ret;
 }
 
 int32_t LnnGetAllOnlineNodeInfo(NodeBasicInfo **info, int32_t *infoNum)
@@ -1084,8 +1149,9 @@ int32_t LnnGetAllOnlineNodeInfo(NodeBasicInfo **info, int32_t *infoNum)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "key params are null");
         return ret;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
+        return ret;
     }
     do {
         *info = NULL;
@@ -1111,7 +1177,7 @@ int32_t LnnGetAllOnlineNodeInfo(NodeBasicInfo **info, int32_t *infoNum)
     if (ret != SOFTBUS_OK && (*info != NULL)) {
         SoftBusFree(*info);
     }
-    if (SoftBusMutexUnlock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockUnlock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "unlock mutex fail!");
     }
     return ret;
@@ -1124,22 +1190,22 @@ int32_t LnnGetNetworkIdByUuid(const char *uuid, char *buf, uint32_t len)
         return SOFTBUS_INVALID_PARAM;
     }
 
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
     NodeInfo *nodeInfo = LnnGetNodeInfoById(uuid, CATEGORY_UUID);
     if (nodeInfo == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get info fail");
-        (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_ERR;
     }
     if (strncpy_s(buf, len, nodeInfo->networkId, strlen(nodeInfo->networkId)) != EOK) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "STR COPY ERROR!");
-        (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_MEM_ERR;
     }
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return SOFTBUS_OK;
 }
 
@@ -1158,7 +1224,7 @@ int32_t LnnSetLaneCount(int32_t laneId, int32_t num)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "laneId is error! laneId:", laneId);
         return SOFTBUS_ERR;
     }
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
@@ -1167,40 +1233,40 @@ int32_t LnnSetLaneCount(int32_t laneId, int32_t num)
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "laneCount(%d) error", g_distributedNetLedger.laneCount[laneId]);
         g_distributedNetLedger.laneCount[laneId] = 0;
     }
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return SOFTBUS_OK;
 }
 
 int32_t LnnGetDistributedHeartbeatTimestamp(const char *networkId, uint64_t *timestamp)
 {
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockRdLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
     NodeInfo *nodeInfo = LnnGetNodeInfoById(networkId, CATEGORY_NETWORK_ID);
     if (nodeInfo == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get info fail");
-        (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_ERR;
     }
     *timestamp = nodeInfo->heartbeatTimeStamp;
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return SOFTBUS_OK;
 }
 
 int32_t LnnSetDistributedHeartbeatTimestamp(const char *networkId, const uint64_t timestamp)
 {
-    if (SoftBusMutexLock(&g_distributedNetLedger.lock) != 0) {
+    if (SoftBusRWLockWrLock(&g_distributedNetLedger.lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return SOFTBUS_ERR;
     }
     NodeInfo *nodeInfo = LnnGetNodeInfoById(networkId, CATEGORY_NETWORK_ID);
     if (nodeInfo == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "get info fail");
-        (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+        (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
         return SOFTBUS_ERR;
     }
     nodeInfo->heartbeatTimeStamp = timestamp;
-    (void)SoftBusMutexUnlock(&g_distributedNetLedger.lock);
+    (void)SoftBusRWLockUnlock(&g_distributedNetLedger.lock);
     return SOFTBUS_OK;
 }
\ No newline at end of file
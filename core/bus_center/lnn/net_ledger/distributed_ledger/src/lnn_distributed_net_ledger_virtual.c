@@ -45,6 +45,14 @@ int32_t LnnGetDLNumInfo(const char *networkId, InfoKey key, int32_t *info)
     return SOFTBUS_NOT_IMPLEMENT;
 }
 
+int32_t LnnGetRemoteInfoBatch(const char *networkId, LnnRemoteInfoItem *items, uint32_t itemNum)
+{
+    (void)networkId;
+    (void)items;
+    (void)itemNum;
+    return SOFTBUS_NOT_IMPLEMENT;
+}
+
 int32_t LnnGetAllOnlineNodeInfo(NodeBasicInfo **info, int32_t *infoNum)
 {
     (void)info;
@@ -24,32 +24,40 @@ extern "C" {
 #endif /* __cplusplus */
 
 /**
- * LNN map node struct
+ * LNN map node struct, key and value live in the same allocation and never move
  */
-typedef struct tagMapNode {
+typedef struct {
     uint32_t hash;
     uint32_t valueSize;
     void *key;
     void *value;
-    struct tagMapNode *next;
 } MapNode;
 
 /**
- * LNN map struct define.
+ * LNN map slot, hash and key length are cached so a probe rarely touches the node
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t keyLen;
+    MapNode *node; /* NULL for an empty slot */
+} MapSlot;
+
+/**
+ * LNN map struct define, open addressing with linear probing.
  */
 typedef struct {
-    MapNode **nodes; /* Map node bucket */
+    MapSlot *nodes; /* Map slot array */
     uint32_t nodeSize; /* Map node count */
-    uint32_t bucketSize; /* Map node bucket size */
+    uint32_t bucketSize; /* Map slot count, power of 2 */
 } Map;
 
 /**
- * LNN map node struct
+ * LNN map iterator struct
  */
 typedef struct {
     MapNode *node; /* Map node */
-    uint32_t nodeNum; /* Map node  */
-    uint32_t bucketNum; /* Map node */
+    uint32_t nodeNum; /* Map node count visited */
+    uint32_t bucketNum; /* Map slot to visit next */
     Map *map;
 } MapIterator;
 
@@ -58,6 +66,15 @@ bool LnnMapHasNext(MapIterator *it);
 MapIterator *LnnMapNext(MapIterator *it);
 void LnnMapDeinitIterator(MapIterator *it);
 
+/**
+ * Reset a caller owned iterator, e.g. one on the stack, to the start of the map.
+ * It is used with LnnMapHasNext and LnnMapNext and needs no LnnMapDeinitIterator.
+ *
+ * @param : map Map see details in type Map
+ *          it Iterator to reset
+ */
+void LnnMapResetIterator(Map *map, MapIterator *it);
+
 /**
  * Initialize map
  *
@@ -100,6 +117,14 @@ void *LnnMapGet(const Map *map, const char *key);
  */
 int32_t LnnMapErase(Map *map, const char *key);
 
+/**
+ * Get map element count
+ *
+ * @param : map Map see details in type Map
+ * @return : element count
+ */
+uint32_t MapGetSize(Map *map);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -24,25 +24,64 @@
 #include "softbus_errcode.h"
 
 #define HDF_MIN_MAP_SIZE 8
-#define HDF_ENLARGE_FACTOR 2
+#define HDF_ENLARGE_FACTOR 1
 #define HDF_MAP_KEY_MAX_SIZE 1000
 #define HDF_MAP_VALUE_MAX_SIZE 1000
 #define SHIFT_ALIGN_BYTE 4
 
-/* BKDR Hash */
-static uint32_t MapHash(const char *key)
+/* max percentage of used slots before the slot array doubles, linear probing degrades past ~80 */
+#ifndef LNN_MAP_LOAD_FACTOR_PERCENT
+#define LNN_MAP_LOAD_FACTOR_PERCENT 70
+#endif
+#define PERCENT_BASE 100
+
+#define HASH_WORD_BYTES 8
+#define HASH_BITS_PER_BYTE 8
+#define HASH_ROTATE_BITS 5
+#define HASH_WORD_MUL 0x517CC1B727220A95ULL
+#define HASH_FINAL_MUL 0xFF51AFD7ED558CCDULL
+#define HASH_FINAL_SHIFT 33
+
+static uint64_t LoadHashTail(const uint8_t *p, uint32_t len)
 {
-    uint32_t hash = 0;
-    const uint32_t seed = 131;
-    if (key == NULL) {
-        return 0;
-    }
-    uint32_t len = strlen(key);
+    uint64_t word = 0;
     for (uint32_t i = 0; i < len; i++) {
-        hash = (hash * seed) + (*key++);
+        word |= (uint64_t)p[i] << (i * HASH_BITS_PER_BYTE);
     }
+    return word;
+}
 
-    return (hash & 0x7FFFFFFF);
+/* spelled out so the compiler turns it into one unaligned load */
+static inline uint64_t LoadHashWord(const uint8_t *p)
+{
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+        ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/* ids are long hex strings, so hash a word at a time instead of a byte at a time */
+static uint32_t MapHash(const char *key, uint32_t *keyLen)
+{
+    uint32_t len = (uint32_t)strlen(key);
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t hash = len;
+    uint32_t left = len;
+    while (left >= HASH_WORD_BYTES) {
+        uint64_t word = LoadHashWord(p);
+        hash = (((hash << HASH_ROTATE_BITS) | (hash >> (64 - HASH_ROTATE_BITS))) ^ word) * HASH_WORD_MUL;
+        p += HASH_WORD_BYTES;
+        left -= HASH_WORD_BYTES;
+    }
+    if (left > 0) {
+        /* a long key reads its last whole word again instead of going byte by byte */
+        uint64_t word = (len >= HASH_WORD_BYTES) ? LoadHashWord(p + left - HASH_WORD_BYTES) : LoadHashTail(p, left);
+        hash = (((hash << HASH_ROTATE_BITS) | (hash >> (64 - HASH_ROTATE_BITS))) ^ word) * HASH_WORD_MUL;
+    }
+    /* slots are picked by the low bits, fold the well mixed high bits into them */
+    hash ^= hash >> HASH_FINAL_SHIFT;
+    hash *= HASH_FINAL_MUL;
+    hash ^= hash >> HASH_FINAL_SHIFT;
+    *keyLen = len;
+    return (uint32_t)hash;
 }
 
 static uint32_t MapHashIdx(const Map *map, uint32_t hash)
@@ -50,51 +89,56 @@ static uint32_t MapHashIdx(const Map *map, uint32_t hash)
     return (hash & (map->bucketSize - 1));
 }
 
-static void MapAddNode(Map *map, MapNode *node)
+static bool IsSlotMatch(const MapSlot *slot, const char *key, uint32_t hash, uint32_t keyLen)
 {
-    uint32_t idx = MapHashIdx(map, node->hash);
-    node->next = map->nodes[idx];
-    map->nodes[idx] = node;
+    return slot->hash == hash && slot->keyLen == keyLen && memcmp(slot->node->key, key, keyLen) == 0;
 }
 
-static int32_t MapResize(Map *map, uint32_t size)
+/* index of the slot holding key, or of the empty slot ending its probe sequence */
+static uint32_t MapFindSlot(const Map *map, const char *key, uint32_t hash, uint32_t keyLen)
 {
-    uint32_t bucketSize;
-    MapNode **nodes = NULL;
-    MapNode **tmp = NULL;
+    uint32_t mask = map->bucketSize - 1;
+    uint32_t idx = MapHashIdx(map, hash);
+    while (map->nodes[idx].node != NULL && !IsSlotMatch(&map->nodes[idx], key, hash, keyLen)) {
+        idx = (idx + 1) & mask;
+    }
+    return idx;
+}
 
-    nodes = (MapNode **)SoftBusCalloc(size * sizeof(*nodes));
+static int32_t MapResize(Map *map, uint32_t size)
+{
+    MapSlot *nodes = (MapSlot *)SoftBusCalloc(size * sizeof(MapSlot));
     if (nodes == NULL) {
         return SOFTBUS_MEM_ERR;
     }
 
-    tmp = map->nodes;
-    bucketSize = map->bucketSize;
+    MapSlot *tmp = map->nodes;
+    uint32_t bucketSize = map->bucketSize;
     map->nodes = nodes;
     map->bucketSize = size;
 
     if (tmp != NULL) {
-        MapNode *node = NULL;
-        MapNode *next = NULL;
-
-        /* remap node with new map size */
+        /* remap slots with new map size, the nodes themselves stay where they are */
+        uint32_t mask = size - 1;
         for (uint32_t i = 0; i < bucketSize; i++) {
-            node = tmp[i];
-            while (node != NULL) {
-                next = node->next;
-                MapAddNode(map, node);
-                node = next;
+            if (tmp[i].node == NULL) {
+                continue;
+            }
+            uint32_t idx = MapHashIdx(map, tmp[i].hash);
+            while (nodes[idx].node != NULL) {
+                idx = (idx + 1) & mask;
             }
+            nodes[idx] = tmp[i];
         }
         SoftBusFree(tmp);
     }
     return SOFTBUS_OK;
 }
 
-static MapNode *MapCreateNode(const char *key, uint32_t hash,
+static MapNode *MapCreateNode(const char *key, uint32_t keyLen, uint32_t hash,
     const void *value, uint32_t valueSize)
 {
-    uint32_t keySize = strlen(key) + 1;
+    uint32_t keySize = keyLen + 1;
     keySize = keySize + (SHIFT_ALIGN_BYTE - keySize % SHIFT_ALIGN_BYTE);
     MapNode *node = (MapNode *)SoftBusCalloc(sizeof(*node) + keySize + valueSize);
     if (node == NULL) {
@@ -105,7 +149,7 @@ static MapNode *MapCreateNode(const char *key, uint32_t hash,
     node->key = (uint8_t *)node + sizeof(*node);
     node->value = (uint8_t *)node + sizeof(*node) + keySize;
     node->valueSize = valueSize;
-    if (memcpy_s(node->key, keySize, key, strlen(key) + 1) != EOK) {
+    if (memcpy_s(node->key, keySize, key, keyLen + 1) != EOK) {
         SoftBusFree(node);
         return NULL;
     }
@@ -127,48 +171,48 @@ static MapNode *MapCreateNode(const char *key, uint32_t hash,
  */
 int32_t LnnMapSet(Map *map, const char *key, const void *value, uint32_t valueSize)
 {
-    MapNode *node = NULL;
-
     if (map == NULL || key == NULL || value == NULL || valueSize == 0) {
         return SOFTBUS_INVALID_PARAM;
     }
-    if (valueSize > HDF_MAP_KEY_MAX_SIZE || strlen(key) > HDF_MAP_VALUE_MAX_SIZE) {
+    uint32_t keyLen;
+    uint32_t hash = MapHash(key, &keyLen);
+    if (valueSize > HDF_MAP_VALUE_MAX_SIZE || keyLen > HDF_MAP_KEY_MAX_SIZE) {
         return SOFTBUS_INVALID_PARAM;
     }
-    uint32_t hash = MapHash(key);
+    uint32_t idx;
     if (map->nodeSize > 0 && map->nodes != NULL) {
-        uint32_t idx = MapHashIdx(map, hash);
-        node = map->nodes[idx];
-        while (node != NULL) {
-            if (node->hash != hash || node->key == NULL || strcmp(node->key, key) != 0) {
-                node = node->next;
-                continue;
-            }
-
+        idx = MapFindSlot(map, key, hash, keyLen);
+        MapNode *node = map->nodes[idx].node;
+        if (node != NULL) {
             // size unmatch
             if (node->value == NULL || node->valueSize != valueSize) {
                 return SOFTBUS_INVALID_PARAM;
             }
-            // update k-v node
+            // update k-v node in place, pointers to the value stay valid
             if (memcpy_s(node->value, node->valueSize, value, valueSize) != EOK) {
                 return SOFTBUS_ERR;
             }
-
             return SOFTBUS_OK;
         }
     }
-    // for decreasing map search conflict, enlarge bucket Size
-    if (map->nodeSize >= map->bucketSize) {
-        uint32_t size = (map->bucketSize < HDF_MIN_MAP_SIZE) ? HDF_MIN_MAP_SIZE : \
+    // keep enough empty slots for probe sequences to stay short
+    if (map->nodes == NULL ||
+        (uint64_t)(map->nodeSize + 1) * PERCENT_BASE > (uint64_t)map->bucketSize * LNN_MAP_LOAD_FACTOR_PERCENT) {
+        uint32_t size = (map->bucketSize < HDF_MIN_MAP_SIZE) ? HDF_MIN_MAP_SIZE :
             (map->bucketSize << HDF_ENLARGE_FACTOR);
-        MapResize(map, size);
+        if (MapResize(map, size) != SOFTBUS_OK) {
+            return SOFTBUS_MEM_ERR;
+        }
     }
 
-    node = MapCreateNode(key, hash, value, valueSize);
+    MapNode *node = MapCreateNode(key, keyLen, hash, value, valueSize);
     if (node == NULL) {
         return SOFTBUS_INVALID_PARAM;
     }
-    MapAddNode(map, node);
+    idx = MapFindSlot(map, key, hash, keyLen);
+    map->nodes[idx].hash = hash;
+    map->nodes[idx].keyLen = keyLen;
+    map->nodes[idx].node = node;
     map->nodeSize++;
 
     return SOFTBUS_OK;
@@ -187,19 +231,10 @@ void* LnnMapGet(const Map *map, const char *key)
         return NULL;
     }
 
-    uint32_t hash = MapHash(key);
-    uint32_t idx = MapHashIdx(map, hash);
-    MapNode *node = map->nodes[idx];
-
-    while (node != NULL) {
-        if (node->hash == hash && node->key != NULL && !strcmp(node->key, key)) {
-            return node->value;
-        }
-
-        node = node->next;
-    }
-
-    return NULL;
+    uint32_t keyLen;
+    uint32_t hash = MapHash(key, &keyLen);
+    MapNode *node = map->nodes[MapFindSlot(map, key, hash, keyLen)].node;
+    return (node != NULL) ? node->value : NULL;
 }
 
 /**
@@ -214,27 +249,28 @@ int32_t LnnMapErase(Map *map, const char *key)
         return SOFTBUS_INVALID_PARAM;
     }
 
-    uint32_t hash = MapHash(key);
-    uint32_t idx = MapHashIdx(map, hash);
-    MapNode *node = map->nodes[idx];
-    MapNode *prev = node;
-
-    while (node != NULL) {
-        if (node->hash == hash && node->key != NULL && !strcmp(node->key, key)) {
-            if (map->nodes[idx] == node) {
-                map->nodes[idx] = node->next;
-            } else {
-                prev->next = node->next;
-            }
-            SoftBusFree(node);
-            map->nodeSize--;
-            return SOFTBUS_OK;
+    uint32_t keyLen;
+    uint32_t hash = MapHash(key, &keyLen);
+    uint32_t idx = MapFindSlot(map, key, hash, keyLen);
+    if (map->nodes[idx].node == NULL) {
+        return SOFTBUS_ERR;
+    }
+    SoftBusFree(map->nodes[idx].node);
+    map->nodes[idx].node = NULL;
+    map->nodeSize--;
+
+    /* shift later slots of the cluster back so no probe sequence crosses the new hole */
+    uint32_t mask = map->bucketSize - 1;
+    uint32_t hole = idx;
+    for (uint32_t next = (hole + 1) & mask; map->nodes[next].node != NULL; next = (next + 1) & mask) {
+        uint32_t home = MapHashIdx(map, map->nodes[next].hash);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->nodes[hole] = map->nodes[next];
+            map->nodes[next].node = NULL;
+            hole = next;
         }
-        prev = node;
-        node = node->next;
     }
-
-    return SOFTBUS_ERR;
+    return SOFTBUS_OK;
 }
 
 uint32_t MapGetSize(Map *map)
@@ -264,20 +300,13 @@ void LnnMapInit(Map *map)
  */
 void LnnMapDelete(Map *map)
 {
-    uint32_t i;
-    MapNode *node = NULL;
-    MapNode *next = NULL;
-
     if (map == NULL || map->nodes == NULL) {
         return;
     }
 
-    for (i = 0; i < map->bucketSize; i++) {
-        node = map->nodes[i];
-        while (node != NULL) {
-            next = node->next;
-            SoftBusFree(node);
-            node = next;
+    for (uint32_t i = 0; i < map->bucketSize; i++) {
+        if (map->nodes[i].node != NULL) {
+            SoftBusFree(map->nodes[i].node);
         }
     }
 
@@ -288,6 +317,23 @@ void LnnMapDelete(Map *map)
     map->bucketSize = 0;
 }
 
+/**
+ * reset LNN map iterator owned by the caller
+ *
+ * @param : map Map see details in type Map
+ *          it Iterator see details in type Iterator
+ */
+void LnnMapResetIterator(Map *map, MapIterator *it)
+{
+    if (it == NULL) {
+        return;
+    }
+    it->node = NULL;
+    it->bucketNum = 0;
+    it->nodeNum = 0;
+    it->map = map;
+}
+
 /**
  * init LNN map iterator
  *
@@ -303,10 +349,7 @@ MapIterator *LnnMapInitIterator(Map *map)
     if (it == NULL) {
         return NULL;
     }
-    it->node = NULL;
-    it->bucketNum = 0;
-    it->nodeNum = 0;
-    it->map = map;
+    LnnMapResetIterator(map, it);
     return it;
 }
 
@@ -327,18 +370,12 @@ bool LnnMapHasNext(MapIterator *it)
  */
 MapIterator *LnnMapNext(MapIterator *it)
 {
-    MapNode *node = NULL;
     if (it == NULL) {
         return NULL;
     }
     if (LnnMapHasNext(it)) {
-        if (it->node != NULL && it->node->next != NULL) {
-            it->nodeNum++;
-            it->node = it->node->next;
-            return it;
-        }
         while (it->bucketNum < it->map->bucketSize) {
-            node = it->map->nodes[it->bucketNum];
+            MapNode *node = it->map->nodes[it->bucketNum].node;
             it->bucketNum++;
             if (node != NULL) {
                 it->nodeNum++;
@@ -361,4 +398,4 @@ void LnnMapDeinitIterator(MapIterator *it)
         return;
     }
     SoftBusFree(it);
-}
\ No newline at end of file
+}
@@ -19,6 +19,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "common_list.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -53,6 +55,11 @@ struct SoftBusMessage {
     void *obj;
     SoftBusHandler *handler;
     void (*FreeMessage)(SoftBusMessage *msg);
+    /* owned by the looper while the message is queued, never touch them */
+    ListNode handlerNode;
+    uint64_t seq;
+    uint32_t heapIndex;
+    int64_t postTime;
 };
 
 SoftBusMessage *MallocMessage(void);
@@ -80,6 +87,44 @@ void DestroyLooper(SoftBusLooper *looper);
 
 void SetLooperDumpable(SoftBusLooper *loop, bool dumpable);
 
+#define LOOPER_HIST_BUCKET_NUM 6
+#define LOOPER_STAT_NAME_LEN 32
+
+/*
+ * Latency histograms in microseconds, the buckets are
+ * [0, 100us) [100us, 1ms) [1ms, 10ms) [10ms, 100ms) [100ms, 1s) [1s, ...)
+ */
+typedef struct {
+    uint64_t dispatchCnt;
+    uint32_t curQueueDepth;
+    uint32_t maxQueueDepth;
+    uint64_t queueWaitHist[LOOPER_HIST_BUCKET_NUM];  /* post to dequeue, immediate messages */
+    uint64_t timerDriftHist[LOOPER_HIST_BUCKET_NUM]; /* due time to dequeue, delayed messages */
+    uint64_t execHist[LOOPER_HIST_BUCKET_NUM];       /* time spent in HandleMessage */
+    int64_t maxQueueWaitUs;
+    int64_t maxTimerDriftUs;
+    int64_t maxExecUs;
+    uint64_t untrackedCnt; /* dispatches not counted per handler, the handler table was full */
+} SoftBusLooperStats;
+
+typedef struct {
+    char handlerName[LOOPER_STAT_NAME_LEN];
+    int32_t what;
+    uint64_t dispatchCnt;
+    int64_t totalExecUs;
+    int64_t maxExecUs;
+} SoftBusLooperHandlerStats;
+
+int32_t GetLooperStats(const SoftBusLooper *looper, SoftBusLooperStats *stats);
+
+/* num is the capacity of stats on input and the number of entries filled on output. */
+int32_t GetLooperHandlerStats(const SoftBusLooper *looper, SoftBusLooperHandlerStats *stats, uint32_t *num);
+
+void ResetLooperStats(const SoftBusLooper *looper);
+
+/* Write the stats of every alive looper to fd as text, used by the service dump. */
+void DumpLooperStats(int32_t fd);
+
 #ifdef __cplusplus
 }
 #endif
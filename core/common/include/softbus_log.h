@@ -35,7 +35,35 @@ typedef enum {
     SOFTBUS_LOG_MODULE_MAX,
 } SoftBusLogModule;
 
-void SoftBusLog(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, ...);
+/* logs below this level are compiled out, release builds may raise it with a define */
+#ifndef SOFTBUS_LOG_LEVEL_MIN
+#define SOFTBUS_LOG_LEVEL_MIN SOFTBUS_LOG_DBG
+#endif
+
+/* cached copy of SOFTBUS_INT_ADAPTER_LOG_LEVEL, only written through SoftBusLogSetLevel */
+extern int32_t g_softbusLogLevel;
+
+#define SOFTBUS_LOG_IS_ENABLED(level) \
+    ((int32_t)(level) >= (int32_t)SOFTBUS_LOG_LEVEL_MIN && (int32_t)(level) >= g_softbusLogLevel)
+
+void SoftBusLogImpl(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, ...);
+
+/* the level check comes first, so the arguments of a filtered log are never evaluated */
+#define SoftBusLog(module, level, fmt, ...) do { \
+    if (SOFTBUS_LOG_IS_ENABLED(level)) { \
+        SoftBusLogImpl(module, level, fmt, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+void SoftBusLogSetLevel(int32_t level);
+
+/*
+ * Async logging: the caller only records the format pointer and the raw arguments (strings are copied),
+ * a log thread does the formatting and the output. Logs are printed in the order they were queued.
+ * Stop drains everything queued before it returns.
+ */
+int32_t SoftBusLogAsyncStart(void);
+void SoftBusLogAsyncStop(void);
 
 #define UUID_ANONYMIZED_LENGTH 4
 #define NETWORKID_ANONYMIZED_LENGTH 4
@@ -40,6 +40,22 @@ typedef struct {
 /* When the received package is an ACK packet, this function does not need to be called for verification. */
 bool IsPassSeqCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq);
 
+/* window size in bits, a power of 2 */
+#define SEQ_WINDOW_SIZE_MIN 128
+#define SEQ_WINDOW_SIZE_MAX 4096
+#define SEQ_WINDOW_SIZE_DEFAULT 1024
+
+/* Sliding anti-replay window for senders with many packets in flight, kept as a ring of 64 bit words
+   like IPsec ESN windows (RFC 6479), so check and update cost O(1) whatever the window size.
+   Any seq ahead of the highest one received passes and slides the window; seqs behind it pass once,
+   as long as they are less than (windowSize - 64) behind. Nothing older than firstSeq passes.
+*/
+typedef struct SeqWindowInfo SeqWindowInfo;
+
+SeqWindowInfo *CreateSeqWindowInfo(uint32_t windowSize, int32_t firstSeq);
+void DestroySeqWindowInfo(SeqWindowInfo *windowInfo);
+bool IsPassSeqWindowCheck(SeqWindowInfo *windowInfo, int32_t recvSeq);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -46,6 +46,7 @@ typedef enum {
     SOFTBUS_UDP_CHANNEL_TIMER_FUN,
     SOFTBUS_TIME_SYNC_TIMER_FUN,
     SOFTBUS_PROXY_SENDFILE_TIMER_FUN,
+    SOFTBUS_PENDING_PKT_TIMER_FUN,
     SOFTBUS_MAX_TIMER_FUN_NUM
 } SoftBusTimerFunEnum;
 
@@ -16,9 +16,17 @@
 #include "softbus_log.h"
 
 #include <securec.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
-#include "softbus_feature_config.h"
+#include "softbus_adapter_atomic.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_adapter_thread.h"
+#include "softbus_adapter_timer.h"
+#include "softbus_errcode.h"
+#include "softbus_queue.h"
 
 #define LOG_NAME_MAX_LEN 5
 #define LOG_PRINT_MAX_LEN 256
@@ -26,7 +34,16 @@
 // anonymize should mask more than half of the string
 #define EXPECTED_ANONYMIZED_TIMES 2
 
-static int32_t g_logLevel;
+#define LOG_ASYNC_RECORD_NUM 128
+#define LOG_ASYNC_QUEUE_SIZE 256
+#define LOG_ASYNC_ARG_MAX 16
+#define LOG_ASYNC_STR_BUF_LEN LOG_PRINT_MAX_LEN
+#define LOG_ASYNC_SPEC_MAX_LEN 16
+#define LOG_ASYNC_IDLE_WAIT_SEC 1
+#define LOG_ASYNC_STOP_WAIT_MS 1
+#define USECTONSEC 1000LL
+
+int32_t g_softbusLogLevel = SOFTBUS_LOG_DBG;
 
 typedef struct {
     SoftBusLogModule mod;
@@ -42,40 +59,426 @@ static LogInfo g_logInfo[SOFTBUS_LOG_MODULE_MAX] = {
     {SOFTBUS_LOG_COMM, "COMM"},
 };
 
-void SoftBusLog(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, ...)
+typedef enum {
+    LOG_ARG_NONE,
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR,
+} LogArgType;
+
+#define LOG_ARG_NULL_STR 0xFFFFFFFFU
+
+typedef struct {
+    LogArgType type;
+    union {
+        int i;
+        long l;
+        long long ll;
+        size_t z;
+        double d;
+        const void *p;
+        uint32_t strOffset;
+    } val;
+} LogArg;
+
+typedef struct {
+    SoftBusLogModule module;
+    SoftBusLogLevel level;
+    const char *fmt;
+    uint32_t argNum;
+    uint32_t strLen;
+    LogArg args[LOG_ASYNC_ARG_MAX];
+    char strBuf[LOG_ASYNC_STR_BUF_LEN];
+} LogRecord;
+
+typedef struct {
+    volatile uint32_t running;
+    volatile uint32_t inFlight;
+    volatile uint32_t idle;
+    bool stop;
+    SoftBusMutex lock;
+    SoftBusCond cond;
+    SoftBusThread tid;
+    LogRecord *records;
+    LockFreeQueue *freeQueue;
+    LockFreeQueue *pendingQueue;
+} LogAsyncCtx;
+
+static LogAsyncCtx g_logAsync = {0};
+
+void SoftBusLogSetLevel(int32_t level)
+{
+    g_softbusLogLevel = level;
+}
+
+static void SoftBusLogSync(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, va_list arg)
 {
     uint32_t ulPos;
-    char szStr[LOG_PRINT_MAX_LEN] = {0};
-    va_list arg;
+    char szStr[LOG_PRINT_MAX_LEN];
     int32_t ret;
 
-    if (module >= SOFTBUS_LOG_MODULE_MAX || level >= SOFTBUS_LOG_LEVEL_MAX) {
-        HILOG_ERROR(SOFTBUS_HILOG_ID, "[COMM]softbus log type or module error");
-        return;
-    }
-
-    SoftbusGetConfig(SOFTBUS_INT_ADAPTER_LOG_LEVEL, (unsigned char *)&g_logLevel, sizeof(g_logLevel));
-    if ((int32_t)level < g_logLevel) {
-        return;
-    }
-
     ret = sprintf_s(szStr, sizeof(szStr), "[%s]", g_logInfo[module].name);
     if (ret < 0) {
         HILOG_ERROR(SOFTBUS_HILOG_ID, "[COMM]softbus log error");
         return;
     }
     ulPos = strlen(szStr);
-    (void)memset_s(&arg, sizeof(va_list), 0, sizeof(va_list));
-    va_start(arg, fmt);
     ret = vsprintf_s(&szStr[ulPos], sizeof(szStr) - ulPos, fmt, arg);
-    va_end(arg);
     if (ret < 0) {
         HILOG_WARN(SOFTBUS_HILOG_ID, "[COMM]softbus log len error");
         return;
     }
     SoftBusOutPrint(szStr, level);
+}
+
+/* returns the end of the conversion starting at the '%', or NULL for one the async path does not take */
+static const char *ParseLogSpec(const char *spec, LogArgType *type)
+{
+    const char *p = spec + 1;
+    LogArgType intType = LOG_ARG_INT;
+
+    if (*p == '%') {
+        *type = LOG_ARG_NONE;
+        return p + 1;
+    }
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    while ((*p >= '0' && *p <= '9') || *p == '.') {
+        p++;
+    }
+    if (*p == 'h') {
+        p += (*(p + 1) == 'h') ? 2 : 1;
+    } else if (*p == 'l') {
+        intType = (*(p + 1) == 'l') ? LOG_ARG_LLONG : LOG_ARG_LONG;
+        p += (*(p + 1) == 'l') ? 2 : 1;
+    } else if (*p == 'z') {
+        intType = LOG_ARG_SIZE;
+        p++;
+    }
+    switch (*p) {
+        case 'c':
+            if (intType != LOG_ARG_INT) {
+                return NULL;
+            }
+            *type = intType;
+            break;
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            *type = intType;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            *type = LOG_ARG_DOUBLE;
+            break;
+        case 'p':
+            *type = LOG_ARG_PTR;
+            break;
+        case 's':
+            *type = LOG_ARG_STR;
+            break;
+        default:
+            return NULL;
+    }
+    if (p + 1 - spec >= LOG_ASYNC_SPEC_MAX_LEN) {
+        return NULL;
+    }
+    return p + 1;
+}
+
+static bool CaptureLogStr(LogRecord *record, LogArg *logArg, const char *str)
+{
+    if (str == NULL) {
+        logArg->val.strOffset = LOG_ARG_NULL_STR;
+        return true;
+    }
+    uint32_t len = strnlen(str, LOG_ASYNC_STR_BUF_LEN);
+    if (record->strLen + len >= LOG_ASYNC_STR_BUF_LEN) {
+        return false;
+    }
+    if (memcpy_s(record->strBuf + record->strLen, LOG_ASYNC_STR_BUF_LEN - record->strLen, str, len) != EOK) {
+        return false;
+    }
+    logArg->val.strOffset = record->strLen;
+    record->strLen += len;
+    record->strBuf[record->strLen++] = '\0';
+    return true;
+}
+
+static bool CaptureLogArgs(LogRecord *record, const char *fmt, va_list arg)
+{
+    const char *p = fmt;
+    LogArgType type;
+
+    record->argNum = 0;
+    record->strLen = 0;
+    while ((p = strchr(p, '%')) != NULL) {
+        p = ParseLogSpec(p, &type);
+        if (p == NULL) {
+            return false;
+        }
+        if (type == LOG_ARG_NONE) {
+            continue;
+        }
+        if (record->argNum >= LOG_ASYNC_ARG_MAX) {
+            return false;
+        }
+        LogArg *logArg = &record->args[record->argNum++];
+        logArg->type = type;
+        switch (type) {
+            case LOG_ARG_INT:
+                logArg->val.i = va_arg(arg, int);
+                break;
+            case LOG_ARG_LONG:
+                logArg->val.l = va_arg(arg, long);
+                break;
+            case LOG_ARG_LLONG:
+                logArg->val.ll = va_arg(arg, long long);
+                break;
+            case LOG_ARG_SIZE:
+                logArg->val.z = va_arg(arg, size_t);
+                break;
+            case LOG_ARG_DOUBLE:
+                logArg->val.d = va_arg(arg, double);
+                break;
+            case LOG_ARG_PTR:
+                logArg->val.p = va_arg(arg, const void *);
+                break;
+            default:
+                if (!CaptureLogStr(record, logArg, va_arg(arg, const char *))) {
+                    return false;
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+static int32_t FormatLogArg(char *buf, uint32_t len, const char *spec, const LogRecord *record, const LogArg *logArg)
+{
+    switch (logArg->type) {
+        case LOG_ARG_INT:
+            return sprintf_s(buf, len, spec, logArg->val.i);
+        case LOG_ARG_LONG:
+            return sprintf_s(buf, len, spec, logArg->val.l);
+        case LOG_ARG_LLONG:
+            return sprintf_s(buf, len, spec, logArg->val.ll);
+        case LOG_ARG_SIZE:
+            return sprintf_s(buf, len, spec, logArg->val.z);
+        case LOG_ARG_DOUBLE:
+            return sprintf_s(buf, len, spec, logArg->val.d);
+        case LOG_ARG_PTR:
+            return sprintf_s(buf, len, spec, logArg->val.p);
+        default:
+            return sprintf_s(buf, len, spec, (logArg->val.strOffset == LOG_ARG_NULL_STR) ?
+                NULL : record->strBuf + logArg->val.strOffset);
+    }
+}
+
+/* replays the format one conversion at a time with the recorded arguments */
+static void FormatLogRecord(const LogRecord *record, char *buf, uint32_t len)
+{
+    char spec[LOG_ASYNC_SPEC_MAX_LEN];
+    const char *p = record->fmt;
+    uint32_t argIdx = 0;
+    LogArgType type;
+    int32_t ret = sprintf_s(buf, len, "[%s]", g_logInfo[record->module].name);
+    uint32_t pos = (ret < 0) ? 0 : (uint32_t)ret;
+
+    while (*p != '\0' && pos + 1 < len) {
+        if (*p != '%') {
+            buf[pos++] = *p++;
+            continue;
+        }
+        const char *end = ParseLogSpec(p, &type);
+        if (end == NULL) {
+            break;
+        }
+        if (type == LOG_ARG_NONE) {
+            buf[pos++] = '%';
+            p = end;
+            continue;
+        }
+        if (memcpy_s(spec, sizeof(spec), p, end - p) != EOK) {
+            break;
+        }
+        spec[end - p] = '\0';
+        ret = FormatLogArg(buf + pos, len - pos, spec, record, &record->args[argIdx++]);
+        if (ret < 0) {
+            break;
+        }
+        pos += (uint32_t)ret;
+        p = end;
+    }
+    buf[pos] = '\0';
+}
+
+static void *LogAsyncTask(void *arg)
+{
+    (void)arg;
+    char buf[LOG_PRINT_MAX_LEN];
+    void *node = NULL;
+    SoftBusSysTime now;
+    SoftBusSysTime outtime;
+
+    while (true) {
+        while (QueueSingleConsumerDequeue(g_logAsync.pendingQueue, &node) == 0) {
+            LogRecord *record = (LogRecord *)node;
+            FormatLogRecord(record, buf, sizeof(buf));
+            SoftBusOutPrint(buf, record->level);
+            (void)QueueMultiProducerEnqueue(g_logAsync.freeQueue, record);
+        }
+        (void)SoftBusMutexLock(&g_logAsync.lock);
+        if (g_logAsync.stop) {
+            (void)SoftBusMutexUnlock(&g_logAsync.lock);
+            if (QueueIsEmpty(g_logAsync.pendingQueue) == 0) {
+                break;
+            }
+            continue;
+        }
+        /* the swap is a full barrier, a producer that queued before it is seen by the check below */
+        (void)SoftBusAtomicCmpAndSwap32(&g_logAsync.idle, 0, 1);
+        if (QueueIsEmpty(g_logAsync.pendingQueue) == 0) {
+            SoftBusGetTime(&now);
+            outtime.sec = now.sec + LOG_ASYNC_IDLE_WAIT_SEC;
+            outtime.usec = now.usec * USECTONSEC;
+            (void)SoftBusCondWait(&g_logAsync.cond, &g_logAsync.lock, &outtime);
+        }
+        g_logAsync.idle = 0;
+        (void)SoftBusMutexUnlock(&g_logAsync.lock);
+    }
+    return NULL;
+}
+
+static bool SoftBusLogAsync(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, va_list arg)
+{
+    void *node = NULL;
+    bool queued = false;
+
+    SoftBusAtomicAdd32(&g_logAsync.inFlight, 1);
+    if (g_logAsync.running == 0 || QueueMultiConsumerDequeue(g_logAsync.freeQueue, &node) != 0) {
+        SoftBusAtomicAdd32(&g_logAsync.inFlight, -1);
+        return false;
+    }
+    LogRecord *record = (LogRecord *)node;
+    record->module = module;
+    record->level = level;
+    record->fmt = fmt;
+    if (CaptureLogArgs(record, fmt, arg)) {
+        queued = (QueueMultiProducerEnqueue(g_logAsync.pendingQueue, record) == 0);
+    }
+    if (!queued) {
+        (void)QueueMultiProducerEnqueue(g_logAsync.freeQueue, record);
+    }
+    SoftBusAtomicAdd32(&g_logAsync.inFlight, -1);
+    /* only the caller that takes the idle flag wakes the log thread */
+    if (queued && g_logAsync.idle != 0 && SoftBusAtomicCmpAndSwap32(&g_logAsync.idle, 1, 0)) {
+        (void)SoftBusMutexLock(&g_logAsync.lock);
+        (void)SoftBusCondSignal(&g_logAsync.cond);
+        (void)SoftBusMutexUnlock(&g_logAsync.lock);
+    }
+    return queued;
+}
+
+void SoftBusLogImpl(SoftBusLogModule module, SoftBusLogLevel level, const char *fmt, ...)
+{
+    va_list arg;
+
+    if (module >= SOFTBUS_LOG_MODULE_MAX || level >= SOFTBUS_LOG_LEVEL_MAX) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "[COMM]softbus log type or module error");
+        return;
+    }
 
-    return;
+    (void)memset_s(&arg, sizeof(va_list), 0, sizeof(va_list));
+    if (g_logAsync.running != 0) {
+        va_start(arg, fmt);
+        bool queued = SoftBusLogAsync(module, level, fmt, arg);
+        va_end(arg);
+        if (queued) {
+            return;
+        }
+    }
+    /* not started, out of records, or a format the async path does not take */
+    va_start(arg, fmt);
+    SoftBusLogSync(module, level, fmt, arg);
+    va_end(arg);
+}
+
+static void LogAsyncFreeCtx(void)
+{
+    SoftBusFree(g_logAsync.records);
+    SoftBusFree(g_logAsync.freeQueue);
+    SoftBusFree(g_logAsync.pendingQueue);
+    (void)SoftBusCondDestroy(&g_logAsync.cond);
+    (void)SoftBusMutexDestroy(&g_logAsync.lock);
+    g_logAsync.records = NULL;
+    g_logAsync.freeQueue = NULL;
+    g_logAsync.pendingQueue = NULL;
+}
+
+int32_t SoftBusLogAsyncStart(void)
+{
+    if (g_logAsync.running != 0) {
+        return SOFTBUS_OK;
+    }
+    g_logAsync.stop = false;
+    g_logAsync.idle = 0;
+    if (SoftBusMutexInit(&g_logAsync.lock, NULL) != SOFTBUS_OK) {
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (SoftBusCondInit(&g_logAsync.cond) != SOFTBUS_OK) {
+        (void)SoftBusMutexDestroy(&g_logAsync.lock);
+        return SOFTBUS_ERR;
+    }
+    g_logAsync.records = (LogRecord *)SoftBusCalloc(sizeof(LogRecord) * LOG_ASYNC_RECORD_NUM);
+    g_logAsync.freeQueue = CreateQueue(LOG_ASYNC_QUEUE_SIZE);
+    g_logAsync.pendingQueue = CreateQueue(LOG_ASYNC_QUEUE_SIZE);
+    if (g_logAsync.records == NULL || g_logAsync.freeQueue == NULL || g_logAsync.pendingQueue == NULL) {
+        LogAsyncFreeCtx();
+        return SOFTBUS_MALLOC_ERR;
+    }
+    for (uint32_t i = 0; i < LOG_ASYNC_RECORD_NUM; i++) {
+        (void)QueueSingleProducerEnqueue(g_logAsync.freeQueue, &g_logAsync.records[i]);
+    }
+
+    SoftBusThreadAttr threadAttr;
+    SoftBusThreadAttrInit(&threadAttr);
+    threadAttr.taskName = "SoftBusLog";
+    if (SoftBusThreadCreate(&g_logAsync.tid, &threadAttr, LogAsyncTask, NULL) != SOFTBUS_OK) {
+        LogAsyncFreeCtx();
+        return SOFTBUS_ERR;
+    }
+    (void)SoftBusAtomicCmpAndSwap32(&g_logAsync.running, 0, 1);
+    return SOFTBUS_OK;
+}
+
+void SoftBusLogAsyncStop(void)
+{
+    if (!SoftBusAtomicCmpAndSwap32(&g_logAsync.running, 1, 0)) {
+        return;
+    }
+    /* a caller that saw running before the swap may still be filling a record */
+    while (g_logAsync.inFlight != 0) {
+        SoftBusSleepMs(LOG_ASYNC_STOP_WAIT_MS);
+    }
+    (void)SoftBusMutexLock(&g_logAsync.lock);
+    g_logAsync.stop = true;
+    (void)SoftBusCondSignal(&g_logAsync.cond);
+    (void)SoftBusMutexUnlock(&g_logAsync.lock);
+    (void)SoftBusThreadJoin(g_logAsync.tid, NULL);
+    LogAsyncFreeCtx();
 }
 
 const char *Anonymizes(const char *target, const uint8_t expectAnonymizedLength)
@@ -15,31 +15,83 @@
 
 #include "message_handler.h"
 
+#include <sched.h>
+#include <stdarg.h>
 #include <sys/time.h>
 #include <sys/types.h>
 
 #include "common_list.h"
 #include "securec.h"
+#include "softbus_adapter_atomic.h"
 #include "softbus_adapter_mem.h"
 #include "softbus_adapter_thread.h"
 #include "softbus_def.h"
+#include "softbus_errcode.h"
 #include "softbus_log.h"
+#include "softbus_queue.h"
 #include "softbus_type_def.h"
 #include "unistd.h"
 
 #define LOOP_NAME_LEN 16
 #define TIME_THOUSANDS_MULTIPLIER 1000LL
+#define MSG_HEAP_INIT_CAPACITY 16
+#define HANDLER_BUCKET_NUM 64
+#define HANDLER_HASH_SHIFT 4
+#define LOOPER_INBOX_SIZE 1024
+#define LOOPER_SPIN_BEFORE_PARK 16
+#define LOOPER_HANDLER_STAT_NUM 64
+#define LOOPER_HIST_BASE_US 100
+#define LOOPER_HIST_STEP 10
+#define LOOPER_DUMP_LINE_LEN 256
 
 static int8_t g_isNeedDestroy = 0;
 static int8_t g_isThreadStarted = 0;
+enum {
+    LOOPER_LIST_LOCK_NONE = 0,
+    LOOPER_LIST_LOCK_INITING,
+    LOOPER_LIST_LOCK_READY,
+};
+
+static SoftBusMutex g_looperListLock = 0;
+static volatile uint32_t g_looperListLockState = LOOPER_LIST_LOCK_NONE;
+static LIST_HEAD(g_looperList);
 
 typedef struct {
-    SoftBusMessage *msg;
-    ListNode node;
-} SoftBusMessageNode;
+    bool used;
+    const char *key; // handler name pointer, only compared, the name itself is copied into stat
+    SoftBusLooperHandlerStats stat;
+} LooperHandlerStatEntry;
 
+typedef struct {
+    const char *name;
+    int32_t what;
+    bool isDelayed;
+    int64_t waitUs;
+    int64_t execUs;
+} LooperDispatchRecord;
+
+/*
+ * Pending messages live in a binary min-heap ordered by (time, seq), seq keeps posts with the
+ * same time in FIFO order. Every queued message is also linked into a bucket picked by its
+ * handler, so removing the messages of one handler never walks the whole queue.
+ *
+ * Immediate messages skip the lock: producers push them to the lock free inbox and only take
+ * the lock to wake the loop when it is parked (waiting == 1). Whoever holds the lock drains the
+ * inbox into the heap first, so the inbox has a single consumer and post order is kept.
+ *
+ * stats and handlerStats are guarded by lock like the queue. The loop records a dispatch in the
+ * critical section it enters for the next message, so instrumentation adds no locking.
+ */
 struct SoftBusLooperContext {
-    ListNode msgHead;
+    ListNode node;
+    SoftBusLooperStats stats;
+    LooperHandlerStatEntry handlerStats[LOOPER_HANDLER_STAT_NUM];
+    LockFreeQueue *inbox;
+    volatile uint32_t waiting;
+    SoftBusMessage **msgHeap;
+    unsigned int heapCapacity;
+    uint64_t postSeq;
+    ListNode handlerBucket[HANDLER_BUCKET_NUM];
     char name[LOOP_NAME_LEN];
     volatile unsigned char stop; // destroys looper, stop =1, and running =0
     volatile unsigned char running;
@@ -70,6 +122,211 @@ static void FreeSoftBusMsg(SoftBusMessage *msg)
     }
 }
 
+static inline ListNode *GetHandlerBucket(SoftBusLooperContext *context, const SoftBusHandler *handler)
+{
+    uintptr_t key = (uintptr_t)handler >> HANDLER_HASH_SHIFT;
+    return &context->handlerBucket[(key ^ (key >> HANDLER_HASH_SHIFT)) % HANDLER_BUCKET_NUM];
+}
+
+static inline bool IsMsgEarlier(const SoftBusMessage *a, const SoftBusMessage *b)
+{
+    return (a->time < b->time) || (a->time == b->time && a->seq < b->seq);
+}
+
+static inline void HeapSet(SoftBusLooperContext *context, unsigned int index, SoftBusMessage *msg)
+{
+    context->msgHeap[index] = msg;
+    msg->heapIndex = index;
+}
+
+static void HeapSiftUp(SoftBusLooperContext *context, unsigned int index)
+{
+    SoftBusMessage *msg = context->msgHeap[index];
+    while (index > 0) {
+        unsigned int parent = (index - 1) / 2;
+        if (!IsMsgEarlier(msg, context->msgHeap[parent])) {
+            break;
+        }
+        HeapSet(context, index, context->msgHeap[parent]);
+        index = parent;
+    }
+    HeapSet(context, index, msg);
+}
+
+static void HeapSiftDown(SoftBusLooperContext *context, unsigned int index)
+{
+    SoftBusMessage *msg = context->msgHeap[index];
+    unsigned int size = context->msgSize;
+    for (;;) {
+        unsigned int child = index * 2 + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && IsMsgEarlier(context->msgHeap[child + 1], context->msgHeap[child])) {
+            child++;
+        }
+        if (!IsMsgEarlier(context->msgHeap[child], msg)) {
+            break;
+        }
+        HeapSet(context, index, context->msgHeap[child]);
+        index = child;
+    }
+    HeapSet(context, index, msg);
+}
+
+static int32_t HeapReserveLocked(SoftBusLooperContext *context)
+{
+    if (context->msgSize < context->heapCapacity) {
+        return SOFTBUS_OK;
+    }
+    unsigned int newCapacity = (context->heapCapacity == 0) ? MSG_HEAP_INIT_CAPACITY : context->heapCapacity * 2;
+    SoftBusMessage **newHeap = (SoftBusMessage **)SoftBusMalloc(newCapacity * sizeof(SoftBusMessage *));
+    if (newHeap == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    if (context->msgHeap != NULL) {
+        if (memcpy_s(newHeap, newCapacity * sizeof(SoftBusMessage *), context->msgHeap,
+            context->msgSize * sizeof(SoftBusMessage *)) != EOK) {
+            SoftBusFree(newHeap);
+            return SOFTBUS_MEM_ERR;
+        }
+        SoftBusFree(context->msgHeap);
+    }
+    context->msgHeap = newHeap;
+    context->heapCapacity = newCapacity;
+    return SOFTBUS_OK;
+}
+
+static void EnqueueMsgLocked(SoftBusLooperContext *context, SoftBusMessage *msg)
+{
+    msg->seq = context->postSeq++;
+    ListTailInsert(GetHandlerBucket(context, msg->handler), &msg->handlerNode);
+    context->msgHeap[context->msgSize] = msg;
+    context->msgSize++;
+    if (context->msgSize > context->stats.maxQueueDepth) {
+        context->stats.maxQueueDepth = context->msgSize;
+    }
+    HeapSiftUp(context, context->msgSize - 1);
+}
+
+static uint32_t GetHistBucket(int64_t us)
+{
+    uint32_t bucket = 0;
+    for (int64_t bound = LOOPER_HIST_BASE_US; us >= bound && bucket < LOOPER_HIST_BUCKET_NUM - 1;
+        bound *= LOOPER_HIST_STEP) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static LooperHandlerStatEntry *GetHandlerStatEntryLocked(SoftBusLooperContext *context, const char *key, int32_t what)
+{
+    uint32_t start = (uint32_t)((((uintptr_t)key) >> HANDLER_HASH_SHIFT) ^ ((uint32_t)what * 31U));
+    for (uint32_t i = 0; i < LOOPER_HANDLER_STAT_NUM; i++) {
+        LooperHandlerStatEntry *entry = &context->handlerStats[(start + i) % LOOPER_HANDLER_STAT_NUM];
+        if (entry->used && entry->key == key && entry->stat.what == what) {
+            return entry;
+        }
+        if (!entry->used) {
+            entry->used = true;
+            entry->key = key;
+            entry->stat.what = what;
+            if (key != NULL) {
+                (void)strncpy_s(entry->stat.handlerName, sizeof(entry->stat.handlerName), key,
+                    sizeof(entry->stat.handlerName) - 1);
+            }
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void RecordDispatchLocked(SoftBusLooperContext *context, const LooperDispatchRecord *record)
+{
+    SoftBusLooperStats *stats = &context->stats;
+    stats->dispatchCnt++;
+    if (record->isDelayed) {
+        stats->timerDriftHist[GetHistBucket(record->waitUs)]++;
+        if (record->waitUs > stats->maxTimerDriftUs) {
+            stats->maxTimerDriftUs = record->waitUs;
+        }
+    } else {
+        stats->queueWaitHist[GetHistBucket(record->waitUs)]++;
+        if (record->waitUs > stats->maxQueueWaitUs) {
+            stats->maxQueueWaitUs = record->waitUs;
+        }
+    }
+    stats->execHist[GetHistBucket(record->execUs)]++;
+    if (record->execUs > stats->maxExecUs) {
+        stats->maxExecUs = record->execUs;
+    }
+    LooperHandlerStatEntry *entry = GetHandlerStatEntryLocked(context, record->name, record->what);
+    if (entry == NULL) {
+        stats->untrackedCnt++;
+        return;
+    }
+    entry->stat.dispatchCnt++;
+    entry->stat.totalExecUs += record->execUs;
+    if (record->execUs > entry->stat.maxExecUs) {
+        entry->stat.maxExecUs = record->execUs;
+    }
+}
+
+static void DrainInboxLocked(SoftBusLooperContext *context)
+{
+    if (context->inbox == NULL) {
+        return;
+    }
+    void *node = NULL;
+    while (QueueIsEmpty(context->inbox) != 0 && HeapReserveLocked(context) == SOFTBUS_OK &&
+        QueueSingleConsumerDequeue(context->inbox, &node) == 0) {
+        EnqueueMsgLocked(context, (SoftBusMessage *)node);
+    }
+}
+
+/* Park the loop until a post, a removal or the deadline, unless an immediate message slipped in. */
+static void WaitMsgLocked(SoftBusLooperContext *context, SoftBusSysTime *deadline)
+{
+    if (context->inbox != NULL) {
+        // a burst usually keeps coming, give producers a few slices before paying for a park and a wakeup
+        uint64_t postSeq = context->postSeq;
+        unsigned int msgSize = context->msgSize;
+        (void)SoftBusMutexUnlock(&context->lock);
+        for (int32_t i = 0; i < LOOPER_SPIN_BEFORE_PARK && QueueIsEmpty(context->inbox) == 0; i++) {
+            sched_yield();
+        }
+        (void)SoftBusMutexLock(&context->lock);
+        // the queue may have changed while unlocked and its broadcast is lost, recheck instead of parking
+        if (QueueIsEmpty(context->inbox) != 0 || context->stop == 1 || postSeq != context->postSeq ||
+            msgSize != context->msgSize) {
+            return;
+        }
+    }
+    (void)SoftBusAtomicCmpAndSwap32(&context->waiting, 0, 1);
+    if (context->inbox != NULL && QueueIsEmpty(context->inbox) != 0) {
+        context->waiting = 0;
+        return;
+    }
+    SoftBusCondWait(&context->cond, &context->lock, deadline);
+    context->waiting = 0;
+}
+
+static void DequeueMsgLocked(SoftBusLooperContext *context, SoftBusMessage *msg)
+{
+    unsigned int index = msg->heapIndex;
+    ListDelete(&msg->handlerNode);
+    context->msgSize--;
+    if (index == context->msgSize) {
+        return;
+    }
+    HeapSet(context, index, context->msgHeap[context->msgSize]);
+    if (index > 0 && IsMsgEarlier(context->msgHeap[index], context->msgHeap[(index - 1) / 2])) {
+        HeapSiftUp(context, index);
+    } else {
+        HeapSiftDown(context, index);
+    }
+}
+
 SoftBusMessage *MallocMessage(void)
 {
     SoftBusMessage *msg = (SoftBusMessage *)SoftBusMalloc(sizeof(SoftBusMessage));
@@ -107,11 +364,21 @@ static void *LoopTask(void *arg)
     g_isThreadStarted = 1;
     (void)SoftBusMutexUnlock(&context->lock);
 
+    SoftBusMessage *msg = NULL;
+    LooperDispatchRecord record;
     for (;;) {
+        if (msg != NULL) {
+            FreeSoftBusMsg(msg);
+        }
         if (SoftBusMutexLock(&context->lock) != 0) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
             return NULL;
         }
+        if (msg != NULL) {
+            RecordDispatchLocked(context, &record);
+            msg = NULL;
+        }
+        context->currentMsg = NULL;
         // wait
         if (context->stop == 1) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s], stop ==1", context->name);
@@ -124,23 +391,19 @@ static void *LoopTask(void *arg)
             break;
         }
 
-        if (IsListEmpty(&context->msgHead)) {
+        DrainInboxLocked(context);
+        if (context->msgSize == 0) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s] wait msg list empty", context->name);
-            SoftBusCondWait(&context->cond, &context->lock, NULL);
+            WaitMsgLocked(context, NULL);
             (void)SoftBusMutexUnlock(&context->lock);
             continue;
         }
 
         int64_t now = UptimeMicros();
-        ListNode *item = context->msgHead.next;
-        SoftBusMessage *msg = NULL;
-        SoftBusMessageNode *itemNode = CONTAINER_OF(item, SoftBusMessageNode, node);
-        int64_t time = itemNode->msg->time;
+        int64_t time = context->msgHeap[0]->time;
         if (now >= time) {
-            msg = itemNode->msg;
-            ListDelete(item);
-            SoftBusFree(itemNode);
-            context->msgSize--;
+            msg = context->msgHeap[0];
+            DequeueMsgLocked(context, msg);
             if (looper->dumpable) {
                 SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG, "LoopTask[%s], get message. handle=%s,what=%d,msgSize=%u",
                     context->name, msg->handler->name, msg->what, context->msgSize);
@@ -149,7 +412,7 @@ static void *LoopTask(void *arg)
             SoftBusSysTime tv;
             tv.sec = time / TIME_THOUSANDS_MULTIPLIER / TIME_THOUSANDS_MULTIPLIER;
             tv.usec = time % (TIME_THOUSANDS_MULTIPLIER * TIME_THOUSANDS_MULTIPLIER) * TIME_THOUSANDS_MULTIPLIER;
-            SoftBusCondWait(&context->cond, &context->lock, &tv);
+            WaitMsgLocked(context, &tv);
         }
 
         if (msg == NULL) {
@@ -163,18 +426,19 @@ static void *LoopTask(void *arg)
                 context->name, msg->handler->name, msg->what);
         }
 
+        record.name = msg->handler->name;
+        record.what = msg->what;
+        record.isDelayed = msg->time > msg->postTime;
+        record.waitUs = now - (record.isDelayed ? msg->time : msg->postTime);
         if (msg->handler->HandleMessage != NULL) {
             msg->handler->HandleMessage(msg);
         }
+        record.execUs = UptimeMicros() - now;
         if (looper->dumpable) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO,
                 "LoopTask[%s], after HandleMessage message. handle=%s,what=%d",
                 context->name, msg->handler->name, msg->what);
         }
-        (void)SoftBusMutexLock(&context->lock);
-        FreeSoftBusMsg(msg);
-        context->currentMsg = NULL;
-        (void)SoftBusMutexUnlock(&context->lock);
     }
     (void)SoftBusMutexLock(&context->lock);
     context->running = 0;
@@ -218,15 +482,12 @@ static int StartNewLooperThread(SoftBusLooper *looper)
 
 static void DumpLooperLocked(const SoftBusLooperContext *context)
 {
-    int i = 0;
-    ListNode *item = NULL;
-    LIST_FOR_EACH(item, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
+    // heap order, only msgHeap[0] is guaranteed to be the next one to run
+    for (unsigned int i = 0; i < context->msgSize; i++) {
+        SoftBusMessage *msg = context->msgHeap[i];
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG,
-            "DumpLooper. i=%d,handler=%s,what =%d,arg1=%llu arg2=%llu, time=%lld",
+            "DumpLooper. i=%u,handler=%s,what =%d,arg1=%llu arg2=%llu, time=%lld",
             i, msg->handler->name, msg->what, msg->arg1, msg->arg2, msg->time);
-        i++;
     }
 }
 
@@ -258,44 +519,27 @@ static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPo
             looper->context->name);
         return;
     }
-    SoftBusMessageNode *newNode = (SoftBusMessageNode *)SoftBusMalloc(sizeof(SoftBusMessageNode));
-    if (newNode == NULL) {
-        FreeSoftBusMsg(msgPost);
-        return;
-    }
-    ListInit(&newNode->node);
-    newNode->msg = msgPost;
     SoftBusLooperContext *context = looper->context;
     if (SoftBusMutexLock(&context->lock) != 0) {
-        SoftBusFree(newNode);
         FreeSoftBusMsg(msgPost);
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
         return;
     }
+    DrainInboxLocked(context);
     if (context->stop == 1) {
-        SoftBusFree(newNode);
         FreeSoftBusMsg(msgPost);
         (void)SoftBusMutexUnlock(&context->lock);
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "[%s]PostMessageAtTime. running=%d,stop=%d",
             context->name, context->running, context->stop);
         return;
     }
-    ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    bool insert = false;
-    LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
-        if (msg->time > msgPost->time) {
-            ListTailInsert(item, &(newNode->node));
-            insert = true;
-            break;
-        }
-    }
-    if (!insert) {
-        ListTailInsert(&(context->msgHead), &(newNode->node));
+    if (HeapReserveLocked(context) != SOFTBUS_OK) {
+        FreeSoftBusMsg(msgPost);
+        (void)SoftBusMutexUnlock(&context->lock);
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "[%s]PostMessageAtTime. grow queue failed", context->name);
+        return;
     }
-    context->msgSize++;
+    EnqueueMsgLocked(context, msgPost);
     if (looper->dumpable) {
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG, "[%s]PostMessageAtTime. insert", context->name);
         DumpLooperLocked(context);
@@ -307,12 +551,33 @@ static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPo
 static void LooperPostMessage(const SoftBusLooper *looper, SoftBusMessage *msg)
 {
     msg->time = UptimeMicros();
-    PostMessageAtTime(looper, msg);
+    msg->postTime = msg->time;
+    SoftBusLooperContext *context = looper->context;
+    // slow path handles a null handler, a stopping looper and a full inbox
+    if (msg->handler == NULL || context->inbox == NULL || context->stop == 1 ||
+        QueueMultiProducerEnqueue(context->inbox, msg) != 0) {
+        PostMessageAtTime(looper, msg);
+        return;
+    }
+    if (looper->dumpable) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG, "[%s]PostMessage what =%d to inbox", context->name, msg->what);
+    }
+    // only the producer that sees the loop parked pays for the lock and the wakeup
+    if (SoftBusAtomicCmpAndSwap32(&context->waiting, 1, 0)) {
+        (void)SoftBusMutexLock(&context->lock);
+        SoftBusCondBroadcast(&context->cond);
+        (void)SoftBusMutexUnlock(&context->lock);
+    }
 }
 
 static void LooperPostMessageDelay(const SoftBusLooper *looper, SoftBusMessage *msg, uint64_t delayMillis)
 {
-    msg->time = UptimeMicros() + (int64_t)delayMillis * TIME_THOUSANDS_MULTIPLIER;
+    if (delayMillis == 0) {
+        LooperPostMessage(looper, msg);
+        return;
+    }
+    msg->postTime = UptimeMicros();
+    msg->time = msg->postTime + (int64_t)delayMillis * TIME_THOUSANDS_MULTIPLIER;
     PostMessageAtTime(looper, msg);
 }
 
@@ -337,18 +602,15 @@ static void LoopRemoveMessageCustom(const SoftBusLooper *looper, const SoftBusHa
         (void)SoftBusMutexUnlock(&context->lock);
         return;
     }
-    ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
+    DrainInboxLocked(context);
+    SoftBusMessage *msg = NULL;
+    SoftBusMessage *nextMsg = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(msg, nextMsg, GetHandlerBucket(context, handler), SoftBusMessage, handlerNode) {
         if (msg->handler == handler && customFunc(msg, args) == 0) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]LooperRemoveMessage. handler=%s, what =%d",
                 context->name, handler->name, msg->what);
+            DequeueMsgLocked(context, msg);
             FreeSoftBusMsg(msg);
-            ListDelete(&itemNode->node);
-            SoftBusFree(itemNode);
-            context->msgSize--;
         }
     }
     (void)SoftBusMutexUnlock(&context->lock);
@@ -367,6 +629,180 @@ void SetLooperDumpable(SoftBusLooper *loop, bool dumpable)
     loop->dumpable = dumpable;
 }
 
+static SoftBusLooperContext *GetContextLocked(const SoftBusLooper *looper)
+{
+    if (looper == NULL || looper->context == NULL) {
+        return NULL;
+    }
+    if (SoftBusMutexLock(&looper->context->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
+        return NULL;
+    }
+    return looper->context;
+}
+
+static void CopyStatsLocked(const SoftBusLooperContext *context, SoftBusLooperStats *stats)
+{
+    *stats = context->stats;
+    stats->curQueueDepth = context->msgSize;
+}
+
+static uint32_t CopyHandlerStatsLocked(const SoftBusLooperContext *context, SoftBusLooperHandlerStats *stats,
+    uint32_t num)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < LOOPER_HANDLER_STAT_NUM && count < num; i++) {
+        if (context->handlerStats[i].used) {
+            stats[count++] = context->handlerStats[i].stat;
+        }
+    }
+    return count;
+}
+
+int32_t GetLooperStats(const SoftBusLooper *looper, SoftBusLooperStats *stats)
+{
+    if (stats == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusLooperContext *context = GetContextLocked(looper);
+    if (context == NULL) {
+        return SOFTBUS_ERR;
+    }
+    CopyStatsLocked(context, stats);
+    (void)SoftBusMutexUnlock(&context->lock);
+    return SOFTBUS_OK;
+}
+
+int32_t GetLooperHandlerStats(const SoftBusLooper *looper, SoftBusLooperHandlerStats *stats, uint32_t *num)
+{
+    if (stats == NULL || num == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusLooperContext *context = GetContextLocked(looper);
+    if (context == NULL) {
+        return SOFTBUS_ERR;
+    }
+    *num = CopyHandlerStatsLocked(context, stats, *num);
+    (void)SoftBusMutexUnlock(&context->lock);
+    return SOFTBUS_OK;
+}
+
+void ResetLooperStats(const SoftBusLooper *looper)
+{
+    SoftBusLooperContext *context = GetContextLocked(looper);
+    if (context == NULL) {
+        return;
+    }
+    (void)memset_s(&context->stats, sizeof(context->stats), 0, sizeof(context->stats));
+    (void)memset_s(context->handlerStats, sizeof(context->handlerStats), 0, sizeof(context->handlerStats));
+    (void)SoftBusMutexUnlock(&context->lock);
+}
+
+static void DumpPrint(int32_t fd, const char *fmt, ...)
+{
+    char line[LOOPER_DUMP_LINE_LEN] = {0};
+    va_list args;
+    va_start(args, fmt);
+    int32_t len = vsnprintf_s(line, sizeof(line), sizeof(line) - 1, fmt, args);
+    va_end(args);
+    if (len > 0) {
+        (void)write(fd, line, len);
+    }
+}
+
+static void DumpHist(int32_t fd, const char *title, const uint64_t *hist)
+{
+    DumpPrint(fd, "  %-6s <100us:%llu <1ms:%llu <10ms:%llu <100ms:%llu <1s:%llu >=1s:%llu\n", title,
+        hist[0], hist[1], hist[2], hist[3], hist[4], hist[5]); // 0~5: LOOPER_HIST_BUCKET_NUM buckets
+}
+
+static void DumpContextStats(int32_t fd, SoftBusLooperContext *context)
+{
+    SoftBusLooperStats stats;
+    SoftBusLooperHandlerStats handlerStats[LOOPER_HANDLER_STAT_NUM];
+    if (SoftBusMutexLock(&context->lock) != 0) {
+        return;
+    }
+    CopyStatsLocked(context, &stats);
+    uint32_t num = CopyHandlerStatsLocked(context, handlerStats, LOOPER_HANDLER_STAT_NUM);
+    (void)SoftBusMutexUnlock(&context->lock);
+
+    DumpPrint(fd, "looper[%s] depth=%u maxDepth=%u dispatch=%llu untracked=%llu\n", context->name,
+        stats.curQueueDepth, stats.maxQueueDepth, stats.dispatchCnt, stats.untrackedCnt);
+    DumpPrint(fd, "  max wait=%lldus drift=%lldus exec=%lldus\n", stats.maxQueueWaitUs, stats.maxTimerDriftUs,
+        stats.maxExecUs);
+    DumpHist(fd, "wait", stats.queueWaitHist);
+    DumpHist(fd, "drift", stats.timerDriftHist);
+    DumpHist(fd, "exec", stats.execHist);
+    for (uint32_t i = 0; i < num; i++) {
+        DumpPrint(fd, "  handler=%s what=%d count=%llu totalExec=%lldus maxExec=%lldus\n",
+            handlerStats[i].handlerName, handlerStats[i].what, handlerStats[i].dispatchCnt,
+            handlerStats[i].totalExecUs, handlerStats[i].maxExecUs);
+    }
+}
+
+/* the compare and swap is a full barrier, so the lock is seen initialised once this returns true */
+static bool IsLooperListLockReady(void)
+{
+    return SoftBusAtomicCmpAndSwap32(&g_looperListLockState, LOOPER_LIST_LOCK_READY, LOOPER_LIST_LOCK_READY);
+}
+
+/* LooperInit calls it, loopers may also be created without it, so it runs once whoever comes first */
+static bool InitLooperListLockOnce(void)
+{
+    if (SoftBusAtomicCmpAndSwap32(&g_looperListLockState, LOOPER_LIST_LOCK_NONE, LOOPER_LIST_LOCK_INITING)) {
+        if (SoftBusMutexInit(&g_looperListLock, NULL) != SOFTBUS_OK) {
+            (void)SoftBusAtomicCmpAndSwap32(&g_looperListLockState, LOOPER_LIST_LOCK_INITING, LOOPER_LIST_LOCK_NONE);
+            return false;
+        }
+        (void)SoftBusAtomicCmpAndSwap32(&g_looperListLockState, LOOPER_LIST_LOCK_INITING, LOOPER_LIST_LOCK_READY);
+        return true;
+    }
+    while (g_looperListLockState == LOOPER_LIST_LOCK_INITING) {
+        (void)sched_yield();
+    }
+    return IsLooperListLockReady();
+}
+
+void DumpLooperStats(int32_t fd)
+{
+    if (fd < 0 || !IsLooperListLockReady()) {
+        return;
+    }
+    if (SoftBusMutexLock(&g_looperListLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    SoftBusLooperContext *context = NULL;
+    LIST_FOR_EACH_ENTRY(context, &g_looperList, SoftBusLooperContext, node) {
+        DumpContextStats(fd, context);
+    }
+    (void)SoftBusMutexUnlock(&g_looperListLock);
+}
+
+static void RegisterLooperContext(SoftBusLooperContext *context)
+{
+    if (!InitLooperListLockOnce()) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "[%s]init looper list lock failed", context->name);
+        return;
+    }
+    if (SoftBusMutexLock(&g_looperListLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    ListTailInsert(&g_looperList, &context->node);
+    (void)SoftBusMutexUnlock(&g_looperListLock);
+}
+
+static void UnregisterLooperContext(SoftBusLooperContext *context)
+{
+    if (!IsLooperListLockReady() || SoftBusMutexLock(&g_looperListLock) != 0) {
+        return;
+    }
+    ListDelete(&context->node);
+    (void)SoftBusMutexUnlock(&g_looperListLock);
+}
+
 SoftBusLooper *CreateNewLooper(const char *name)
 {
     SoftBusLooper *looper = (SoftBusLooper *)SoftBusCalloc(sizeof(SoftBusLooper));
@@ -385,7 +821,14 @@ SoftBusLooper *CreateNewLooper(const char *name)
         SoftBusFree(context);
         return NULL;
     }
-    ListInit(&context->msgHead);
+    for (uint32_t i = 0; i < HANDLER_BUCKET_NUM; i++) {
+        ListInit(&context->handlerBucket[i]);
+    }
+    ListInit(&context->node);
+    context->inbox = CreateQueue(LOOPER_INBOX_SIZE);
+    if (context->inbox == NULL) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_WARN, "[%s]create inbox failed, post with lock only", context->name);
+    }
     // init context
     SoftBusMutexInit(&context->lock, NULL);
     SoftBusCondInit(&context->cond);
@@ -399,10 +842,12 @@ SoftBusLooper *CreateNewLooper(const char *name)
     looper->RemoveMessageCustom = LoopRemoveMessageCustom;
     int ret = StartNewLooperThread(looper);
     if (ret != 0) {
+        SoftBusFree(context->inbox);
         SoftBusFree(looper);
         SoftBusFree(context);
         return NULL;
     }
+    RegisterLooperContext(context);
 
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]wait looper start ok", context->name);
     return looper;
@@ -460,6 +905,7 @@ void DestroyLooper(SoftBusLooper *looper)
 
     SoftBusLooperContext *context = looper->context;
     if (context != NULL) {
+        UnregisterLooperContext(context);
         (void)SoftBusMutexLock(&context->lock);
 
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]set stop = 1", context->name);
@@ -478,15 +924,18 @@ void DestroyLooper(SoftBusLooper *looper)
             (void)SoftBusMutexUnlock(&context->lock);
         }
         // release msg
-        ListNode *item = NULL;
-        ListNode *nextItem = NULL;
-        LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-            SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-            SoftBusMessage *msg = itemNode->msg;
-            FreeSoftBusMsg(msg);
-            ListDelete(&itemNode->node);
-            SoftBusFree(itemNode);
+        void *node = NULL;
+        while (context->inbox != NULL && QueueSingleConsumerDequeue(context->inbox, &node) == 0) {
+            FreeSoftBusMsg((SoftBusMessage *)node);
         }
+        SoftBusFree(context->inbox);
+        context->inbox = NULL;
+        for (unsigned int i = 0; i < context->msgSize; i++) {
+            FreeSoftBusMsg(context->msgHeap[i]);
+        }
+        context->msgSize = 0;
+        SoftBusFree(context->msgHeap);
+        context->msgHeap = NULL;
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s] destroy", context->name);
         // destroy looper
         SoftBusCondDestroy(&context->cond);
@@ -501,6 +950,10 @@ void DestroyLooper(SoftBusLooper *looper)
 
 int LooperInit(void)
 {
+    if (!InitLooperListLockOnce()) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "init looper list lock fail.");
+        return -1;
+    }
     SoftBusLooper *looper = CreateNewLooper("Loop-default");
     if (!looper) {
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "init looper fail.");
@@ -15,6 +15,7 @@
 #include "permission_entry.h"
 
 #include <securec.h>
+#include <stdlib.h>
 
 #include "cJSON.h"
 #include "common_list.h"
@@ -75,13 +76,52 @@
 #define DBINDER_SERVICE_NAME "DBinderService"
 #define DBINDER_BUS_NAME_PREFIX "DBinder"
 
+#define PERM_CACHE_SIZE 64
+#define PERM_ORDER_NONE 0xFFFFFFFFU
+
 typedef struct {
     const char *key;
     int32_t value;
 } PeMap;
 
+typedef struct {
+    const char *sessionName;
+    uint32_t order;
+    SoftBusPermissionEntry *pe;
+} PermExactItem;
+
+typedef struct {
+    uint32_t order;
+    SoftBusPermissionEntry *pe;
+    regex_t regComp;
+    char literal[SESSION_NAME_SIZE_MAX];
+} PermRegexItem;
+
+/* built from g_permissionEntryList at load, order is the position in the list */
+typedef struct {
+    PermExactItem *exact;
+    uint32_t exactNum;
+    PermRegexItem *regex;
+    uint32_t regexNum;
+} PermIndex;
+
+typedef struct {
+    ListNode node;
+    bool used;
+    int32_t permType;
+    int32_t uid;
+    int32_t pid;
+    uint32_t actions;
+    int32_t result;
+    char sessionName[SESSION_NAME_SIZE_MAX];
+    char pkgName[PKG_NAME_SIZE_MAX];
+} PermCacheItem;
+
 static SoftBusList *g_permissionEntryList = NULL;
 static char g_permissonJson[PERMISSION_JSON_LEN];
+static PermIndex g_permIndex = {0};
+static PermCacheItem g_permCache[PERM_CACHE_SIZE];
+static ListNode g_permCacheLru = {&g_permCacheLru, &g_permCacheLru};
 
 static PeMap g_peMap[] = {
     {SYSTEM_APP_STR, SYSTEM_APP},
@@ -246,28 +286,267 @@ EXIT:
     return NULL;
 }
 
-static int32_t CompareString(const char *src, const char *dest, bool regexp)
+static int32_t CompareString(const char *src, const char *dest)
 {
     if (src == NULL || dest == NULL) {
         return SOFTBUS_PERMISSION_DENIED;
     }
-    if (regexp) {
-        regex_t regComp;
-        if (regcomp(&regComp, src, REG_EXTENDED | REG_NOSUB) != 0) {
-            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "regcomp failed");
-            return SOFTBUS_PERMISSION_DENIED;
+    if (strcmp(src, dest) == 0) {
+        return SOFTBUS_OK;
+    }
+    return SOFTBUS_PERMISSION_DENIED;
+}
+
+/* skips a bracket expression, a group or an interval starting at p, returns the char after it */
+static const char *SkipRegexBlock(const char *p)
+{
+    if (*p == '[') {
+        p++;
+        p += (*p == '^') ? 1 : 0;
+        p += (*p == ']') ? 1 : 0;
+        while (*p != '\0' && *p != ']') {
+            p++;
         }
-        if (regexec(&regComp, dest, 0, NULL, 0) == 0) {
-            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "src:%s dest:%s", src, dest);
-            return SOFTBUS_OK;
+        return (*p == '\0') ? p : p + 1;
+    }
+    char open = *p;
+    char close = (open == '(') ? ')' : '}';
+    int32_t depth = 0;
+    while (*p != '\0') {
+        if (*p == '[') {
+            p = SkipRegexBlock(p);
+            continue;
         }
-    } else {
-        if (strcmp(src, dest) == 0) {
-            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "src:%s dest:%s", src, dest);
-            return SOFTBUS_OK;
+        if (*p == open) {
+            depth++;
+        } else if (*p == close) {
+            depth--;
+        }
+        p++;
+        if (depth == 0) {
+            break;
         }
     }
-    return SOFTBUS_PERMISSION_DENIED;
+    return p;
+}
+
+/*
+ * The longest run of plain chars outside any group, every name the pattern matches contains it.
+ * Empty when the pattern has an alternation, the filter then lets every name through.
+ */
+static void GetRegexLiteral(const char *pattern, PermRegexItem *item)
+{
+    const char *meta = ".[]()*+?{}|^$\\";
+    const char *best = pattern;
+    uint32_t bestLen = 0;
+    const char *p = pattern;
+
+    item->literal[0] = '\0';
+    if (strchr(pattern, '|') != NULL) {
+        return;
+    }
+    while (*p != '\0') {
+        if (*p == '[' || *p == '(' || *p == '{') {
+            p = SkipRegexBlock(p);
+            continue;
+        }
+        if (*p == '\\') {
+            p += (*(p + 1) == '\0') ? 1 : 2;
+            continue;
+        }
+        if (strchr(meta, *p) != NULL) {
+            p++;
+            continue;
+        }
+        const char *start = p;
+        while (*p != '\0' && strchr(meta, *p) == NULL) {
+            p++;
+        }
+        uint32_t len = (uint32_t)(p - start);
+        /* a quantifier that allows zero repeats makes the char in front of it optional */
+        if (*p == '*' || *p == '?' || *p == '{') {
+            len--;
+        }
+        if (len > bestLen) {
+            best = start;
+            bestLen = len;
+        }
+    }
+    if (memcpy_s(item->literal, sizeof(item->literal) - 1, best, bestLen) != EOK) {
+        bestLen = 0;
+    }
+    item->literal[bestLen] = '\0';
+}
+
+static bool MatchRegexItem(const PermRegexItem *item, const char *sessionName)
+{
+    if (item->literal[0] != '\0' && strstr(sessionName, item->literal) == NULL) {
+        return false;
+    }
+    return regexec(&item->regComp, sessionName, 0, NULL, 0) == 0;
+}
+
+static int ComparePermExactItem(const void *a, const void *b)
+{
+    const PermExactItem *itemA = (const PermExactItem *)a;
+    const PermExactItem *itemB = (const PermExactItem *)b;
+    int ret = strcmp(itemA->sessionName, itemB->sessionName);
+    if (ret != 0) {
+        return ret;
+    }
+    return (itemA->order < itemB->order) ? -1 : 1;
+}
+
+static void ClearPermIndex(void)
+{
+    for (uint32_t i = 0; i < g_permIndex.regexNum; i++) {
+        regfree(&g_permIndex.regex[i].regComp);
+    }
+    SoftBusFree(g_permIndex.exact);
+    SoftBusFree(g_permIndex.regex);
+    (void)memset_s(&g_permIndex, sizeof(g_permIndex), 0, sizeof(g_permIndex));
+}
+
+static void ClearPermCache(void)
+{
+    ListInit(&g_permCacheLru);
+    for (uint32_t i = 0; i < PERM_CACHE_SIZE; i++) {
+        g_permCache[i].used = false;
+        ListTailInsert(&g_permCacheLru, &g_permCache[i].node);
+    }
+}
+
+static int32_t BuildPermIndexLocked(void)
+{
+    uint32_t order = 0;
+    SoftBusPermissionEntry *pe = NULL;
+
+    ClearPermIndex();
+    ClearPermCache();
+    if (g_permissionEntryList->cnt == 0) {
+        return SOFTBUS_OK;
+    }
+    g_permIndex.exact = (PermExactItem *)SoftBusCalloc(sizeof(PermExactItem) * g_permissionEntryList->cnt);
+    g_permIndex.regex = (PermRegexItem *)SoftBusCalloc(sizeof(PermRegexItem) * g_permissionEntryList->cnt);
+    if (g_permIndex.exact == NULL || g_permIndex.regex == NULL) {
+        ClearPermIndex();
+        return SOFTBUS_MALLOC_ERR;
+    }
+    LIST_FOR_EACH_ENTRY(pe, &g_permissionEntryList->list, SoftBusPermissionEntry, node) {
+        if (!pe->regexp) {
+            PermExactItem *exact = &g_permIndex.exact[g_permIndex.exactNum++];
+            exact->sessionName = pe->sessionName;
+            exact->order = order++;
+            exact->pe = pe;
+            continue;
+        }
+        PermRegexItem *regex = &g_permIndex.regex[g_permIndex.regexNum];
+        if (regcomp(&regex->regComp, pe->sessionName, REG_EXTENDED | REG_NOSUB) != 0) {
+            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "regcomp failed, %s never matches", pe->sessionName);
+            order++;
+            continue;
+        }
+        regex->order = order++;
+        regex->pe = pe;
+        GetRegexLiteral(pe->sessionName, regex);
+        g_permIndex.regexNum++;
+    }
+    qsort(g_permIndex.exact, g_permIndex.exactNum, sizeof(PermExactItem), ComparePermExactItem);
+    return SOFTBUS_OK;
+}
+
+static const PermExactItem *FindPermExactItem(const char *sessionName)
+{
+    uint32_t left = 0;
+    uint32_t right = g_permIndex.exactNum;
+
+    /* lower bound, the first of several entries with one name is the one that comes first in the list */
+    while (left < right) {
+        uint32_t mid = left + (right - left) / 2;
+        if (strcmp(g_permIndex.exact[mid].sessionName, sessionName) < 0) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    if (left < g_permIndex.exactNum && strcmp(g_permIndex.exact[left].sessionName, sessionName) == 0) {
+        return &g_permIndex.exact[left];
+    }
+    return NULL;
+}
+
+/* the entry a walk over the list in order would stop at */
+static SoftBusPermissionEntry *FindPermissionEntryLocked(const char *sessionName)
+{
+    const PermExactItem *exact = FindPermExactItem(sessionName);
+    uint32_t exactOrder = (exact != NULL) ? exact->order : PERM_ORDER_NONE;
+
+    for (uint32_t i = 0; i < g_permIndex.regexNum && g_permIndex.regex[i].order < exactOrder; i++) {
+        if (MatchRegexItem(&g_permIndex.regex[i], sessionName)) {
+            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "src:%s dest:%s",
+                g_permIndex.regex[i].pe->sessionName, sessionName);
+            return g_permIndex.regex[i].pe;
+        }
+    }
+    if (exact != NULL) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "src:%s dest:%s", exact->sessionName, sessionName);
+        return exact->pe;
+    }
+    return NULL;
+}
+
+static bool IsPermCacheItemMatch(const PermCacheItem *item, const char *sessionName,
+    const SoftBusPermissionItem *pItem)
+{
+    if (!item->used || item->uid != pItem->uid || item->pid != pItem->pid || item->actions != pItem->actions ||
+        item->permType != pItem->permType) {
+        return false;
+    }
+    if (strcmp(item->sessionName, sessionName) != 0) {
+        return false;
+    }
+    return strcmp(item->pkgName, (pItem->pkgName == NULL) ? "" : pItem->pkgName) == 0;
+}
+
+static bool GetPermCacheLocked(const char *sessionName, const SoftBusPermissionItem *pItem, int32_t *result)
+{
+    PermCacheItem *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &g_permCacheLru, PermCacheItem, node) {
+        if (!item->used) {
+            return false;
+        }
+        if (IsPermCacheItemMatch(item, sessionName, pItem)) {
+            ListDelete(&item->node);
+            ListNodeInsert(&g_permCacheLru, &item->node);
+            *result = item->result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AddPermCacheLocked(const char *sessionName, const SoftBusPermissionItem *pItem, int32_t result)
+{
+    const char *pkgName = (pItem->pkgName == NULL) ? "" : pItem->pkgName;
+    PermCacheItem *item = LIST_ENTRY(g_permCacheLru.prev, PermCacheItem, node);
+
+    if (IsListEmpty(&g_permCacheLru) || strlen(sessionName) >= sizeof(item->sessionName) ||
+        strlen(pkgName) >= sizeof(item->pkgName)) {
+        return;
+    }
+    if (strcpy_s(item->sessionName, sizeof(item->sessionName), sessionName) != EOK ||
+        strcpy_s(item->pkgName, sizeof(item->pkgName), pkgName) != EOK) {
+        item->used = false;
+        return;
+    }
+    item->permType = pItem->permType;
+    item->uid = pItem->uid;
+    item->pid = pItem->pid;
+    item->actions = pItem->actions;
+    item->result = result;
+    item->used = true;
+    ListDelete(&item->node);
+    ListNodeInsert(&g_permCacheLru, &item->node);
 }
 
 static int32_t GetPermType(const SoftBusAppInfo *appInfo, const SoftBusPermissionItem *pItem)
@@ -341,7 +620,7 @@ static int32_t CheckPermissionAppInfo(const SoftBusPermissionEntry *pe,
             continue;
         }
         if (!StrIsEmpty(appInfo->pkgName)) {
-            if ((CompareString(appInfo->pkgName, pItem->pkgName, false) != SOFTBUS_OK) &&
+            if ((CompareString(appInfo->pkgName, pItem->pkgName) != SOFTBUS_OK) &&
                 !StrIsEmpty(pItem->pkgName)) {
                 continue;
             }
@@ -392,6 +671,7 @@ int32_t LoadPermissionJson(const char *fileName)
     }
     int index;
     SoftBusPermissionEntry *pe = NULL;
+    (void)SoftBusMutexLock(&g_permissionEntryList->lock);
     for (index = 0; index < itemNum; index++) {
         cJSON *permissionEntryObeject = cJSON_GetArrayItem(jsonArray, index);
         pe = ProcessPermissionEntry(permissionEntryObeject);
@@ -400,8 +680,11 @@ int32_t LoadPermissionJson(const char *fileName)
             g_permissionEntryList->cnt++;
         }
     }
+    /* a reload changes which entry matches first, so the old verdicts go with the old index */
+    ret = BuildPermIndexLocked();
+    (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
     cJSON_Delete(jsonArray);
-    return SOFTBUS_OK;
+    return ret;
 }
 
 void ClearAppInfo(const ListNode *appInfo)
@@ -428,8 +711,11 @@ void DeinitPermissionJson(void)
         ListDelete(&item->node);
         SoftBusFree(item);
     }
+    ClearPermIndex();
+    ClearPermCache();
     SoftBusMutexUnlock(&g_permissionEntryList->lock);
     DestroySoftBusList(g_permissionEntryList);
+    g_permissionEntryList = NULL;
 }
 
 SoftBusPermissionItem *CreatePermissionItem(int32_t permType, int32_t uid, int32_t pid,
@@ -455,25 +741,30 @@ int32_t CheckPermissionEntry(const char *sessionName, const SoftBusPermissionIte
     int permType;
     SoftBusPermissionEntry *pe = NULL;
     (void)SoftBusMutexLock(&g_permissionEntryList->lock);
-    LIST_FOR_EACH_ENTRY(pe, &g_permissionEntryList->list, SoftBusPermissionEntry, node) {
-        if (CompareString(pe->sessionName, sessionName, pe->regexp) == SOFTBUS_OK) {
-            if (CheckDBinder(sessionName)) {
-                (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
-                return GRANTED_APP;
-            }
+    if (GetPermCacheLocked(sessionName, pItem, &permType)) {
+        (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
+        return permType;
+    }
+    pe = FindPermissionEntryLocked(sessionName);
+    if (pe != NULL) {
+        if (CheckDBinder(sessionName)) {
+            permType = GRANTED_APP;
+        } else {
             permType = CheckPermissionAppInfo(pe, pItem);
             if (permType < 0) {
-                (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
-                return ENFORCING ? SOFTBUS_PERMISSION_DENIED : permType;
+                permType = ENFORCING ? SOFTBUS_PERMISSION_DENIED : permType;
             }
-            (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
-            return permType;
         }
+        AddPermCacheLocked(sessionName, pItem, permType);
+        (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
+        return permType;
     }
     if (pItem->permType != NORMAL_APP) {
+        AddPermCacheLocked(sessionName, pItem, SOFTBUS_PERMISSION_DENIED);
         (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
-        return ENFORCING ? SOFTBUS_PERMISSION_DENIED : permType;
+        return SOFTBUS_PERMISSION_DENIED;
     }
+    /* not cached, the package check below asks the system and its answer can change */
     if (pItem->actions == ACTION_CREATE) {
         if (IsValidPkgName(pItem->uid, pItem->pkgName) != SOFTBUS_OK) {
             (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
@@ -498,13 +789,9 @@ bool PermIsSecLevelPublic(const char *sessionName)
     if (SoftBusMutexLock(&g_permissionEntryList->lock) != 0) {
         return false;
     }
-    LIST_FOR_EACH_ENTRY(pe, &g_permissionEntryList->list, SoftBusPermissionEntry, node) {
-        if (CompareString(pe->sessionName, sessionName, pe->regexp) == SOFTBUS_OK) {
-            if (pe->secLevel == LEVEL_PUBLIC) {
-                ret = true;
-            }
-            break;
-        }
+    pe = FindPermissionEntryLocked(sessionName);
+    if (pe != NULL && pe->secLevel == LEVEL_PUBLIC) {
+        ret = true;
     }
     (void)SoftBusMutexUnlock(&g_permissionEntryList->lock);
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "PermIsSecLevelPublic: %s is %d", sessionName, ret);
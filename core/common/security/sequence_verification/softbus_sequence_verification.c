@@ -14,10 +14,25 @@
  */
 
 #include "softbus_sequence_verification.h"
+
+#include <securec.h>
+
+#include "softbus_adapter_mem.h"
 #include "softbus_log.h"
 
 #define MAX_SEQ_BIAS 60
 
+#define SEQ_WINDOW_WORD_BITS 64
+#define SEQ_WINDOW_WORD_SHIFT 6
+#define SEQ_WINDOW_WORD_INDEX_MASK (UINT32_MAX >> SEQ_WINDOW_WORD_SHIFT)
+
+struct SeqWindowInfo {
+    uint32_t windowSize;
+    uint32_t wordMask;
+    uint32_t nextSeq; /* highest seq received + 1, bits of nextSeq and above in its word are always clear */
+    uint64_t bitmap[];
+};
+
 static bool IsDifferentSign(int32_t seqA, int32_t seqB)
 {
     if ((seqA >= 0 && seqB >= 0) || (seqA < 0 && seqB < 0)) {
@@ -176,3 +191,82 @@ bool IsPassSeqCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
     /* can not reach here. */
     return false;
 }
+
+static uint64_t *GetSeqWindowWord(SeqWindowInfo *windowInfo, uint32_t seq)
+{
+    return &(windowInfo->bitmap[(seq >> SEQ_WINDOW_WORD_SHIFT) & windowInfo->wordMask]);
+}
+
+static uint64_t GetSeqWindowBit(uint32_t seq)
+{
+    return (uint64_t)1 << (seq & (SEQ_WINDOW_WORD_BITS - 1));
+}
+
+SeqWindowInfo *CreateSeqWindowInfo(uint32_t windowSize, int32_t firstSeq)
+{
+    if ((windowSize < SEQ_WINDOW_SIZE_MIN) || (windowSize > SEQ_WINDOW_SIZE_MAX) ||
+        ((windowSize & (windowSize - 1)) != 0)) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "invalid seq window size[%u].", windowSize);
+        return NULL;
+    }
+    uint32_t wordNum = windowSize >> SEQ_WINDOW_WORD_SHIFT;
+    uint32_t bitmapSize = wordNum * sizeof(uint64_t);
+    SeqWindowInfo *windowInfo = (SeqWindowInfo *)SoftBusMalloc(sizeof(SeqWindowInfo) + bitmapSize);
+    if (windowInfo == NULL) {
+        return NULL;
+    }
+    windowInfo->windowSize = windowSize;
+    windowInfo->wordMask = wordNum - 1;
+    windowInfo->nextSeq = (uint32_t)firstSeq;
+    /* the window starts out as if everything before firstSeq was received */
+    (void)memset_s(windowInfo->bitmap, bitmapSize, 0xFF, bitmapSize);
+    *GetSeqWindowWord(windowInfo, windowInfo->nextSeq) = GetSeqWindowBit(windowInfo->nextSeq) - 1;
+    return windowInfo;
+}
+
+void DestroySeqWindowInfo(SeqWindowInfo *windowInfo)
+{
+    if (windowInfo != NULL) {
+        SoftBusFree(windowInfo);
+    }
+}
+
+static void SlideSeqWindow(SeqWindowInfo *windowInfo, uint32_t recvSeq)
+{
+    uint32_t newNextSeq = recvSeq + 1;
+    uint32_t curWord = windowInfo->nextSeq >> SEQ_WINDOW_WORD_SHIFT;
+    uint32_t wordDiff = ((newNextSeq >> SEQ_WINDOW_WORD_SHIFT) - curWord) & SEQ_WINDOW_WORD_INDEX_MASK;
+    /* words entered by the window held seqs one window ago, at most every word is cleared once */
+    if (wordDiff > windowInfo->wordMask) {
+        wordDiff = windowInfo->wordMask + 1;
+    }
+    for (uint32_t i = 1; i <= wordDiff; i++) {
+        windowInfo->bitmap[(curWord + i) & windowInfo->wordMask] = 0;
+    }
+    windowInfo->nextSeq = newNextSeq;
+}
+
+bool IsPassSeqWindowCheck(SeqWindowInfo *windowInfo, int32_t recvSeq)
+{
+    if (windowInfo == NULL) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "invalid param.");
+        return false;
+    }
+    uint32_t seq = (uint32_t)recvSeq;
+    uint32_t behind = windowInfo->nextSeq - seq;
+    /* consider flip: seqs less than half the seq space behind are old ones */
+    if ((behind == 0) || (behind > (UINT32_MAX >> 1))) {
+        SlideSeqWindow(windowInfo, seq);
+    } else if (behind > windowInfo->windowSize - SEQ_WINDOW_WORD_BITS) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "package seq[%d] is out of window.", recvSeq);
+        return false;
+    }
+    uint64_t *word = GetSeqWindowWord(windowInfo, seq);
+    uint64_t bit = GetSeqWindowBit(seq);
+    if ((*word & bit) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "duplicated package seq[%d].", recvSeq);
+        return false;
+    }
+    *word |= bit;
+    return true;
+}
@@ -20,6 +20,7 @@
 #include "softbus_errcode.h"
 #include "softbus_config_adapter.h"
 #include "softbus_feature_config.h"
+#include "softbus_log.h"
 
 #define MAX_STORAGE_PATH_LEN 256
 #define MAX_NET_IF_NAME_LEN 256
@@ -30,14 +31,16 @@
 #ifdef SOFTBUS_STANDARD_SYSTEM
 #define CONN_BR_MAX_DATA_LENGTH (40 * 1000)
 #define CONN_BR_MAX_CONN_NUM 20
+/* room for a 64K proxy slice plus its heads */
+#define CONN_TCP_MAX_LENGTH (65 * 1024)
 #else
 #define CONN_BR_MAX_DATA_LENGTH 4096
 #define CONN_BR_MAX_CONN_NUM 5
+#define CONN_TCP_MAX_LENGTH 3072
 #endif
 
 #define CONN_RFCOM_SEND_MAX_LEN 990
 #define CONN_BR_RECEIVE_MAX_LEN 50
-#define CONN_TCP_MAX_LENGTH 3072
 #define CONN_TCP_MAX_CONN_NUM 30
 #define CONN_TCP_TIME_OUT 100
 #define MAX_NODE_STATE_CB_CNT 10
@@ -51,6 +54,7 @@
 #define LNN_UDID_INIT_DELAY_LEN 0
 #define LNN_NET_IF_NAME "0:eth0,1:wlan0"
 #define LNN_MAX_CONCURENT_NUM 2
+#define DISC_FOUND_DEDUP_WINDOW 1000
 
 #ifdef __LITEOS_M__
 #define DEFAULT_SELECT_INTERVAL 100000
@@ -58,6 +62,15 @@
 #define DEFAULT_SELECT_INTERVAL 10000
 #endif
 
+#ifdef SOFTBUS_LISTENER_EPOLL
+#define DEFAULT_LISTENER_REACTOR_NUM 2
+#else
+#define DEFAULT_LISTENER_REACTOR_NUM 0
+#endif
+
+#define DEFAULT_SEQ_WINDOW_SIZE 1024
+#define DEFAULT_MESSAGE_WINDOW_SIZE 64
+
 #ifdef SOFTBUS_STANDARD_SYSTEM
 #define DEFAULT_MAX_BYTES_LEN (4 * 1024 * 1024)
 #define DEFAULT_MAX_MESSAGE_LEN (4 * 1024)
@@ -97,6 +110,7 @@ typedef struct {
     int32_t lnnMaxConcurentNum;
     bool lnnAutoNetworkingSwitch;
     bool isSupportTopo;
+    int32_t discFoundDedupWindow;
 } ConfigItem;
 
 typedef struct {
@@ -124,6 +138,7 @@ ConfigItem g_config = {
     LNN_MAX_CONCURENT_NUM,
     true,
     true,
+    DISC_FOUND_DEDUP_WINDOW,
 };
 
 typedef struct {
@@ -133,6 +148,9 @@ typedef struct {
     int32_t maxMessageLen;
     int32_t maxAuthBytesLen;
     int32_t maxAuthMessageLen;
+    int32_t listenerReactorNum;
+    int32_t seqWindowSize;
+    int32_t messageWindowSize;
 } TransConfigItem;
 
 static TransConfigItem g_tranConfig = {0};
@@ -258,6 +276,26 @@ ConfigVal g_configItems[SOFTBUS_CONFIG_TYPE_MAX] = {
         (unsigned char*)&(g_config.isSupportTopo),
         sizeof(g_config.isSupportTopo)
     },
+    {
+        SOFTBUS_INT_CONN_LISTENER_REACTOR_NUM,
+        (unsigned char*)&(g_tranConfig.listenerReactorNum),
+        sizeof(g_tranConfig.listenerReactorNum)
+    },
+    {
+        SOFTBUS_INT_SEQ_WINDOW_SIZE,
+        (unsigned char*)&(g_tranConfig.seqWindowSize),
+        sizeof(g_tranConfig.seqWindowSize)
+    },
+    {
+        SOFTBUS_INT_MESSAGE_WINDOW_SIZE,
+        (unsigned char*)&(g_tranConfig.messageWindowSize),
+        sizeof(g_tranConfig.messageWindowSize)
+    },
+    {
+        SOFTBUS_INT_DISC_FOUND_DEDUP_WINDOW,
+        (unsigned char*)&(g_config.discFoundDedupWindow),
+        sizeof(g_config.discFoundDedupWindow)
+    },
 };
 
 int SoftbusSetConfig(ConfigType type, const unsigned char *val, uint32_t len)
@@ -268,6 +306,9 @@ int SoftbusSetConfig(ConfigType type, const unsigned char *val, uint32_t len)
     if (memcpy_s(g_configItems[type].val, g_configItems[type].len, val, len) != EOK) {
         return SOFTBUS_ERR;
     }
+    if (type == SOFTBUS_INT_ADAPTER_LOG_LEVEL) {
+        SoftBusLogSetLevel(g_config.adapterLogLevel);
+    }
     return SOFTBUS_OK;
 }
 
@@ -290,6 +331,9 @@ static void SoftbusConfigSetTransDefaultVal(void)
     g_tranConfig.maxMessageLen = DEFAULT_MAX_MESSAGE_LEN;
     g_tranConfig.maxAuthBytesLen = DEFAULT_AUTH_MAX_BYTES_LEN;
     g_tranConfig.maxAuthMessageLen = DEFAULT_AUTH_MAX_MESSAGE_LEN;
+    g_tranConfig.listenerReactorNum = DEFAULT_LISTENER_REACTOR_NUM;
+    g_tranConfig.seqWindowSize = DEFAULT_SEQ_WINDOW_SIZE;
+    g_tranConfig.messageWindowSize = DEFAULT_MESSAGE_WINDOW_SIZE;
 }
 
 static void SoftbusConfigSetDefaultVal(void)
@@ -37,10 +37,25 @@ typedef struct {
     const char *data;
 } SendQueueNode;
 
+#define BLE_QUEUE_PRIORITY_NUM 3
+
+/* per priority arrays are indexed high, middle, low */
+typedef struct {
+    uint32_t depth[BLE_QUEUE_PRIORITY_NUM];  /* messages one pid may queue at a priority */
+    uint32_t weight[BLE_QUEUE_PRIORITY_NUM]; /* share of a flow of this priority */
+    uint32_t quantum;                        /* bytes a flow of weight 1 may send per round */
+    uint32_t idleAgeMs;                      /* an empty pid queue is freed after idling this long */
+} BleQueueConfig;
+
 int BleInnerQueueInit(void);
 void BleInnerQueueDeinit(void);
+/* only allowed before BleInnerQueueInit */
+int BleQueueSetConfig(const BleQueueConfig *config);
+void BleQueueGetConfig(BleQueueConfig *config);
 int BleEnqueueNonBlock(const void *msg);
 int BleDequeueNonBlock(void **msg);
+/* waits until a message is queued */
+int BleDequeueBlock(void **msg);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -1127,12 +1127,12 @@ static void FreeSendNode(SendQueueNode *node)
 
 void *BleSendTask(void *arg)
 {
-#define WAIT_TIME 10
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "BleSendTask enter");
     while (1) {
         SendQueueNode *node = NULL;
-        if (BleDequeueNonBlock((void **)(&node)) != SOFTBUS_OK) {
-            SoftBusSleepMs(WAIT_TIME);
+        /* it only fails when the wait itself failed, there is nothing to back off from */
+        if (BleDequeueBlock((void **)(&node)) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "BleSendTask dequeue failed");
             continue;
         }
         if (SendBleData(node) != SOFTBUS_OK) {
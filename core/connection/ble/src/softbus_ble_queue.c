@@ -20,6 +20,7 @@
 #include "common_list.h"
 #include "securec.h"
 #include "softbus_adapter_mem.h"
+#include "softbus_adapter_timer.h"
 #include "softbus_ble_queue.h"
 #include "softbus_conn_manager.h"
 #include "softbus_def.h"
@@ -28,15 +29,55 @@
 #include "softbus_queue.h"
 #include "softbus_type_def.h"
 
-#define QUEUE_NUM_PER_PID 3
-#define HIGH_PRIORITY_DEFAULT_LIMIT 32
-#define MIDDLE_PRIORITY_DEFAULT_LIMIT 32
-#define LOW_PRIORITY_DEFAULT_LIMIT 16
+#define QUEUE_NUM_PER_PID BLE_QUEUE_PRIORITY_NUM
 
+#ifndef BLE_QUEUE_HIGH_DEPTH
+#define BLE_QUEUE_HIGH_DEPTH 32
+#endif
+#ifndef BLE_QUEUE_MIDDLE_DEPTH
+#define BLE_QUEUE_MIDDLE_DEPTH 32
+#endif
+#ifndef BLE_QUEUE_LOW_DEPTH
+#define BLE_QUEUE_LOW_DEPTH 16
+#endif
+#define HIGH_PRIORITY_DEFAULT_WEIGHT 4
+#define MIDDLE_PRIORITY_DEFAULT_WEIGHT 2
+#define LOW_PRIORITY_DEFAULT_WEIGHT 1
+#define DEFAULT_QUANTUM 1024
+#define DEFAULT_IDLE_AGE_MS 30000
+/* connection control messages of pid 0 get twice the share of an app flow of the same priority */
+#define INNER_QUEUE_WEIGHT_FACTOR 2
+#define BLE_QUEUE_MAX_DEPTH 4096
+#define AGING_INTERVAL_MS 1000
+#define MS_PER_SECOND 1000
+#define USEC_PER_MS 1000
+#define USECTONSEC 1000
+
+struct BleQueue;
+
+/*
+ * One flow per pid and priority. The flows holding messages are served deficit round robin: each turn at the head
+ * of g_bleActiveList adds quantum * weight bytes to the deficit, and messages go out while the next one fits in it.
+ */
 typedef struct {
+    ListNode node;
+    struct BleQueue *owner;
+    int32_t priority;
+    LockFreeQueue *queue;
+    SendQueueNode *head; /* taken out of queue, so its length can be checked against the deficit */
+    uint32_t depth;
+    uint32_t count;
+    uint32_t deficit;
+    bool active;
+    bool topped; /* deficit already got the quantum of this turn */
+} BleFlow;
+
+typedef struct BleQueue {
     ListNode node;
     int32_t pid;
-    LockFreeQueue *queue[QUEUE_NUM_PER_PID];
+    uint32_t count;
+    uint64_t lastActive;
+    BleFlow flow[QUEUE_NUM_PER_PID];
 } BleQueue;
 
 typedef enum {
@@ -46,15 +87,39 @@ typedef enum {
     PRIORITY_BOUNDARY
 } QueuePriority;
 
-static const int32_t QUEUE_LIMIT[QUEUE_NUM_PER_PID] = {
-    HIGH_PRIORITY_DEFAULT_LIMIT,
-    MIDDLE_PRIORITY_DEFAULT_LIMIT,
-    LOW_PRIORITY_DEFAULT_LIMIT
+static BleQueueConfig g_bleQueueConfig = {
+    .depth = { BLE_QUEUE_HIGH_DEPTH, BLE_QUEUE_MIDDLE_DEPTH, BLE_QUEUE_LOW_DEPTH },
+    .weight = { HIGH_PRIORITY_DEFAULT_WEIGHT, MIDDLE_PRIORITY_DEFAULT_WEIGHT, LOW_PRIORITY_DEFAULT_WEIGHT },
+    .quantum = DEFAULT_QUANTUM,
+    .idleAgeMs = DEFAULT_IDLE_AGE_MS,
 };
+/* queues of app pids, kept while idle until they age out */
 static LIST_HEAD(g_bleQueueList);
+/* flows holding messages, in service order */
+static LIST_HEAD(g_bleActiveList);
 static SoftBusMutex g_bleQueueLock;
+static SoftBusCond g_bleQueueCond;
+static uint32_t g_waitingNum = 0;
+static uint64_t g_lastAgingTime = 0;
 static BleQueue *g_innerQueue = NULL;
 
+static uint64_t GetNowMs(void)
+{
+    SoftBusSysTime now = {0};
+    (void)SoftBusGetTime(&now);
+    return (uint64_t)now.sec * MS_PER_SECOND + (uint64_t)now.usec / USEC_PER_MS;
+}
+
+static uint32_t GetQueueUnitNum(uint32_t depth)
+{
+    /* the flow head holds one message, the ring keeps unitNum - 1 */
+    uint32_t unitNum = 1;
+    while (unitNum < depth) {
+        unitNum <<= 1;
+    }
+    return unitNum;
+}
+
 static BleQueue *CreateBleQueue(int32_t pid)
 {
     BleQueue *queue = (BleQueue *)SoftBusCalloc(sizeof(BleQueue));
@@ -64,15 +129,20 @@ static BleQueue *CreateBleQueue(int32_t pid)
     queue->pid = pid;
     int i;
     for (i = 0; i < QUEUE_NUM_PER_PID; i++) {
-        queue->queue[i] = CreateQueue(QUEUE_LIMIT[i]);
-        if (queue->queue[i] == NULL) {
+        BleFlow *flow = &queue->flow[i];
+        flow->queue = CreateQueue(GetQueueUnitNum(g_bleQueueConfig.depth[i]));
+        if (flow->queue == NULL) {
             goto ERR_RETURN;
         }
+        ListInit(&flow->node);
+        flow->owner = queue;
+        flow->priority = i;
+        flow->depth = g_bleQueueConfig.depth[i];
     }
     return queue;
 ERR_RETURN:
     for (i--; i >= 0; i--) {
-        SoftBusFree(queue->queue[i]);
+        SoftBusFree(queue->flow[i].queue);
     }
     SoftBusFree(queue);
     return NULL;
@@ -84,7 +154,10 @@ static void DestroyBleQueue(BleQueue *queue)
         return;
     }
     for (int i = 0; i < QUEUE_NUM_PER_PID; i++) {
-        SoftBusFree(queue->queue[i]);
+        if (queue->flow[i].active) {
+            ListDelete(&queue->flow[i].node);
+        }
+        SoftBusFree(queue->flow[i].queue);
     }
     SoftBusFree(queue);
 }
@@ -101,48 +174,125 @@ static int GetPriority(int32_t flag)
     }
 }
 
+static BleQueue *GetBleQueueLocked(int32_t pid)
+{
+    if (pid == 0) {
+        return g_innerQueue;
+    }
+    BleQueue *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &g_bleQueueList, BleQueue, node) {
+        if (item->pid == pid) {
+            return item;
+        }
+    }
+    item = CreateBleQueue(pid);
+    if (item == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "BleEnqueueNonBlock CreateBleQueue failed");
+        return NULL;
+    }
+    item->lastActive = GetNowMs();
+    ListTailInsert(&g_bleQueueList, &item->node);
+    return item;
+}
+
+static void AgeIdleQueuesLocked(uint64_t now)
+{
+    if (now - g_lastAgingTime < AGING_INTERVAL_MS) {
+        return;
+    }
+    g_lastAgingTime = now;
+    BleQueue *item = NULL;
+    BleQueue *next = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_bleQueueList, BleQueue, node) {
+        if (item->count == 0 && now - item->lastActive >= g_bleQueueConfig.idleAgeMs) {
+            ListDelete(&item->node);
+            DestroyBleQueue(item);
+        }
+    }
+}
+
 int BleEnqueueNonBlock(const void *msg)
 {
     if (msg == NULL) {
         return SOFTBUS_ERR;
     }
     SendQueueNode *queueNode = (SendQueueNode *)msg;
-    if (queueNode->pid == 0) {
-        return QueueMultiProducerEnqueue(g_innerQueue->queue[GetPriority(queueNode->flag)], msg);
-    }
-    LockFreeQueue *lockFreeQueue = NULL;
-    BleQueue *item = NULL;
     if (SoftBusMutexLock(&g_bleQueueLock) != EOK) {
         return SOFTBUS_ERR;
     }
-    LIST_FOR_EACH_ENTRY(item, &g_bleQueueList, BleQueue, node) {
-        if (item->pid == queueNode->pid) {
-            lockFreeQueue = item->queue[GetPriority(queueNode->flag)];
-            break;
-        }
+    BleQueue *queue = GetBleQueueLocked(queueNode->pid);
+    if (queue == NULL) {
+        (void)SoftBusMutexUnlock(&g_bleQueueLock);
+        return SOFTBUS_ERR;
     }
-    if (lockFreeQueue == NULL) {
-        BleQueue *newQueue = CreateBleQueue(queueNode->pid);
-        if (newQueue == NULL) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "BleEnqueueNonBlock CreateBleQueue failed");
-            (void)SoftBusMutexUnlock(&g_bleQueueLock);
-            return SOFTBUS_ERR;
-        }
-        ListTailInsert(&g_bleQueueList, &(newQueue->node));
-        lockFreeQueue = newQueue->queue[GetPriority(queueNode->flag)];
+    BleFlow *flow = &queue->flow[GetPriority(queueNode->flag)];
+    if (flow->count >= flow->depth) {
+        (void)SoftBusMutexUnlock(&g_bleQueueLock);
+        return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
+    }
+    if (flow->head == NULL) {
+        flow->head = queueNode;
+    } else if (QueueSingleProducerEnqueue(flow->queue, msg) != 0) {
+        (void)SoftBusMutexUnlock(&g_bleQueueLock);
+        return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
+    }
+    flow->count++;
+    queue->count++;
+    if (!flow->active) {
+        flow->active = true;
+        ListTailInsert(&g_bleActiveList, &flow->node);
+    }
+    if (g_waitingNum > 0) {
+        (void)SoftBusCondSignal(&g_bleQueueCond);
     }
     (void)SoftBusMutexUnlock(&g_bleQueueLock);
-    return QueueMultiProducerEnqueue(lockFreeQueue, msg);
+    return SOFTBUS_OK;
 }
 
-static int GetMsg(BleQueue *queue, void **msg)
+static uint32_t GetFlowQuantum(const BleFlow *flow)
 {
-    for (int i = 0; i < QUEUE_NUM_PER_PID; i++) {
-        if (QueueSingleConsumerDequeue(queue->queue[i], msg) == 0) {
-            return SOFTBUS_OK;
+    uint32_t quantum = g_bleQueueConfig.quantum * g_bleQueueConfig.weight[flow->priority];
+    if (flow->owner->pid == 0) {
+        quantum *= INNER_QUEUE_WEIGHT_FACTOR;
+    }
+    return quantum;
+}
+
+static SendQueueNode *PopFlowHead(BleFlow *flow, uint64_t now)
+{
+    SendQueueNode *node = flow->head;
+    void *next = NULL;
+    flow->head = (QueueSingleConsumerDequeue(flow->queue, &next) == 0) ? (SendQueueNode *)next : NULL;
+    flow->count--;
+    flow->owner->count--;
+    flow->owner->lastActive = now;
+    if (flow->head == NULL) {
+        ListDelete(&flow->node);
+        flow->active = false;
+        flow->topped = false;
+        flow->deficit = 0;
+    }
+    return node;
+}
+
+static SendQueueNode *DequeueLocked(uint64_t now)
+{
+    while (!IsListEmpty(&g_bleActiveList)) {
+        BleFlow *flow = LIST_ENTRY(g_bleActiveList.next, BleFlow, node);
+        if (!flow->topped) {
+            flow->deficit += GetFlowQuantum(flow);
+            flow->topped = true;
+        }
+        if (flow->head->len <= flow->deficit) {
+            flow->deficit -= flow->head->len;
+            return PopFlowHead(flow, now);
         }
+        /* turn is over, the deficit carries over to the next one */
+        flow->topped = false;
+        ListDelete(&flow->node);
+        ListTailInsert(&g_bleActiveList, &flow->node);
     }
-    return SOFTBUS_ERR;
+    return NULL;
 }
 
 int BleDequeueNonBlock(void **msg)
@@ -150,27 +300,81 @@ int BleDequeueNonBlock(void **msg)
     if (msg == NULL) {
         return SOFTBUS_ERR;
     }
-    if (GetMsg(g_innerQueue, msg) == SOFTBUS_OK) {
-        return SOFTBUS_OK;
+    if (SoftBusMutexLock(&g_bleQueueLock) != EOK) {
+        return SOFTBUS_ERR;
     }
+    uint64_t now = GetNowMs();
+    AgeIdleQueuesLocked(now);
+    SendQueueNode *node = DequeueLocked(now);
+    (void)SoftBusMutexUnlock(&g_bleQueueLock);
+    if (node == NULL) {
+        return SOFTBUS_ERR;
+    }
+    *msg = (void *)node;
+    return SOFTBUS_OK;
+}
 
-    if (SoftBusMutexLock(&g_bleQueueLock) != EOK) {
+int BleDequeueBlock(void **msg)
+{
+    if (msg == NULL) {
         return SOFTBUS_ERR;
     }
-    if (IsListEmpty(&g_bleQueueList)) {
-        (void)SoftBusMutexUnlock(&g_bleQueueLock);
+    if (SoftBusMutexLock(&g_bleQueueLock) != EOK) {
         return SOFTBUS_ERR;
     }
-    BleQueue *item = LIST_ENTRY(g_bleQueueList.next, BleQueue, node);
-    ListDelete(&(item->node));
-    if (GetMsg(item, msg) == SOFTBUS_OK) {
-        ListTailInsert(&g_bleQueueList, &(item->node));
-        (void)SoftBusMutexUnlock(&g_bleQueueLock);
-        return SOFTBUS_OK;
+    SendQueueNode *node = NULL;
+    while (1) {
+        uint64_t now = GetNowMs();
+        AgeIdleQueuesLocked(now);
+        node = DequeueLocked(now);
+        if (node != NULL) {
+            break;
+        }
+        /* idle app queues still have to age out, otherwise sleep until an enqueue */
+        SoftBusSysTime outtime;
+        SoftBusSysTime *deadline = NULL;
+        if (!IsListEmpty(&g_bleQueueList)) {
+            (void)SoftBusGetTime(&outtime);
+            outtime.sec += AGING_INTERVAL_MS / MS_PER_SECOND;
+            outtime.usec = outtime.usec * USECTONSEC;
+            deadline = &outtime;
+        }
+        g_waitingNum++;
+        int32_t ret = SoftBusCondWait(&g_bleQueueCond, &g_bleQueueLock, deadline);
+        g_waitingNum--;
+        if (ret != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "BleDequeueBlock wait failed");
+            (void)SoftBusMutexUnlock(&g_bleQueueLock);
+            return SOFTBUS_ERR;
+        }
     }
-    DestroyBleQueue(item);
     (void)SoftBusMutexUnlock(&g_bleQueueLock);
-    return SOFTBUS_ERR;
+    *msg = (void *)node;
+    return SOFTBUS_OK;
+}
+
+int BleQueueSetConfig(const BleQueueConfig *config)
+{
+    if (config == NULL || g_innerQueue != NULL) {
+        return SOFTBUS_ERR;
+    }
+    if (config->quantum == 0) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    for (int i = 0; i < QUEUE_NUM_PER_PID; i++) {
+        if (config->depth[i] == 0 || config->depth[i] > BLE_QUEUE_MAX_DEPTH || config->weight[i] == 0) {
+            return SOFTBUS_INVALID_PARAM;
+        }
+    }
+    g_bleQueueConfig = *config;
+    return SOFTBUS_OK;
+}
+
+void BleQueueGetConfig(BleQueueConfig *config)
+{
+    if (config != NULL) {
+        *config = g_bleQueueConfig;
+    }
 }
 
 int BleInnerQueueInit(void)
@@ -178,18 +382,32 @@ int BleInnerQueueInit(void)
     if (SoftBusMutexInit(&g_bleQueueLock, NULL) != 0) {
         return SOFTBUS_ERR;
     }
+    if (SoftBusCondInit(&g_bleQueueCond) != SOFTBUS_OK) {
+        (void)SoftBusMutexDestroy(&g_bleQueueLock);
+        return SOFTBUS_ERR;
+    }
     g_innerQueue = CreateBleQueue(0);
     if (g_innerQueue == NULL) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "BleQueueInit CreateBleQueue(0) failed");
+        (void)SoftBusCondDestroy(&g_bleQueueCond);
         (void)SoftBusMutexDestroy(&g_bleQueueLock);
         return SOFTBUS_ERR;
     }
+    g_lastAgingTime = GetNowMs();
     return SOFTBUS_OK;
 }
 
 void BleInnerQueueDeinit(void)
 {
-    SoftBusMutexDestroy(&g_bleQueueLock);
+    BleQueue *item = NULL;
+    BleQueue *next = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_bleQueueList, BleQueue, node) {
+        ListDelete(&item->node);
+        DestroyBleQueue(item);
+    }
     DestroyBleQueue(g_innerQueue);
     g_innerQueue = NULL;
-}
\ No newline at end of file
+    ListInit(&g_bleActiveList);
+    (void)SoftBusCondDestroy(&g_bleQueueCond);
+    (void)SoftBusMutexDestroy(&g_bleQueueLock);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOFTBUS_LISTENER_REACTOR_H
+#define SOFTBUS_LISTENER_REACTOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "softbus_base_listener.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+#define MAX_LISTENER_REACTOR_NUM 8
+
+/*
+ * Called on a reactor thread for every ready fd. Events of one fd are always
+ * delivered on the same reactor, so a callback never races with itself for one fd.
+ */
+typedef int32_t (*ReactorEventProc)(ListenerModule module, int32_t fd, uint32_t events);
+
+/* threadNum <= 0 means the reactor backend is not used and the select loop stays in charge. */
+int32_t ListenerReactorInit(int32_t threadNum, ReactorEventProc proc);
+bool ListenerReactorIsEnabled(void);
+
+/*
+ * Register triggerType for fd, owned by module. isNewFd is set when fd was not watched before,
+ * so the caller can keep its own per-module fd count.
+ */
+int32_t ListenerReactorAddFd(ListenerModule module, int32_t fd, TriggerType triggerType, bool *isNewFd);
+
+/* isRemoved is set when no trigger is left and fd is no longer watched. */
+int32_t ListenerReactorDelFd(int32_t fd, TriggerType triggerType, bool *isRemoved);
+bool ListenerReactorIsFdExist(int32_t fd);
+
+/* Stop watching every fd of module except keepFd (pass -1 to drop all). */
+void ListenerReactorClearModule(ListenerModule module, int32_t keepFd);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* SOFTBUS_LISTENER_REACTOR_H */
@@ -23,6 +23,7 @@
 #include "softbus_adapter_socket.h"
 #include "softbus_errcode.h"
 #include "softbus_feature_config.h"
+#include "softbus_listener_reactor.h"
 #include "softbus_log.h"
 #include "softbus_tcp_socket.h"
 #include "softbus_thread_pool.h"
@@ -82,6 +83,7 @@ static SoftBusSetLock g_fdSetLock = {
     .lockInit = false,
 };
 static bool g_fdSetInit = false;
+static bool g_backendInit = false;
 
 static int32_t FdCopy(const SoftBusFdSet *dest, const SoftBusFdSet *src)
 {
@@ -95,6 +97,9 @@ static int32_t MaxFd(int32_t fd1, int32_t fd2)
 
 static void UpdateMaxFd(void)
 {
+    if (ListenerReactorIsEnabled()) {
+        return;
+    }
     int32_t tmpMax = -1;
 
     for (int i = 0; i < UNUSE_BUTT; i++) {
@@ -202,6 +207,15 @@ static int32_t InitListenFd(ListenerModule module, const char *ip, int32_t port)
         return SOFTBUS_ERR;
     }
 
+    if (ListenerReactorIsEnabled()) {
+        bool isNewFd = false;
+        if (ListenerReactorAddFd(module, listenerInfo->listenFd, READ_TRIGGER, &isNewFd) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "add listen fd to reactor failed");
+            ResetBaseListener(module);
+            return SOFTBUS_ERR;
+        }
+        return SOFTBUS_OK;
+    }
     if (SoftBusMutexLock(&(g_fdSetLock.lock)) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
         ResetBaseListener(module);
@@ -237,6 +251,7 @@ void ResetBaseListener(ListenerModule module)
     listenerInfo->modeType = UNSET_MODE;
     listenerInfo->fdCount = 0;
     ClearListenerFdList(&listenerInfo->node);
+    ListenerReactorClearModule(module, -1);
     SoftBusMutexUnlock(&g_listenerList[module].lock);
     UpdateMaxFd();
 }
@@ -256,6 +271,7 @@ void ResetBaseListenerSet(ListenerModule module)
         return;
     }
     ClearListenerFdList(&listenerInfo->node);
+    ListenerReactorClearModule(module, listenerInfo->listenFd);
     listenerInfo->fdCount = 0;
     SoftBusMutexUnlock(&g_listenerList[module].lock);
     UpdateMaxFd();
@@ -275,6 +291,11 @@ static int32_t OnEvent(ListenerModule module, int32_t fd, uint32_t events)
         SoftBusMutexUnlock(&g_listenerList[module].lock);
         return SOFTBUS_ERR;
     }
+    if (g_listenerList[module].info->status != LISTENER_RUNNING) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_DBG, "module %d is not running!", module);
+        SoftBusMutexUnlock(&g_listenerList[module].lock);
+        return SOFTBUS_ERR;
+    }
     int32_t listenFd = g_listenerList[module].info->listenFd;
     SoftbusBaseListener listener = {0};
     listener.onConnectEvent = g_listenerList[module].listener->onConnectEvent;
@@ -474,6 +495,9 @@ static int32_t StartThread(ListenerModule module, ModeType modeType)
     }
     listenerInfo->modeType = modeType;
     listenerInfo->status = LISTENER_RUNNING;
+    if (ListenerReactorIsEnabled()) {
+        return SOFTBUS_OK;
+    }
 
     return ThreadPoolAddJob(g_threadPool, (int32_t(*)(void *))SelectThread,
         NULL, PERSISTENT, (uintptr_t)0);
@@ -490,7 +514,7 @@ static int32_t PrepareBaseListener(ListenerModule module, ModeType modeType)
         return SOFTBUS_ERR;
     }
 
-    if (g_threadPool == NULL) {
+    if (g_threadPool == NULL && !ListenerReactorIsEnabled()) {
         g_threadPool = ThreadPoolInit(THREADPOOL_THREADNUM, THREADPOOL_QUEUE_NUM);
         if (g_threadPool == NULL) {
             return SOFTBUS_MALLOC_ERR;
@@ -598,6 +622,23 @@ static int32_t DelTriggerFromSet(int32_t fd, TriggerType triggerType)
     return ret;
 }
 
+static void InitListenerBackend(void)
+{
+    if (g_backendInit) {
+        return;
+    }
+    g_backendInit = true;
+    int32_t reactorNum = 0;
+    if (SoftbusGetConfig(SOFTBUS_INT_CONN_LISTENER_REACTOR_NUM, (unsigned char *)&reactorNum,
+        sizeof(reactorNum)) != SOFTBUS_OK || reactorNum <= 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "base listener use select backend");
+        return;
+    }
+    if (ListenerReactorInit(reactorNum, OnEvent) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "init reactor failed, fall back to select backend");
+    }
+}
+
 int32_t StartBaseClient(ListenerModule module)
 {
     if (CheckModule(module) != SOFTBUS_OK) {
@@ -611,6 +652,7 @@ int32_t StartBaseClient(ListenerModule module)
         }
         g_fdSetLock.lockInit = true;
     }
+    InitListenerBackend();
     int32_t ret;
 
     g_listenerList[module].module = module;
@@ -657,6 +699,7 @@ int32_t StartBaseListener(ListenerModule module, const char *ip, int32_t port, M
         }
         g_fdSetLock.lockInit = true;
     }
+    InitListenerBackend();
 
     int32_t ret;
 
@@ -763,7 +806,12 @@ int32_t StopBaseListener(ListenerModule module)
     if (listenerInfo->listenFd > 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "del listen fd from readSet, fd = %d, module = %d.",
             listenerInfo->listenFd, module);
-        DelTriggerFromSet(listenerInfo->listenFd, READ_TRIGGER);
+        if (ListenerReactorIsEnabled()) {
+            bool isRemoved = false;
+            (void)ListenerReactorDelFd(listenerInfo->listenFd, READ_TRIGGER, &isRemoved);
+        } else {
+            DelTriggerFromSet(listenerInfo->listenFd, READ_TRIGGER);
+        }
         TcpShutDown(listenerInfo->listenFd);
         UpdateMaxFd();
     }
@@ -835,12 +883,69 @@ static void DelFdNode(SoftbusBaseListenerInfo *info, int32_t fd)
     }
 }
 
+static int32_t AddTriggerToReactor(ListenerModule module, int32_t fd, TriggerType triggerType)
+{
+    if (SoftBusMutexLock(&g_listenerList[module].lock) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
+        return SOFTBUS_LOCK_ERR;
+    }
+    SoftbusBaseListenerInfo *info = g_listenerList[module].info;
+    if (info == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot AddTrigger any more");
+        SoftBusMutexUnlock(&g_listenerList[module].lock);
+        return SOFTBUS_ERR;
+    }
+    bool isNewFd = false;
+    if (ListenerReactorAddFd(module, fd, triggerType, &isNewFd) != SOFTBUS_OK) {
+        SoftBusMutexUnlock(&g_listenerList[module].lock);
+        return SOFTBUS_ERR;
+    }
+    if (isNewFd) {
+        info->fdCount++;
+    }
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
+        "AddTrigger fd:%d success, current fdcount:%d, module:%d, triggerType:%d",
+        fd, info->fdCount, module, triggerType);
+    SoftBusMutexUnlock(&g_listenerList[module].lock);
+    return SOFTBUS_OK;
+}
+
+static int32_t DelTriggerFromReactor(ListenerModule module, int32_t fd, TriggerType triggerType)
+{
+    if (SoftBusMutexLock(&g_listenerList[module].lock) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
+        return SOFTBUS_LOCK_ERR;
+    }
+    SoftbusBaseListenerInfo *info = g_listenerList[module].info;
+    if (info == NULL) {
+        SoftBusMutexUnlock(&g_listenerList[module].lock);
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "DelTrigger base listener info is NULL");
+        return SOFTBUS_ERR;
+    }
+    bool isRemoved = false;
+    if (ListenerReactorDelFd(fd, triggerType, &isRemoved) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
+            "del trigger fail: fd = %d, trigger = %d", fd, triggerType);
+    }
+    if (isRemoved) {
+        info->fdCount--;
+    }
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
+        "DelTrigger [fd:%d] success, current fdcount:%d, module:%d, triggerType:%d",
+        fd, info->fdCount, module, triggerType);
+    SoftBusMutexUnlock(&g_listenerList[module].lock);
+    return SOFTBUS_OK;
+}
+
 int32_t AddTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
 {
     if (CheckModule(module) != SOFTBUS_OK || fd < 0 || CheckTrigger(triggerType) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Invalid AddTrigger Param");
         return SOFTBUS_INVALID_PARAM;
     }
+    if (ListenerReactorIsEnabled()) {
+        return AddTriggerToReactor(module, fd, triggerType);
+    }
 
     if (SoftBusMutexLock(&g_listenerList[module].lock) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
@@ -890,6 +995,9 @@ int32_t DelTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Invalid AddTrigger Param");
         return SOFTBUS_INVALID_PARAM;
     }
+    if (ListenerReactorIsEnabled()) {
+        return DelTriggerFromReactor(module, fd, triggerType);
+    }
     if (SoftBusMutexLock(&g_listenerList[module].lock) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
         return SOFTBUS_LOCK_ERR;
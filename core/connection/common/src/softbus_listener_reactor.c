@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softbus_listener_reactor.h"
+
+#include "softbus_errcode.h"
+#include "softbus_log.h"
+
+#ifdef SOFTBUS_LISTENER_EPOLL
+#include <errno.h>
+#include <securec.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "softbus_adapter_mem.h"
+#include "softbus_adapter_thread.h"
+#include "softbus_tcp_socket.h"
+#include "softbus_thread_pool.h"
+
+#define REACTOR_MAX_EVENTS 64
+#define REACTOR_WAIT_TIMEOUT_MS 1000
+#define REACTOR_MAX_DRAIN_ROUND 16
+#define FD_TABLE_START_SIZE 64
+#define FD_TABLE_EXPAND_BASE 2
+#define FD_HASH_FACTOR 2654435761U
+#define EVENT_DATA_SEQ_SHIFT 32
+#define EVENT_DATA_FD_MASK 0xFFFFFFFFULL
+
+#define TRIGGER_BIT_READ 0x1U
+#define TRIGGER_BIT_WRITE 0x2U
+#define TRIGGER_BIT_EXCEPT 0x4U
+
+typedef struct {
+    uint32_t triggers;
+    uint32_t seq;
+    ListenerModule module;
+} ReactorFdEntry;
+
+typedef struct {
+    int32_t epollFd;
+    int32_t index;
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+} Reactor;
+
+typedef struct {
+    SoftBusMutex lock;
+    bool inited;
+    int32_t reactorNum;
+    Reactor reactors[MAX_LISTENER_REACTOR_NUM];
+    ThreadPool *pool;
+    ReactorEventProc proc;
+    ReactorFdEntry *fdTable;
+    int32_t fdTableSize;
+    uint32_t nextSeq;
+} ReactorManager;
+
+static ReactorManager g_reactorMgr = {
+    .inited = false,
+    .reactorNum = 0,
+    .pool = NULL,
+    .proc = NULL,
+    .fdTable = NULL,
+    .fdTableSize = 0,
+    .nextSeq = 0,
+};
+
+static uint32_t TriggerToBits(TriggerType triggerType)
+{
+    switch (triggerType) {
+        case READ_TRIGGER:
+            return TRIGGER_BIT_READ;
+        case WRITE_TRIGGER:
+            return TRIGGER_BIT_WRITE;
+        case EXCEPT_TRIGGER:
+            return TRIGGER_BIT_EXCEPT;
+        case RW_TRIGGER:
+            return TRIGGER_BIT_READ | TRIGGER_BIT_WRITE;
+        default:
+            return 0;
+    }
+}
+
+static uint32_t BitsToEpollEvents(uint32_t triggers)
+{
+    uint32_t events = EPOLLET;
+    if ((triggers & TRIGGER_BIT_READ) != 0) {
+        events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if ((triggers & TRIGGER_BIT_WRITE) != 0) {
+        events |= EPOLLOUT;
+    }
+    if ((triggers & TRIGGER_BIT_EXCEPT) != 0) {
+        events |= EPOLLPRI;
+    }
+    return events;
+}
+
+static Reactor *GetReactorByFd(int32_t fd)
+{
+    uint32_t hash = (uint32_t)fd * FD_HASH_FACTOR;
+    return &g_reactorMgr.reactors[hash % (uint32_t)g_reactorMgr.reactorNum];
+}
+
+/* lock must be held; table only grows, so fds are looked up in O(1) without any scan */
+static ReactorFdEntry *GetFdEntry(int32_t fd, bool create)
+{
+    if (fd < g_reactorMgr.fdTableSize) {
+        return &g_reactorMgr.fdTable[fd];
+    }
+    if (!create) {
+        return NULL;
+    }
+    int32_t newSize = (g_reactorMgr.fdTableSize == 0) ? FD_TABLE_START_SIZE : g_reactorMgr.fdTableSize;
+    while (newSize <= fd) {
+        newSize *= FD_TABLE_EXPAND_BASE;
+    }
+    ReactorFdEntry *newTable = (ReactorFdEntry *)SoftBusCalloc(sizeof(ReactorFdEntry) * (uint32_t)newSize);
+    if (newTable == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "expand reactor fd table failed, fd=%d", fd);
+        return NULL;
+    }
+    if (g_reactorMgr.fdTable != NULL) {
+        if (memcpy_s(newTable, sizeof(ReactorFdEntry) * (uint32_t)newSize, g_reactorMgr.fdTable,
+            sizeof(ReactorFdEntry) * (uint32_t)g_reactorMgr.fdTableSize) != EOK) {
+            SoftBusFree(newTable);
+            return NULL;
+        }
+        SoftBusFree(g_reactorMgr.fdTable);
+    }
+    g_reactorMgr.fdTable = newTable;
+    g_reactorMgr.fdTableSize = newSize;
+    return &g_reactorMgr.fdTable[fd];
+}
+
+static int32_t ReactorCtl(int32_t op, int32_t fd, const ReactorFdEntry *entry)
+{
+    struct epoll_event ev;
+    (void)memset_s(&ev, sizeof(ev), 0, sizeof(ev));
+    ev.events = BitsToEpollEvents(entry->triggers);
+    ev.data.u64 = ((uint64_t)entry->seq << EVENT_DATA_SEQ_SHIFT) | (uint32_t)fd;
+    if (epoll_ctl(GetReactorByFd(fd)->epollFd, op, fd, &ev) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_ctl op=%d fd=%d failed, errno=%d", op, fd, errno);
+        return SOFTBUS_TCP_SOCKET_ERR;
+    }
+    return SOFTBUS_OK;
+}
+
+/* return the owner module of fd if the event still belongs to the current registration */
+static bool CheckEventValid(int32_t fd, uint32_t seq, uint32_t triggerBit, ListenerModule *module)
+{
+    bool valid = false;
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return false;
+    }
+    ReactorFdEntry *entry = GetFdEntry(fd, false);
+    if (entry != NULL && entry->seq == seq && (entry->triggers & triggerBit) != 0) {
+        *module = entry->module;
+        valid = true;
+    }
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+    return valid;
+}
+
+static void RearmFd(int32_t fd, uint32_t seq)
+{
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return;
+    }
+    ReactorFdEntry *entry = GetFdEntry(fd, false);
+    if (entry != NULL && entry->seq == seq && entry->triggers != 0) {
+        (void)ReactorCtl(EPOLL_CTL_MOD, fd, entry);
+    }
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+}
+
+/*
+ * Handlers written for the select loop consume one packet per notification, so with edge
+ * triggering the reactor keeps calling back while bytes are pending. After a bounded number
+ * of rounds the fd is re-armed instead, which queues a fresh edge and keeps the shard fair.
+ */
+static void DispatchReadEvent(int32_t fd, uint32_t seq)
+{
+    for (int32_t round = 0; round < REACTOR_MAX_DRAIN_ROUND; round++) {
+        ListenerModule module;
+        if (!CheckEventValid(fd, seq, TRIGGER_BIT_READ, &module)) {
+            return;
+        }
+        (void)g_reactorMgr.proc(module, fd, SOFTBUS_SOCKET_IN);
+        int32_t pending = 0;
+        if (ioctl(fd, FIONREAD, &pending) != 0 || pending <= 0) {
+            return;
+        }
+    }
+    RearmFd(fd, seq);
+}
+
+static void DispatchEvent(const struct epoll_event *ev)
+{
+    int32_t fd = (int32_t)(ev->data.u64 & EVENT_DATA_FD_MASK);
+    uint32_t seq = (uint32_t)(ev->data.u64 >> EVENT_DATA_SEQ_SHIFT);
+    ListenerModule module;
+
+    if ((ev->events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0) {
+        DispatchReadEvent(fd, seq);
+    }
+    if ((ev->events & EPOLLOUT) != 0 && CheckEventValid(fd, seq, TRIGGER_BIT_WRITE, &module)) {
+        (void)g_reactorMgr.proc(module, fd, SOFTBUS_SOCKET_OUT);
+    }
+    if ((ev->events & EPOLLPRI) != 0 && CheckEventValid(fd, seq, TRIGGER_BIT_EXCEPT, &module)) {
+        (void)g_reactorMgr.proc(module, fd, SOFTBUS_SOCKET_EXCEPTION);
+    }
+}
+
+static int32_t ReactorThread(void *arg)
+{
+    Reactor *reactor = (Reactor *)arg;
+    int32_t nEvents = epoll_wait(reactor->epollFd, reactor->events, REACTOR_MAX_EVENTS, REACTOR_WAIT_TIMEOUT_MS);
+    if (nEvents < 0) {
+        if (errno == EINTR) {
+            return SOFTBUS_OK;
+        }
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_wait failed, reactor=%d, errno=%d",
+            reactor->index, errno);
+        return SOFTBUS_TCP_SOCKET_ERR;
+    }
+    for (int32_t i = 0; i < nEvents; i++) {
+        DispatchEvent(&reactor->events[i]);
+    }
+    return SOFTBUS_OK;
+}
+
+static void CloseReactors(int32_t num)
+{
+    for (int32_t i = 0; i < num; i++) {
+        if (g_reactorMgr.reactors[i].epollFd >= 0) {
+            (void)close(g_reactorMgr.reactors[i].epollFd);
+            g_reactorMgr.reactors[i].epollFd = -1;
+        }
+    }
+}
+
+int32_t ListenerReactorInit(int32_t threadNum, ReactorEventProc proc)
+{
+    if (g_reactorMgr.inited) {
+        return SOFTBUS_OK;
+    }
+    if (threadNum <= 0 || proc == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (threadNum > MAX_LISTENER_REACTOR_NUM) {
+        threadNum = MAX_LISTENER_REACTOR_NUM;
+    }
+    for (int32_t i = 0; i < threadNum; i++) {
+        g_reactorMgr.reactors[i].index = i;
+        g_reactorMgr.reactors[i].epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (g_reactorMgr.reactors[i].epollFd < 0) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_create1 failed, errno=%d", errno);
+            CloseReactors(i);
+            return SOFTBUS_TCP_SOCKET_ERR;
+        }
+    }
+    if (SoftBusMutexInit(&g_reactorMgr.lock, NULL) != SOFTBUS_OK) {
+        CloseReactors(threadNum);
+        return SOFTBUS_LOCK_ERR;
+    }
+    g_reactorMgr.reactorNum = threadNum;
+    g_reactorMgr.proc = proc;
+    g_reactorMgr.pool = ThreadPoolInit(threadNum, threadNum);
+    if (g_reactorMgr.pool == NULL) {
+        (void)SoftBusMutexDestroy(&g_reactorMgr.lock);
+        CloseReactors(threadNum);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    for (int32_t i = 0; i < threadNum; i++) {
+        if (ThreadPoolAddJob(g_reactorMgr.pool, ReactorThread, &g_reactorMgr.reactors[i],
+            PERSISTENT, (uintptr_t)&g_reactorMgr.reactors[i]) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "start reactor %d failed", i);
+            (void)ThreadPoolDestroy(g_reactorMgr.pool);
+            g_reactorMgr.pool = NULL;
+            (void)SoftBusMutexDestroy(&g_reactorMgr.lock);
+            CloseReactors(threadNum);
+            return SOFTBUS_ERR;
+        }
+    }
+    g_reactorMgr.inited = true;
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "listener reactor started, threadNum=%d", threadNum);
+    return SOFTBUS_OK;
+}
+
+bool ListenerReactorIsEnabled(void)
+{
+    return g_reactorMgr.inited;
+}
+
+int32_t ListenerReactorAddFd(ListenerModule module, int32_t fd, TriggerType triggerType, bool *isNewFd)
+{
+    uint32_t bits = TriggerToBits(triggerType);
+    if (!g_reactorMgr.inited || fd < 0 || bits == 0 || isNewFd == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return SOFTBUS_LOCK_ERR;
+    }
+    ReactorFdEntry *entry = GetFdEntry(fd, true);
+    if (entry == NULL) {
+        (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    *isNewFd = (entry->triggers == 0);
+    if (!(*isNewFd) && entry->module != module) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "fd=%d already owned by module %d", fd, entry->module);
+        (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+        return SOFTBUS_ALREADY_EXISTED;
+    }
+    if (!(*isNewFd) && (entry->triggers & bits) == bits) {
+        (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+        return SOFTBUS_OK;
+    }
+    ReactorFdEntry newEntry = *entry;
+    newEntry.triggers |= bits;
+    newEntry.module = module;
+    if (*isNewFd) {
+        newEntry.seq = ++g_reactorMgr.nextSeq;
+    }
+    int32_t ret = ReactorCtl((*isNewFd) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &newEntry);
+    if (ret == SOFTBUS_OK) {
+        *entry = newEntry;
+    }
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+    return ret;
+}
+
+int32_t ListenerReactorDelFd(int32_t fd, TriggerType triggerType, bool *isRemoved)
+{
+    uint32_t bits = TriggerToBits(triggerType);
+    if (!g_reactorMgr.inited || fd < 0 || bits == 0 || isRemoved == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    *isRemoved = false;
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return SOFTBUS_LOCK_ERR;
+    }
+    ReactorFdEntry *entry = GetFdEntry(fd, false);
+    if (entry == NULL || entry->triggers == 0) {
+        (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+        return SOFTBUS_NOT_FIND;
+    }
+    entry->triggers &= ~bits;
+    if (entry->triggers != 0) {
+        int32_t ret = ReactorCtl(EPOLL_CTL_MOD, fd, entry);
+        (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+        return ret;
+    }
+    /* the fd may already be closed by its owner, which removes it from epoll implicitly */
+    (void)epoll_ctl(GetReactorByFd(fd)->epollFd, EPOLL_CTL_DEL, fd, NULL);
+    *isRemoved = true;
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+    return SOFTBUS_OK;
+}
+
+bool ListenerReactorIsFdExist(int32_t fd)
+{
+    if (!g_reactorMgr.inited || fd < 0) {
+        return false;
+    }
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return false;
+    }
+    ReactorFdEntry *entry = GetFdEntry(fd, false);
+    bool exist = (entry != NULL && entry->triggers != 0);
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+    return exist;
+}
+
+void ListenerReactorClearModule(ListenerModule module, int32_t keepFd)
+{
+    if (!g_reactorMgr.inited) {
+        return;
+    }
+    if (SoftBusMutexLock(&g_reactorMgr.lock) != SOFTBUS_OK) {
+        return;
+    }
+    for (int32_t fd = 0; fd < g_reactorMgr.fdTableSize; fd++) {
+        ReactorFdEntry *entry = &g_reactorMgr.fdTable[fd];
+        if (fd == keepFd || entry->triggers == 0 || entry->module != module) {
+            continue;
+        }
+        (void)epoll_ctl(GetReactorByFd(fd)->epollFd, EPOLL_CTL_DEL, fd, NULL);
+        entry->triggers = 0;
+    }
+    (void)SoftBusMutexUnlock(&g_reactorMgr.lock);
+}
+
+#else /* SOFTBUS_LISTENER_EPOLL */
+
+int32_t ListenerReactorInit(int32_t threadNum, ReactorEventProc proc)
+{
+    (void)proc;
+    if (threadNum <= 0) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "listener reactor not supported, use select");
+    return SOFTBUS_NOT_IMPLEMENT;
+}
+
+bool ListenerReactorIsEnabled(void)
+{
+    return false;
+}
+
+int32_t ListenerReactorAddFd(ListenerModule module, int32_t fd, TriggerType triggerType, bool *isNewFd)
+{
+    (void)module;
+    (void)fd;
+    (void)triggerType;
+    (void)isNewFd;
+    return SOFTBUS_NOT_IMPLEMENT;
+}
+
+int32_t ListenerReactorDelFd(int32_t fd, TriggerType triggerType, bool *isRemoved)
+{
+    (void)fd;
+    (void)triggerType;
+    (void)isRemoved;
+    return SOFTBUS_NOT_IMPLEMENT;
+}
+
+bool ListenerReactorIsFdExist(int32_t fd)
+{
+    (void)fd;
+    return false;
+}
+
+void ListenerReactorClearModule(ListenerModule module, int32_t keepFd)
+{
+    (void)module;
+    (void)keepFd;
+}
+
+#endif /* SOFTBUS_LISTENER_EPOLL */
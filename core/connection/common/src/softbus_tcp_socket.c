@@ -278,6 +278,12 @@ ssize_t SendTcpData(int32_t fd, const char *buf, size_t len, int32_t timeout)
     while (1) {
         ssize_t rc = TEMP_FAILURE_RETRY(SoftBusSocketSend(fd, &buf[bytes], len - bytes, 0));
         if (rc == SOFTBUS_ADAPTER_SOCKET_EAGAIN) {
+            err = WaitEvent(fd, SOFTBUS_SOCKET_OUT, timeout);
+            if (err <= 0) {
+                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "send data wait event fail %d", err);
+                bytes = (bytes == 0) ? -1 : bytes;
+                break;
+            }
             continue;
         } else if (rc <= 0) {
             if (bytes == 0) {
@@ -291,14 +297,63 @@ ssize_t SendTcpData(int32_t fd, const char *buf, size_t len, int32_t timeout)
             break;
         }
 
+        /* a timeout is a failure too, the partial send is reported and the caller gives up */
         err = WaitEvent(fd, SOFTBUS_SOCKET_OUT, timeout);
-        if (err == 0) {
+        if (err <= 0) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "send data wait event fail %d", err);
+            break;
+        }
+    }
+    return bytes;
+}
+
+static void ConsumeIov(SoftBusIovec **iov, int32_t *iovCnt, size_t sent)
+{
+    while (*iovCnt > 0 && sent >= (*iov)->iovLen) {
+        sent -= (*iov)->iovLen;
+        (*iov)++;
+        (*iovCnt)--;
+    }
+    if (*iovCnt > 0) {
+        (*iov)->iovBase = (char *)(*iov)->iovBase + sent;
+        (*iov)->iovLen -= (uint32_t)sent;
+    }
+}
+
+ssize_t SendTcpDataIov(int32_t fd, SoftBusIovec *iov, int32_t iovCnt, int32_t timeout)
+{
+    if (fd < 0 || iov == NULL || iovCnt <= 0 || iovCnt > SOFTBUS_IOV_MAX) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "fd=%d invalid params", fd);
+        return -1;
+    }
+
+    if (timeout == 0) {
+        timeout = USER_TIMEOUT_MS;
+    }
+
+    /* try the send first, a writable socket needs no select before it */
+    ssize_t bytes = 0;
+    while (1) {
+        ssize_t rc = TEMP_FAILURE_RETRY(SoftBusSocketSendIov(fd, iov, iovCnt));
+        if (rc == SOFTBUS_ADAPTER_SOCKET_EAGAIN) {
+            /* a timeout fails the send too, instead of retrying for ever */
+            int err = WaitEvent(fd, SOFTBUS_SOCKET_OUT, timeout);
+            if (err <= 0) {
+                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "send iov wait event fail %d", err);
+                bytes = (bytes == 0) ? -1 : bytes;
+                break;
+            }
             continue;
-        } else if (err < 0) {
+        } else if (rc <= 0) {
             if (bytes == 0) {
-                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "send data wait event fail %d", err);
-                bytes = err;
+                bytes = -1;
             }
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "tcp send iov fail %d %d", rc, errno);
+            break;
+        }
+        bytes += rc;
+        ConsumeIov(&iov, &iovCnt, (size_t)rc);
+        if (iovCnt == 0) {
             break;
         }
     }
@@ -335,6 +390,11 @@ ssize_t RecvTcpData(int32_t fd, char *buf, size_t len, int32_t timeout)
     return OnRecvData(fd, buf, len, timeout, 0);
 }
 
+ssize_t RecvTcpDataNonBlock(int32_t fd, char *buf, size_t len)
+{
+    return OnRecvData(fd, buf, len, 0, SOFTBUS_MSG_DONTWAIT);
+}
+
 void CloseTcpFd(int32_t fd)
 {
     if (fd >= 0) {
@@ -22,6 +22,7 @@
 #include <sys/uio.h>
 
 #include "softbus_adapter_errcode.h"
+#include "softbus_adapter_socket.h"
 #ifdef __cplusplus
 #if __cplusplus
 extern "C" {
@@ -53,7 +54,11 @@ int32_t OpenTcpServerSocket(const char *ip, int32_t port);
 int32_t OpenTcpClientSocket(const char *peerIp, const char *myIp, int32_t port, bool isNonBlock);
 int32_t GetTcpSockPort(int32_t fd);
 ssize_t SendTcpData(int32_t fd, const char *buf, size_t len, int32_t timeout);
+/* Same as SendTcpData for the concatenation of iov, without copying it into one buffer. iov is consumed. */
+ssize_t SendTcpDataIov(int32_t fd, SoftBusIovec *iov, int32_t iovCnt, int32_t timeout);
 ssize_t RecvTcpData(int32_t fd, char *buf, size_t len, int32_t timeout);
+/* return 0 when nothing is readable now, -1 when the peer closed or the socket failed */
+ssize_t RecvTcpDataNonBlock(int32_t fd, char *buf, size_t len);
 void CloseTcpFd(int32_t fd);
 void TcpShutDown(int32_t fd);
 int32_t ConnSetTcpKeepAlive(int32_t fd, int32_t seconds);
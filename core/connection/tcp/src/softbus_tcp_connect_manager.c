@@ -33,6 +33,8 @@
 
 #define INVALID_DATA (-1)
 #define AUTH_P2P_KEEP_ALIVE_TIME 10
+#define TCP_MAX_FRAMES_PER_EVENT 16
+#define TCP_RECV_BUF_KEEP_SIZE 4096
 
 static int32_t g_tcpMaxConnNum;
 static int32_t g_tcpTimeOut;
@@ -43,12 +45,30 @@ typedef struct {
     SoftbusBaseListener listener;
 } TcpListenerItem;
 
+typedef enum {
+    TCP_RECV_HEAD,
+    TCP_RECV_BODY,
+} TcpRecvState;
+
+/*
+ * per connection reassembly buffer, it holds a header while idle, grows to the frame being received
+ * and is shrunk again after a frame bigger than TCP_RECV_BUF_KEEP_SIZE
+ */
+typedef struct {
+    TcpRecvState state;
+    uint32_t frameLen;
+    uint32_t recvLen;
+    uint32_t bufSize;
+    char *buf;
+} TcpRecvBuf;
+
 typedef struct TcpConnInfoNode {
     ListNode node;
     uint32_t connectionId;
     ConnectionInfo info;
     ConnectResult result;
     uint32_t requestId;
+    TcpRecvBuf *recvBuf;
 } TcpConnInfoNode;
 
 static SoftBusList *g_tcpConnInfoList = NULL;
@@ -62,6 +82,21 @@ static int32_t TcpOnConnectEvent(ListenerModule module, int32_t events, int32_t
 static int32_t TcpOnDataEvent(int32_t events, int32_t fd);
 static SoftbusBaseListener *CheckTcpListener(ListenerModule moduleId);
 
+static void FreeTcpRecvBuf(TcpRecvBuf *recvBuf)
+{
+    if (recvBuf == NULL) {
+        return;
+    }
+    SoftBusFree(recvBuf->buf);
+    SoftBusFree(recvBuf);
+}
+
+static void FreeTcpConnInfoNode(TcpConnInfoNode *item)
+{
+    FreeTcpRecvBuf(item->recvBuf);
+    SoftBusFree(item);
+}
+
 int32_t TcpGetConnNum(void)
 {
     if (g_tcpConnInfoList == NULL) {
@@ -118,7 +153,7 @@ static void DelTcpConnInfo(uint32_t connectionId)
             g_tcpConnInfoList->cnt--;
             (void)SoftBusMutexUnlock(&g_tcpConnInfoList->lock);
             g_tcpConnCallback->OnDisconnected(connectionId, &item->info);
-            SoftBusFree(item);
+            FreeTcpConnInfoNode(item);
             return;
         }
     }
@@ -143,7 +178,7 @@ static void DelTcpConnNode(uint32_t connectionId)
             ListDelete(&item->node);
             g_tcpConnInfoList->cnt--;
             (void)SoftBusMutexUnlock(&g_tcpConnInfoList->lock);
-            SoftBusFree(item);
+            FreeTcpConnInfoNode(item);
             return;
         }
     }
@@ -194,36 +229,145 @@ EXIT:
     return SOFTBUS_ERR;
 }
 
-static char *RecvData(const ConnPktHead *head, int32_t fd, uint32_t len)
+static TcpRecvBuf *CreateTcpRecvBuf(void)
 {
-    uint32_t headSize = sizeof(ConnPktHead);
-    uint32_t recvLen = 0;
-    if (len > g_tcpMaxLen) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data out of max data length, shutdown");
+    TcpRecvBuf *recvBuf = (TcpRecvBuf *)SoftBusCalloc(sizeof(TcpRecvBuf));
+    if (recvBuf == NULL) {
         return NULL;
     }
-    char *data = (char *)SoftBusCalloc(headSize + len);
-    if (data == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data malloc err");
+    recvBuf->bufSize = sizeof(ConnPktHead);
+    recvBuf->buf = (char *)SoftBusMalloc(recvBuf->bufSize);
+    if (recvBuf->buf == NULL) {
+        SoftBusFree(recvBuf);
         return NULL;
     }
-    if (memcpy_s(data, headSize, head, headSize) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data copy head failed");
-        goto EXIT;
+    recvBuf->state = TCP_RECV_HEAD;
+    recvBuf->frameLen = sizeof(ConnPktHead);
+    recvBuf->recvLen = 0;
+    return recvBuf;
+}
+
+/*
+ * Detach the receive buffer of connectionId so it can be filled without holding the list lock.
+ * Only the listener thread owning the fd takes it, and it is handed back by PutTcpRecvBuf.
+ */
+static TcpRecvBuf *TakeTcpRecvBuf(uint32_t connectionId)
+{
+    if (g_tcpConnInfoList == NULL) {
+        return NULL;
+    }
+    if (SoftBusMutexLock(&g_tcpConnInfoList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
+        return NULL;
+    }
+    TcpRecvBuf *recvBuf = NULL;
+    TcpConnInfoNode *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
+        if (item->connectionId == connectionId) {
+            recvBuf = (item->recvBuf != NULL) ? item->recvBuf : CreateTcpRecvBuf();
+            item->recvBuf = NULL;
+            break;
+        }
+    }
+    (void)SoftBusMutexUnlock(&g_tcpConnInfoList->lock);
+    return recvBuf;
+}
+
+static void PutTcpRecvBuf(uint32_t connectionId, TcpRecvBuf *recvBuf)
+{
+    if (SoftBusMutexLock(&g_tcpConnInfoList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "%s:lock failed", __func__);
+        FreeTcpRecvBuf(recvBuf);
+        return;
     }
-    while (recvLen < len) {
-        ssize_t n = RecvTcpData(fd, data + headSize + recvLen, len - recvLen, g_tcpTimeOut);
+    TcpConnInfoNode *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
+        if (item->connectionId == connectionId && item->recvBuf == NULL) {
+            item->recvBuf = recvBuf;
+            (void)SoftBusMutexUnlock(&g_tcpConnInfoList->lock);
+            return;
+        }
+    }
+    (void)SoftBusMutexUnlock(&g_tcpConnInfoList->lock);
+    FreeTcpRecvBuf(recvBuf);
+}
+
+/* replace the buffer by one of bufSize bytes, keeping the recvLen bytes already received */
+static int32_t ResizeTcpRecvBuf(TcpRecvBuf *recvBuf, uint32_t bufSize)
+{
+    char *buf = (char *)SoftBusMalloc(bufSize);
+    if (buf == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "malloc tcp recv buf failed, size = %u", bufSize);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    if (recvBuf->recvLen > 0 && memcpy_s(buf, bufSize, recvBuf->buf, recvBuf->recvLen) != EOK) {
+        SoftBusFree(buf);
+        return SOFTBUS_MEM_ERR;
+    }
+    SoftBusFree(recvBuf->buf);
+    recvBuf->buf = buf;
+    recvBuf->bufSize = bufSize;
+    return SOFTBUS_OK;
+}
+
+static int32_t OnTcpHeadReceived(TcpRecvBuf *recvBuf)
+{
+    const ConnPktHead *head = (const ConnPktHead *)recvBuf->buf;
+    if (head->len > g_tcpMaxLen) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data out of max data length, shutdown");
+        return SOFTBUS_CONN_MANAGER_PKT_LEN_INVALID;
+    }
+    uint32_t frameLen = sizeof(ConnPktHead) + head->len;
+    if (frameLen > recvBuf->bufSize && ResizeTcpRecvBuf(recvBuf, frameLen) != SOFTBUS_OK) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    recvBuf->state = TCP_RECV_BODY;
+    recvBuf->frameLen = frameLen;
+    return SOFTBUS_OK;
+}
+
+/*
+ * Consume only what is readable right now and dispatch every complete frame. A partial frame
+ * stays in recvBuf until the next readable event, so a slow peer never blocks the listener.
+ */
+static int32_t TcpRecvFrames(uint32_t connectionId, int32_t fd, TcpRecvBuf *recvBuf)
+{
+    int32_t frameCnt = 0;
+    while (frameCnt < TCP_MAX_FRAMES_PER_EVENT) {
+        ssize_t n = RecvTcpDataNonBlock(fd, recvBuf->buf + recvBuf->recvLen, recvBuf->frameLen - recvBuf->recvLen);
         if (n < 0) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
-                "receiveData: error occurred![recvLen=%d][len=%d]", recvLen, len);
-            goto EXIT;
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "TcpOnDataEvent Disconnect fd:%d", fd);
+            return SOFTBUS_CONNECTION_ERR_CLOSED;
+        }
+        if (n == 0) {
+            return SOFTBUS_OK;
+        }
+        recvBuf->recvLen += (uint32_t)n;
+        if (recvBuf->recvLen < recvBuf->frameLen) {
+            continue;
         }
-        recvLen += (uint32_t)n;
+        if (recvBuf->state == TCP_RECV_HEAD) {
+            int32_t ret = OnTcpHeadReceived(recvBuf);
+            if (ret != SOFTBUS_OK) {
+                return ret;
+            }
+            if (recvBuf->recvLen < recvBuf->frameLen) {
+                continue;
+            }
+        }
+        const ConnPktHead *head = (const ConnPktHead *)recvBuf->buf;
+        g_tcpConnCallback->OnDataReceived(connectionId, head->module, head->seq, recvBuf->buf,
+            (int32_t)recvBuf->frameLen);
+        recvBuf->state = TCP_RECV_HEAD;
+        recvBuf->frameLen = sizeof(ConnPktHead);
+        recvBuf->recvLen = 0;
+        if (recvBuf->bufSize > TCP_RECV_BUF_KEEP_SIZE) {
+            /* keep the big buffer if the small one cannot be had, it still fits every frame */
+            (void)ResizeTcpRecvBuf(recvBuf, sizeof(ConnPktHead));
+        }
+        frameCnt++;
     }
-    return data;
-EXIT:
-    SoftBusFree(data);
-    return NULL;
+    return SOFTBUS_OK;
 }
 
 static int32_t GetTcpInfoByFd(int32_t fd, TcpConnInfoNode *tcpInfo)
@@ -278,24 +422,19 @@ int32_t TcpOnDataEventOut(int32_t fd)
 int32_t TcpOnDataEventIn(int32_t fd)
 {
     uint32_t connectionId = CalTcpConnectionId(fd);
-    ConnPktHead head;
-    uint32_t headSize = sizeof(ConnPktHead);
-    ssize_t bytes = RecvTcpData(fd, (char *)&head, headSize, g_tcpTimeOut);
-    if (bytes <= 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "TcpOnDataEvent Disconnect fd:%d", fd);
+    TcpRecvBuf *recvBuf = TakeTcpRecvBuf(connectionId);
+    if (recvBuf == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "get recv buf failed, fd:%d", fd);
         DelTcpConnInfo(connectionId);
-        return SOFTBUS_OK;
-    } else if (bytes != (ssize_t)headSize) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Recv Head failed.");
         return SOFTBUS_ERR;
     }
-    char *data = RecvData(&head, fd, head.len);
-    if (data == NULL) {
+    int32_t ret = TcpRecvFrames(connectionId, fd, recvBuf);
+    if (ret != SOFTBUS_OK) {
+        FreeTcpRecvBuf(recvBuf);
         DelTcpConnInfo(connectionId);
-        return SOFTBUS_ERR;
+        return (ret == SOFTBUS_CONNECTION_ERR_CLOSED) ? SOFTBUS_OK : SOFTBUS_ERR;
     }
-    g_tcpConnCallback->OnDataReceived(connectionId, head.module, head.seq, data, (int32_t)(headSize + head.len));
-    SoftBusFree(data);
+    PutTcpRecvBuf(connectionId, recvBuf);
     return SOFTBUS_OK;
 }
 
@@ -331,7 +470,7 @@ static void DelAllConnInfo(ListenerModule moduleId)
             ListDelete(&item->node);
             TcpShutDown(item->info.info.ipInfo.fd);
             g_tcpConnCallback->OnDisconnected(item->connectionId, &item->info);
-            SoftBusFree(item);
+            FreeTcpConnInfoNode(item);
             g_tcpConnInfoList->cnt--;
         }
     }
@@ -444,7 +583,7 @@ int32_t TcpDisconnectDeviceNow(const ConnectOption *option)
             ListDelete(&item->node);
             g_tcpConnInfoList->cnt--;
             g_tcpConnCallback->OnDisconnected(item->connectionId, &item->info);
-            SoftBusFree(item);
+            FreeTcpConnInfoNode(item);
         }
     }
     if (g_tcpConnInfoList->cnt == 0) {
@@ -457,6 +596,7 @@ int32_t TcpDisconnectDeviceNow(const ConnectOption *option)
 int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32_t pid, int32_t flag)
 {
     (void)pid;
+    (void)flag;
     TcpConnInfoNode *item = NULL;
     if (data == NULL || len <= 0) {
         return SOFTBUS_INVALID_PARAM;
@@ -484,7 +624,8 @@ int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32
             "TcpPostBytes failed, connectionId:%08x not found.", connectionId);
         return SOFTBUS_ERR;
     }
-    int32_t bytes = SendTcpData(fd, data, len, flag);
+    /* flag is the priority of the data, not a timeout */
+    int32_t bytes = SendTcpData(fd, data, len, 0);
     SoftBusFree((void*)data);
     if (bytes != len) {
         return SOFTBUS_TCPCONNECTION_SOCKET_ERR;
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DISC_FOUND_CACHE_H
+#define DISC_FOUND_CACHE_H
+
+#include <stdint.h>
+
+#include "softbus_common.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/*
+ * Remembers the last report of each device id and capability bit passed on to subscribers. A report with the same
+ * content inside the window is a duplicate. Not thread safe, callers hold the discovery info list lock.
+ */
+void DiscFoundCacheInit(uint32_t windowMs);
+void DiscFoundCacheDeinit(void);
+/* returns the bits of capabilityBitmap to report, the others repeat a report from less than the window ago */
+uint32_t DiscFoundCacheFilter(const DeviceInfo *device, uint32_t capabilityBitmap, uint64_t nowMs);
+/* a new subscriber of the capability gets the next report of every device */
+void DiscFoundCacheRenew(uint32_t capabilityBit);
+void DiscFoundCacheRenewAll(void);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+#endif /* DISC_FOUND_CACHE_H */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disc_found_cache.h"
+
+#include <string.h>
+
+#include "disc_manager.h"
+#include "securec.h"
+
+#define FOUND_CACHE_SET_NUM 64
+#define FOUND_CACHE_WAY_NUM 4
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+#define HASH_HIGH_SHIFT 32
+
+typedef struct {
+    uint64_t key;     /* hash of device id and capability bit, 0 for a free slot */
+    uint64_t content; /* hash of what subscribers see of the device */
+    uint64_t time;    /* when the report was last passed on */
+    uint32_t gen;     /* generation of the capability at that time */
+} FoundCacheItem;
+
+static FoundCacheItem g_foundCache[FOUND_CACHE_SET_NUM][FOUND_CACHE_WAY_NUM];
+static uint32_t g_capabilityGen[CAPABILITY_MAX_BITNUM];
+static uint32_t g_foundWindow = 0;
+
+static uint64_t HashBytes(uint64_t hash, const void *data, uint32_t len)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (uint32_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t HashString(uint64_t hash, const char *str, uint32_t maxLen)
+{
+    return HashBytes(hash, str, (uint32_t)strnlen(str, maxLen));
+}
+
+static uint64_t HashDeviceContent(const DeviceInfo *device)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    uint32_t addrNum = (device->addrNum < CONNECTION_ADDR_MAX) ? device->addrNum : CONNECTION_ADDR_MAX;
+    hash = HashBytes(hash, device->accountHash, sizeof(device->accountHash));
+    hash = HashBytes(hash, &device->devType, sizeof(device->devType));
+    hash = HashString(hash, device->devName, sizeof(device->devName));
+    hash = HashBytes(hash, &addrNum, sizeof(addrNum));
+    hash = HashBytes(hash, device->addr, addrNum * sizeof(ConnectionAddr));
+    return HashString(hash, device->custData, sizeof(device->custData));
+}
+
+static FoundCacheItem *GetFoundCacheItem(uint64_t key)
+{
+    FoundCacheItem *set = g_foundCache[(key ^ (key >> HASH_HIGH_SHIFT)) % FOUND_CACHE_SET_NUM];
+    FoundCacheItem *victim = &set[0];
+    for (uint32_t i = 0; i < FOUND_CACHE_WAY_NUM; i++) {
+        if (set[i].key == key) {
+            return &set[i];
+        }
+        /* a free slot first, then the one passed on longest ago */
+        if (victim->key != 0 && (set[i].key == 0 || set[i].time < victim->time)) {
+            victim = &set[i];
+        }
+    }
+    (void)memset_s(victim, sizeof(FoundCacheItem), 0, sizeof(FoundCacheItem));
+    victim->key = key;
+    return victim;
+}
+
+uint32_t DiscFoundCacheFilter(const DeviceInfo *device, uint32_t capabilityBitmap, uint64_t nowMs)
+{
+    if (device == NULL || g_foundWindow == 0) {
+        return capabilityBitmap;
+    }
+    uint64_t devHash = HashString(FNV_OFFSET_BASIS, device->devId, sizeof(device->devId));
+    uint64_t content = HashDeviceContent(device);
+    uint32_t result = 0;
+    for (uint32_t bit = 0; bit < CAPABILITY_MAX_BITNUM; bit++) {
+        if ((capabilityBitmap & (1U << bit)) == 0) {
+            continue;
+        }
+        uint64_t key = HashBytes(devHash, &bit, sizeof(bit));
+        key = (key == 0) ? 1 : key;
+        FoundCacheItem *item = GetFoundCacheItem(key);
+        if (item->time != 0 && item->content == content && item->gen == g_capabilityGen[bit] &&
+            nowMs - item->time < g_foundWindow) {
+            continue;
+        }
+        item->content = content;
+        item->gen = g_capabilityGen[bit];
+        /* 0 marks an item that never passed a report on */
+        item->time = (nowMs == 0) ? 1 : nowMs;
+        result |= 1U << bit;
+    }
+    /* bits beyond the ones the manager knows are passed on untouched */
+    return result | (capabilityBitmap & ~((1U << CAPABILITY_MAX_BITNUM) - 1));
+}
+
+void DiscFoundCacheRenew(uint32_t capabilityBit)
+{
+    if (capabilityBit < CAPABILITY_MAX_BITNUM) {
+        g_capabilityGen[capabilityBit]++;
+    }
+}
+
+void DiscFoundCacheRenewAll(void)
+{
+    for (uint32_t bit = 0; bit < CAPABILITY_MAX_BITNUM; bit++) {
+        g_capabilityGen[bit]++;
+    }
+}
+
+void DiscFoundCacheInit(uint32_t windowMs)
+{
+    (void)memset_s(g_foundCache, sizeof(g_foundCache), 0, sizeof(g_foundCache));
+    g_foundWindow = windowMs;
+}
+
+void DiscFoundCacheDeinit(void)
+{
+    (void)memset_s(g_foundCache, sizeof(g_foundCache), 0, sizeof(g_foundCache));
+    g_foundWindow = 0;
+}
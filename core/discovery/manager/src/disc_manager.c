@@ -17,15 +17,21 @@
 #include "common_list.h"
 #include "disc_ble.h"
 #include "disc_coap.h"
+#include "disc_found_cache.h"
 #include "securec.h"
 #include "softbus.h"
 #include "softbus_adapter_mem.h"
 #include "softbus_adapter_thread.h"
+#include "softbus_adapter_timer.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
+#include "softbus_feature_config.h"
 #include "softbus_log.h"
 #include "softbus_utils.h"
 
+#define DISC_MS_PER_SECOND 1000
+#define DISC_USEC_PER_MS 1000
+
 static bool g_isInited = false;
 static SoftBusList *g_publishInfoList = NULL;
 static SoftBusList *g_discoveryInfoList = NULL;
@@ -33,6 +39,7 @@ static DiscoveryFuncInterface *g_discCoapInterface = NULL;
 static DiscoveryFuncInterface *g_discBleInterface = NULL;
 static DiscInnerCallback g_discMgrMediumCb;
 static ListNode g_capabilityList[CAPABILITY_MAX_BITNUM];
+static uint32_t g_foundSeq = 0;
 static const char *g_discModuleMap[] = {
     "MODULE_LNN",
     "MODULE_CONN",
@@ -67,6 +74,8 @@ typedef union  {
 typedef struct {
     ListNode node;
     char packageName[PKG_NAME_SIZE_MAX];
+    bool isInner;
+    uint32_t foundSeq;
     InnerCallback callback;
     uint32_t infoNum;
     ListNode InfoList;
@@ -184,7 +193,7 @@ static void AddInfoToCapability(DiscInfo *info, const ServiceType type)
     if (type == SUBSCRIBE_SERVICE) {
         ListTailInsert(&(g_capabilityList[tmp]), &(info->capNode));
     }
-
+    DiscFoundCacheRenew(tmp);
     return;
 }
 
@@ -214,50 +223,70 @@ static void ReleaseInfoNodeMem(DiscInfo *info, const ServiceType type)
     return;
 }
 
-static void InnerDeviceFound(const DiscInfo *infoNode, const DeviceInfo *device)
+static bool IsInnerPackageName(const char *packageName)
 {
-    uint32_t tmp;
-    bool isInnerInfo = false;
-    for (tmp = 0; tmp < MODULE_MAX; tmp++) {
-        if (strcmp(infoNode->item->packageName, g_discModuleMap[tmp]) != 0) {
-            continue;
+    for (uint32_t tmp = 0; tmp < MODULE_MAX; tmp++) {
+        if (strcmp(packageName, g_discModuleMap[tmp]) == 0) {
+            return true;
         }
-        isInnerInfo = true;
     }
-    if (isInnerInfo == false) {
-        (void)infoNode->item->callback.serverCb.OnServerDeviceFound(infoNode->item->packageName, device);
+    return false;
+}
+
+static void InnerDeviceFound(const DiscItem *itemNode, const DeviceInfo *device)
+{
+    if (itemNode->isInner == false) {
+        (void)itemNode->callback.serverCb.OnServerDeviceFound(itemNode->packageName, device);
         return;
     }
-    if (infoNode->item->callback.innerCb.OnDeviceFound == NULL) {
+    if (itemNode->callback.innerCb.OnDeviceFound == NULL) {
         SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_ERROR, "OnDeviceFound not regist");
         return;
     }
     bool isCallLnn = GetCallLnnStatus();
     if (isCallLnn) {
-        infoNode->item->callback.innerCb.OnDeviceFound(device);
+        itemNode->callback.innerCb.OnDeviceFound(device);
     }
 }
 
+static uint64_t GetNowMs(void)
+{
+    SoftBusSysTime now = {0};
+    (void)SoftBusGetTime(&now);
+    return (uint64_t)now.sec * DISC_MS_PER_SECOND + (uint64_t)now.usec / DISC_USEC_PER_MS;
+}
+
 static void DiscOnDeviceFound(const DeviceInfo *device)
 {
     uint32_t tmp;
     DiscInfo *infoNode = NULL;
+    if (SoftBusMutexLock(&(g_discoveryInfoList->lock)) != 0) {
+        SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    uint32_t bitmap = DiscFoundCacheFilter(device, device->capabilityBitmap[0], GetNowMs());
+    if (bitmap == 0) {
+        (void)SoftBusMutexUnlock(&(g_discoveryInfoList->lock));
+        return;
+    }
     SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_INFO, "Server OnDeviceFound capabilityBitmap = %d",
         device->capabilityBitmap[0]);
+    /* a subscriber hears of the device once, however many of its capabilities match */
+    g_foundSeq++;
     for (tmp = 0; tmp < CAPABILITY_MAX_BITNUM; tmp++) {
-        if (IsBitmapSet((uint32_t *)&(device->capabilityBitmap[0]), tmp) == false) {
+        if (IsBitmapSet(&bitmap, tmp) == false) {
             continue;
         }
-        if (SoftBusMutexLock(&(g_discoveryInfoList->lock)) != 0) {
-            SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_ERROR, "lock failed");
-            return;
-        }
         LIST_FOR_EACH_ENTRY(infoNode, &(g_capabilityList[tmp]), DiscInfo, capNode) {
+            if (infoNode->item->foundSeq == g_foundSeq) {
+                continue;
+            }
+            infoNode->item->foundSeq = g_foundSeq;
             SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_INFO, "find callback:id = %d", infoNode->id);
-            InnerDeviceFound(infoNode, device);
+            InnerDeviceFound(infoNode->item, device);
         }
-        (void)SoftBusMutexUnlock(&(g_discoveryInfoList->lock));
     }
+    (void)SoftBusMutexUnlock(&(g_discoveryInfoList->lock));
     return;
 }
 
@@ -359,6 +388,7 @@ static DiscItem *CreateNewItem(SoftBusList *serviceList, const char *packageName
         return NULL;
     }
     itemNode->infoNum = 0;
+    itemNode->isInner = IsInnerPackageName(packageName);
     if ((type == PUBLISH_INNER_SERVICE) || (type == SUBSCRIBE_INNER_SERVICE)) {
         ListNodeInsert(&(serviceList->list), &(itemNode->node));
     }
@@ -671,6 +701,7 @@ static int32_t InnerSetDiscoverCallback(const char *packageName, const DiscInner
         isIdExist = true;
         break;
     }
+    DiscFoundCacheRenewAll();
     if (isIdExist == false) {
         callback.innerCb.OnDeviceFound = cb->OnDeviceFound;
         itemNode = CreateNewItem(g_discoveryInfoList, packageName, &callback, SUBSCRIBE_INNER_SERVICE);
@@ -1070,6 +1101,13 @@ int32_t DiscMgrInit(void)
     for (int32_t i = 0; i < CAPABILITY_MAX_BITNUM; i++) {
         ListInit(&g_capabilityList[i]);
     }
+    int32_t foundWindow = 0;
+    if (SoftbusGetConfig(SOFTBUS_INT_DISC_FOUND_DEDUP_WINDOW, (unsigned char *)&foundWindow,
+        sizeof(foundWindow)) != SOFTBUS_OK || foundWindow < 0) {
+        SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_WARN, "get found dedup window fail, dedup is off");
+        foundWindow = 0;
+    }
+    DiscFoundCacheInit((uint32_t)foundWindow);
 
     g_isInited = true;
     SoftBusLog(SOFTBUS_LOG_DISC, SOFTBUS_LOG_INFO, "init success");
@@ -1119,6 +1157,7 @@ void DiscMgrDeinit(void)
     g_discBleInterface = NULL;
     DiscCoapDeinit();
     DiscBleDeinit();
+    DiscFoundCacheDeinit();
     g_isInited = false;
 }
 
@@ -16,6 +16,9 @@
 #ifndef SOFTBUS_SERVER_H_
 #define SOFTBUS_SERVER_H_
 
+#include <string>
+#include <vector>
+
 #include "softbus_server_stub.h"
 #include "softbus_common.h"
 #include "system_ability.h"
@@ -60,6 +63,7 @@ public:
     int32_t ActiveMetaNode(const MetaNodeConfigInfo *info, char *metaNodeId) override;
     int32_t DeactiveMetaNode(const char *metaNodeId) override;
     int32_t GetAllMetaNodeInfo(MetaNodeInfo *info, int32_t *infoNum) override;
+    int Dump(int fd, const std::vector<std::u16string> &args) override;
 
 protected:
     void OnStart() override;
@@ -18,6 +18,7 @@
 #include "ipc_skeleton.h"
 #include "ipc_types.h"
 #include "lnn_bus_center_ipc.h"
+#include "message_handler.h"
 #include "securec.h"
 #include "softbus_client_info_manager.h"
 #include "softbus_conn_interface.h"
@@ -246,6 +247,17 @@ int32_t SoftBusServer::GetAllMetaNodeInfo(MetaNodeInfo *info, int32_t *infoNum)
     return LnnIpcGetAllMetaNodeInfo(info, infoNum);
 }
 
+int SoftBusServer::Dump(int fd, const std::vector<std::u16string> &args)
+{
+    (void)args;
+    if (fd < 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "SoftBusServer dump invalid fd");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    DumpLooperStats(fd);
+    return SOFTBUS_OK;
+}
+
 void SoftBusServer::OnStart()
 {
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "SoftBusServer OnStart called!\n");
@@ -33,13 +33,20 @@ enum {
     PENDING_TYPE_BUTT,
 };
 
+/* result is SOFTBUS_OK once the peer acked seq, or the reason the packet was given up */
+typedef void (*PendingPktDoneCb)(int32_t channelId, int32_t seq, int32_t result, void *cbArg);
+
 typedef struct {
     ListNode node;
     SoftBusCond cond;
-    SoftBusMutex lock;
     int32_t channelId;
     int32_t seq;
     bool finded;
+    bool isClosed;
+    PendingPktDoneCb onDone; /* NULL for packets waited in ProcPendingPacket */
+    void *cbArg;
+    int32_t timeout;
+    int32_t result;
 } PendingPktInfo;
 
 int32_t PendingInit(int type);
@@ -48,6 +55,14 @@ int32_t ProcPendingPacket(int32_t channelId, int32_t seqNum, int type);
 int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type);
 int32_t DelPendingPacket(int32_t channelId, int type);
 
+/*
+ * Register seqNum before it is sent, onDone is called once it is acked, times out or the channel
+ * is closed. Blocks while the channel already has the configured number of packets in flight.
+ */
+int32_t AddAsyncPendingPacket(int32_t channelId, int32_t seqNum, int type, PendingPktDoneCb onDone, void *cbArg);
+/* Drop a packet that could not be sent, onDone is not called. */
+void RemoveAsyncPendingPacket(int32_t channelId, int32_t seqNum, int type);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
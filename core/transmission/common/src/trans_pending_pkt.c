@@ -21,13 +21,46 @@
 #include "softbus_adapter_mem.h"
 #include "softbus_adapter_thread.h"
 #include "softbus_errcode.h"
+#include "softbus_feature_config.h"
 #include "softbus_log.h"
 #include "softbus_utils.h"
 
 #define TIME_OUT 2
 #define USECTONSEC 1000
+#define PENDING_CHANNEL_BUCKET_NUM 32
+#define PENDING_WINDOW_DEFAULT 64
+#define PENDING_WINDOW_MAX 512
 
-static SoftBusList *g_pendingList[PENDING_TYPE_BUTT] = {NULL, NULL};
+typedef struct {
+    ListNode node;
+    int32_t channelId;
+    uint32_t asyncCnt;
+    uint32_t windowWaiterCnt;
+    SoftBusCond windowCond;
+    ListNode pktList; /* in send order, so acks and timeouts mostly hit the head */
+} PendingChannel;
+
+typedef struct {
+    SoftBusMutex lock;
+    ListNode buckets[PENDING_CHANNEL_BUCKET_NUM];
+} PendingTable;
+
+static PendingTable *g_pendingTable[PENDING_TYPE_BUTT] = {NULL, NULL};
+static uint32_t g_pendingWindow = PENDING_WINDOW_DEFAULT;
+
+static void PendingTimerProc(void);
+
+static void InitPendingWindow(void)
+{
+    int32_t window = PENDING_WINDOW_DEFAULT;
+    if (SoftbusGetConfig(SOFTBUS_INT_MESSAGE_WINDOW_SIZE, (unsigned char *)&window, sizeof(window)) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "get message window size fail, use default");
+    }
+    if (window <= 0 || window > PENDING_WINDOW_MAX) {
+        window = PENDING_WINDOW_DEFAULT;
+    }
+    g_pendingWindow = (uint32_t)window;
+}
 
 int32_t PendingInit(int type)
 {
@@ -35,136 +68,375 @@ int32_t PendingInit(int type)
         return SOFTBUS_ERR;
     }
 
-    g_pendingList[type] = CreateSoftBusList();
-    if (g_pendingList[type] == NULL) {
+    PendingTable *table = (PendingTable *)SoftBusCalloc(sizeof(PendingTable));
+    if (table == NULL) {
         return SOFTBUS_ERR;
     }
+    if (SoftBusMutexInit(&table->lock, NULL) != SOFTBUS_OK) {
+        SoftBusFree(table);
+        return SOFTBUS_ERR;
+    }
+    for (int32_t i = 0; i < PENDING_CHANNEL_BUCKET_NUM; i++) {
+        ListInit(&table->buckets[i]);
+    }
+    g_pendingTable[type] = table;
+    InitPendingWindow();
+    if (RegisterTimeoutCallback(SOFTBUS_PENDING_PKT_TIMER_FUN, PendingTimerProc) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "register pending timer fail");
+    }
     return SOFTBUS_OK;
 }
 
-void PendingDeinit(int type)
+static PendingTable *GetPendingTable(int type)
 {
     if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "type[%d] illegal.", type);
+        return NULL;
+    }
+    if (g_pendingTable[type] == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pending[%d] list not inited.", type);
+    }
+    return g_pendingTable[type];
+}
+
+static PendingChannel *GetPendingChannel(PendingTable *table, int32_t channelId, bool isCreate)
+{
+    ListNode *bucket = &table->buckets[(uint32_t)channelId % PENDING_CHANNEL_BUCKET_NUM];
+    PendingChannel *channel = NULL;
+    LIST_FOR_EACH_ENTRY(channel, bucket, PendingChannel, node) {
+        if (channel->channelId == channelId) {
+            return channel;
+        }
+    }
+    if (!isCreate) {
+        return NULL;
+    }
+    channel = (PendingChannel *)SoftBusCalloc(sizeof(PendingChannel));
+    if (channel == NULL) {
+        return NULL;
+    }
+    if (SoftBusCondInit(&channel->windowCond) != SOFTBUS_OK) {
+        SoftBusFree(channel);
+        return NULL;
+    }
+    channel->channelId = channelId;
+    ListInit(&channel->pktList);
+    ListAdd(bucket, &channel->node);
+    return channel;
+}
+
+static void TryFreePendingChannel(PendingChannel *channel)
+{
+    if (!IsListEmpty(&channel->pktList) || channel->windowWaiterCnt != 0) {
         return;
     }
+    ListDelete(&channel->node);
+    (void)SoftBusCondDestroy(&channel->windowCond);
+    SoftBusFree(channel);
+}
+
+static PendingPktInfo *GetPendingPkt(const PendingChannel *channel, int32_t seqNum)
+{
+    PendingPktInfo *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &channel->pktList, PendingPktInfo, node) {
+        if (item->seq == seqNum) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+static void UnlinkAsyncPkt(PendingChannel *channel, PendingPktInfo *item)
+{
+    ListDelete(&item->node);
+    channel->asyncCnt--;
+    if (channel->windowWaiterCnt != 0) {
+        (void)SoftBusCondBroadcast(&channel->windowCond);
+    }
+}
+
+/* the callbacks of the packets moved to done run once the table lock is released */
+static void MoveAsyncPktToDone(PendingChannel *channel, PendingPktInfo *item, int32_t result, ListNode *done)
+{
+    UnlinkAsyncPkt(channel, item);
+    item->result = result;
+    ListTailInsert(done, &item->node);
+}
 
-    if (g_pendingList[type] != NULL) {
-        DestroySoftBusList(g_pendingList[type]);
-        g_pendingList[type] = NULL;
+static void NotifyAsyncPktDone(ListNode *done)
+{
+    PendingPktInfo *item = NULL;
+    PendingPktInfo *next = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, done, PendingPktInfo, node) {
+        ListDelete(&item->node);
+        item->onDone(item->channelId, item->seq, item->result, item->cbArg);
+        SoftBusFree(item);
+    }
+}
+
+static void GetPendingDeadline(SoftBusSysTime *outtime)
+{
+    SoftBusSysTime now;
+    SoftBusGetTime(&now);
+    outtime->sec = now.sec + TIME_OUT;
+    outtime->usec = now.usec * USECTONSEC;
+}
+
+static bool IsPendingDeadlinePassed(const SoftBusSysTime *outtime)
+{
+    SoftBusSysTime now;
+    SoftBusGetTime(&now);
+    if (now.sec != outtime->sec) {
+        return now.sec > outtime->sec;
+    }
+    return now.usec * USECTONSEC >= outtime->usec;
+}
+
+void PendingDeinit(int type)
+{
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
+        return;
     }
+
+    ListNode done;
+    ListInit(&done);
+    SoftBusMutexLock(&table->lock);
+    g_pendingTable[type] = NULL;
+    for (int32_t i = 0; i < PENDING_CHANNEL_BUCKET_NUM; i++) {
+        PendingChannel *channel = NULL;
+        PendingChannel *nextChannel = NULL;
+        LIST_FOR_EACH_ENTRY_SAFE(channel, nextChannel, &table->buckets[i], PendingChannel, node) {
+            PendingPktInfo *item = NULL;
+            PendingPktInfo *next = NULL;
+            LIST_FOR_EACH_ENTRY_SAFE(item, next, &channel->pktList, PendingPktInfo, node) {
+                if (item->onDone != NULL) {
+                    MoveAsyncPktToDone(channel, item, SOFTBUS_CONNECTION_ERR_CLOSED, &done);
+                }
+            }
+            TryFreePendingChannel(channel);
+        }
+    }
+    SoftBusMutexUnlock(&table->lock);
+    NotifyAsyncPktDone(&done);
+    SoftBusMutexDestroy(&table->lock);
+    SoftBusFree(table);
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "PendigPackManagerDeinit init ok");
 }
 
 int32_t ProcPendingPacket(int32_t channelId, int32_t seqNum, int type)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
         return SOFTBUS_ERR;
     }
 
-    PendingPktInfo *item;
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pending[%d] list not inited.", type);
-        return SOFTBUS_ERR;
+    SoftBusMutexLock(&table->lock);
+    PendingChannel *channel = GetPendingChannel(table, channelId, true);
+    if (channel == NULL) {
+        SoftBusMutexUnlock(&table->lock);
+        return SOFTBUS_MALLOC_ERR;
     }
-
-    SoftBusMutexLock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->seq == seqNum && item->channelId == channelId) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PendingPacket already Created");
-            SoftBusMutexUnlock(&pendingList->lock);
-            return SOFTBUS_ERR;
-        }
+    if (GetPendingPkt(channel, seqNum) != NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PendingPacket already Created");
+        SoftBusMutexUnlock(&table->lock);
+        return SOFTBUS_ERR;
     }
-    item = (PendingPktInfo *)SoftBusCalloc(sizeof(PendingPktInfo));
-    if (item == NULL) {
-        SoftBusMutexUnlock(&pendingList->lock);
+    PendingPktInfo *item = (PendingPktInfo *)SoftBusCalloc(sizeof(PendingPktInfo));
+    if (item == NULL || SoftBusCondInit(&item->cond) != SOFTBUS_OK) {
+        SoftBusFree(item);
+        TryFreePendingChannel(channel);
+        SoftBusMutexUnlock(&table->lock);
         return SOFTBUS_MALLOC_ERR;
     }
-
-    SoftBusMutexInit(&item->lock, NULL);
-    SoftBusCondInit(&item->cond);
     item->channelId = channelId;
     item->seq = seqNum;
     item->finded = false;
+    ListTailInsert(&channel->pktList, &item->node);
 
-    ListAdd(&pendingList->list, &item->node);
-    pendingList->cnt++;
-    SoftBusMutexUnlock(&pendingList->lock);
-
+    /* the ack flag is set under the table lock, so it can not slip in between the check and the wait */
     SoftBusSysTime outtime;
-    SoftBusSysTime now;
-    SoftBusGetTime(&now);
-    outtime.sec = now.sec + TIME_OUT;
-    outtime.usec = now.usec * USECTONSEC;
-    SoftBusMutexLock(&item->lock);
-    SoftBusCondWait(&item->cond, &item->lock, &outtime);
-
-    int32_t ret = SOFTBUS_OK;
-    if (item->finded != true) {
-        ret = SOFTBUS_TIMOUT;
+    GetPendingDeadline(&outtime);
+    while (!item->finded && !item->isClosed) {
+        if (SoftBusCondWait(&item->cond, &table->lock, &outtime) != SOFTBUS_OK ||
+            IsPendingDeadlinePassed(&outtime)) {
+            break;
+        }
     }
-    SoftBusMutexUnlock(&item->lock);
 
-    SoftBusMutexLock(&pendingList->lock);
+    int32_t ret = item->finded ? SOFTBUS_OK : SOFTBUS_TIMOUT;
     ListDelete(&item->node);
-    SoftBusMutexDestroy(&item->lock);
     SoftBusCondDestroy(&item->cond);
     SoftBusFree(item);
-    pendingList->cnt--;
-    SoftBusMutexUnlock(&pendingList->lock);
-
+    TryFreePendingChannel(channel);
+    SoftBusMutexUnlock(&table->lock);
     return ret;
 }
 
-int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type)
+int32_t AddAsyncPendingPacket(int32_t channelId, int32_t seqNum, int type, PendingPktDoneCb onDone, void *cbArg)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "type[%d] illegal.", type);
+    if (onDone == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
         return SOFTBUS_ERR;
     }
 
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pendind list not exist");
+    SoftBusMutexLock(&table->lock);
+    PendingChannel *channel = GetPendingChannel(table, channelId, true);
+    if (channel == NULL) {
+        SoftBusMutexUnlock(&table->lock);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    SoftBusSysTime outtime;
+    GetPendingDeadline(&outtime);
+    while (channel->asyncCnt >= g_pendingWindow) {
+        channel->windowWaiterCnt++;
+        int32_t ret = SoftBusCondWait(&channel->windowCond, &table->lock, &outtime);
+        channel->windowWaiterCnt--;
+        if (channel->asyncCnt >= g_pendingWindow && (ret != SOFTBUS_OK || IsPendingDeadlinePassed(&outtime))) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "channel[%d] pending window full", channelId);
+            TryFreePendingChannel(channel);
+            SoftBusMutexUnlock(&table->lock);
+            return SOFTBUS_TIMOUT;
+        }
+    }
+    PendingPktInfo *item = (GetPendingPkt(channel, seqNum) != NULL) ? NULL :
+        (PendingPktInfo *)SoftBusCalloc(sizeof(PendingPktInfo));
+    if (item == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "add pending packet[%d] fail", seqNum);
+        TryFreePendingChannel(channel);
+        SoftBusMutexUnlock(&table->lock);
         return SOFTBUS_ERR;
     }
+    item->channelId = channelId;
+    item->seq = seqNum;
+    /* the timer ticks every second, one more tick keeps the wait at least TIME_OUT seconds */
+    item->timeout = TIME_OUT + 1;
+    item->onDone = onDone;
+    item->cbArg = cbArg;
+    ListTailInsert(&channel->pktList, &item->node);
+    channel->asyncCnt++;
+    SoftBusMutexUnlock(&table->lock);
+    return SOFTBUS_OK;
+}
 
-    PendingPktInfo *item = NULL;
-    SoftBusMutexLock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->seq == seqNum && item->channelId == channelId) {
+void RemoveAsyncPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
+        return;
+    }
+
+    SoftBusMutexLock(&table->lock);
+    PendingChannel *channel = GetPendingChannel(table, channelId, false);
+    PendingPktInfo *item = (channel == NULL) ? NULL : GetPendingPkt(channel, seqNum);
+    if (item != NULL && item->onDone != NULL) {
+        UnlinkAsyncPkt(channel, item);
+        SoftBusFree(item);
+        TryFreePendingChannel(channel);
+    }
+    SoftBusMutexUnlock(&table->lock);
+}
+
+int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
+        return SOFTBUS_ERR;
+    }
+
+    ListNode done;
+    ListInit(&done);
+    SoftBusMutexLock(&table->lock);
+    PendingChannel *channel = GetPendingChannel(table, channelId, false);
+    if (channel == NULL) {
+        SoftBusMutexUnlock(&table->lock);
+        return SOFTBUS_ERR;
+    }
+    /*
+     * An ack completes its own seq only: concurrent senders may put seqs on the link out of order, and
+     * the peer drops messages it can not decrypt without acking them, those are left to the timeout.
+     */
+    int32_t ret = SOFTBUS_ERR;
+    PendingPktInfo *item = GetPendingPkt(channel, seqNum);
+    if (item != NULL) {
+        if (item->onDone != NULL) {
+            MoveAsyncPktToDone(channel, item, SOFTBUS_OK, &done);
+        } else {
             item->finded = true;
             SoftBusCondSignal(&item->cond);
-            SoftBusMutexUnlock(&pendingList->lock);
-            return SOFTBUS_OK;
         }
+        ret = SOFTBUS_OK;
     }
-    SoftBusMutexUnlock(&pendingList->lock);
-    return SOFTBUS_ERR;
+    TryFreePendingChannel(channel);
+    SoftBusMutexUnlock(&table->lock);
+    NotifyAsyncPktDone(&done);
+    return ret;
 }
 
 int32_t DelPendingPacket(int32_t channelId, int type)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    PendingTable *table = GetPendingTable(type);
+    if (table == NULL) {
         return SOFTBUS_ERR;
     }
 
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
-        return SOFTBUS_ERR;
+    ListNode done;
+    ListInit(&done);
+    SoftBusMutexLock(&table->lock);
+    PendingChannel *channel = GetPendingChannel(table, channelId, false);
+    if (channel != NULL) {
+        PendingPktInfo *item = NULL;
+        PendingPktInfo *next = NULL;
+        LIST_FOR_EACH_ENTRY_SAFE(item, next, &channel->pktList, PendingPktInfo, node) {
+            if (item->onDone != NULL) {
+                MoveAsyncPktToDone(channel, item, SOFTBUS_CONNECTION_ERR_CLOSED, &done);
+            } else {
+                item->isClosed = true;
+                SoftBusCondSignal(&item->cond);
+            }
+        }
+        TryFreePendingChannel(channel);
     }
+    SoftBusMutexUnlock(&table->lock);
+    NotifyAsyncPktDone(&done);
+    return SOFTBUS_OK;
+}
 
-    PendingPktInfo *item = NULL;
-    SoftBusMutexLock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->channelId == channelId) {
-            SoftBusCondSignal(&item->cond);
-            SoftBusMutexUnlock(&pendingList->lock);
-            return SOFTBUS_OK;
+static void PendingTableTimeout(PendingTable *table, ListNode *done)
+{
+    for (int32_t i = 0; i < PENDING_CHANNEL_BUCKET_NUM; i++) {
+        PendingChannel *channel = NULL;
+        PendingChannel *nextChannel = NULL;
+        LIST_FOR_EACH_ENTRY_SAFE(channel, nextChannel, &table->buckets[i], PendingChannel, node) {
+            PendingPktInfo *item = NULL;
+            PendingPktInfo *next = NULL;
+            LIST_FOR_EACH_ENTRY_SAFE(item, next, &channel->pktList, PendingPktInfo, node) {
+                if (item->onDone != NULL && --item->timeout <= 0) {
+                    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "channel[%d] seq[%d] ack timeout",
+                        item->channelId, item->seq);
+                    MoveAsyncPktToDone(channel, item, SOFTBUS_TIMOUT, done);
+                }
+            }
+            TryFreePendingChannel(channel);
         }
     }
-    SoftBusMutexUnlock(&pendingList->lock);
-    return SOFTBUS_OK;
 }
 
+static void PendingTimerProc(void)
+{
+    for (int type = PENDING_TYPE_PROXY; type < PENDING_TYPE_BUTT; type++) {
+        PendingTable *table = g_pendingTable[type];
+        if (table == NULL) {
+            continue;
+        }
+        ListNode done;
+        ListInit(&done);
+        SoftBusMutexLock(&table->lock);
+        PendingTableTimeout(table, &done);
+        SoftBusMutexUnlock(&table->lock);
+        NotifyAsyncPktDone(&done);
+    }
+}
@@ -48,6 +48,7 @@ typedef enum {
 #define JSON_KEY_PKG_NAME "PKG_NAME"
 #define JSON_KEY_SESSION_KEY "SESSION_KEY"
 #define JSON_KEY_REQUEST_ID "REQUEST_ID"
+#define JSON_KEY_MAX_SLICE_LEN "MAX_SLICE_LEN"
 
 typedef struct {
     uint8_t type; // MsgType
@@ -107,6 +108,7 @@ typedef struct {
     char identity[IDENTITY_LEN + 1];
     AppInfo appInfo;
     int32_t chiperSide;
+    uint32_t peerSliceLen;
 } ProxyChannelInfo;
 
 typedef struct {
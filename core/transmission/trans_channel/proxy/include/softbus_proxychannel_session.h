@@ -16,9 +16,16 @@
 #ifndef SOFTBUS_PROXYCHANNEL_SESSION_H
 #define SOFTBUS_PROXYCHANNEL_SESSION_H
 #include "stdint.h"
+#include "softbus_adapter_crypto.h"
 #include "softbus_def.h"
 #include "softbus_proxychannel_message.h"
 
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
 typedef enum {
     PROXY_FLAG_BYTES = 0,
     PROXY_FLAG_ACK = 1,
@@ -38,13 +45,55 @@ typedef enum {
     PROXY_CHANNEL_PRORITY_BUTT = 3,
 } ProxyChannelPriority;
 
+typedef struct {
+    char *buf;
+    int32_t len;
+} ProxySliceFrame;
+
+typedef struct {
+    const unsigned char *data;
+    uint32_t len;
+    int32_t seq;
+    ProxyPacketType flag;
+    uint32_t sliceLen;
+} ProxyPacketInfo;
+
+typedef struct {
+    ProxySliceFrame *frames;
+    SoftBusCryptoIov *iov;
+    int32_t sliceNum;
+    SoftBusCryptoIovDoneCb onSliceReady;
+    void *cbArg;
+} ProxySliceBatch;
+
 int32_t TransProxyPostSessionData(int32_t channelId, const uint8_t *data, uint32_t len, SessionPktType flags);
 int32_t TransOnNormalMsgReceived(const char *pkgName, int32_t channelId, const char *data, uint32_t len);
 int32_t TransOnAuthMsgReceived(const char *pkgName, int32_t channelId, const char *data, uint32_t len);
 int32_t TransProxyDelSliceProcessorByChannelId(int32_t channelId);
+void TransProxyDelCipherCtxByChannelId(int32_t channelId);
 int32_t TransProxyTransNetWorkMsg(ProxyMessageHead *msghead, const ProxyChannelInfo *info,
     const char *payLoad, int payLoadLen, int priority);
 void TransSliceManagerDeInit(void);
 int32_t TransSliceManagerInit(void);
 
+/* largest slice this side takes over the link type, announced to the peer in the handshake */
+uint32_t TransProxyGetLinkSliceLen(ConnectType type);
+/* returns 0 for a value out of range, the channel then keeps the default slice len */
+uint32_t TransProxyCheckPeerSliceLen(int32_t peerSliceLen);
+
+/*
+ * Pack one app packet into batch->sliceNum ready-to-post frames. The packet is encrypted straight into
+ * the frames, so no intermediate packed buffer is built. Without onSliceReady the caller owns every
+ * frames[i].buf on success. onSliceReady gets each slice as soon as it is complete and takes it over.
+ */
+int32_t TransProxyGetPacketSliceNum(uint32_t dataLen, uint32_t sliceLen);
+int32_t TransProxyPackPacketSlices(const ProxyMessageHead *msgHead, SoftBusCipherCtx *cipherCtx,
+    const ProxyPacketInfo *packet, const ProxySliceBatch *batch);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
 #endif
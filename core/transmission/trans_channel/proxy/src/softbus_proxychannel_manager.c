@@ -162,6 +162,7 @@ static int32_t TransProxyUpdateAckInfo(ProxyChannelInfo *info)
     LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if ((item->myId == info->myId) && (strncmp(item->identity, info->identity, sizeof(item->identity)) == 0)) {
             item->peerId = info->peerId;
+            item->peerSliceLen = info->peerSliceLen;
             item->status = PROXY_CHANNEL_STATUS_COMPLETED;
             item->timeout = 0;
             (void)memcpy_s(&(item->appInfo.peerData), sizeof(item->appInfo.peerData),
@@ -262,6 +263,7 @@ void TransProxyDelChanByChanId(int32_t chanlId)
             ListDelete(&(item->node));
             SoftBusFree(item);
             g_proxyChannelList->cnt--;
+            TransProxyDelCipherCtxByChannelId(chanlId);
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "del chan info!");
             (void)SoftBusMutexUnlock(&g_proxyChannelList->lock);
             return;
@@ -301,6 +303,7 @@ static void TransProxyCloseProxyOtherRes(int32_t channelId, const ProxyChannelIn
     if (TransProxyDelSliceProcessorByChannelId(channelId) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "del channel err %d", channelId);
     }
+    TransProxyDelCipherCtxByChannelId(channelId);
 
     if (DelPendingPacket(channelId, PENDING_TYPE_PROXY) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "del pending pkt err %d", channelId);
@@ -731,6 +734,7 @@ void TransProxyProcessResetMsg(const ProxyMessage *msg)
         return;
     }
 
+    TransProxyDelCipherCtxByChannelId(info->channelId);
     if (info->status == PROXY_CHANNEL_STATUS_HANDSHAKEING) {
         OnProxyChannelOpenFailed(info->channelId, &(info->appInfo));
     } else {
@@ -966,6 +970,7 @@ void TransProxyTimerItemProc(const ListNode *proxyProcList)
         ListDelete(&(removeNode->node));
         if (removeNode->status == PROXY_CHANNEL_STATUS_TIMEOUT) {
             connId = removeNode->connId;
+            TransProxyDelCipherCtxByChannelId(removeNode->channelId);
             ProxyChannelInfo *resetMsg = SoftBusMalloc(sizeof(ProxyChannelInfo));
             if (resetMsg != NULL) {
                 (void)memcpy_s(resetMsg, sizeof(ProxyChannelInfo), removeNode, sizeof(ProxyChannelInfo));
@@ -1160,6 +1165,7 @@ void TransProxyDeathCallback(const char *pkgName)
         if (strcmp(item->appInfo.myData.pkgName, pkgName) == 0) {
             TransProxyResetPeer(item);
             (void)TransProxyCloseConnChannel(item->connId);
+            TransProxyDelCipherCtxByChannelId(item->channelId);
             ListDelete(&(item->node));
             SoftBusFree(item);
             g_proxyChannelList->cnt--;
@@ -25,6 +25,7 @@
 #include "softbus_json_utils.h"
 #include "softbus_log.h"
 #include "softbus_proxychannel_manager.h"
+#include "softbus_proxychannel_session.h"
 #include "softbus_proxychannel_transceiver.h"
 #include "softbus_utils.h"
 
@@ -235,11 +236,7 @@ int32_t TransProxyPackMessage(ProxyMessageHead *msg, uint32_t connId,
             SoftBusFree(buf);
             return SOFTBUS_ERR;
         }
-        if (memcpy_s(buf + connHeadLen + PROXY_CHANNEL_HEAD_LEN, bufLen - connHeadLen - PROXY_CHANNEL_HEAD_LEN,
-            enBuf.buf, enBuf.outLen) != EOK) {
-            SoftBusFree(buf);
-            return SOFTBUS_ERR;
-        }
+        // AuthEncrypt already wrote the cipher text in place behind the heads
         *data = buf;
         *dataLen = (int32_t)(PROXY_CHANNEL_HEAD_LEN + connHeadLen + enBuf.outLen);
     }
@@ -284,7 +281,8 @@ char *TransProxyPackHandshakeMsg(ProxyChannelInfo *info)
         !AddStringToJsonObject(root, JSON_KEY_IDENTITY, info->identity) ||
         !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId) ||
         !AddStringToJsonObject(root, JSON_KEY_SRC_BUS_NAME, appInfo->myData.sessionName) ||
-        !AddStringToJsonObject(root, JSON_KEY_DST_BUS_NAME, appInfo->peerData.sessionName)) {
+        !AddStringToJsonObject(root, JSON_KEY_DST_BUS_NAME, appInfo->peerData.sessionName) ||
+        !AddNumberToJsonObject(root, JSON_KEY_MAX_SLICE_LEN, (int32_t)TransProxyGetLinkSliceLen(info->type))) {
         goto EXIT;
     }
     (void)cJSON_AddTrueToObject(root, JSON_KEY_HAS_PRIORITY);
@@ -338,7 +336,8 @@ char *TransProxyPackHandshakeAckMsg(ProxyChannelInfo *chan)
     }
 
     if (!AddStringToJsonObject(root, JSON_KEY_IDENTITY, chan->identity) ||
-        !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId)) {
+        !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId) ||
+        !AddNumberToJsonObject(root, JSON_KEY_MAX_SLICE_LEN, (int32_t)TransProxyGetLinkSliceLen(chan->type))) {
         cJSON_Delete(root);
         return NULL;
     }
@@ -362,6 +361,15 @@ char *TransProxyPackHandshakeAckMsg(ProxyChannelInfo *chan)
     return buf;
 }
 
+static void TransProxyUnpackPeerSliceLen(const cJSON *root, ProxyChannelInfo *chan)
+{
+    int32_t peerSliceLen = 0;
+    if (!GetJsonObjectNumberItem(root, JSON_KEY_MAX_SLICE_LEN, &peerSliceLen)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "peer has no slice len, use default");
+    }
+    chan->peerSliceLen = TransProxyCheckPeerSliceLen(peerSliceLen);
+}
+
 int32_t TransProxyUnpackHandshakeAckMsg(const char *msg, ProxyChannelInfo *chanInfo)
 {
     cJSON *root = 0;
@@ -384,6 +392,7 @@ int32_t TransProxyUnpackHandshakeAckMsg(const char *msg, ProxyChannelInfo *chanI
                                  sizeof(appInfo->peerData.pkgName))) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "no item to get pkg name");
     }
+    TransProxyUnpackPeerSliceLen(root, chanInfo);
     cJSON_Delete(root);
     return SOFTBUS_OK;
 }
@@ -472,6 +481,7 @@ int32_t TransProxyUnpackHandshakeMsg(const char *msg, ProxyChannelInfo *chan)
             return SOFTBUS_ERR;
         }
     }
+    TransProxyUnpackPeerSliceLen(root, chan);
     cJSON_Delete(root);
     return SOFTBUS_OK;
 }
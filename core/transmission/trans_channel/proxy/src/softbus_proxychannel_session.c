@@ -22,6 +22,7 @@
 #include "softbus_adapter_socket.h"
 #include "softbus_adapter_thread.h"
 #include "softbus_errcode.h"
+#include "softbus_feature_config.h"
 #include "softbus_log.h"
 #include "softbus_property.h"
 #include "softbus_proxychannel_callback.h"
@@ -38,6 +39,11 @@
 #define USECTONSEC 1000
 #define PACK_HEAD_LEN (sizeof(PacketHead))
 #define DATA_HEAD_SIZE (4 * 1024)  // donot knoe bytes 1024 or message (4 * 1024)
+#define MAGIC_NUMBER 0xBABEFACE
+#define PROXY_SEND_SCRATCH_SLICE_NUM 64
+#define PROXY_SEND_SCRATCH_CACHE_NUM 4
+#define PROXY_SLICE_LEN_DEFAULT 1024
+#define PROXY_SLICE_LEN_MAX (64 * 1024)
 
 typedef struct {
     unsigned char *inData;
@@ -60,8 +66,34 @@ typedef struct  {
     int32_t dataLen;
 } PacketHead;
 
+typedef struct {
+    ListNode node;
+    int32_t channelId;
+    char sessionKey[SESSION_KEY_LENGTH];
+    SoftBusCipherCtx *cipherCtx;
+    SoftBusCipherCtx *sendCtx;
+} ChannelCipherCtx;
+
 static SoftBusList *g_channelSliceProcessorList = NULL;
-int32_t TransProxyTransDataSendMsg(int32_t channelId, const char *payLoad, int payLoadLen, ProxyPacketType flag);
+static SoftBusList *g_channelCipherCtxList = NULL;
+
+/* per-send bookkeeping, cached so a send does not hit the allocator except for the wire frames */
+typedef struct {
+    ListNode node;
+    ProxyChannelInfo info;
+    ProxySliceFrame frames[PROXY_SEND_SCRATCH_SLICE_NUM];
+    SoftBusCryptoIov iov[PROXY_SEND_SCRATCH_SLICE_NUM];
+} ProxySendScratch;
+
+static SoftBusList *g_sendScratchList = NULL;
+static uint32_t g_linkSliceLen[CONNECT_TYPE_MAX];
+
+typedef struct {
+    uint32_t connId;
+    int32_t priority;
+    ProxySliceFrame *frames;
+    int32_t ret;
+} ProxySlicePoster;
 
 int32_t NotifyClientMsgReceived(const char *pkgName, int32_t channelId, const char *data, uint32_t len,
     SessionPktType type)
@@ -122,51 +154,119 @@ SendPriority ProxyTypeToConnPri(ProxyPacketType proxyType)
     }
 }
 
-static int32_t TransProxyEncryptPacketData(int32_t channelId, int32_t seq, ProxyDataInfo *dataInfo)
+static void TransProxyFreeChannelCipherCtx(ChannelCipherCtx *item)
 {
-    char sessionKey[SESSION_KEY_LENGTH] = {0};
-    AesGcmCipherKey cipherKey = {0};
-    uint32_t checkLen;
+    SoftBusUnrefCipherCtx(item->cipherCtx);
+    SoftBusUnrefCipherCtx(item->sendCtx);
+    (void)memset_s(item, sizeof(ChannelCipherCtx), 0, sizeof(ChannelCipherCtx));
+    SoftBusFree(item);
+}
+
+static ChannelCipherCtx *TransProxyUpdateCipherCtxLocked(ChannelCipherCtx *item, int32_t channelId,
+    const char *sessionKey)
+{
+    SoftBusCipherCtx *cipherCtx = SoftBusCreateCipherCtx((const unsigned char *)sessionKey, SESSION_KEY_LENGTH);
+    SoftBusCipherCtx *sendCtx = SoftBusCreateCipherCtx((const unsigned char *)sessionKey, SESSION_KEY_LENGTH);
+    if (cipherCtx == NULL || sendCtx == NULL) {
+        SoftBusUnrefCipherCtx(cipherCtx);
+        SoftBusUnrefCipherCtx(sendCtx);
+        return NULL;
+    }
+    if (item == NULL) {
+        item = (ChannelCipherCtx *)SoftBusCalloc(sizeof(ChannelCipherCtx));
+        if (item == NULL) {
+            SoftBusUnrefCipherCtx(cipherCtx);
+            SoftBusUnrefCipherCtx(sendCtx);
+            return NULL;
+        }
+        item->channelId = channelId;
+        ListAdd(&(g_channelCipherCtxList->list), &(item->node));
+        g_channelCipherCtxList->cnt++;
+    } else {
+        SoftBusUnrefCipherCtx(item->cipherCtx);
+        SoftBusUnrefCipherCtx(item->sendCtx);
+    }
+    item->cipherCtx = cipherCtx;
+    item->sendCtx = sendCtx;
+    if (memcpy_s(item->sessionKey, sizeof(item->sessionKey), sessionKey, SESSION_KEY_LENGTH) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s key error.");
+    }
+    return item;
+}
 
+/*
+ * The key schedule is built once per channel, the returned reference is dropped by the caller.
+ * Sending keeps its own context so a long pipelined send never holds up decryption of received data.
+ */
+static SoftBusCipherCtx *TransProxyGetCipherCtx(int32_t channelId, bool isSend)
+{
+    char sessionKey[SESSION_KEY_LENGTH] = {0};
+    if (g_channelCipherCtxList == NULL) {
+        return NULL;
+    }
     if (TransProxyGetSessionKeyByChanId(channelId, sessionKey, sizeof(sessionKey)) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId(%d) session key err", channelId);
-        return SOFTBUS_ERR;
+        return NULL;
     }
+    if (SoftBusMutexLock(&g_channelCipherCtxList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock err");
+        (void)memset_s(sessionKey, sizeof(sessionKey), 0, sizeof(sessionKey));
+        return NULL;
+    }
+    ChannelCipherCtx *item = NULL;
+    ChannelCipherCtx *target = NULL;
+    LIST_FOR_EACH_ENTRY(item, &g_channelCipherCtxList->list, ChannelCipherCtx, node) {
+        if (item->channelId == channelId) {
+            target = item;
+            break;
+        }
+    }
+    if (target == NULL || memcmp(target->sessionKey, sessionKey, SESSION_KEY_LENGTH) != 0) {
+        target = TransProxyUpdateCipherCtxLocked(target, channelId, sessionKey);
+    }
+    SoftBusCipherCtx *cipherCtx = NULL;
+    if (target != NULL) {
+        cipherCtx = SoftBusRefCipherCtx(isSend ? target->sendCtx : target->cipherCtx);
+    }
+    (void)SoftBusMutexUnlock(&g_channelCipherCtxList->lock);
+    (void)memset_s(sessionKey, sizeof(sessionKey), 0, sizeof(sessionKey));
+    return cipherCtx;
+}
 
-    checkLen = dataInfo->inLen + OVERHEAD_LEN;
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s key error.");
-        return SOFTBUS_ERR;
+void TransProxyDelCipherCtxByChannelId(int32_t channelId)
+{
+    ChannelCipherCtx *item = NULL;
+    ChannelCipherCtx *next = NULL;
+
+    if (g_channelCipherCtxList == NULL) {
+        return;
     }
-    int32_t ret = SoftBusEncryptDataWithSeq(&cipherKey, dataInfo->inData, dataInfo->inLen,
-        dataInfo->outData, &(dataInfo->outLen), seq);
-    if (ret != SOFTBUS_OK || dataInfo->outLen != checkLen) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Trans Proxy encrypt error. %d ", ret);
-        return SOFTBUS_ENCRYPT_ERR;
+    if (SoftBusMutexLock(&g_channelCipherCtxList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock err");
+        return;
     }
-    return SOFTBUS_OK;
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_channelCipherCtxList->list, ChannelCipherCtx, node) {
+        if (item->channelId == channelId) {
+            ListDelete(&(item->node));
+            g_channelCipherCtxList->cnt--;
+            TransProxyFreeChannelCipherCtx(item);
+            break;
+        }
+    }
+    (void)SoftBusMutexUnlock(&g_channelCipherCtxList->lock);
 }
 
 static int32_t TransProxyDecryptPacketData(int32_t channelId, int32_t seq, ProxyDataInfo *dataInfo)
 {
-    char sessionKey[SESSION_KEY_LENGTH] = {0};
-    AesGcmCipherKey cipherKey = {0};
-    int ret;
-
-    if (TransProxyGetSessionKeyByChanId(channelId, sessionKey, sizeof(sessionKey)) != SOFTBUS_OK) {
+    (void)seq;
+    SoftBusCipherCtx *cipherCtx = TransProxyGetCipherCtx(channelId, false);
+    if (cipherCtx == NULL) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "DecryptPacket get chan fail channid %d.", channelId);
         return SOFTBUS_ERR;
     }
-    cipherKey.keyLen = SESSION_KEY_LENGTH; // 256 bit encryption
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
-        return SOFTBUS_ERR;
-    }
-    (void)memset_s(sessionKey, sizeof(sessionKey), 0, sizeof(sessionKey));
-    ret = SoftBusDecryptDataWithSeq(&cipherKey, dataInfo->inData, dataInfo->inLen,
-        dataInfo->outData, &(dataInfo->outLen), seq);
-    (void)memset_s(&cipherKey, sizeof(AesGcmCipherKey), 0, sizeof(AesGcmCipherKey));
+    int32_t ret = SoftBusDecryptDataByCtx(cipherCtx, dataInfo->inData, dataInfo->inLen,
+        dataInfo->outData, &(dataInfo->outLen));
+    SoftBusUnrefCipherCtx(cipherCtx);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans proxy Decrypt Data fail. %d ", ret);
         return SOFTBUS_ERR;
@@ -174,148 +274,261 @@ static int32_t TransProxyDecryptPacketData(int32_t channelId, int32_t seq, Proxy
     return SOFTBUS_OK;
 }
 
-static int32_t TransProxyGetPktSeqId(int32_t channelId, const ProxyDataInfo *dataInfo, ProxyPacketType flag)
+static void TransProxyInitLinkSliceLen(void)
+{
+    for (int32_t i = 0; i < CONNECT_TYPE_MAX; i++) {
+        g_linkSliceLen[i] = PROXY_SLICE_LEN_DEFAULT;
+    }
+    // BR and BLE stay on the default, their connection layer cuts every frame down to the link mtu anyway
+    uint32_t tcpMaxLen = 0;
+    if (SoftbusGetConfig(SOFTBUS_INT_CONN_TCP_MAX_LENGTH, (unsigned char *)&tcpMaxLen,
+        sizeof(tcpMaxLen)) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get tcp max len fail, use default slice len");
+        return;
+    }
+    if (tcpMaxLen <= MSG_SLICE_HEAD_LEN + PROXY_SLICE_LEN_DEFAULT) {
+        return;
+    }
+    uint32_t sliceLen = tcpMaxLen - MSG_SLICE_HEAD_LEN;
+    if (sliceLen > PROXY_SLICE_LEN_MAX) {
+        sliceLen = PROXY_SLICE_LEN_MAX;
+    }
+    g_linkSliceLen[CONNECT_TCP] = sliceLen;
+    g_linkSliceLen[CONNECT_P2P] = sliceLen;
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "proxy tcp slice len %u", sliceLen);
+}
+
+uint32_t TransProxyGetLinkSliceLen(ConnectType type)
+{
+    if (type < 0 || type >= CONNECT_TYPE_MAX || g_linkSliceLen[type] == 0) {
+        return PROXY_SLICE_LEN_DEFAULT;
+    }
+    return g_linkSliceLen[type];
+}
+
+uint32_t TransProxyCheckPeerSliceLen(int32_t peerSliceLen)
+{
+    if (peerSliceLen < PROXY_SLICE_LEN_DEFAULT || peerSliceLen > PROXY_SLICE_LEN_MAX) {
+        return 0;
+    }
+    return (uint32_t)peerSliceLen;
+}
+
+/* a peer that did not announce its slice len during the handshake only takes the default */
+static uint32_t TransProxyGetChanSliceLen(const ProxyChannelInfo *info)
+{
+    uint32_t localLen = TransProxyGetLinkSliceLen(info->type);
+    if (info->peerSliceLen == 0) {
+        return PROXY_SLICE_LEN_DEFAULT;
+    }
+    return (info->peerSliceLen < localLen) ? info->peerSliceLen : localLen;
+}
+
+static int32_t TransProxyGetPktSeqId(int32_t channelId, const unsigned char *data, uint32_t len,
+    ProxyPacketType flag)
 {
     int32_t seq = 0;
 
     if (flag == PROXY_FLAG_ACK) {
-        if (memcpy_s(&seq, sizeof(seq), dataInfo->inData, dataInfo->inLen) == EOK) {
+        if (memcpy_s(&seq, sizeof(seq), data, len) == EOK) {
             return seq;
         }
     }
     return TransProxyGetNewChanSeq(channelId);
 }
 
-static int32_t TransProxyPackBytes(int32_t channelId, ProxyDataInfo *dataInfo, ProxyPacketType flag, int32_t *outseq)
+int32_t TransProxyGetPacketSliceNum(uint32_t dataLen, uint32_t sliceLen)
 {
-#define MAGIC_NUMBER 0xBABEFACE
-    uint32_t outBufLen;
-    uint8_t *outBuf = NULL;
-    PacketHead *pktHead = NULL;
-    ProxyDataInfo enDataInfo = {0};
-    int32_t seq;
-
-    outBufLen = dataInfo->inLen + OVERHEAD_LEN + sizeof(PacketHead);
-    outBuf = SoftBusCalloc(outBufLen);
-    if (outBuf == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "calloc error");
-        return SOFTBUS_MEM_ERR;
+    if (sliceLen < PROXY_SLICE_LEN_DEFAULT) {
+        sliceLen = PROXY_SLICE_LEN_DEFAULT;
     }
-    seq = TransProxyGetPktSeqId(channelId, dataInfo, flag);
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "trans proxy send packet seq %d flag %d", seq, flag);
-    enDataInfo.outData = outBuf + sizeof(PacketHead);
-    enDataInfo.outLen = outBufLen - sizeof(PacketHead);
+    uint32_t packLen = sizeof(PacketHead) + dataLen + OVERHEAD_LEN;
+    return (int32_t)((packLen + sliceLen - 1) / sliceLen);
+}
 
-    enDataInfo.inData = dataInfo->inData;
-    enDataInfo.inLen = dataInfo->inLen;
-    if (TransProxyEncryptPacketData(channelId, seq, &enDataInfo) != SOFTBUS_OK) {
-        SoftBusFree(outBuf);
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "tran pack encrypt data fail. channid %d", channelId);
-        return SOFTBUS_TRANS_PROXY_SESS_ENCRYPT_ERR;
+static void TransProxyFreeSliceFrames(ProxySliceFrame *frames, int32_t sliceNum)
+{
+    for (int32_t i = 0; i < sliceNum; i++) {
+        if (frames[i].buf != NULL) {
+            SoftBusFree(frames[i].buf);
+            frames[i].buf = NULL;
+        }
     }
-    pktHead = (PacketHead*)outBuf;
-    pktHead->magicNumber = MAGIC_NUMBER;
-    pktHead->seq = seq;
-    pktHead->flags = flag;
-    pktHead->dataLen = (int32_t)enDataInfo.outLen;
-    *outseq = seq;
-    dataInfo->outData = outBuf;
-    dataInfo->outLen = outBufLen;
-    return SOFTBUS_OK;
 }
 
-static int32_t TransProxyProcSendMsgAck(int32_t channelId, const char *data, int32_t len)
+int32_t TransProxyPackPacketSlices(const ProxyMessageHead *msgHead, SoftBusCipherCtx *cipherCtx,
+    const ProxyPacketInfo *packet, const ProxySliceBatch *batch)
 {
-    int32_t seq;
+    if (msgHead == NULL || cipherCtx == NULL || packet == NULL || packet->data == NULL || batch == NULL ||
+        batch->frames == NULL || batch->iov == NULL || packet->sliceLen < PROXY_SLICE_LEN_DEFAULT ||
+        batch->sliceNum != TransProxyGetPacketSliceNum(packet->len, packet->sliceLen)) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    ProxySliceFrame *frames = batch->frames;
+    SoftBusCryptoIov *iov = batch->iov;
+    int32_t sliceNum = batch->sliceNum;
+    uint32_t packLen = sizeof(PacketHead) + packet->len + OVERHEAD_LEN;
+    uint32_t sliceLen = packet->sliceLen;
+    uint32_t connHeadLen = ConnGetHeadSize();
+    SliceHead sliceHead = {0};
+    sliceHead.priority = ProxyTypeToProxyIndex(packet->flag);
+    sliceHead.sliceNum = sliceNum;
+    for (int32_t i = 0; i < sliceNum; i++) {
+        uint32_t chunkLen = (i == sliceNum - 1) ? (packLen - (uint32_t)i * sliceLen) : sliceLen;
+        uint32_t frameLen = connHeadLen + MSG_SLICE_HEAD_LEN + chunkLen;
+        frames[i].buf = (char *)SoftBusMalloc(frameLen);
+        if (frames[i].buf == NULL) {
+            TransProxyFreeSliceFrames(frames, i);
+            return SOFTBUS_MALLOC_ERR;
+        }
+        frames[i].len = (int32_t)frameLen;
+        sliceHead.sliceSeq = i;
+        char *head = frames[i].buf + connHeadLen;
+        if (memcpy_s(head, frameLen - connHeadLen, msgHead, sizeof(ProxyMessageHead)) != EOK ||
+            memcpy_s(head + sizeof(ProxyMessageHead), frameLen - connHeadLen - sizeof(ProxyMessageHead),
+            &sliceHead, sizeof(SliceHead)) != EOK) {
+            TransProxyFreeSliceFrames(frames, i + 1);
+            return SOFTBUS_MEM_ERR;
+        }
+        iov[i].buf = (unsigned char *)(head + MSG_SLICE_HEAD_LEN);
+        iov[i].len = chunkLen;
+    }
 
-    if (len != PROXY_ACK_SIZE) {
-        return SOFTBUS_TRANS_INVALID_DATA_LENGTH;
+    PacketHead pktHead = {0};
+    pktHead.magicNumber = MAGIC_NUMBER;
+    pktHead.seq = packet->seq;
+    pktHead.flags = packet->flag;
+    pktHead.dataLen = (int32_t)(packet->len + OVERHEAD_LEN);
+    if (memcpy_s(iov[0].buf, iov[0].len, &pktHead, sizeof(PacketHead)) != EOK) {
+        TransProxyFreeSliceFrames(frames, sliceNum);
+        return SOFTBUS_MEM_ERR;
     }
-    if (data == NULL) {
-        return SOFTBUS_ERR;
+    iov[0].buf += sizeof(PacketHead);
+    iov[0].len -= sizeof(PacketHead);
+    int32_t ret = SoftBusEncryptDataWithSeqByCtxIov(cipherCtx, packet->data, packet->len, iov,
+        (uint32_t)sliceNum, packet->seq, batch->onSliceReady, batch->cbArg);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Trans Proxy encrypt error. %d ", ret);
+        TransProxyFreeSliceFrames(frames, sliceNum);
+        return SOFTBUS_TRANS_PROXY_SESS_ENCRYPT_ERR;
     }
-    seq = *(int32_t *)data;
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "TransProxyProcSendMsgAck. chanid %d,seq :%d", channelId, seq);
-    return SetPendingPacket(channelId, seq, PENDING_TYPE_PROXY);
+    return SOFTBUS_OK;
 }
 
-static int32_t TransProxyTransDataSendSyncMsg(int32_t channelId, const char *payLoad, int payLoadLen,
-    ProxyPacketType flag, int32_t seq)
+static ProxySendScratch *TransProxyGetSendScratch(void)
 {
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "send syncmsg chanid[%d] seq[%d] dataLen[%d] type[%d]",
-        channelId, seq, payLoadLen, flag);
-    int32_t ret = TransProxyTransDataSendMsg(channelId, payLoad, payLoadLen, flag);
-    if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxyTransDataSendSyncMsg err,ret :%d", ret);
-        return ret;
+    ProxySendScratch *scratch = NULL;
+    if (g_sendScratchList != NULL && SoftBusMutexLock(&g_sendScratchList->lock) == 0) {
+        if (!IsListEmpty(&g_sendScratchList->list)) {
+            scratch = LIST_ENTRY(g_sendScratchList->list.next, ProxySendScratch, node);
+            ListDelete(&scratch->node);
+            g_sendScratchList->cnt--;
+        }
+        (void)SoftBusMutexUnlock(&g_sendScratchList->lock);
     }
-    ret = ProcPendingPacket(channelId, seq, PENDING_TYPE_PROXY);
-    if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "proxy send sync msg fail.[%d]", ret);
+    if (scratch == NULL) {
+        scratch = (ProxySendScratch *)SoftBusMalloc(sizeof(ProxySendScratch));
     }
-    return ret;
+    return scratch;
 }
 
-int32_t TransProxyPostPacketData(int32_t channelId, const unsigned char *data, uint32_t len, ProxyPacketType flags)
+static void TransProxyPutSendScratch(ProxySendScratch *scratch)
 {
-    ProxyDataInfo packDataInfo = {0};
-    int32_t ret;
-    int32_t seq = 0;
-
-    if (data == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid para");
-        return SOFTBUS_INVALID_PARAM;
+    (void)memset_s(&scratch->info.appInfo.sessionKey, sizeof(scratch->info.appInfo.sessionKey), 0,
+        sizeof(scratch->info.appInfo.sessionKey));
+    if (g_sendScratchList != NULL && SoftBusMutexLock(&g_sendScratchList->lock) == 0) {
+        if (g_sendScratchList->cnt < PROXY_SEND_SCRATCH_CACHE_NUM) {
+            ListInit(&scratch->node);
+            ListAdd(&g_sendScratchList->list, &scratch->node);
+            g_sendScratchList->cnt++;
+            scratch = NULL;
+        }
+        (void)SoftBusMutexUnlock(&g_sendScratchList->lock);
     }
-
-    packDataInfo.inData = (unsigned char *)data;
-    packDataInfo.inLen = len;
-    ProxyChannelInfo *chanInfo = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
-    if (chanInfo == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc in TransProxyPostPacketData.id[%d]", channelId);
-        return SOFTBUS_MALLOC_ERR;
+    if (scratch != NULL) {
+        SoftBusFree(scratch);
     }
-    if (TransProxyGetSendMsgChanInfo(channelId, chanInfo) != SOFTBUS_OK) {
-        SoftBusFree(chanInfo);
-        return SOFTBUS_ERR;
+}
+
+/* posts each slice as soon as its part of the cipher text is complete, while later slices are still encrypted */
+static int32_t TransProxyPostReadySlice(uint32_t index, void *arg)
+{
+    ProxySlicePoster *poster = (ProxySlicePoster *)arg;
+    ProxySliceFrame *frame = &(poster->frames[index]);
+    // the connection layer owns the frame from here, even when posting fails
+    int32_t ret = TransProxyTransSendMsg(poster->connId, frame->buf, frame->len, poster->priority);
+    frame->buf = NULL;
+    if (ret == SOFTBUS_OK) {
+        return SOFTBUS_OK;
     }
-    AppType appType = chanInfo->appInfo.appType;
-    SoftBusFree(chanInfo);
-    if (appType != APP_TYPE_AUTH) {
-        ret = TransProxyPackBytes(channelId, &packDataInfo, flags, &seq);
-        if (ret != SOFTBUS_OK) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PackBytes err");
-            return ret;
-        }
+    if (ret == SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "normal proxy send queue full!!");
+        poster->ret = SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
     } else {
-        packDataInfo.outData = (uint8_t *)data;
-        packDataInfo.outLen = len;
-        if (flags == PROXY_FLAG_MESSAGE) {
-            flags = PROXY_FLAG_BYTES;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "normal proxy send msg error");
+        poster->ret = SOFTBUS_TRANS_PROXY_SENDMSG_ERR;
+    }
+    return poster->ret;
+}
+
+static int32_t TransProxyTransPacketMsg(ProxySendScratch *scratch, ProxyPacketInfo *packet)
+{
+    const ProxyChannelInfo *info = &scratch->info;
+    if ((info->status != PROXY_CHANNEL_STATUS_COMPLETED && info->status != PROXY_CHANNEL_STATUS_KEEPLIVEING)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", info->status);
+        return SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
+    }
+    packet->sliceLen = TransProxyGetChanSliceLen(info);
+    ProxySlicePoster poster = {info->connId, ProxyTypeToConnPri(packet->flag), scratch->frames, SOFTBUS_OK};
+    ProxySliceBatch batch = {scratch->frames, scratch->iov, 0, TransProxyPostReadySlice, &poster};
+    batch.sliceNum = TransProxyGetPacketSliceNum(packet->len, packet->sliceLen);
+    if (batch.sliceNum > PROXY_SEND_SCRATCH_SLICE_NUM) {
+        batch.frames = (ProxySliceFrame *)SoftBusCalloc(sizeof(ProxySliceFrame) * (uint32_t)batch.sliceNum);
+        batch.iov = (SoftBusCryptoIov *)SoftBusCalloc(sizeof(SoftBusCryptoIov) * (uint32_t)batch.sliceNum);
+        if (batch.frames == NULL || batch.iov == NULL) {
+            SoftBusFree(batch.frames);
+            SoftBusFree(batch.iov);
+            return SOFTBUS_MALLOC_ERR;
         }
+        poster.frames = batch.frames;
     }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "InLen[%d] seq[%d] outLen[%d] flags[%d]",
-        len, seq, packDataInfo.outLen, flags);
-    if (flags == PROXY_FLAG_MESSAGE) {
-        ret = TransProxyTransDataSendSyncMsg(channelId, (char *)packDataInfo.outData,
-            (int32_t)packDataInfo.outLen, flags, seq);
-    } else {
-        ret = TransProxyTransDataSendMsg(channelId, (char *)packDataInfo.outData, (int32_t)packDataInfo.outLen, flags);
+    ProxyMessageHead msgHead = {0};
+    msgHead.type = (PROXYCHANNEL_MSG_TYPE_NORMAL & FOUR_BIT_MASK) | (VERSION << VERSION_SHIFT);
+    msgHead.myId = info->myId;
+    msgHead.peerId = info->peerId;
+    int32_t ret = SOFTBUS_ERR;
+    SoftBusCipherCtx *cipherCtx = TransProxyGetCipherCtx(info->channelId, true);
+    if (cipherCtx == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId(%d) cipher ctx err", info->channelId);
+        goto EXIT;
     }
-    if (appType != APP_TYPE_AUTH) {
-        SoftBusFree(packDataInfo.outData);
+    ret = TransProxyPackPacketSlices(&msgHead, cipherCtx, packet, &batch);
+    SoftBusUnrefCipherCtx(cipherCtx);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "tran pack send data fail. channid %d", info->channelId);
+        ret = (poster.ret != SOFTBUS_OK) ? poster.ret : ret;
+    }
+EXIT:
+    if (batch.frames != scratch->frames) {
+        SoftBusFree(batch.frames);
+        SoftBusFree(batch.iov);
     }
     return ret;
 }
 
-int32_t TransProxyPostSessionData(int32_t channelId, const unsigned char *data, uint32_t len, SessionPktType flags)
-{
-    ProxyPacketType type = SessionTypeToPacketType(flags);
-    return TransProxyPostPacketData(channelId, data, len, type);
-}
-static int32_t TransProxyGetBufLen(void)
+static int32_t TransProxyProcSendMsgAck(int32_t channelId, const char *data, int32_t len)
 {
-#define MAX_SEND_LENGTH 1024
-    return MAX_SEND_LENGTH;
+    int32_t seq;
+
+    if (len != PROXY_ACK_SIZE) {
+        return SOFTBUS_TRANS_INVALID_DATA_LENGTH;
+    }
+    if (data == NULL) {
+        return SOFTBUS_ERR;
+    }
+    seq = *(int32_t *)data;
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "TransProxyProcSendMsgAck. chanid %d,seq :%d", channelId, seq);
+    return SetPendingPacket(channelId, seq, PENDING_TYPE_PROXY);
 }
 
 static char *TransProxyPackAppNormalMsg(const ProxyMessageHead *msg, const SliceHead *sliceHead, const char *payLoad,
@@ -389,57 +602,6 @@ static int32_t TransProxyTransAuthMsg(const ProxyChannelInfo *info, const char *
     return SOFTBUS_OK;
 }
 
-static int32_t TransProxyTransAppNormalMsg(const ProxyChannelInfo *info, const char *payLoad, int payLoadLen,
-    ProxyPacketType flag)
-{
-    int32_t dataLen;
-    int32_t offset;
-    int32_t singleLen;
-    int32_t sliceNum;
-
-    singleLen = TransProxyGetBufLen();
-    if (singleLen <= 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "getBuflen msg error");
-        return SOFTBUS_ERR;
-    }
-    sliceNum = (payLoadLen + singleLen - 1) / singleLen;
-    ProxyMessageHead msgHead = {0};
-    msgHead.type = (PROXYCHANNEL_MSG_TYPE_NORMAL & FOUR_BIT_MASK) | (VERSION << VERSION_SHIFT);
-    msgHead.myId = info->myId;
-    msgHead.peerId = info->peerId;
-    for (int i = 0; i < sliceNum; i++) {
-        char *buf = NULL;
-        int bufLen = 0;
-        SliceHead slicehead = {0};
-        slicehead.priority = ProxyTypeToProxyIndex(flag);
-        slicehead.sliceNum = sliceNum;
-        slicehead.sliceSeq = i;
-        if (sliceNum > 1) {
-            dataLen = (i == (sliceNum - 1)) ? (payLoadLen - i * MAX_SEND_LENGTH) : MAX_SEND_LENGTH;
-            offset = i * MAX_SEND_LENGTH;
-        } else {
-            dataLen = payLoadLen;
-            offset = 0;
-        }
-
-        buf = TransProxyPackAppNormalMsg(&msgHead, &slicehead, payLoad + offset, dataLen, &bufLen);
-        if (buf == NULL) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
-            return SOFTBUS_TRANS_PROXY_PACKMSG_ERR;
-        }
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "slice: i:%d", i);
-        int32_t ret = TransProxyTransSendMsg(info->connId, buf, bufLen, ProxyTypeToConnPri(flag));
-        if (ret == SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "normal proxy send queue full!!");
-            return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
-        } else if (ret != SOFTBUS_OK) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "normal proxy send msg error");
-            return SOFTBUS_TRANS_PROXY_SENDMSG_ERR;
-        }
-    }
-    return SOFTBUS_OK;
-}
-
 int32_t TransProxyTransNetWorkMsg(ProxyMessageHead *msghead, const ProxyChannelInfo *info, const char *payLoad,
     int payLoadLen, int priority)
 {
@@ -454,39 +616,76 @@ int32_t TransProxyTransNetWorkMsg(ProxyMessageHead *msghead, const ProxyChannelI
     return TransProxyTransSendMsg(info->connId, buf, bufLen, priority);
 }
 
-int32_t TransProxyTransDataSendMsg(int32_t channelId, const char *payLoad, int payLoadLen, ProxyPacketType flag)
+static int32_t TransProxyTransAuthDataMsg(const ProxyChannelInfo *info, const char *payLoad, int payLoadLen,
+    ProxyPacketType flag)
+{
+    if ((info->status != PROXY_CHANNEL_STATUS_COMPLETED && info->status != PROXY_CHANNEL_STATUS_KEEPLIVEING)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", info->status);
+        return SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
+    }
+    int32_t ret = TransProxyTransAuthMsg(info, payLoad, payLoadLen, flag);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
+    }
+    return ret;
+}
+
+int32_t TransProxyPostPacketData(int32_t channelId, const unsigned char *data, uint32_t len, ProxyPacketType flags)
 {
-    int ret = SOFTBUS_OK;
-    ProxyChannelInfo *info = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
-    if (info == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc fail when trans proxy trans data");
+    int32_t ret;
+    ProxyPacketInfo packet = {0};
+
+    if (data == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid para");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    ProxySendScratch *scratch = TransProxyGetSendScratch();
+    if (scratch == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc in TransProxyPostPacketData.id[%d]", channelId);
         return SOFTBUS_MALLOC_ERR;
     }
-    if (TransProxyGetSendMsgChanInfo(channelId, info) != SOFTBUS_OK) {
+    if (TransProxyGetSendMsgChanInfo(channelId, &scratch->info) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId err %d", channelId);
-        ret = SOFTBUS_TRANS_PROXY_SEND_CHANNELID_INVALID;
-        goto EXIT;
-    }
-
-    if ((info->status != PROXY_CHANNEL_STATUS_COMPLETED && info->status != PROXY_CHANNEL_STATUS_KEEPLIVEING)) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", info->status);
-        ret = SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
-        goto EXIT;
+        TransProxyPutSendScratch(scratch);
+        return SOFTBUS_TRANS_PROXY_SEND_CHANNELID_INVALID;
     }
-    if (info->appInfo.appType == APP_TYPE_AUTH) {
-        ret = TransProxyTransAuthMsg(info, payLoad, payLoadLen, flag);
-    } else {
-        ret = TransProxyTransAppNormalMsg(info, payLoad, payLoadLen, flag);
+    if (scratch->info.appInfo.appType == APP_TYPE_AUTH) {
+        if (flags == PROXY_FLAG_MESSAGE) {
+            flags = PROXY_FLAG_BYTES;
+        }
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "InLen[%d] flags[%d]", len, flags);
+        ret = TransProxyTransAuthDataMsg(&scratch->info, (const char *)data, (int32_t)len, flags);
+        TransProxyPutSendScratch(scratch);
+        return ret;
     }
+
+    packet.data = data;
+    packet.len = len;
+    packet.flag = flags;
+    packet.seq = TransProxyGetPktSeqId(channelId, data, len, flags);
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "trans proxy send packet InLen[%d] seq[%d] flags[%d]",
+        len, packet.seq, flags);
+    ret = TransProxyTransPacketMsg(scratch, &packet);
+    TransProxyPutSendScratch(scratch);
     if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
-        goto EXIT;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxyTransPacketMsg err, ret :%d", ret);
+        return ret;
+    }
+    if (flags == PROXY_FLAG_MESSAGE) {
+        ret = ProcPendingPacket(channelId, packet.seq, PENDING_TYPE_PROXY);
+        if (ret != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "proxy send sync msg fail.[%d]", ret);
+        }
     }
-EXIT:
-    SoftBusFree(info);
     return ret;
 }
 
+int32_t TransProxyPostSessionData(int32_t channelId, const unsigned char *data, uint32_t len, SessionPktType flags)
+{
+    ProxyPacketType type = SessionTypeToPacketType(flags);
+    return TransProxyPostPacketData(channelId, data, len, type);
+}
+
 static void TransProxySendSessionAck(int32_t channelId, int32_t seq)
 {
 #define PROXY_ACK_SIZE 4
@@ -934,21 +1133,75 @@ static void TransProxySliceTimerProc(void)
 
 int32_t TransSliceManagerInit(void)
 {
+    TransProxyInitLinkSliceLen();
     g_channelSliceProcessorList = CreateSoftBusList();
     if (g_channelSliceProcessorList == NULL) {
         return SOFTBUS_ERR;
     }
+    g_channelCipherCtxList = CreateSoftBusList();
+    if (g_channelCipherCtxList == NULL) {
+        DestroySoftBusList(g_channelSliceProcessorList);
+        g_channelSliceProcessorList = NULL;
+        return SOFTBUS_ERR;
+    }
     if (RegisterTimeoutCallback(SOFTBUS_PROXYSLICE_TIMER_FUN, (void *)TransProxySliceTimerProc) != SOFTBUS_OK) {
         DestroySoftBusList(g_channelSliceProcessorList);
+        DestroySoftBusList(g_channelCipherCtxList);
+        g_channelSliceProcessorList = NULL;
+        g_channelCipherCtxList = NULL;
         return SOFTBUS_ERR;
     }
+    g_sendScratchList = CreateSoftBusList();
+    if (g_sendScratchList == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "send scratch cache disabled");
+    }
     return SOFTBUS_OK;
 }
 
+static void TransProxyClearCipherCtxList(void)
+{
+    ChannelCipherCtx *item = NULL;
+    ChannelCipherCtx *next = NULL;
+    if (SoftBusMutexLock(&g_channelCipherCtxList->lock) != 0) {
+        return;
+    }
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_channelCipherCtxList->list, ChannelCipherCtx, node) {
+        ListDelete(&(item->node));
+        TransProxyFreeChannelCipherCtx(item);
+    }
+    g_channelCipherCtxList->cnt = 0;
+    (void)SoftBusMutexUnlock(&g_channelCipherCtxList->lock);
+}
+
+static void TransProxyClearSendScratchList(void)
+{
+    ProxySendScratch *item = NULL;
+    ProxySendScratch *next = NULL;
+    if (SoftBusMutexLock(&g_sendScratchList->lock) != 0) {
+        return;
+    }
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_sendScratchList->list, ProxySendScratch, node) {
+        ListDelete(&(item->node));
+        SoftBusFree(item);
+    }
+    g_sendScratchList->cnt = 0;
+    (void)SoftBusMutexUnlock(&g_sendScratchList->lock);
+}
+
 void TransSliceManagerDeInit(void)
 {
     if (g_channelSliceProcessorList) {
         DestroySoftBusList(g_channelSliceProcessorList);
     }
+    if (g_channelCipherCtxList) {
+        TransProxyClearCipherCtxList();
+        DestroySoftBusList(g_channelCipherCtxList);
+        g_channelCipherCtxList = NULL;
+    }
+    if (g_sendScratchList) {
+        TransProxyClearSendScratchList();
+        DestroySoftBusList(g_sendScratchList);
+        g_sendScratchList = NULL;
+    }
     return;
 }
@@ -379,6 +379,34 @@ int SendBytes(int sessionId, const void *data, unsigned int len);
  */
 int SendMessage(int sessionId, const void *data, unsigned int len);
 
+/**
+ * @brief Defines the callback invoked when a message sent by {@link SendMessageAsync} is done.
+ *
+ * @param sessionId Indicates the session ID.
+ * @param result Indicates <b>0</b> if the peer acknowledged the message, or the error code otherwise.
+ * @param cbArg Indicates the argument passed to {@link SendMessageAsync}.
+ * @since 1.0
+ * @version 1.0
+ */
+typedef void (*OnMessageSendDone)(int sessionId, int result, void *cbArg);
+
+/**
+ * @brief Sends message based on a session ID without waiting for the acknowledgement of the peer.
+ *
+ * Messages from one thread are sent in order. A session keeps a limited number of messages in flight, and the call
+ * blocks while that window is full. <b>onDone</b> is invoked once for every message the call accepted.
+ *
+ * @param sessionId Indicates the session ID.
+ * @param data Indicates the pointer to the message data to send, which cannot be <b>NULL</b>.
+ * @param len Indicates the length of the message to send.
+ * @param onDone Indicates the callback invoked when the message is done, which cannot be <b>NULL</b>.
+ * @param cbArg Indicates the argument passed to <b>onDone</b>.
+ * @return Returns <b>0</b> if the message is sent, returns an error code otherwise.
+ * @since 1.0
+ * @version 1.0
+ */
+int SendMessageAsync(int sessionId, const void *data, unsigned int len, OnMessageSendDone onDone, void *cbArg);
+
 int SendStream(int sessionId, const StreamData *data, const StreamData *ext, const StreamFrameInfo *param);
 
 /**
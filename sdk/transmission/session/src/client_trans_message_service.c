@@ -17,6 +17,7 @@
 
 #include "client_trans_channel_manager.h"
 #include "client_trans_session_manager.h"
+#include "softbus_adapter_mem.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_feature_config.h"
@@ -77,6 +78,58 @@ int SendMessage(int sessionId, const void *data, unsigned int len)
     return ClientTransChannelSendMessage(channelId, type, data, len);
 }
 
+typedef struct {
+    int sessionId;
+    OnMessageSendDone onDone;
+    void *cbArg;
+} AsyncMessageCtx;
+
+static void OnAsyncMessageDone(int32_t channelId, int32_t seq, int32_t result, void *cbArg)
+{
+    (void)channelId;
+    (void)seq;
+    AsyncMessageCtx *ctx = (AsyncMessageCtx *)cbArg;
+    ctx->onDone(ctx->sessionId, result, ctx->cbArg);
+    SoftBusFree(ctx);
+}
+
+int SendMessageAsync(int sessionId, const void *data, unsigned int len, OnMessageSendDone onDone, void *cbArg)
+{
+    if (data == NULL || len == 0 || onDone == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Invalid param");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    uint32_t maxLen;
+    if (SoftbusGetConfig(SOFTBUS_INT_MAX_MESSAGE_LENGTH, (unsigned char *)&maxLen, sizeof(maxLen)) != SOFTBUS_OK) {
+        return SOFTBUS_GET_CONFIG_VAL_ERR;
+    }
+    if (len > maxLen) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    int32_t channelId = INVALID_CHANNEL_ID;
+    int32_t type = CHANNEL_TYPE_BUTT;
+    bool isEnable = false;
+    if (ClientGetChannelBySessionId(sessionId, &channelId, &type, &isEnable) != SOFTBUS_OK) {
+        return SOFTBUS_TRANS_INVALID_SESSION_ID;
+    }
+    if (isEnable != true) {
+        return SOFTBUS_TRANS_SESSION_OPENING;
+    }
+
+    AsyncMessageCtx *ctx = (AsyncMessageCtx *)SoftBusMalloc(sizeof(AsyncMessageCtx));
+    if (ctx == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    ctx->sessionId = sessionId;
+    ctx->onDone = onDone;
+    ctx->cbArg = cbArg;
+    int32_t ret = ClientTransChannelSendMessageAsync(channelId, type, data, len, OnAsyncMessageDone, ctx);
+    if (ret != SOFTBUS_OK) {
+        SoftBusFree(ctx);
+    }
+    return ret;
+}
+
 int SendStream(int sessionId, const StreamData *data, const StreamData *ext, const StreamFrameInfo *param)
 {
     if ((data == NULL) || (ext == NULL) || (param == NULL)) {
@@ -18,6 +18,7 @@
 
 #include "session.h"
 #include "softbus_def.h"
+#include "trans_pending_pkt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,9 @@ int32_t ClientTransChannelSendBytes(int32_t channelId, int32_t type, const void
 
 int32_t ClientTransChannelSendMessage(int32_t channelId, int32_t type, const void *data, uint32_t len);
 
+int32_t ClientTransChannelSendMessageAsync(int32_t channelId, int32_t type, const void *data, uint32_t len,
+    PendingPktDoneCb onDone, void *cbArg);
+
 int32_t ClientTransChannelSendStream(int32_t channelId, int32_t type, const StreamData *data,
     const StreamData *ext, const StreamFrameInfo *param);
 
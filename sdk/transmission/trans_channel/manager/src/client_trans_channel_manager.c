@@ -131,6 +131,26 @@ int32_t ClientTransChannelSendMessage(int32_t channelId, int32_t type, const voi
     return ret;
 }
 
+int32_t ClientTransChannelSendMessageAsync(int32_t channelId, int32_t type, const void *data, uint32_t len,
+    PendingPktDoneCb onDone, void *cbArg)
+{
+    if ((data == NULL) || (len == 0) || (onDone == NULL)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Invalid param");
+        return SOFTBUS_INVALID_PARAM;
+    }
+
+    if (type == CHANNEL_TYPE_TCP_DIRECT) {
+        return TransTdcSendMessageAsync(channelId, data, len, onDone, cbArg);
+    }
+    /* acks of the other channels are waited in the core process, so they are sent one by one */
+    int32_t ret = ClientTransChannelSendMessage(channelId, type, data, len);
+    if (ret != SOFTBUS_OK) {
+        return ret;
+    }
+    onDone(channelId, 0, SOFTBUS_OK, cbArg);
+    return SOFTBUS_OK;
+}
+
 int32_t ClientTransChannelSendStream(int32_t channelId, int32_t type, const StreamData *data,
     const StreamData *ext, const StreamFrameInfo *param)
 {
@@ -33,7 +33,8 @@ extern "C" {
 #define MAX_FILE_PATH_NAME_LEN 512
 
 #define FRAME_DATA_SEQ_OFFSET (4)
-#define PROXY_MAX_PACKET_SIZE (1024 - 48)
+#define PROXY_MAX_PACKET_SIZE (4 * 1024)
+#define PROXY_FILE_READ_AHEAD_FRAME_NUM 16
 #define MAX_FILE_SIZE (0x500000) /* 5M */
 
 #define PATH_SEPARATOR '/'
@@ -115,6 +116,12 @@ int32_t ProcessFileFrameData(int32_t sessionId, FileListener fileListener, const
 
 int32_t ProcessFileListData(int32_t sessionId, FileListener fileListener, const char *data, uint32_t len);
 
+typedef int32_t (*ProxyFileFrameSend)(int32_t channelId, const char *data, uint32_t len, int32_t type);
+
+/* Send the first frame with destFile and then the content of fd, each frame handed to sendFrame in order. */
+int32_t TransProxySendFileFrames(const SendListenerInfo *sendInfo, int32_t fd, const char *destFile,
+    uint64_t fileSize, ProxyFileFrameSend sendFrame);
+
 #ifdef __cplusplus
 }
 #endif
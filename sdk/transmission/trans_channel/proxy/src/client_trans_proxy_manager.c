@@ -49,7 +49,6 @@ static void ProxyFileTransTimerProc(void);
 #define BYTE_INT_NUM 4
 #define BIT_INT_NUM 32
 #define BIT_BYTE_NUM 8
-#define SEND_DELAY_TIME 20
 
 int32_t ClinetTransProxyInit(const IClientSessionCallBack *cb)
 {
@@ -415,22 +414,30 @@ static int32_t FrameIndexToType(uint64_t index, uint64_t frameNumber)
     return FILE_ONGOINE_FRAME;
 }
 
+/*
+ * Frames are not paced: a full connection send queue is the only signal to slow down,
+ * so the sender backs off until the link has drained it and then runs at link speed again.
+ */
 static int32_t ProxyChannelSendFileStream(int32_t channelId, const char *data, uint32_t len, int32_t type)
 {
-#define FILE_RETRY_DELAY_TIME 100
-#define FILE_RETRY_COUNT 3
-    int32_t retry = FILE_RETRY_COUNT;
+#define FILE_RETRY_DELAY_MIN 1
+#define FILE_RETRY_DELAY_MAX 100
+#define FILE_RETRY_WAIT_MAX 3000
+    uint32_t delay = FILE_RETRY_DELAY_MIN;
+    uint32_t waited = 0;
     int32_t ret;
-    while (retry) {
+    while (true) {
         ret = ServerIpcSendMessage(channelId, CHANNEL_TYPE_PROXY, data, len, type);
-        if (ret == SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send queue full %d", ret);
-            SoftBusSleepMs(FILE_RETRY_DELAY_TIME);
-            retry--;
-            continue;
+        if ((ret != SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) || (waited >= FILE_RETRY_WAIT_MAX)) {
+            break;
         }
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "send msg(%d): type=%d, ret=%d", channelId, type, ret);
-        return ret;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "send queue full, back off %ums", delay);
+        SoftBusSleepMs(delay);
+        waited += delay;
+        delay = (delay * 2 > FILE_RETRY_DELAY_MAX) ? FILE_RETRY_DELAY_MAX : delay * 2;
+    }
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send msg(%d): type=%d, ret=%d", channelId, type, ret);
     }
     return ret;
 }
@@ -536,7 +543,7 @@ static int32_t GetAndCheckFileSize(const char *sourceFile, uint64_t *fileSize)
     return SOFTBUS_OK;
 }
 
-static int32_t SendOneFrame(int32_t channelId, FileFrame fileFrame)
+static int32_t SendOneFrame(int32_t channelId, FileFrame fileFrame, ProxyFileFrameSend sendFrame)
 {
     if (fileFrame.data == NULL) {
         return SOFTBUS_ERR;
@@ -546,7 +553,7 @@ static int32_t SendOneFrame(int32_t channelId, FileFrame fileFrame)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Frame Type To Session Type fail %d", fileFrame.frameType);
         return SOFTBUS_ERR;
     }
-    int32_t ret = ProxyChannelSendFileStream(channelId, (char *)fileFrame.data, fileFrame.frameLength, type);
+    int32_t ret = sendFrame(channelId, (char *)fileFrame.data, fileFrame.frameLength, type);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "conn send buf fail %d", ret);
         return ret;
@@ -554,61 +561,6 @@ static int32_t SendOneFrame(int32_t channelId, FileFrame fileFrame)
     return SOFTBUS_OK;
 }
 
-static int32_t FileToFrame(SendListenerInfo sendInfo, uint64_t frameNum, int32_t fd,
-    const char *destFile, uint64_t fileSize)
-{
-    FileFrame fileFrame;
-    uint8_t *buffer = (uint8_t *)SoftBusCalloc(PROXY_MAX_PACKET_SIZE);
-    if (buffer == NULL) {
-        return SOFTBUS_ERR;
-    }
-    uint64_t fileOffset = 0;
-    uint64_t remainedSendSize = fileSize;
-    uint64_t frameDataSize = PROXY_MAX_PACKET_SIZE - FRAME_DATA_SEQ_OFFSET;
-    for (uint64_t index = 0; index < frameNum; index++) {
-        fileFrame.frameType = FrameIndexToType(index, frameNum);
-        fileFrame.data = buffer;
-        if (memcpy_s(fileFrame.data, FRAME_DATA_SEQ_OFFSET, (char *)&sendInfo.channelId,
-            FRAME_DATA_SEQ_OFFSET) != EOK) {
-            goto EXIT_ERR;
-        }
-        if (index == 0) {
-            uint32_t dNameSize = strlen(destFile);
-            if (memcpy_s(fileFrame.data + FRAME_DATA_SEQ_OFFSET, dNameSize, destFile, dNameSize) != SOFTBUS_OK) {
-                goto EXIT_ERR;
-            }
-            fileFrame.frameLength = FRAME_DATA_SEQ_OFFSET + dNameSize;
-        } else {
-            uint64_t readLength = (remainedSendSize < frameDataSize) ? remainedSendSize : frameDataSize;
-            int64_t len = SoftBusPreadFile(fd, fileFrame.data + FRAME_DATA_SEQ_OFFSET, readLength, fileOffset);
-            if (len >= 0) {
-                fileOffset += readLength;
-                fileFrame.frameLength = readLength + FRAME_DATA_SEQ_OFFSET;
-                remainedSendSize -= readLength;
-            } else {
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pread src file failed");
-                goto EXIT_ERR;
-            }
-        }
-
-        if (sendInfo.fileListener.sendListener.OnSendFileProcess != NULL) {
-            sendInfo.fileListener.sendListener.OnSendFileProcess(sendInfo.channelId, fileOffset, fileSize);
-        }
-        if (SendOneFrame(sendInfo.channelId, fileFrame) != SOFTBUS_OK) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send one frame failed");
-            goto EXIT_ERR;
-        }
-        memset_s(fileFrame.data, PROXY_MAX_PACKET_SIZE, 0, PROXY_MAX_PACKET_SIZE);
-        SoftBusSleepMs(SEND_DELAY_TIME);
-    }
-    SoftBusFree(fileFrame.data);
-    return SOFTBUS_OK;
-EXIT_ERR:
-    SoftBusFree(fileFrame.data);
-    return SOFTBUS_ERR;
-}
-
-
 static bool CheckDestFilePathValid(const char *destFile)
 {
     if (destFile == NULL) {
@@ -651,6 +603,92 @@ static int32_t GetFrameNum(uint64_t fileSize, uint64_t *frameNum)
     return SOFTBUS_OK;
 }
 
+static int32_t SendFirstFrame(const SendListenerInfo *sendInfo, uint8_t *buffer, uint32_t bufferSize,
+    uint64_t frameNum, const char *destFile, ProxyFileFrameSend sendFrame)
+{
+    FileFrame fileFrame;
+    fileFrame.frameType = FrameIndexToType(0, frameNum);
+    fileFrame.data = buffer;
+    uint32_t dNameSize = strlen(destFile);
+    if (memcpy_s(fileFrame.data, bufferSize, (char *)&sendInfo->channelId, FRAME_DATA_SEQ_OFFSET) != EOK ||
+        memcpy_s(fileFrame.data + FRAME_DATA_SEQ_OFFSET, bufferSize - FRAME_DATA_SEQ_OFFSET,
+        destFile, dNameSize) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack first frame failed");
+        return SOFTBUS_ERR;
+    }
+    fileFrame.frameLength = FRAME_DATA_SEQ_OFFSET + dNameSize;
+    return SendOneFrame(sendInfo->channelId, fileFrame, sendFrame);
+}
+
+/*
+ * File data is read ahead PROXY_FILE_READ_AHEAD_FRAME_NUM frames at a time into one block and the frames
+ * are cut from it in place: the seq of each frame overwrites the tail of the frame sent just before it.
+ */
+int32_t TransProxySendFileFrames(const SendListenerInfo *sendInfo, int32_t fd, const char *destFile,
+    uint64_t fileSize, ProxyFileFrameSend sendFrame)
+{
+    if ((sendInfo == NULL) || (destFile == NULL) || (sendFrame == NULL)) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    uint64_t frameNum = 0;
+    if (GetFrameNum(fileSize, &frameNum) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get frame num fail");
+        return SOFTBUS_ERR;
+    }
+    uint64_t frameDataSize = PROXY_MAX_PACKET_SIZE - FRAME_DATA_SEQ_OFFSET;
+    uint64_t blockDataSize = frameDataSize * PROXY_FILE_READ_AHEAD_FRAME_NUM;
+    uint32_t blockSize = (uint32_t)(FRAME_DATA_SEQ_OFFSET + blockDataSize);
+    uint8_t *block = (uint8_t *)SoftBusCalloc(blockSize);
+    if (block == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    if (sendInfo->fileListener.sendListener.OnSendFileProcess != NULL) {
+        sendInfo->fileListener.sendListener.OnSendFileProcess(sendInfo->channelId, 0, fileSize);
+    }
+    if (SendFirstFrame(sendInfo, block, blockSize, frameNum, destFile, sendFrame) != SOFTBUS_OK) {
+        goto EXIT_ERR;
+    }
+
+    FileFrame fileFrame;
+    uint64_t fileOffset = 0;
+    uint64_t index = 1;
+    while (index < frameNum) {
+        uint64_t readLength = fileSize - fileOffset;
+        readLength = (readLength < blockDataSize) ? readLength : blockDataSize;
+        if (SoftBusPreadFile(fd, block + FRAME_DATA_SEQ_OFFSET, readLength, fileOffset) != (int64_t)readLength) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pread src file failed");
+            goto EXIT_ERR;
+        }
+        uint64_t blockOffset = 0;
+        while ((blockOffset < readLength) && (index < frameNum)) {
+            uint64_t frameDataLen = readLength - blockOffset;
+            frameDataLen = (frameDataLen < frameDataSize) ? frameDataLen : frameDataSize;
+            fileFrame.frameType = FrameIndexToType(index, frameNum);
+            fileFrame.data = block + blockOffset;
+            if (memcpy_s(fileFrame.data, FRAME_DATA_SEQ_OFFSET, (char *)&sendInfo->channelId,
+                FRAME_DATA_SEQ_OFFSET) != EOK) {
+                goto EXIT_ERR;
+            }
+            fileFrame.frameLength = (uint32_t)(frameDataLen + FRAME_DATA_SEQ_OFFSET);
+            blockOffset += frameDataLen;
+            fileOffset += frameDataLen;
+            if (sendInfo->fileListener.sendListener.OnSendFileProcess != NULL) {
+                sendInfo->fileListener.sendListener.OnSendFileProcess(sendInfo->channelId, fileOffset, fileSize);
+            }
+            if (SendOneFrame(sendInfo->channelId, fileFrame, sendFrame) != SOFTBUS_OK) {
+                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send one frame failed");
+                goto EXIT_ERR;
+            }
+            index++;
+        }
+    }
+    SoftBusFree(block);
+    return SOFTBUS_OK;
+EXIT_ERR:
+    SoftBusFree(block);
+    return SOFTBUS_ERR;
+}
+
 static int32_t FileToFrameAndSendFile(SendListenerInfo sendInfo, const char *sourceFile, const char *destFile)
 {
     uint64_t fileSize = 0;
@@ -684,18 +722,13 @@ static int32_t FileToFrameAndSendFile(SendListenerInfo sendInfo, const char *sou
         return SOFTBUS_ERR;
     }
 
-    uint64_t frameNum = 0;
-    if (GetFrameNum(fileSize, &frameNum) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get frame num fail");
-        goto EXIT_ERR;
-    }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO,
-        "channelId:%d, fileName:%s, fileSize:%llu, frameNum:%llu, destPath:%s",
-        sendInfo.channelId, absSrcPath, fileSize, frameNum, destFile);
-    if (FileToFrame(sendInfo, frameNum, fd, destFile, fileSize) != SOFTBUS_OK) {
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channelId:%d, fileName:%s, fileSize:%llu, destPath:%s",
+        sendInfo.channelId, absSrcPath, fileSize, destFile);
+    if (TransProxySendFileFrames(&sendInfo, fd, destFile, fileSize, ProxyChannelSendFileStream) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "File To Frame fail");
         goto EXIT_ERR;
     }
+    SoftBusCloseFile(fd);
     SoftBusFree(absSrcPath);
     return SOFTBUS_OK;
 EXIT_ERR:
@@ -18,6 +18,7 @@
 
 #include "client_trans_session_callback.h"
 #include "client_trans_tcp_direct_message.h"
+#include "softbus_adapter_crypto.h"
 #include "softbus_sequence_verification.h"
 
 #ifdef __cplusplus
@@ -31,8 +32,9 @@ typedef struct {
     bool aliveState;
     int apiVersion;
     int32_t sequence;
-    SeqVerifyInfo verifyInfo;
+    SeqWindowInfo *verifyInfo; // owned by the list node
     char sessionKey[SESSION_KEY_LENGTH];
+    SoftBusCipherCtx *cipherCtx; // owned by the list node, copies must use TransTdcGetCipherCtxById
     SoftBusList *pendingPacketsList;
 } TcpDirectChannelDetail;
 
@@ -56,6 +58,8 @@ int32_t TransTdcManagerInit(const IClientSessionCallBack *callback);
 void TransTdcManagerDeinit(void);
 
 int32_t TransTdcGetSessionKey(int32_t channelId, char *key, unsigned int len);
+/* Returns a referenced cipher context of the channel, release it with SoftBusUnrefCipherCtx. */
+SoftBusCipherCtx *TransTdcGetCipherCtxById(int32_t channelId);
 int32_t TransTdcGetHandle(int32_t channelId, int *handle);
 int32_t TransDisableSessionListener(int32_t channelId);
 
@@ -17,6 +17,7 @@
 #define CLIENT_TRANS_TCP_DIRECT_MESSAGE_H
 
 #include "softbus_def.h"
+#include "trans_pending_pkt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +56,8 @@ int32_t TransDelDataBufNode(int32_t channelId);
 int32_t TransAddDataBufNode(int32_t channelId, int32_t fd);
 int32_t TransTdcSendBytes(int32_t channelId, const char *data, uint32_t len);
 int32_t TransTdcSendMessage(int32_t channelId, const char *data, uint32_t len);
+int32_t TransTdcSendMessageAsync(int32_t channelId, const char *data, uint32_t len,
+    PendingPktDoneCb onDone, void *cbArg);
 
 #ifdef __cplusplus
 }
@@ -23,6 +23,7 @@
 #include "softbus_base_listener.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
+#include "softbus_feature_config.h"
 #include "softbus_log.h"
 #include "softbus_tcp_socket.h"
 #include "softbus_utils.h"
@@ -32,6 +33,14 @@
 #define HEART_TIME 300
 static SoftBusList *g_tcpDirectChannelInfoList = NULL;
 
+static void TransTdcFreeChannelItem(TcpDirectChannelInfo *item)
+{
+    SoftBusUnrefCipherCtx(item->detail.cipherCtx);
+    DestroySeqWindowInfo(item->detail.verifyInfo);
+    (void)memset_s(item->detail.sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
+    SoftBusFree(item);
+}
+
 TcpDirectChannelInfo *TransTdcGetInfoById(int32_t channelId, TcpDirectChannelInfo *info)
 {
     TcpDirectChannelInfo *item = NULL;
@@ -97,7 +106,7 @@ int32_t TransTdcCheckSeq(int32_t fd, int32_t seq)
     (void)SoftBusMutexLock(&g_tcpDirectChannelInfoList->lock);
     LIST_FOR_EACH_ENTRY(item, &(g_tcpDirectChannelInfoList->list), TcpDirectChannelInfo, node) {
         if (item->detail.fd == fd) {
-            if (!IsPassSeqCheck(&(item->detail.verifyInfo), seq)) {
+            if (!IsPassSeqWindowCheck(item->detail.verifyInfo, seq)) {
                 SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "SeqCheck is false");
                 (void)SoftBusMutexUnlock(&g_tcpDirectChannelInfoList->lock);
                 return SOFTBUS_ERR;
@@ -124,7 +133,7 @@ void TransTdcCloseChannel(int32_t channelId)
         if (item->channelId == channelId) {
             TransTdcReleaseFd(item->detail.fd);
             ListDelete(&item->node);
-            SoftBusFree(item);
+            TransTdcFreeChannelItem(item);
             item = NULL;
             (void)SoftBusMutexUnlock(&g_tcpDirectChannelInfoList->lock);
             DelPendingPacket(channelId, PENDING_TYPE_DIRECT);
@@ -150,6 +159,17 @@ static TcpDirectChannelInfo *TransGetNewTcpChannel(const ChannelInfo *channel)
         SoftBusFree(item);
         return NULL;
     }
+    int32_t windowSize = SEQ_WINDOW_SIZE_DEFAULT;
+    if (SoftbusGetConfig(SOFTBUS_INT_SEQ_WINDOW_SIZE, (unsigned char *)&windowSize, sizeof(windowSize)) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "get seq window size fail, use default");
+    }
+    item->detail.verifyInfo = CreateSeqWindowInfo((uint32_t)windowSize, 0);
+    if (item->detail.verifyInfo == NULL) {
+        TransTdcFreeChannelItem(item);
+        return NULL;
+    }
+    // NULL leaves the channel on the per packet key setup
+    item->detail.cipherCtx = SoftBusCreateCipherCtx((const unsigned char *)channel->sessionKey, SESSION_KEY_LENGTH);
     return item;
 }
 
@@ -176,20 +196,20 @@ int32_t ClientTransTdcOnChannelOpened(const char *sessionName, const ChannelInfo
 
     if (TransAddDataBufNode(channel->channelId, channel->fd) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "add data buf node fail.");
-        SoftBusFree(item);
+        TransTdcFreeChannelItem(item);
         goto EXIT_ERR;
     }
     if (TransTdcCreateListener(channel->fd) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans tcp direct create listener failed.");
         TransDelDataBufNode(channel->channelId);
-        SoftBusFree(item);
+        TransTdcFreeChannelItem(item);
         goto EXIT_ERR;
     }
 
     int32_t ret = ConnSetTcpKeepAlive(channel->fd, HEART_TIME);
     if (ret != SOFTBUS_OK) {
         TransDelDataBufNode(channel->channelId);
-        SoftBusFree(item);
+        TransTdcFreeChannelItem(item);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "ConnSetTcpKeepAlive failed.");
         goto EXIT_ERR;
     }
@@ -232,6 +252,14 @@ void TransTdcManagerDeinit(void)
     }
 
     TransDataListDeinit();
+    TcpDirectChannelInfo *item = NULL;
+    TcpDirectChannelInfo *next = NULL;
+    (void)SoftBusMutexLock(&g_tcpDirectChannelInfoList->lock);
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &(g_tcpDirectChannelInfoList->list), TcpDirectChannelInfo, node) {
+        ListDelete(&item->node);
+        TransTdcFreeChannelItem(item);
+    }
+    (void)SoftBusMutexUnlock(&g_tcpDirectChannelInfoList->lock);
     DestroySoftBusList(g_tcpDirectChannelInfoList);
     g_tcpDirectChannelInfoList = NULL;
     PendingDeinit(PENDING_TYPE_DIRECT);
@@ -256,6 +284,22 @@ int32_t TransTdcGetSessionKey(int32_t channelId, char *key, unsigned int len)
     return SOFTBUS_OK;
 }
 
+SoftBusCipherCtx *TransTdcGetCipherCtxById(int32_t channelId)
+{
+    TcpDirectChannelInfo *item = NULL;
+    SoftBusCipherCtx *cipherCtx = NULL;
+
+    (void)SoftBusMutexLock(&g_tcpDirectChannelInfoList->lock);
+    LIST_FOR_EACH_ENTRY(item, &(g_tcpDirectChannelInfoList->list), TcpDirectChannelInfo, node) {
+        if (item->channelId == channelId) {
+            cipherCtx = SoftBusRefCipherCtx(item->detail.cipherCtx);
+            break;
+        }
+    }
+    (void)SoftBusMutexUnlock(&g_tcpDirectChannelInfoList->lock);
+    return cipherCtx;
+}
+
 int32_t TransTdcGetHandle(int32_t channelId, int *handle)
 {
     TcpDirectChannelInfo channel;
@@ -39,20 +39,48 @@
 #define BYTE_TOS 0x60
 #define MESSAGE_TOS 0xC0
 
+#define TDC_DATA_BUF_BUCKET_NUM 32
+/* cipher buffers up to this size are kept by the channel, larger ones are allocated per packet */
+#define TDC_SEND_BUF_KEEP_MAX (64 * 1024 + OVERHEAD_LEN)
+
 typedef struct {
     ListNode node;
     int32_t channelId;
     int32_t fd;
+    uint32_t refCnt; /* guarded by the table lock */
+    SoftBusMutex lock; /* guards the fields below */
+    bool isDeleted;
     uint32_t size;
     char *data;
+    char *r; /* start of the first unprocessed packet */
     char *w;
+    SoftBusMutex sendLock; /* guards the fields below, held across encrypting and sending a packet */
+    uint32_t tos; /* last IP_TOS set on fd */
+    uint32_t sendBufSize;
+    char *sendBuf;
 } ClientDataBuf;
 
+typedef struct {
+    SoftBusMutex lock; /* only held to look up, add or remove a buffer */
+    ListNode buckets[TDC_DATA_BUF_BUCKET_NUM];
+} ClientDataBufTable;
+
 static uint32_t g_dataBufferMaxLen = 0;
-static SoftBusList *g_tcpDataList = NULL;
+static ClientDataBufTable *g_tcpDataTable = NULL;
+
+static ClientDataBuf *TransRefDataBufById(int32_t channelId);
+static void TransUnrefDataBuf(ClientDataBuf *node);
 
-static int32_t TransTdcDecrypt(const char *sessionKey, const char *in, uint32_t inLen, char *out, uint32_t *outLen)
+static int32_t TransTdcDecrypt(const TcpDirectChannelInfo *channel, const char *in, uint32_t inLen, char *out,
+    uint32_t *outLen)
 {
+    SoftBusCipherCtx *cipherCtx = TransTdcGetCipherCtxById(channel->channelId);
+    if (cipherCtx != NULL) {
+        int32_t ret = SoftBusDecryptDataByCtx(cipherCtx, (unsigned char*)in, inLen, (unsigned char*)out, outLen);
+        SoftBusUnrefCipherCtx(cipherCtx);
+        return ret;
+    }
+    const char *sessionKey = channel->detail.sessionKey;
     AesGcmCipherKey cipherKey = {0};
     cipherKey.keyLen = SESSION_KEY_LENGTH; // 256 bit encryption
     if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
@@ -62,16 +90,24 @@ static int32_t TransTdcDecrypt(const char *sessionKey, const char *in, uint32_t
     return SoftBusDecryptData(&cipherKey, (unsigned char*)in, inLen, (unsigned char*)out, outLen);
 }
 
-static int32_t TransTdcEncryptWithSeq(const char *sessionKey, int32_t seqNum, const char *in, uint32_t inLen,
-    char *out, uint32_t *outLen)
+static int32_t TransTdcEncryptWithSeq(const TcpDirectChannelInfo *channel, int32_t seqNum, const char *in,
+    uint32_t inLen, char *out, uint32_t *outLen)
 {
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
-        return SOFTBUS_ERR;
+    int ret;
+    SoftBusCipherCtx *cipherCtx = TransTdcGetCipherCtxById(channel->channelId);
+    if (cipherCtx != NULL) {
+        ret = SoftBusEncryptDataWithSeqByCtx(cipherCtx, (unsigned char*)in, inLen, (unsigned char*)out, outLen,
+            seqNum);
+        SoftBusUnrefCipherCtx(cipherCtx);
+    } else {
+        AesGcmCipherKey cipherKey = {0};
+        cipherKey.keyLen = SESSION_KEY_LENGTH;
+        if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, channel->detail.sessionKey, SESSION_KEY_LENGTH) != EOK) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
+            return SOFTBUS_ERR;
+        }
+        ret = SoftBusEncryptDataWithSeq(&cipherKey, (unsigned char*)in, inLen, (unsigned char*)out, outLen, seqNum);
     }
-    int ret = SoftBusEncryptDataWithSeq(&cipherKey, (unsigned char*)in, inLen, (unsigned char*)out, outLen, seqNum);
     if (ret != SOFTBUS_OK || *outLen != inLen + OVERHEAD_LEN) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "encrypt error.");
         return SOFTBUS_ENCRYPT_ERR;
@@ -94,17 +130,28 @@ static int32_t TransTdcSetPendingPacket(int32_t channelId, const char *data, uin
     return SOFTBUS_OK;
 }
 
-static char *TransTdcPackData(const TcpDirectChannelInfo *channel, const char *data, uint32_t len, int flags,
-    uint32_t *outLen)
+static char *TransTdcGetSendBuf(ClientDataBuf *node, uint32_t len)
 {
-    uint32_t dataLen = len + OVERHEAD_LEN;
-    char *buf = (char *)SoftBusMalloc(dataLen + DC_DATA_HEAD_SIZE);
-    if (buf == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc failed.");
-        return NULL;
+    if (len > TDC_SEND_BUF_KEEP_MAX) {
+        return (char *)SoftBusMalloc(len);
+    }
+    if (len > node->sendBufSize) {
+        char *buf = (char *)SoftBusMalloc(len);
+        if (buf == NULL) {
+            return NULL;
+        }
+        SoftBusFree(node->sendBuf);
+        node->sendBuf = buf;
+        node->sendBufSize = len;
     }
+    return node->sendBuf;
+}
 
-    char *finalData = (char *)data;
+/* called with node->sendLock held, so packets of one channel never interleave on the socket */
+static int32_t TransTdcSendPacket(const TcpDirectChannelInfo *channel, ClientDataBuf *node, const char *data,
+    uint32_t len, int32_t flags)
+{
+    const char *finalData = data;
     int32_t finalSeq = channel->detail.sequence;
     uint32_t tmpSeq;
     if (flags == FLAG_ACK) {
@@ -112,55 +159,61 @@ static char *TransTdcPackData(const TcpDirectChannelInfo *channel, const char *d
         tmpSeq = SoftBusHtoNl((uint32_t)finalSeq);
         finalData = (char *)(&tmpSeq);
     }
-
     TcpDataPacketHead pktHead = {
         .magicNumber = MAGIC_NUMBER,
         .seq = finalSeq,
         .flags = flags,
-        .dataLen = dataLen,
+        .dataLen = len + OVERHEAD_LEN,
     };
-    if (memcpy_s(buf, DC_DATA_HEAD_SIZE, &pktHead, sizeof(TcpDataPacketHead)) != EOK) {
-        SoftBusFree(buf);
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s error");
-        return NULL;
-    }
-    if (TransTdcEncryptWithSeq(channel->detail.sessionKey, finalSeq, finalData, len,
-        buf + DC_DATA_HEAD_SIZE, outLen) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "encrypt error");
-        SoftBusFree(buf);
-        return NULL;
-    }
-    return buf;
-}
 
-static int32_t TransTdcProcessPostData(const TcpDirectChannelInfo *channel, const char *data, uint32_t len,
-    int32_t flags)
-{
-    uint32_t outLen;
-    char *buf = TransTdcPackData(channel, data, len, flags, &outLen);
+    char *buf = TransTdcGetSendBuf(node, pktHead.dataLen);
     if (buf == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "failed to pack bytes.");
-        return SOFTBUS_ENCRYPT_ERR;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc failed.");
+        return SOFTBUS_MALLOC_ERR;
     }
-    if (outLen != len + OVERHEAD_LEN) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack bytes len error, len: %d", outLen);
-        SoftBusFree(buf);
-        return SOFTBUS_ENCRYPT_ERR;
+    uint32_t outLen;
+    int32_t ret = TransTdcEncryptWithSeq(channel, finalSeq, finalData, len, buf, &outLen);
+    if (ret != SOFTBUS_OK || outLen != pktHead.dataLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "failed to pack bytes.");
+        ret = SOFTBUS_ENCRYPT_ERR;
+        goto EXIT;
     }
     uint32_t tos = (flags == FLAG_BYTES) ? BYTE_TOS : MESSAGE_TOS;
-    if (SetIpTos(channel->detail.fd, tos) != SOFTBUS_OK) {
-        SoftBusFree(buf);
-        return SOFTBUS_TCP_SOCKET_ERR;
+    if (tos != node->tos) {
+        if (SetIpTos(channel->detail.fd, tos) != SOFTBUS_OK) {
+            ret = SOFTBUS_TCP_SOCKET_ERR;
+            goto EXIT;
+        }
+        node->tos = tos;
     }
-    ssize_t ret = SendTcpData(channel->detail.fd, buf, outLen + DC_DATA_HEAD_SIZE, 0);
-    if (ret != (ssize_t)outLen + DC_DATA_HEAD_SIZE) {
+    SoftBusIovec iov[] = {
+        { &pktHead, DC_DATA_HEAD_SIZE },
+        { buf, outLen },
+    };
+    if (SendTcpDataIov(channel->detail.fd, iov, sizeof(iov) / sizeof(iov[0]), 0) !=
+        (ssize_t)outLen + DC_DATA_HEAD_SIZE) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "failed to send tcp data.");
+        ret = SOFTBUS_ERR;
+    }
+EXIT:
+    if (buf != node->sendBuf) {
         SoftBusFree(buf);
+    }
+    return ret;
+}
+
+static int32_t TransTdcProcessPostData(const TcpDirectChannelInfo *channel, const char *data, uint32_t len,
+    int32_t flags)
+{
+    ClientDataBuf *node = TransRefDataBufById(channel->channelId);
+    if (node == NULL) {
         return SOFTBUS_ERR;
     }
-    SoftBusFree(buf);
-    buf = NULL;
-    return SOFTBUS_OK;
+    SoftBusMutexLock(&node->sendLock);
+    int32_t ret = TransTdcSendPacket(channel, node, data, len, flags);
+    SoftBusMutexUnlock(&node->sendLock);
+    TransUnrefDataBuf(node);
+    return ret;
 }
 
 int32_t TransTdcSendBytes(int32_t channelId, const char *data, uint32_t len)
@@ -195,6 +248,29 @@ int32_t TransTdcSendMessage(int32_t channelId, const char *data, uint32_t len)
     return ProcPendingPacket(channelId, channel.detail.sequence, PENDING_TYPE_DIRECT);
 }
 
+int32_t TransTdcSendMessageAsync(int32_t channelId, const char *data, uint32_t len,
+    PendingPktDoneCb onDone, void *cbArg)
+{
+    TcpDirectChannelInfo channel;
+    (void)memset_s(&channel, sizeof(TcpDirectChannelInfo), 0, sizeof(TcpDirectChannelInfo));
+    if (TransTdcGetInfoByIdWithIncSeq(channelId, &channel) == NULL) {
+        return SOFTBUS_ERR;
+    }
+    /* registered before sending, the ack may come back before SendTcpData returns */
+    int32_t seq = channel.detail.sequence;
+    int32_t ret = AddAsyncPendingPacket(channelId, seq, PENDING_TYPE_DIRECT, onDone, cbArg);
+    if (ret != SOFTBUS_OK) {
+        return ret;
+    }
+    ret = TransTdcProcessPostData(&channel, data, len, FLAG_MESSAGE);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "post async message failed.");
+        RemoveAsyncPendingPacket(channelId, seq, PENDING_TYPE_DIRECT);
+        return ret;
+    }
+    return SOFTBUS_OK;
+}
+
 static int32_t TransTdcSendAck(const TcpDirectChannelInfo *channel, int32_t seq)
 {
     if (channel == NULL) {
@@ -222,85 +298,135 @@ static int32_t TransGetDataBufMaxSize(void)
 
 int32_t TransAddDataBufNode(int32_t channelId, int32_t fd)
 {
-    if (g_tcpDataList == NULL) {
+    if (g_tcpDataTable == NULL) {
         return SOFTBUS_ERR;
     }
     ClientDataBuf *node = (ClientDataBuf *)SoftBusCalloc(sizeof(ClientDataBuf));
     if (node == NULL) {
         return SOFTBUS_ERR;
     }
+    if (SoftBusMutexInit(&node->lock, NULL) != SOFTBUS_OK) {
+        SoftBusFree(node);
+        return SOFTBUS_ERR;
+    }
+    if (SoftBusMutexInit(&node->sendLock, NULL) != SOFTBUS_OK) {
+        SoftBusMutexDestroy(&node->lock);
+        SoftBusFree(node);
+        return SOFTBUS_ERR;
+    }
     node->channelId = channelId;
     node->fd = fd;
+    node->refCnt = 1;
     node->size = TransGetDataBufSize();
     node->data = (char *)SoftBusCalloc(node->size);
     if (node->data == NULL) {
+        SoftBusMutexDestroy(&node->sendLock);
+        SoftBusMutexDestroy(&node->lock);
         SoftBusFree(node);
         return SOFTBUS_ERR;
     }
+    node->r = node->data;
     node->w = node->data;
 
-    SoftBusMutexLock(&g_tcpDataList->lock);
-    ListAdd(&g_tcpDataList->list, &node->node);
-    g_tcpDataList->cnt++;
-    SoftBusMutexUnlock(&g_tcpDataList->lock);
+    SoftBusMutexLock(&g_tcpDataTable->lock);
+    ListAdd(&g_tcpDataTable->buckets[(uint32_t)channelId % TDC_DATA_BUF_BUCKET_NUM], &node->node);
+    SoftBusMutexUnlock(&g_tcpDataTable->lock);
     return SOFTBUS_OK;
 }
 
+static void TransUnrefDataBuf(ClientDataBuf *node)
+{
+    SoftBusMutexLock(&g_tcpDataTable->lock);
+    bool isLast = (--node->refCnt == 0);
+    SoftBusMutexUnlock(&g_tcpDataTable->lock);
+    if (!isLast) {
+        return;
+    }
+    SoftBusMutexDestroy(&node->sendLock);
+    SoftBusMutexDestroy(&node->lock);
+    SoftBusFree(node->sendBuf);
+    SoftBusFree(node->data);
+    SoftBusFree(node);
+}
+
+/* called on a buffer already unlinked from the table, the receiving thread may still hold a reference */
+static void TransReleaseDataBuf(ClientDataBuf *node)
+{
+    SoftBusMutexLock(&node->lock);
+    node->isDeleted = true;
+    SoftBusMutexUnlock(&node->lock);
+    TransUnrefDataBuf(node);
+}
+
 int32_t TransDelDataBufNode(int32_t channelId)
 {
-    if (g_tcpDataList ==  NULL) {
+    if (g_tcpDataTable ==  NULL) {
         return SOFTBUS_ERR;
     }
 
     ClientDataBuf *item = NULL;
     ClientDataBuf *next = NULL;
-    SoftBusMutexLock(&g_tcpDataList->lock);
-    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_tcpDataList->list, ClientDataBuf, node) {
+    ClientDataBuf *found = NULL;
+    SoftBusMutexLock(&g_tcpDataTable->lock);
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_tcpDataTable->buckets[(uint32_t)channelId % TDC_DATA_BUF_BUCKET_NUM],
+        ClientDataBuf, node) {
         if (item->channelId == channelId) {
             ListDelete(&item->node);
-            SoftBusFree(item->data);
-            SoftBusFree(item);
-            g_tcpDataList->cnt--;
+            found = item;
             break;
         }
     }
-    SoftBusMutexUnlock(&g_tcpDataList->lock);
+    SoftBusMutexUnlock(&g_tcpDataTable->lock);
+    if (found != NULL) {
+        TransReleaseDataBuf(found);
+    }
 
     return SOFTBUS_OK;
 }
 
 static int32_t TransDestroyDataBuf(void)
 {
-    if (g_tcpDataList ==  NULL) {
+    if (g_tcpDataTable ==  NULL) {
         return SOFTBUS_ERR;
     }
 
+    ListNode removed;
+    ListInit(&removed);
     ClientDataBuf *item = NULL;
     ClientDataBuf *next = NULL;
-    SoftBusMutexLock(&g_tcpDataList->lock);
-    LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_tcpDataList->list, ClientDataBuf, node) {
+    SoftBusMutexLock(&g_tcpDataTable->lock);
+    for (uint32_t i = 0; i < TDC_DATA_BUF_BUCKET_NUM; i++) {
+        LIST_FOR_EACH_ENTRY_SAFE(item, next, &g_tcpDataTable->buckets[i], ClientDataBuf, node) {
+            ListDelete(&item->node);
+            ListAdd(&removed, &item->node);
+        }
+    }
+    SoftBusMutexUnlock(&g_tcpDataTable->lock);
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, &removed, ClientDataBuf, node) {
         ListDelete(&item->node);
-        SoftBusFree(item->data);
-        SoftBusFree(item);
-        g_tcpDataList->cnt--;
+        TransReleaseDataBuf(item);
     }
-    SoftBusMutexUnlock(&g_tcpDataList->lock);
 
     return SOFTBUS_OK;
 }
 
-static ClientDataBuf *TransGetDataBufNodeById(int32_t channelId)
+static ClientDataBuf *TransRefDataBufById(int32_t channelId)
 {
-    if (g_tcpDataList ==  NULL) {
+    if (g_tcpDataTable ==  NULL) {
         return NULL;
     }
 
     ClientDataBuf *item = NULL;
-    LIST_FOR_EACH_ENTRY(item, &(g_tcpDataList->list), ClientDataBuf, node) {
+    SoftBusMutexLock(&g_tcpDataTable->lock);
+    LIST_FOR_EACH_ENTRY(item, &g_tcpDataTable->buckets[(uint32_t)channelId % TDC_DATA_BUF_BUCKET_NUM],
+        ClientDataBuf, node) {
         if (item->channelId == channelId) {
+            item->refCnt++;
+            SoftBusMutexUnlock(&g_tcpDataTable->lock);
             return item;
         }
     }
+    SoftBusMutexUnlock(&g_tcpDataTable->lock);
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "tcp direct channel id not exist.");
     return NULL;
 }
@@ -323,55 +449,40 @@ static int32_t TransTdcProcessDataByFlag(uint32_t flag, int32_t seqNum, const Tc
     }
 }
 
-static int32_t TransTdcProcessData(int32_t channelId)
+/* called with node->lock held, the packet at the read cursor is complete */
+static int32_t TransTdcProcessData(const TcpDirectChannelInfo *channel, ClientDataBuf *node)
 {
-    TcpDirectChannelInfo channel;
-    if (TransTdcGetInfoById(channelId, &channel) == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get key fail.");
-        return SOFTBUS_ERR;
-    }
-
-    SoftBusMutexLock(&g_tcpDataList->lock);
-    ClientDataBuf *node = TransGetDataBufNodeById(channelId);
-    if (node == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "node is null.");
-        return SOFTBUS_ERR;
-    }
-    TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->data);
+    TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->r);
     int32_t seqNum = pktHead->seq;
     uint32_t flag = pktHead->flags;
     uint32_t dataLen = pktHead->dataLen;
     char *plain = (char *)SoftBusCalloc(dataLen - OVERHEAD_LEN);
     if (plain == NULL) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc fail.");
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
         return SOFTBUS_MALLOC_ERR;
     }
 
     uint32_t plainLen;
-    int ret = TransTdcDecrypt(channel.detail.sessionKey, node->data + DC_DATA_HEAD_SIZE,
-        dataLen, plain, &plainLen);
+    int ret = TransTdcDecrypt(channel, node->r + DC_DATA_HEAD_SIZE, dataLen, plain, &plainLen);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "decrypt fail.");
         SoftBusFree(plain);
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
         return SOFTBUS_DECRYPT_ERR;
     }
-    char *end = node->data + DC_DATA_HEAD_SIZE + dataLen;
-    if (memmove_s(node->data, node->size, end, node->w - end) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memmove fail.");
-        SoftBusFree(plain);
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
-        return SOFTBUS_MEM_ERR;
+    node->r += DC_DATA_HEAD_SIZE + dataLen;
+    if (node->r == node->w) {
+        node->r = node->data;
+        node->w = node->data;
     }
-    node->w = node->w - DC_DATA_HEAD_SIZE - dataLen;
-    SoftBusMutexUnlock(&g_tcpDataList->lock);
 
-    ret = TransTdcProcessDataByFlag(flag, seqNum, &channel, plain, plainLen);
+    /* the callbacks may close the channel, so they run without the buffer lock */
+    SoftBusMutexUnlock(&node->lock);
+    ret = TransTdcProcessDataByFlag(flag, seqNum, channel, plain, plainLen);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "process data fail");
     }
     SoftBusFree(plain);
+    SoftBusMutexLock(&node->lock);
     return ret;
 }
 
@@ -384,111 +495,135 @@ static int32_t TransResizeDataBuffer(ClientDataBuf *oldBuf, uint32_t pkgLen)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransResizeDataBuffer malloc err(%u)", pkgLen);
         return SOFTBUS_MEM_ERR;
     }
-    uint32_t bufLen = oldBuf->w - oldBuf->data;
-    if (memcpy_s(newBuf, pkgLen, oldBuf->data, bufLen) != EOK) {
+    uint32_t bufLen = oldBuf->w - oldBuf->r;
+    if (memcpy_s(newBuf, pkgLen, oldBuf->r, bufLen) != EOK) {
         SoftBusFree(newBuf);
         return SOFTBUS_MEM_ERR;
     }
     SoftBusFree(oldBuf->data);
     oldBuf->data = newBuf;
     oldBuf->size = pkgLen;
+    oldBuf->r = newBuf;
     oldBuf->w = newBuf + bufLen;
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "TransResizeDataBuffer ok");
     return SOFTBUS_OK;
 }
 
-static int32_t TransTdcProcAllData(int32_t channelId)
+/* called with node->lock held */
+static int32_t TransTdcProcAllData(const TcpDirectChannelInfo *channel, ClientDataBuf *node)
 {
     while (1) {
-        SoftBusMutexLock(&g_tcpDataList->lock);
-        ClientDataBuf *node = TransGetDataBufNodeById(channelId);
-        if (node == NULL) {
-            SoftBusMutexUnlock(&g_tcpDataList->lock);
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "can not find data buf node.");
+        if (node->isDeleted) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "data buf node removed.");
             return SOFTBUS_ERR;
         }
-        uint32_t bufLen = node->w - node->data;
+        uint32_t bufLen = node->w - node->r;
         if (bufLen < DC_DATA_HEAD_SIZE) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "head not enough, recv biz head next time.");
-            SoftBusMutexUnlock(&g_tcpDataList->lock);
             return SOFTBUS_DATA_NOT_ENOUGH;
         }
 
-        TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->data);
+        TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->r);
         if (pktHead->magicNumber != MAGIC_NUMBER) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid data packet head");
-            SoftBusMutexUnlock(&g_tcpDataList->lock);
             return SOFTBUS_ERR;
         }
 
         uint32_t pkgLen = pktHead->dataLen + DC_DATA_HEAD_SIZE;
         if (pkgLen > g_dataBufferMaxLen) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "out of recv data buf size[%d]", pkgLen);
-            SoftBusMutexUnlock(&g_tcpDataList->lock);
             return SOFTBUS_ERR;
         }
 
         if (pkgLen > node->size && pkgLen <= g_dataBufferMaxLen) {
-            int32_t ret = TransResizeDataBuffer(node, pkgLen);
-            SoftBusMutexUnlock(&g_tcpDataList->lock);
-            return ret;
+            return TransResizeDataBuffer(node, pkgLen);
         }
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
 
         if (bufLen < pkgLen) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "data not enough, recv biz data next time.");
             return SOFTBUS_DATA_NOT_ENOUGH;
         }
 
-        if (TransTdcProcessData(channelId) != SOFTBUS_OK) {
+        if (TransTdcProcessData(channel, node) != SOFTBUS_OK) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "data received failed");
             return SOFTBUS_ERR;
         }
     }
 }
 
+/* move the unfinished packet to the front once per recv, instead of shifting the buffer after every packet */
+static void TransCompactDataBuf(ClientDataBuf *node)
+{
+    if (node->r == node->data) {
+        return;
+    }
+    uint32_t bufLen = node->w - node->r;
+    if (bufLen != 0 && memmove_s(node->data, node->size, node->r, bufLen) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memmove fail.");
+    }
+    node->r = node->data;
+    node->w = node->data + bufLen;
+}
+
 int32_t TransTdcRecvData(int32_t channelId)
 {
-    SoftBusMutexLock(&g_tcpDataList->lock);
-    ClientDataBuf *node = TransGetDataBufNodeById(channelId);
+    TcpDirectChannelInfo channel;
+    if (TransTdcGetInfoById(channelId, &channel) == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get key fail.");
+        return SOFTBUS_ERR;
+    }
+    ClientDataBuf *node = TransRefDataBufById(channelId);
     if (node == NULL) {
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "can not find data buf node.");
         return SOFTBUS_ERR;
     }
+
+    SoftBusMutexLock(&node->lock);
+    TransCompactDataBuf(node);
     int32_t ret = RecvTcpData(node->fd, node->w, node->size - (node->w - node->data), 0);
     if (ret <= 0) {
-        SoftBusMutexUnlock(&g_tcpDataList->lock);
+        SoftBusMutexUnlock(&node->lock);
+        TransUnrefDataBuf(node);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "recv tcp data fail.");
         return SOFTBUS_ERR;
     }
     node->w += ret;
-    SoftBusMutexUnlock(&g_tcpDataList->lock);
-
-    return TransTdcProcAllData(channelId);
+    ret = TransTdcProcAllData(&channel, node);
+    SoftBusMutexUnlock(&node->lock);
+    TransUnrefDataBuf(node);
+    return ret;
 }
 
 int32_t TransDataListInit(void)
 {
-    if (g_tcpDataList != NULL) {
+    if (g_tcpDataTable != NULL) {
         return SOFTBUS_OK;
     }
     if (TransGetDataBufMaxSize() != SOFTBUS_OK) {
         return SOFTBUS_ERR;
     }
-    g_tcpDataList = CreateSoftBusList();
-    if (g_tcpDataList == NULL) {
+    ClientDataBufTable *table = (ClientDataBufTable *)SoftBusCalloc(sizeof(ClientDataBufTable));
+    if (table == NULL) {
         return SOFTBUS_ERR;
     }
+    if (SoftBusMutexInit(&table->lock, NULL) != SOFTBUS_OK) {
+        SoftBusFree(table);
+        return SOFTBUS_ERR;
+    }
+    for (uint32_t i = 0; i < TDC_DATA_BUF_BUCKET_NUM; i++) {
+        ListInit(&table->buckets[i]);
+    }
+    g_tcpDataTable = table;
     return SOFTBUS_OK;
 }
 
 void TransDataListDeinit(void)
 {
-    if (g_tcpDataList == NULL) {
+    if (g_tcpDataTable == NULL) {
         return;
     }
     (void)TransDestroyDataBuf();
-    DestroySoftBusList(g_tcpDataList);
-    g_tcpDataList = NULL;
+    SoftBusMutexDestroy(&g_tcpDataTable->lock);
+    SoftBusFree(g_tcpDataTable);
+    g_tcpDataTable = NULL;
 }
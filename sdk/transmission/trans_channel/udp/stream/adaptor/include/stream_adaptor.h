@@ -29,10 +29,13 @@ class StreamAdaptor : public std::enable_shared_from_this<StreamAdaptor> {
 public:
     StreamAdaptor() = delete;
     explicit StreamAdaptor(const std::string &pkgName);
-    ~StreamAdaptor() = default;
+    ~StreamAdaptor();
 
     static ssize_t Encrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen, const char* sessionKey);
     static ssize_t Decrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen, const char *sessionKey);
+    // use the cipher context built from the session key in InitAdaptor
+    ssize_t Encrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen);
+    ssize_t Decrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen);
     static ssize_t GetEncryptOverhead();
     int GetStreamType();
     const char *GetSessionKey();
@@ -53,6 +56,7 @@ private:
     bool serverSide_;
     std::string pkgName_ {};
     std::string sessionKey_;
+    SoftBusCipherCtx *cipherCtx_ = nullptr;
     const IStreamListener *callback_ = nullptr;
     std::atomic<bool> enableState_ = {false};
 };
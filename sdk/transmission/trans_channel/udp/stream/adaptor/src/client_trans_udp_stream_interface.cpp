@@ -58,7 +58,7 @@ int32_t SendVtpStream(int32_t channelId, const StreamData *indata, const StreamD
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
             "bufLen = %zd, GetEncryptOverhead() = %zd", indata->bufLen, adaptor->GetEncryptOverhead());
         std::unique_ptr<char[]> data = std::make_unique<char[]>(dataLen);
-        ssize_t encLen = adaptor->Encrypt(indata->buf, indata->bufLen, data.get(), dataLen, adaptor->GetSessionKey());
+        ssize_t encLen = adaptor->Encrypt(indata->buf, indata->bufLen, data.get(), dataLen);
         if (encLen != dataLen) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
                 "encrypted failed, dataLen = %zd, encryptLen = %zd", dataLen, encLen);
@@ -91,7 +91,15 @@ int32_t SendVtpStream(int32_t channelId, const StreamData *indata, const StreamD
                 return SOFTBUS_ERR;
             }
         }
-        stream = IStream::MakeCommonStream(data, {});
+        /* the frame type goes to the peer, whose receive queue may drop P frames up to the next I frame */
+        Communication::SoftBus::StreamFrameInfo info;
+        int frameType = param->frameType;
+        if (frameType == Communication::SoftBus::VIDEO_I || frameType == Communication::SoftBus::VIDEO_P) {
+            info.frameType = static_cast<Communication::SoftBus::FrameType>(frameType);
+        }
+        /* capture time in ms, the send queue drops frames waiting longer than the max delay after it */
+        info.timestamp = static_cast<uint32_t>(param->timeStamp);
+        stream = IStream::MakeCommonStream(data, info);
     } else {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Do not support");
     }
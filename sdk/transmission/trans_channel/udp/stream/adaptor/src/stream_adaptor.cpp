@@ -33,6 +33,12 @@ using namespace OHOS;
 
 StreamAdaptor::StreamAdaptor(const std::string &pkgName) : pkgName_(pkgName) {}
 
+StreamAdaptor::~StreamAdaptor()
+{
+    SoftBusUnrefCipherCtx(cipherCtx_);
+    cipherCtx_ = nullptr;
+}
+
 ssize_t StreamAdaptor::GetEncryptOverhead()
 {
     return OVERHEAD_LEN;
@@ -82,6 +88,9 @@ void StreamAdaptor::InitAdaptor(int32_t channelId, const VtpStreamOpenParam *par
     streamManager_->PrepareEnvironment(param->pkgName);
     serverSide_ = isServerSide;
     sessionKey_ = std::string(param->sessionKey, SESSION_KEY_LENGTH);
+    SoftBusUnrefCipherCtx(cipherCtx_);
+    cipherCtx_ = SoftBusCreateCipherCtx(reinterpret_cast<const unsigned char *>(param->sessionKey),
+        SESSION_KEY_LENGTH);
     callback_ = callback;
     streamType_ = param->type;
     channelId_ = channelId;
@@ -147,3 +156,39 @@ ssize_t StreamAdaptor::Decrypt(const void *in, ssize_t inLen, void *out, ssize_t
 
     return outLen;
 }
+
+ssize_t StreamAdaptor::Encrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen)
+{
+    if (cipherCtx_ == nullptr) {
+        return Encrypt(in, inLen, out, outLen, sessionKey_.c_str());
+    }
+    if (inLen - OVERHEAD_LEN > outLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Encrypt invalid para.");
+        return SOFTBUS_ERR;
+    }
+    int ret = SoftBusEncryptDataByCtx(cipherCtx_, (unsigned char *)in, inLen, (unsigned char *)out,
+        (unsigned int *)&outLen);
+    if (ret != SOFTBUS_OK || outLen != inLen + OVERHEAD_LEN) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Encrypt Data fail. %d", ret);
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return outLen;
+}
+
+ssize_t StreamAdaptor::Decrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen)
+{
+    if (cipherCtx_ == nullptr) {
+        return Decrypt(in, inLen, out, outLen, sessionKey_.c_str());
+    }
+    if (inLen - OVERHEAD_LEN > outLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Decrypt invalid para.");
+        return SOFTBUS_ERR;
+    }
+    int ret = SoftBusDecryptDataByCtx(cipherCtx_, (unsigned char *)in, inLen, (unsigned char *)out,
+        (unsigned int *)&outLen);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Decrypt Data fail. %d ", ret);
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    return outLen;
+}
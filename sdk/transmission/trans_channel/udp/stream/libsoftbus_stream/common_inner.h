@@ -66,6 +66,19 @@ enum InnerStreamOptionType {
 
     // for link/mac
     LINK_TYPE,
+
+    // for receive queue
+    RECV_DROP_POLICY,
+    RECV_PLAYOUT_DELAY,
+    RECV_DROP_NUM,
+    RECV_LATE_NUM,
+
+    // for send scheduler
+    SEND_MAX_DELAY,
+    SEND_KEY_QUEUE_DEPTH,
+    SEND_NORMAL_QUEUE_DEPTH,
+    SEND_DROP_NUM,
+    SEND_EXPIRED_NUM,
     INNER_STREAM_OPTION_TYPE_MAX = 1000,
 };
 
@@ -16,15 +16,14 @@
 #ifndef STREAM_SOCKET_H
 #define STREAM_SOCKET_H
 
-#include <condition_variable>
 #include <map>
 #include <mutex>
-#include <queue>
 #include <utility>
 
 #include "i_stream.h"
 #include "session.h"
 #include "stream_common.h"
+#include "stream_receive_queue.h"
 
 namespace Communication {
 namespace SoftBus {
@@ -45,10 +44,8 @@ public:
     {
         listenFd_ = -1;
         streamFd_ = -1;
-        epollFd_ = -1;
         isStreamRecv_ = false;
         streamType_ = INVALID;
-        isBlocked_ = false;
     }
     virtual ~IStreamSocket() = default;
 
@@ -60,6 +57,12 @@ public:
     virtual void DestroyStreamSocket() = 0;
 
     virtual bool Connect(const IpAndPort &remote) = 0;
+    /*
+     * True once the frame is queued, not once it is sent: a queued frame may still be dropped, as counted
+     * by SEND_DROP_NUM and SEND_EXPIRED_NUM. False when it is dropped right away or the socket is broken.
+     * A raw stream loses no frame while the socket works: Send waits while its queue is full, and fails
+     * if it stays full.
+     */
     virtual bool Send(std::unique_ptr<IStream> stream) = 0;
 
     virtual bool SetOption(int type, const StreamAttr &value) = 0;
@@ -68,7 +71,6 @@ public:
     virtual bool SetStreamListener(std::shared_ptr<IStreamSocketListener> receiver) = 0;
 
 protected:
-    static constexpr int MAX_EPOLL_NUM = 100;
     static constexpr int MAX_CONNECTION_VALUE = 100;
     static constexpr int FRAME_HEADER_LEN = 4;
     static constexpr int BYTE_TO_BIT = 8;
@@ -80,57 +82,38 @@ protected:
     virtual int CreateAndBindSocket(IpAndPort &local) = 0;
     virtual bool Accept() = 0;
 
-    virtual int EpollTimeout(int fd, int timeout) = 0;
     virtual int SetSocketEpollMode(int fd) = 0;
-    virtual std::unique_ptr<char[]> RecvStream(int dataLength) = 0;
-    virtual std::unique_ptr<IStream> TakeStream()
+    virtual std::unique_ptr<IStream> PollStream()
     {
-        std::unique_lock<std::mutex> lock(streamReceiveLock_);
-        while (isStreamRecv_) {
-            if (!streamReceiveBuffer_.empty()) {
-                auto item = std::move(streamReceiveBuffer_.front());
-                streamReceiveBuffer_.pop();
-                return item;
-            }
-            streamReceiveCv_.wait(lock);
-        }
-        return nullptr;
+        return streamReceiveBuffer_.Poll(StreamReceiveQueue::NowMs());
     }
 
-    virtual void PutStream(std::unique_ptr<IStream> stream)
+    virtual void PutStream(std::unique_ptr<IStream> stream, const StreamFrameInfo &info)
     {
-        std::lock_guard<std::mutex> lock(streamReceiveLock_);
         if (isStreamRecv_) {
-            streamReceiveBuffer_.push(std::move(stream));
-            streamReceiveCv_.notify_all();
+            streamReceiveBuffer_.Put(std::move(stream), info);
         }
     }
 
     virtual int GetStreamNum()
     {
-        std::lock_guard<std::mutex> lock(streamReceiveLock_);
-        return streamReceiveBuffer_.size();
+        return streamReceiveBuffer_.Size();
     }
 
     virtual void QuitStreamBuffer()
     {
-        std::lock_guard<std::mutex> lock(streamReceiveLock_);
         isStreamRecv_ = false;
-        streamReceiveCv_.notify_all();
+        streamReceiveBuffer_.Quit();
     }
 
     int listenFd_;
     int streamFd_;
-    int epollFd_;
     IpAndPort localIpPort_ {};
     IpAndPort remoteIpPort_ {};
     bool isStreamRecv_;
     std::shared_ptr<IStreamSocketListener> streamReceiver_ = nullptr;
-    std::queue<std::unique_ptr<IStream>> streamReceiveBuffer_;
-    std::mutex streamReceiveLock_;
-    std::condition_variable streamReceiveCv_;
+    StreamReceiveQueue streamReceiveBuffer_;
     int streamType_ = INVALID;
-    bool isBlocked_;
     std::string sessionKey_;
 };
 } // namespace SoftBus
@@ -19,13 +19,38 @@
 #include <cstdint>
 #include <memory>
 #include <sys/types.h>
+#include <utility>
 
 #include "stream_common.h"
 
 namespace Communication {
 namespace SoftBus {
+class StreamBufferPool;
+
+/*
+ * Frees a buffer taken from a StreamBufferPool back to its pool, or with delete[] for plain buffers.
+ * The pointer it owns may point into the middle of the pooled block, e.g. at the payload of a frame.
+ */
+struct StreamBufferDeleter {
+    StreamBufferDeleter() = default;
+    StreamBufferDeleter(const std::default_delete<char[]> &deleter)
+    {
+        static_cast<void>(deleter);
+    }
+    StreamBufferDeleter(std::shared_ptr<StreamBufferPool> pool, char *block, int sizeClass)
+        : pool_(std::move(pool)), block_(block), sizeClass_(sizeClass) {}
+
+    void operator()(char *buffer) const;
+
+    std::shared_ptr<StreamBufferPool> pool_ = nullptr;
+    char *block_ = nullptr;
+    int sizeClass_ = -1;
+};
+
+using StreamBuffer = std::unique_ptr<char[], StreamBufferDeleter>;
+
 struct StreamData {
-    std::unique_ptr<char[]> buffer = nullptr;
+    StreamBuffer buffer = nullptr;
     ssize_t bufLen = 0;
     std::unique_ptr<char[]> extBuffer = nullptr;
     ssize_t extLen = 0;
@@ -55,13 +80,14 @@ public:
     virtual void SetTimeStamp(uint32_t timestamp) = 0;
     virtual uint32_t GetTimeStamp() const = 0;
 
-    virtual std::unique_ptr<char[]> GetBuffer() = 0;
+    virtual StreamBuffer GetBuffer() = 0;
     virtual ssize_t GetBufferLen() const = 0;
     virtual std::unique_ptr<char[]> GetExtBuffer() = 0;
     virtual ssize_t GetExtBufferLen() const = 0;
 
     virtual int GetSeqNum() const = 0;
     virtual uint32_t GetStreamId() const = 0;
+    virtual FrameType GetFrameType() const = 0;
 };
 }; // namespace SoftBus
 }; // namespace Communication
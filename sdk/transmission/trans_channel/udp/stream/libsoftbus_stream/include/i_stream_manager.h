@@ -55,10 +55,10 @@ public:
     virtual int CreateStreamClientChannel(IpAndPort &local, IpAndPort remote, Proto protocol,
         int streamType, const std::string &sessionKey) = 0; // 堵塞式
     virtual int CreateStreamServerChannel(IpAndPort &local, Proto protocol,
-        int streamType, const std::string &sessionKey) = 0; // 非堵塞， 内部起线程堵塞式accept
+        int streamType, const std::string &sessionKey) = 0; // 非堵塞，由共享的reactor接受连接
     virtual bool DestroyStreamDataChannel() = 0;
 
-    virtual bool Send(std::unique_ptr<IStream>) = 0;
+    virtual bool Send(std::unique_ptr<IStream>) = 0; // true once queued, the frame may still be dropped later
 
     virtual bool SetOption(int type, const StreamAttr &value) = 0;
     virtual StreamAttr GetOption(int type) const = 0;
@@ -67,8 +67,8 @@ std::unique_ptr<IStream> IStream::MakeRawStream(const char *buf, ssize_t bufLen,
     return raw;
 }
 
-int RawStreamData::InitStreamData(std::unique_ptr<char[]> buffer, ssize_t bufLen,
-    std::unique_ptr<char[]> extBuffer, ssize_t extLen)
+int RawStreamData::InitStreamData(StreamBuffer buffer, ssize_t bufLen, std::unique_ptr<char[]> extBuffer,
+    ssize_t extLen)
 {
     streamData_ = std::move(buffer);
     streamLen_ = bufLen;
@@ -77,9 +77,9 @@ int RawStreamData::InitStreamData(std::unique_ptr<char[]> buffer, ssize_t bufLen
     return 0;
 }
 
-std::unique_ptr<char[]> RawStreamData::GetBuffer()
+StreamBuffer RawStreamData::GetBuffer()
 {
-    return std::unique_ptr<char[]>(streamData_.release());
+    return std::move(streamData_);
 }
 
 ssize_t RawStreamData::GetBufferLen() const
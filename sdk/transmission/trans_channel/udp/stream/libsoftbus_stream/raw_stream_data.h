@@ -32,10 +32,9 @@ public:
     static constexpr int INT_TO_BYTE = 0xff;
     static constexpr int FRAME_HEADER_LEN = 4;
 
-    int InitStreamData(std::unique_ptr<char[]> buffer, ssize_t bufLen, std::unique_ptr<char[]> extBuffer,
-        ssize_t extLen);
+    int InitStreamData(StreamBuffer buffer, ssize_t bufLen, std::unique_ptr<char[]> extBuffer, ssize_t extLen);
 
-    std::unique_ptr<char[]> GetBuffer() override;
+    StreamBuffer GetBuffer() override;
     ssize_t GetBufferLen() const override;
 
     static void InsertBufferLength(int num, int length, uint8_t *output);
@@ -70,7 +69,12 @@ private:
         return 0;
     }
 
-    std::unique_ptr<char[]> streamData_ = nullptr;
+    FrameType GetFrameType() const override
+    {
+        return NONE;
+    }
+
+    StreamBuffer streamData_ = nullptr;
     ssize_t streamLen_ = 0;
 };
 } // namespace SoftBus
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_buffer_pool.h"
+
+#include <new>
+
+#include "common_inner.h"
+
+namespace Communication {
+namespace SoftBus {
+void StreamBufferDeleter::operator()(char *buffer) const
+{
+    char *block = (block_ != nullptr) ? block_ : buffer;
+    if (pool_ == nullptr) {
+        delete[] block;
+        return;
+    }
+    pool_->Release(block, sizeClass_);
+}
+
+StreamBufferPool::~StreamBufferPool()
+{
+    for (int i = 0; i < SIZE_CLASS_NUM; i++) {
+        for (int j = 0; j < freeNum_[i]; j++) {
+            delete[] freeBlocks_[i][j];
+        }
+        freeNum_[i] = 0;
+    }
+}
+
+StreamBuffer StreamBufferPool::Acquire(ssize_t size)
+{
+    if (size <= 0) {
+        return nullptr;
+    }
+
+    int sizeClass = 0;
+    while (sizeClass < SIZE_CLASS_NUM && (MIN_BLOCK_SIZE << sizeClass) < size) {
+        sizeClass++;
+    }
+
+    char *block = nullptr;
+    ssize_t blockSize = size;
+    if (sizeClass < SIZE_CLASS_NUM) {
+        blockSize = MIN_BLOCK_SIZE << sizeClass;
+        std::lock_guard<std::mutex> guard(lock_);
+        if (freeNum_[sizeClass] > 0) {
+            block = freeBlocks_[sizeClass][--freeNum_[sizeClass]];
+        }
+    } else {
+        sizeClass = -1;
+    }
+
+    if (block == nullptr) {
+        block = new (std::nothrow) char[blockSize];
+        if (block == nullptr) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "alloc stream buffer failed, size = %zd", blockSize);
+            return nullptr;
+        }
+    }
+    return StreamBuffer(block, StreamBufferDeleter(shared_from_this(), block, sizeClass));
+}
+
+StreamBuffer StreamBufferPool::SubBuffer(StreamBuffer buffer, ssize_t offset)
+{
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    StreamBufferDeleter deleter = buffer.get_deleter();
+    if (deleter.block_ == nullptr) {
+        deleter.block_ = buffer.get();
+    }
+    char *start = buffer.release() + offset;
+    return StreamBuffer(start, std::move(deleter));
+}
+
+int StreamBufferPool::GetFreeBlockNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    int num = 0;
+    for (int i = 0; i < SIZE_CLASS_NUM; i++) {
+        num += freeNum_[i];
+    }
+    return num;
+}
+
+void StreamBufferPool::Release(char *block, int sizeClass)
+{
+    if (sizeClass >= 0 && sizeClass < SIZE_CLASS_NUM) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (freeNum_[sizeClass] < MAX_FREE_BLOCK_NUM) {
+            freeBlocks_[sizeClass][freeNum_[sizeClass]++] = block;
+            return;
+        }
+    }
+    delete[] block;
+}
+} // namespace SoftBus
+} // namespace Communication
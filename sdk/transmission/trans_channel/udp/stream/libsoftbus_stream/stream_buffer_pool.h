@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_BUFFER_POOL_H
+#define STREAM_BUFFER_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+
+#include "i_stream.h"
+
+namespace Communication {
+namespace SoftBus {
+/*
+ * Frame buffers of one stream socket. Blocks come in power of two size classes and go back to the
+ * free list of their class when the last StreamBuffer on them is released, so a socket that keeps
+ * sending or receiving frames of similar size stops allocating after the first few frames.
+ * Buffers may outlive the socket, they keep the pool alive until they are released.
+ */
+class StreamBufferPool : public std::enable_shared_from_this<StreamBufferPool> {
+public:
+    static constexpr ssize_t MIN_BLOCK_SIZE = 4 * 1024;
+    static constexpr int SIZE_CLASS_NUM = 10; /* 4K up to 2M, bigger blocks are not cached */
+    static constexpr int MAX_FREE_BLOCK_NUM = 4;
+
+    StreamBufferPool() = default;
+    ~StreamBufferPool();
+
+    StreamBufferPool(const StreamBufferPool &) = delete;
+    StreamBufferPool &operator=(const StreamBufferPool &) = delete;
+
+    /* returns a buffer of at least size bytes, nullptr if out of memory */
+    StreamBuffer Acquire(ssize_t size);
+
+    /* the same block seen from offset on, releasing the result releases the whole block */
+    static StreamBuffer SubBuffer(StreamBuffer buffer, ssize_t offset);
+
+    int GetFreeBlockNum() const;
+
+private:
+    friend struct StreamBufferDeleter;
+
+    void Release(char *block, int sizeClass);
+
+    mutable std::mutex lock_;
+    char *freeBlocks_[SIZE_CLASS_NUM][MAX_FREE_BLOCK_NUM] = {};
+    int freeNum_[SIZE_CLASS_NUM] = {};
+};
+} // namespace SoftBus
+} // namespace Communication
+
+#endif
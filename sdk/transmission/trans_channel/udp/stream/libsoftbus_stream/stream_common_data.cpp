@@ -21,20 +21,22 @@ namespace Communication {
 namespace SoftBus {
 std::unique_ptr<IStream> IStream::MakeCommonStream(StreamData &data, const StreamFrameInfo &info)
 {
-    auto stream = std::make_unique<StreamCommonData>(info.streamId, info.seqNum);
+    auto stream = std::make_unique<StreamCommonData>(info.streamId, info.seqNum, info.frameType);
     stream->InitStreamData(std::move(data.buffer), data.bufLen, std::move(data.extBuffer), data.extLen);
+    stream->SetTimeStamp(info.timestamp);
 
     return stream;
 }
 
-StreamCommonData::StreamCommonData(uint32_t streamId, uint16_t seq)
+StreamCommonData::StreamCommonData(uint32_t streamId, uint16_t seq, FrameType frameType)
 {
     curSeqNum_ = seq;
     curStreamId_ = streamId;
+    frameType_ = frameType;
 }
 
-int StreamCommonData::InitStreamData(std::unique_ptr<char[]> inputBuf, ssize_t bufSize,
-    std::unique_ptr<char[]> inputExt, ssize_t extSize)
+int StreamCommonData::InitStreamData(StreamBuffer inputBuf, ssize_t bufSize, std::unique_ptr<char[]> inputExt,
+    ssize_t extSize)
 {
     if (inputBuf == nullptr) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "InitStreamData: Stream MUST not be null");
@@ -30,27 +30,26 @@ namespace SoftBus {
 class StreamCommonData : public IStream {
 public:
     StreamCommonData() = default;
-    StreamCommonData(uint32_t streamId, uint16_t seq);
+    StreamCommonData(uint32_t streamId, uint16_t seq, FrameType frameType = NONE);
 
     virtual ~StreamCommonData() = default;
 
     // 应用调用生成流数据。
-    int InitStreamData(std::unique_ptr<char[]> buffer, ssize_t bufSize, std::unique_ptr<char[]> extBuffer,
-        ssize_t extSize);
+    int InitStreamData(StreamBuffer buffer, ssize_t bufSize, std::unique_ptr<char[]> extBuffer, ssize_t extSize);
 
     void SetTimeStamp(uint32_t timestamp) override
     {
-        static_cast<void>(timestamp);
+        timestamp_ = timestamp;
     }
 
     virtual uint32_t GetTimeStamp() const override
     {
-        return 0;
+        return timestamp_;
     }
 
-    std::unique_ptr<char[]> GetBuffer() override
+    StreamBuffer GetBuffer() override
     {
-        return std::unique_ptr<char[]>(streamData_.release());
+        return std::move(streamData_);
     }
 
     ssize_t GetBufferLen() const override
@@ -78,8 +77,13 @@ public:
         return curStreamId_;
     }
 
+    FrameType GetFrameType() const override
+    {
+        return frameType_;
+    }
+
 protected:
-    std::unique_ptr<char[]> streamData_ = nullptr;
+    StreamBuffer streamData_ = nullptr;
     ssize_t streamLen_ = 0;
 
     /*
@@ -90,6 +94,8 @@ protected:
 
     uint16_t curSeqNum_ = 0;
     uint32_t curStreamId_ = 0;
+    FrameType frameType_ = NONE;
+    uint32_t timestamp_ = 0;
 };
 } // namespace SoftBus
 } // namespace Communication
@@ -36,10 +36,16 @@ void StreamDepacketizer::DepacketizeHeader(const char *header)
     }
 }
 
-void StreamDepacketizer::DepacketizeBuffer(char *buffer)
+void StreamDepacketizer::DepacketizeBuffer(char *buffer, ssize_t bufLen)
 {
     char *ptr = buffer;
     uint32_t tlvTotalLen = 0;
+    if (buffer == nullptr || static_cast<ssize_t>(header_.GetDataLen()) > bufLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+            "DepacketizeBuffer error, header_dataLen = %u, bufLen = %zd", header_.GetDataLen(), bufLen);
+        dataLength_ = -1;
+        return;
+    }
     if (header_.GetExtFlag() != 0) {
         tlvs_.Depacketize(ptr);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO,
@@ -56,12 +62,7 @@ void StreamDepacketizer::DepacketizeBuffer(char *buffer)
             "DepacketizeBuffer error, header_dataLen = %u, tlvTotalLen = %u", header_.GetDataLen(), tlvTotalLen);
         return;
     }
-    data_ = std::make_unique<char[]>(dataLength_);
-    auto ret = memcpy_s(data_.get(), dataLength_, ptr, dataLength_);
-    if (ret != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Failed to memcpy data_, ret:%d", ret);
-        dataLength_ = -1;
-    }
+    data_ = ptr;
 }
 } // namespace SoftBus
 } // namespace Communication
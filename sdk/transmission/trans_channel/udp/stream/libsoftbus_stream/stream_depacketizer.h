@@ -29,7 +29,8 @@ public:
     virtual ~StreamDepacketizer() = default;
 
     void DepacketizeHeader(const char *header);
-    void DepacketizeBuffer(char *buffer);
+    /* the data is not copied, GetData() points into buffer */
+    void DepacketizeBuffer(char *buffer, ssize_t bufLen);
 
     uint32_t GetHeaderDataLen() const
     {
@@ -46,6 +47,19 @@ public:
         return header_.GetSeqNum();
     }
 
+    uint32_t GetTimestamp() const
+    {
+        return header_.GetTimestamp();
+    }
+
+    FrameType GetFrameType() const
+    {
+        if (header_.GetFlag() == 0) {
+            return NONE;
+        }
+        return (header_.GetMarker() != 0) ? VIDEO_I : VIDEO_P;
+    }
+
     std::unique_ptr<char[]> GetUserExt()
     {
         return tlvs_.GetExtBuffer();
@@ -56,9 +70,9 @@ public:
         return tlvs_.GetExtLen();
     }
 
-    std::unique_ptr<char[]> GetData()
+    char *GetData() const
     {
-        return std::move(data_);
+        return data_;
     }
 
     int GetDataLength() const
@@ -70,7 +84,7 @@ private:
     int streamType_;
     StreamPacketHeader header_ {};
     TwoLevelsTlv tlvs_ {};
-    std::unique_ptr<char[]> data_ = nullptr;
+    char *data_ = nullptr;
     int dataLength_ = 0;
 };
 } // namespace SoftBus
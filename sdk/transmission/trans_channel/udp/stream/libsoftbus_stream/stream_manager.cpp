@@ -15,6 +15,8 @@
 
 #include "stream_manager.h"
 
+#include <mutex>
+
 #include "session.h"
 #include "vtp_stream_socket.h"
 
@@ -29,6 +31,28 @@ std::shared_ptr<IStreamManager> IStreamManager::GetInstance(std::shared_ptr<IStr
     return dataManager;
 }
 
+std::shared_ptr<StreamReactor> StreamManager::GetStreamReactor()
+{
+    static std::mutex reactorLock;
+    static std::shared_ptr<StreamReactor> reactor = nullptr;
+    std::lock_guard<std::mutex> guard(reactorLock);
+    if (reactor == nullptr) {
+        reactor = std::make_shared<StreamReactor>();
+    }
+    return reactor;
+}
+
+std::shared_ptr<StreamReactor> StreamManager::GetCallbackReactor()
+{
+    static std::mutex reactorLock;
+    static std::shared_ptr<StreamReactor> reactor = nullptr;
+    std::lock_guard<std::mutex> guard(reactorLock);
+    if (reactor == nullptr) {
+        reactor = std::make_shared<StreamReactor>();
+    }
+    return reactor;
+}
+
 bool StreamManager::PrepareEnvironment(const std::string &pkgName)
 {
     return VtpStreamSocket::InitVtpInstance(pkgName);
@@ -47,7 +71,7 @@ int StreamManager::CreateStreamClientChannel(IpAndPort &local, IpAndPort remote,
 
     std::shared_ptr<IStreamSocket> streamSocket = nullptr;
     if (protocol == VTP) {
-        streamSocket = std::make_shared<VtpStreamSocket>();
+        streamSocket = std::make_shared<VtpStreamSocket>(GetStreamReactor(), GetCallbackReactor());
     } else {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "do not support %d protocol", protocol);
         return -1;
@@ -77,7 +101,7 @@ int StreamManager::CreateStreamServerChannel(IpAndPort &local, Proto protocol,
 
     std::shared_ptr<IStreamSocket> streamSocket = nullptr;
     if (protocol == VTP) {
-        streamSocket = std::make_shared<VtpStreamSocket>();
+        streamSocket = std::make_shared<VtpStreamSocket>(GetStreamReactor(), GetCallbackReactor());
     } else {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "do not support %d protocol", protocol);
         return -1;
@@ -27,6 +27,7 @@
 #include "i_stream_socket.h"
 #include "session.h"
 #include "stream_common.h"
+#include "stream_reactor.h"
 
 namespace Communication {
 namespace SoftBus {
@@ -93,6 +94,11 @@ public:
         return msgManager_;
     }
 
+    /* the stream sockets of all channels share its threads, so they do not grow with the channel number */
+    static std::shared_ptr<StreamReactor> GetStreamReactor();
+    /* runs the listener calls of all stream sockets, apart from their I/O */
+    static std::shared_ptr<StreamReactor> GetCallbackReactor();
+
 private:
     StreamManager(const StreamManager &) = delete;
     StreamManager(StreamManager &&) = delete;
@@ -328,6 +328,10 @@ public:
         return commonHeader_.marker;
     }
 
+    void SetFlag(uint8_t flag)
+    {
+        commonHeader_.flag = flag;
+    }
     uint8_t GetFlag() const
     {
         return commonHeader_.flag;
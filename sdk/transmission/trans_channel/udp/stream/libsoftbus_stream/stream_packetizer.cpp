@@ -43,21 +43,27 @@ ssize_t StreamPacketizer::CalculateExtSize(ssize_t extSize) const
     return total;
 }
 
-std::unique_ptr<char[]> StreamPacketizer::PacketizeStream()
+bool StreamPacketizer::PacketizeStream(char *out, ssize_t outLen)
 {
-    dataSize_ = originData_->GetBufferLen();
-    hdrSize_ = CalculateHeaderSize();
-    extSize_ = CalculateExtSize(originData_->GetExtBufferLen());
-    auto data = std::make_unique<char[]>(hdrSize_ + extSize_ + dataSize_);
+    if (out == nullptr || outLen < GetPacketLen()) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "packetize buffer too small, outLen = %zd", outLen);
+        return false;
+    }
 
     auto streamPktHeader = StreamPacketHeader(streamType_, extSize_ > 0, originData_->GetSeqNum(),
         originData_->GetStreamId(), extSize_ + dataSize_);
-    streamPktHeader.Packetize(data.get(), hdrSize_, 0);
+    FrameType frameType = originData_->GetFrameType();
+    if (frameType == VIDEO_I || frameType == VIDEO_P) {
+        /* flag says the frame type is known, marker says it is a key frame. Older peers ignore both. */
+        streamPktHeader.SetFlag(1);
+        streamPktHeader.SetMarker((frameType == VIDEO_I) ? 1 : 0);
+    }
+    streamPktHeader.Packetize(out, hdrSize_, 0);
 
     TwoLevelsTlv tlv(originData_->GetExtBuffer(), originData_->GetExtBufferLen());
-    if (tlv.Packetize(data.get(), extSize_, hdrSize_) != 0) {
+    if (tlv.Packetize(out, extSize_, hdrSize_) != 0) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "packetize tlv failed");
-        return nullptr;
+        return false;
     }
 
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO,
@@ -75,13 +81,14 @@ std::unique_ptr<char[]> StreamPacketizer::PacketizeStream()
         "TLV version: %d, num = %d, extSize = %zd, extLen = %zd, checksum = %u",
         tlv.GetVersion(), tlv.GetTlvNums(), extSize_, tlv.GetExtLen(), tlv.GetCheckSum());
 
-    auto ret = memcpy_s(data.get() + hdrSize_ + extSize_, dataSize_, originData_->GetBuffer().get(),
+    auto ret = memcpy_s(out + hdrSize_ + extSize_, dataSize_, originData_->GetBuffer().get(),
         originData_->GetBufferLen());
     if (ret != 0) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Failed to memcpy data!, ret:%d", ret);
+        return false;
     }
 
-    return data;
+    return true;
 }
 } // namespace SoftBus
 } // namespace Communication
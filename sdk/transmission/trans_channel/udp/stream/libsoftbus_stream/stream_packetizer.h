@@ -30,13 +30,17 @@ public:
     {
         originData_ = std::move(data);
         streamType_ = streamType;
+        dataSize_ = originData_->GetBufferLen();
+        hdrSize_ = CalculateHeaderSize();
+        extSize_ = CalculateExtSize(originData_->GetExtBufferLen());
     }
     virtual ~StreamPacketizer() = default;
 
     ssize_t CalculateHeaderSize() const;
     ssize_t CalculateExtSize(ssize_t extSize) const;
 
-    std::unique_ptr<char[]> PacketizeStream();
+    /* writes the packet of GetPacketLen() bytes to out, which the caller places inside its frame buffer */
+    bool PacketizeStream(char *out, ssize_t outLen);
     ssize_t GetPacketLen() const
     {
         return hdrSize_ + dataSize_ + extSize_;
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_reactor.h"
+
+#include <chrono>
+
+#include "common_inner.h"
+#include "fillpinc.h"
+
+namespace Communication {
+namespace SoftBus {
+StreamReactor::StreamReactor(int workerNum)
+{
+    if (workerNum <= 0) {
+        workerNum = 1;
+    }
+    for (int i = 0; i < workerNum; i++) {
+        workers_.emplace_back(&StreamReactor::WorkerLoop, this);
+    }
+}
+
+StreamReactor::~StreamReactor()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        isStop_ = true;
+        cv_.notify_all();
+    }
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+    if (loopThread_.joinable()) {
+        loopThread_.join();
+    }
+    if (epollFd_ != -1) {
+        FtClose(epollFd_);
+        epollFd_ = -1;
+    }
+}
+
+bool StreamReactor::AddFd(int fd, EventHandler handler)
+{
+    std::thread exitedLoop;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (isStop_) {
+            return false;
+        }
+        if (epollFd_ == -1) {
+            epollFd_ = FtEpollCreate();
+            if (epollFd_ < 0) {
+                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Failed to create epoll fd:%d", FtGetErrno());
+                epollFd_ = -1;
+                return false;
+            }
+        }
+
+        struct SpungeEpollEvent event = {0};
+        event.events = SPUNGE_EPOLLIN;
+        event.data.fd = fd;
+        int ret = FtEpollCtl(epollFd_, SPUNGE_EPOLL_CTL_ADD, fd, &event);
+        if (ret != ERR_OK) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+                "FtEpollCtl failed, fd = %d, ret = %d, errno = %d", fd, ret, FtGetErrno());
+            if (handlers_.empty()) {
+                FtClose(epollFd_);
+                epollFd_ = -1;
+            }
+            return false;
+        }
+        handlers_[fd] = std::move(handler);
+
+        if (!isLoopRunning_) {
+            exitedLoop = std::move(loopThread_);
+            isLoopRunning_ = true;
+            loopThread_ = std::thread(&StreamReactor::EventLoop, this, epollFd_);
+        }
+    }
+    if (exitedLoop.joinable()) {
+        exitedLoop.join();
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "add fd %d to stream reactor", fd);
+    return true;
+}
+
+void StreamReactor::RemoveFd(int fd)
+{
+    std::thread loop;
+    int epollFd = -1;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (handlers_.erase(fd) == 0) {
+            return;
+        }
+        if (!handlers_.empty()) {
+            (void)FtEpollCtl(epollFd_, SPUNGE_EPOLL_CTL_DEL, fd, nullptr);
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "remove fd %d from stream reactor", fd);
+            return;
+        }
+        /* the epoll thread leaves once its epoll fd is no longer current, an AddFd meanwhile makes a new one */
+        epollFd = epollFd_;
+        epollFd_ = -1;
+        loop = std::move(loopThread_);
+        isLoopRunning_ = false;
+    }
+    /* closed only after the wait on it returned, but before FillP may be destroyed with the last socket */
+    if (loop.joinable()) {
+        loop.join();
+    }
+    if (epollFd != -1) {
+        FtClose(epollFd);
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "remove fd %d from stream reactor, no fd left", fd);
+}
+
+void StreamReactor::Post(Task task)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    if (isStop_) {
+        return;
+    }
+    tasks_.push_back(std::move(task));
+    cv_.notify_one();
+}
+
+uint32_t StreamReactor::AddTimer(int delayMs, Task task, int periodMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    uint32_t timerId = nextTimerId_++;
+    if (nextTimerId_ == 0) {
+        nextTimerId_ = 1;
+    }
+    int64_t due = NowMs() + ((delayMs > 0) ? delayMs : 0);
+    Timer timer;
+    timer.task = std::move(task);
+    timer.periodMs = (periodMs > 0) ? periodMs : 0;
+    timers_.emplace(TimerKey(due, timerId), std::move(timer));
+    timerDue_[timerId] = due;
+    cv_.notify_one();
+    return timerId;
+}
+
+void StreamReactor::CancelTimer(uint32_t timerId)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = timerDue_.find(timerId);
+    if (it == timerDue_.end()) {
+        return;
+    }
+    timers_.erase(TimerKey(it->second, timerId));
+    timerDue_.erase(it);
+}
+
+int StreamReactor::GetThreadNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return static_cast<int>(workers_.size()) + (isLoopRunning_ ? 1 : 0);
+}
+
+void StreamReactor::EventLoop(int epollFd)
+{
+    struct SpungeEpollEvent events[MAX_EPOLL_NUM];
+    while (true) {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            if (isStop_ || epollFd != epollFd_) {
+                break;
+            }
+        }
+
+        FILLP_INT fdNum = FtEpollWait(epollFd, events, MAX_EPOLL_NUM, EPOLL_WAIT_TIMEOUT);
+        if (fdNum < 0) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+                "FtEpollWait failed, ret = %d, errno = %d", fdNum, FtGetErrno());
+            continue;
+        }
+        for (FILLP_INT i = 0; i < fdNum; i++) {
+            EventHandler handler = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                auto it = handlers_.find(events[i].data.fd);
+                if (it != handlers_.end()) {
+                    handler = it->second;
+                }
+            }
+            if (handler != nullptr) {
+                handler(events[i].events);
+            }
+        }
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "stream reactor epoll thread exit, epollFd = %d", epollFd);
+}
+
+void StreamReactor::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!isStop_) {
+        if (!tasks_.empty()) {
+            Task task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            task = nullptr;
+            lock.lock();
+            continue;
+        }
+        if (RunNextTimer(lock)) {
+            continue;
+        }
+        if (timers_.empty()) {
+            cv_.wait(lock);
+        } else {
+            cv_.wait_until(lock, std::chrono::steady_clock::time_point(
+                std::chrono::milliseconds(timers_.begin()->first.first)));
+        }
+    }
+}
+
+bool StreamReactor::RunNextTimer(std::unique_lock<std::mutex> &lock)
+{
+    if (timers_.empty()) {
+        return false;
+    }
+    auto it = timers_.begin();
+    int64_t now = NowMs();
+    if (it->first.first > now) {
+        return false;
+    }
+
+    uint32_t timerId = it->first.second;
+    Task task = it->second.task;
+    if (it->second.periodMs > 0) {
+        int64_t due = it->first.first + it->second.periodMs;
+        if (due <= now) {
+            due = now + it->second.periodMs;
+        }
+        Timer timer = std::move(it->second);
+        timers_.erase(it);
+        timers_.emplace(TimerKey(due, timerId), std::move(timer));
+        timerDue_[timerId] = due;
+    } else {
+        timers_.erase(it);
+        timerDue_.erase(timerId);
+    }
+
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+    return true;
+}
+
+int64_t StreamReactor::NowMs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+void SerialTask::Schedule()
+{
+    if (pending_.fetch_add(1) != 0) {
+        return;
+    }
+    auto self = shared_from_this();
+    reactor_->Post([self]() { self->Run(); });
+}
+
+void SerialTask::Stop()
+{
+    isStopped_ = true;
+    if (runner_.load() == std::this_thread::get_id()) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(runLock_);
+}
+
+void SerialTask::Run()
+{
+    std::lock_guard<std::mutex> guard(runLock_);
+    runner_ = std::this_thread::get_id();
+    int handled = pending_.load();
+    while (true) {
+        if (!isStopped_) {
+            task_();
+        }
+        int left = pending_.fetch_sub(handled) - handled;
+        if (left == 0) {
+            break;
+        }
+        handled = left;
+    }
+    runner_ = std::thread::id();
+}
+} // namespace SoftBus
+} // namespace Communication
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_REACTOR_H
+#define STREAM_REACTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Communication {
+namespace SoftBus {
+/*
+ * Runs the I/O of all stream sockets of the process on a fixed set of threads: one thread waits on a FillP
+ * epoll for every registered fd, a small pool of workers runs the posted tasks and the timers.
+ * Fd handlers run on the epoll thread and must only post work. Removing the last fd stops and joins the
+ * epoll thread before its epoll fd is closed, so that FillP can be destroyed, the next AddFd starts it again.
+ */
+class StreamReactor {
+public:
+    using Task = std::function<void()>;
+    using EventHandler = std::function<void(uint32_t events)>;
+
+    static constexpr int DEFAULT_WORKER_NUM = 4;
+    static constexpr int EPOLL_WAIT_TIMEOUT = 100; /* ms, how long removing the last fd may wait for the thread */
+    static constexpr int MAX_EPOLL_NUM = 100;
+
+    explicit StreamReactor(int workerNum = DEFAULT_WORKER_NUM);
+    ~StreamReactor();
+
+    StreamReactor(const StreamReactor &) = delete;
+    StreamReactor &operator=(const StreamReactor &) = delete;
+
+    /* the fd is watched level triggered for SPUNGE_EPOLLIN, remove it before closing it */
+    bool AddFd(int fd, EventHandler handler);
+    /* not from an fd handler, removing the last fd joins the epoll thread */
+    void RemoveFd(int fd);
+
+    void Post(Task task);
+    /* a period of 0 runs the task once, returns the id to cancel it with */
+    uint32_t AddTimer(int delayMs, Task task, int periodMs = 0);
+    /* a run already started is not waited for */
+    void CancelTimer(uint32_t timerId);
+
+    int GetThreadNum() const;
+
+private:
+    struct Timer {
+        Task task;
+        int periodMs = 0;
+    };
+    using TimerKey = std::pair<int64_t, uint32_t>; /* due time, id */
+
+    void EventLoop(int epollFd);
+    void WorkerLoop();
+    bool RunNextTimer(std::unique_lock<std::mutex> &lock);
+    static int64_t NowMs();
+
+    mutable std::mutex lock_;
+    std::condition_variable cv_;
+    bool isStop_ = false;
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+
+    std::map<TimerKey, Timer> timers_;
+    std::map<uint32_t, int64_t> timerDue_;
+    uint32_t nextTimerId_ = 1;
+
+    int epollFd_ = -1;
+    bool isLoopRunning_ = false;
+    std::thread loopThread_;
+    std::map<int, EventHandler> handlers_;
+};
+
+/*
+ * A task that never runs on two workers at once. Scheduling it while it runs makes it run once more
+ * afterwards, so an event arriving during a run is never lost. Once stopped it does not run any more.
+ */
+class SerialTask : public std::enable_shared_from_this<SerialTask> {
+public:
+    SerialTask(std::shared_ptr<StreamReactor> reactor, StreamReactor::Task task)
+        : reactor_(std::move(reactor)), task_(std::move(task)) {}
+    ~SerialTask() = default;
+
+    void Schedule();
+    /* waits for a run in progress on another thread, called from the task itself it just stops */
+    void Stop();
+
+private:
+    void Run();
+
+    std::shared_ptr<StreamReactor> reactor_ = nullptr;
+    StreamReactor::Task task_;
+    std::atomic<int> pending_ {0};
+    std::mutex runLock_;
+    std::atomic<bool> isStopped_ {false};
+    std::atomic<std::thread::id> runner_ {};
+};
+} // namespace SoftBus
+} // namespace Communication
+
+#endif
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_receive_queue.h"
+
+#include <chrono>
+#include <utility>
+
+#include "common_inner.h"
+
+namespace Communication {
+namespace SoftBus {
+StreamReceiveQueue::StreamReceiveQueue(int capacity) : slots_((capacity > 0) ? capacity : DEFAULT_CAPACITY) {}
+
+void StreamReceiveQueue::SetDropPolicy(StreamDropPolicy policy)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    dropPolicy_ = policy;
+    waitKeyFrame_ = false;
+}
+
+StreamDropPolicy StreamReceiveQueue::GetDropPolicy() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return dropPolicy_;
+}
+
+void StreamReceiveQueue::SetPlayoutDelay(int delayMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    playoutDelay_ = (delayMs > 0) ? delayMs : 0;
+    cv_.notify_all();
+}
+
+int StreamReceiveQueue::GetPlayoutDelay() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return playoutDelay_;
+}
+
+bool StreamReceiveQueue::Put(std::unique_ptr<IStream> stream, const StreamFrameInfo &info)
+{
+    return Put(std::move(stream), info, NowMs());
+}
+
+bool StreamReceiveQueue::Put(std::unique_ptr<IStream> stream, const StreamFrameInfo &info, int64_t nowMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    if (isQuit_ || stream == nullptr) {
+        return false;
+    }
+
+    Slot slot;
+    slot.isKeyFrame = (info.frameType != VIDEO_P);
+    slot.playoutTime = nowMs + playoutDelay_;
+    if (playoutDelay_ > 0 && info.timestamp != 0) {
+        slot.isOrdered = true;
+        slot.timestamp = UnwrapTimestamp(info.timestamp);
+        if (hasReleased_ && slot.timestamp < releasedTimestamp_) {
+            lateNum_++;
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "drop late frame, timestamp = %u, late num = %u",
+                info.timestamp, lateNum_);
+            return false;
+        }
+        slot.playoutTime = GetPlayoutTime(slot.timestamp, nowMs);
+    }
+
+    /* a frame that is refused anyway must not push out one already queued */
+    if (waitKeyFrame_ && !slot.isKeyFrame) {
+        dropNum_++;
+        return false;
+    }
+    if (size_ == static_cast<int>(slots_.size())) {
+        if (!slot.isKeyFrame && dropPolicy_ == DROP_UNTIL_KEY_FRAME && !HasKeyFrameBehindFront()) {
+            /* room would take the whole group this frame depends on, its tail goes instead */
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "receive queue full, drop num = %u", dropNum_ + 1);
+            dropNum_++;
+            waitKeyFrame_ = true;
+            return false;
+        }
+        MakeRoom();
+    }
+    if (slot.isKeyFrame) {
+        waitKeyFrame_ = false;
+    }
+
+    slot.stream = std::move(stream);
+    Insert(std::move(slot));
+    cv_.notify_one();
+    return true;
+}
+
+std::unique_ptr<IStream> StreamReceiveQueue::Take()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!isQuit_) {
+        if (size_ == 0) {
+            cv_.wait(lock);
+            continue;
+        }
+        auto stream = TakeFront(NowMs());
+        if (stream != nullptr) {
+            return stream;
+        }
+        auto due = std::chrono::steady_clock::time_point(std::chrono::milliseconds(At(0).playoutTime));
+        cv_.wait_until(lock, due);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<IStream> StreamReceiveQueue::Poll(int64_t nowMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    if (isQuit_) {
+        return nullptr;
+    }
+    return TakeFront(nowMs);
+}
+
+bool StreamReceiveQueue::GetFrontPlayoutTime(int64_t &playoutTime) const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    if (isQuit_ || size_ == 0) {
+        return false;
+    }
+    playoutTime = (playoutDelay_ > 0) ? At(0).playoutTime : 0;
+    return true;
+}
+
+void StreamReceiveQueue::Quit()
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    isQuit_ = true;
+    while (size_ > 0) {
+        PopFront();
+    }
+    cv_.notify_all();
+}
+
+int StreamReceiveQueue::Size() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return size_;
+}
+
+uint32_t StreamReceiveQueue::GetDropNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return dropNum_;
+}
+
+uint32_t StreamReceiveQueue::GetLateNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return lateNum_;
+}
+
+int64_t StreamReceiveQueue::NowMs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+StreamReceiveQueue::Slot &StreamReceiveQueue::At(int index)
+{
+    return slots_[(head_ + index) % slots_.size()];
+}
+
+const StreamReceiveQueue::Slot &StreamReceiveQueue::At(int index) const
+{
+    return slots_[(head_ + index) % slots_.size()];
+}
+
+/* the header carries the low 32 bits of the sender clock in ms, it wraps every 49 days */
+int64_t StreamReceiveQueue::UnwrapTimestamp(uint32_t timestamp)
+{
+    if (!hasTimestamp_) {
+        hasTimestamp_ = true;
+        lastTimestamp_ = timestamp;
+        lastUnwrapped_ = timestamp;
+        return lastUnwrapped_;
+    }
+    int64_t unwrapped = lastUnwrapped_ + static_cast<int32_t>(timestamp - lastTimestamp_);
+    if (unwrapped > lastUnwrapped_) {
+        lastTimestamp_ = timestamp;
+        lastUnwrapped_ = unwrapped;
+    }
+    return unwrapped;
+}
+
+/*
+ * The sender and local clocks are not synchronized, only their difference is known. The frame with the smallest
+ * difference so far took the fastest path, every frame is played as if it had taken that path plus the delay.
+ */
+int64_t StreamReceiveQueue::GetPlayoutTime(int64_t timestamp, int64_t nowMs)
+{
+    int64_t transit = nowMs - timestamp;
+    if (!hasTransit_ || transit < minTransit_) {
+        hasTransit_ = true;
+        minTransit_ = transit;
+    }
+    return timestamp + minTransit_ + playoutDelay_;
+}
+
+void StreamReceiveQueue::PopFront()
+{
+    At(0).stream = nullptr;
+    head_ = (head_ + 1) % static_cast<int>(slots_.size());
+    size_--;
+}
+
+void StreamReceiveQueue::DropFront()
+{
+    PopFront();
+    dropNum_++;
+}
+
+bool StreamReceiveQueue::HasKeyFrameBehindFront() const
+{
+    for (int i = 1; i < size_; i++) {
+        if (At(i).isKeyFrame) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StreamReceiveQueue::MakeRoom()
+{
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "receive queue full, drop num = %u", dropNum_ + 1);
+    DropFront();
+    if (dropPolicy_ != DROP_UNTIL_KEY_FRAME) {
+        return;
+    }
+    while (size_ > 0 && !At(0).isKeyFrame) {
+        DropFront();
+    }
+    waitKeyFrame_ = (size_ == 0);
+}
+
+void StreamReceiveQueue::Insert(Slot &&slot)
+{
+    int pos = size_;
+    while (slot.isOrdered && pos > 0 && At(pos - 1).isOrdered && At(pos - 1).timestamp > slot.timestamp) {
+        At(pos) = std::move(At(pos - 1));
+        pos--;
+    }
+    At(pos) = std::move(slot);
+    size_++;
+}
+
+std::unique_ptr<IStream> StreamReceiveQueue::TakeFront(int64_t nowMs)
+{
+    if (size_ == 0) {
+        return nullptr;
+    }
+    Slot &front = At(0);
+    if (playoutDelay_ > 0 && front.playoutTime > nowMs) {
+        return nullptr;
+    }
+    if (front.isOrdered) {
+        hasReleased_ = true;
+        releasedTimestamp_ = front.timestamp;
+    }
+    auto stream = std::move(front.stream);
+    PopFront();
+    return stream;
+}
+} // namespace SoftBus
+} // namespace Communication
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_RECEIVE_QUEUE_H
+#define STREAM_RECEIVE_QUEUE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "i_stream.h"
+
+namespace Communication {
+namespace SoftBus {
+enum StreamDropPolicy {
+    DROP_OLDEST,
+    /*
+     * a dropped frame also takes the P frames depending on it, up to the next key frame. When no key frame
+     * is queued behind the oldest one, the incoming P frame and those after it are dropped instead.
+     */
+    DROP_UNTIL_KEY_FRAME,
+};
+
+/*
+ * Frames received on a stream socket waiting for the listener. The queue holds at most capacity frames,
+ * on overflow old frames are dropped by the drop policy instead of letting a slow listener grow memory
+ * and latency.
+ * With a playout delay set, the queue is also a jitter buffer: frames are kept in timestamp order and
+ * each one is released playout delay after the time it was due, as seen from the fastest frame so far.
+ * A frame arriving after a later one was released is late and dropped.
+ */
+class StreamReceiveQueue {
+public:
+    static constexpr int DEFAULT_CAPACITY = 32;
+
+    explicit StreamReceiveQueue(int capacity = DEFAULT_CAPACITY);
+    ~StreamReceiveQueue() = default;
+
+    StreamReceiveQueue(const StreamReceiveQueue &) = delete;
+    StreamReceiveQueue &operator=(const StreamReceiveQueue &) = delete;
+
+    void SetDropPolicy(StreamDropPolicy policy);
+    StreamDropPolicy GetDropPolicy() const;
+    /* 0 turns the jitter buffer off, frames are then taken in arrival order at once */
+    void SetPlayoutDelay(int delayMs);
+    int GetPlayoutDelay() const;
+
+    /* returns false if the frame was dropped */
+    bool Put(std::unique_ptr<IStream> stream, const StreamFrameInfo &info);
+    bool Put(std::unique_ptr<IStream> stream, const StreamFrameInfo &info, int64_t nowMs);
+    /* blocks until a frame is due, nullptr once the queue is quit */
+    std::unique_ptr<IStream> Take();
+    /* the frame due at nowMs if any, never blocks */
+    std::unique_ptr<IStream> Poll(int64_t nowMs);
+    /* when the first frame is due, false if the queue is empty */
+    bool GetFrontPlayoutTime(int64_t &playoutTime) const;
+    void Quit();
+
+    int Size() const;
+    uint32_t GetDropNum() const;
+    uint32_t GetLateNum() const;
+
+    static int64_t NowMs();
+
+private:
+    struct Slot {
+        std::unique_ptr<IStream> stream = nullptr;
+        int64_t timestamp = 0;
+        int64_t playoutTime = 0;
+        bool isOrdered = false; /* false for frames without timestamp, they keep their arrival order */
+        bool isKeyFrame = true;
+    };
+
+    Slot &At(int index);
+    const Slot &At(int index) const;
+    int64_t UnwrapTimestamp(uint32_t timestamp);
+    int64_t GetPlayoutTime(int64_t timestamp, int64_t nowMs);
+    void PopFront();
+    void DropFront();
+    bool HasKeyFrameBehindFront() const;
+    void MakeRoom();
+    void Insert(Slot &&slot);
+    std::unique_ptr<IStream> TakeFront(int64_t nowMs);
+
+    mutable std::mutex lock_;
+    std::condition_variable cv_;
+    std::vector<Slot> slots_;
+    int head_ = 0;
+    int size_ = 0;
+    bool isQuit_ = false;
+
+    StreamDropPolicy dropPolicy_ = DROP_OLDEST;
+    bool waitKeyFrame_ = false;
+
+    int playoutDelay_ = 0;
+    bool hasTimestamp_ = false;
+    uint32_t lastTimestamp_ = 0;
+    int64_t lastUnwrapped_ = 0;
+    bool hasTransit_ = false;
+    int64_t minTransit_ = 0;
+    bool hasReleased_ = false;
+    int64_t releasedTimestamp_ = 0;
+
+    uint32_t dropNum_ = 0;
+    uint32_t lateNum_ = 0;
+};
+} // namespace SoftBus
+} // namespace Communication
+
+#endif
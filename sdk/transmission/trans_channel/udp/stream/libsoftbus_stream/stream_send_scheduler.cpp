@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stream_send_scheduler.h"
+
+#include <chrono>
+#include <utility>
+
+#include "common_inner.h"
+
+namespace Communication {
+namespace SoftBus {
+StreamSendScheduler::StreamSendScheduler(Transport transport, int capacity)
+    : transport_(std::move(transport)), capacity_((capacity > 0) ? capacity : DEFAULT_CAPACITY) {}
+
+void StreamSendScheduler::SetLossless(bool isLossless, int waitMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    isLossless_ = isLossless;
+    waitTime_ = (waitMs > 0) ? waitMs : 0;
+}
+
+bool StreamSendScheduler::IsLossless() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return isLossless_;
+}
+
+void StreamSendScheduler::SetMaxDelay(int delayMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    maxDelay_ = (delayMs > 0) ? delayMs : 0;
+}
+
+int StreamSendScheduler::GetMaxDelay() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return maxDelay_;
+}
+
+bool StreamSendScheduler::Push(StreamBuffer frame, int frameLen, FrameType frameType, uint32_t timestamp,
+    int64_t nowMs)
+{
+    if (frame == nullptr || frameLen <= 0) {
+        return false;
+    }
+    std::unique_lock<std::mutex> guard(lock_);
+    if (isBroken_) {
+        return false;
+    }
+    if (isLossless_) {
+        auto &queue = queues_[SEND_PRIORITY_NORMAL];
+        bool hasRoom = roomCond_.wait_for(guard, std::chrono::milliseconds(waitTime_),
+            [this, &queue]() { return isBroken_ || static_cast<int>(queue.size()) < capacity_; });
+        if (!hasRoom || isBroken_) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "lossless send queue stays full, frame refused");
+            return false;
+        }
+        Frame item;
+        item.buffer = std::move(frame);
+        item.len = frameLen;
+        item.frameType = frameType;
+        queue.push_back(std::move(item));
+        return true;
+    }
+
+    StreamSendPriority priority = (frameType == VIDEO_I) ? SEND_PRIORITY_KEY : SEND_PRIORITY_NORMAL;
+    int64_t captureTime = (timestamp != 0) ? GetCaptureTime(timestamp, nowMs) : nowMs;
+    if (priority == SEND_PRIORITY_NORMAL && maxDelay_ != 0 && nowMs - captureTime > maxDelay_) {
+        expiredNum_++;
+        return false;
+    }
+    if (priority == SEND_PRIORITY_KEY) {
+        DropSuperseded();
+    }
+
+    auto &queue = queues_[priority];
+    if (static_cast<int>(queue.size()) >= capacity_) {
+        queue.pop_front();
+        dropNum_++;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "send queue %d is full, drop num = %u", priority, dropNum_);
+    }
+
+    Frame item;
+    item.buffer = std::move(frame);
+    item.len = frameLen;
+    item.frameType = frameType;
+    item.captureTime = captureTime;
+    queue.push_back(std::move(item));
+    return true;
+}
+
+bool StreamSendScheduler::Flush(int64_t nowMs)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    while (!isBroken_) {
+        if (current_.buffer == nullptr && !TakeNext(nowMs)) {
+            return true;
+        }
+        int ret = transport_(current_.buffer.get() + offset_, current_.len - offset_);
+        if (ret < 0) {
+            isBroken_ = true;
+            DropAll();
+            break;
+        }
+        if (ret == 0) {
+            return true;
+        }
+        offset_ += ret;
+        if (offset_ >= current_.len) {
+            current_ = Frame();
+            offset_ = 0;
+            sentNum_++;
+        }
+    }
+    return false;
+}
+
+bool StreamSendScheduler::IsEmpty() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    if (current_.buffer != nullptr) {
+        return false;
+    }
+    for (const auto &queue : queues_) {
+        if (!queue.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StreamSendScheduler::IsBroken() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return isBroken_;
+}
+
+int StreamSendScheduler::GetQueueDepth(StreamSendPriority priority) const
+{
+    if (priority < SEND_PRIORITY_KEY || priority >= SEND_PRIORITY_NUM) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    return static_cast<int>(queues_[priority].size());
+}
+
+uint32_t StreamSendScheduler::GetSentNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return sentNum_;
+}
+
+uint32_t StreamSendScheduler::GetDropNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return dropNum_;
+}
+
+uint32_t StreamSendScheduler::GetExpiredNum() const
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return expiredNum_;
+}
+
+int64_t StreamSendScheduler::NowMs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+/*
+ * The clock of the application is not the local one, only their difference is known. The frame queued with
+ * the smallest difference so far waited the least, every frame is taken as captured that long before.
+ */
+int64_t StreamSendScheduler::GetCaptureTime(uint32_t timestamp, int64_t nowMs)
+{
+    if (!hasTimestamp_) {
+        hasTimestamp_ = true;
+        lastTimestamp_ = timestamp;
+        lastUnwrapped_ = timestamp;
+        minTransit_ = nowMs - lastUnwrapped_;
+        return nowMs;
+    }
+    int64_t unwrapped = lastUnwrapped_ + static_cast<int32_t>(timestamp - lastTimestamp_);
+    if (unwrapped > lastUnwrapped_) {
+        lastTimestamp_ = timestamp;
+        lastUnwrapped_ = unwrapped;
+    }
+    if (nowMs - unwrapped < minTransit_) {
+        minTransit_ = nowMs - unwrapped;
+    }
+    return unwrapped + minTransit_;
+}
+
+/* P frames queued before a key frame would reach the peer after it, their reference is gone by then */
+void StreamSendScheduler::DropSuperseded()
+{
+    auto &queue = queues_[SEND_PRIORITY_NORMAL];
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (it->frameType == VIDEO_P) {
+            it = queue.erase(it);
+            dropNum_++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void StreamSendScheduler::DropExpired(int64_t nowMs)
+{
+    if (maxDelay_ == 0 || isLossless_) {
+        return;
+    }
+    auto &queue = queues_[SEND_PRIORITY_NORMAL];
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (nowMs - it->captureTime > maxDelay_) {
+            it = queue.erase(it);
+            expiredNum_++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool StreamSendScheduler::TakeNext(int64_t nowMs)
+{
+    DropExpired(nowMs);
+    for (auto &queue : queues_) {
+        if (!queue.empty()) {
+            current_ = std::move(queue.front());
+            queue.pop_front();
+            offset_ = 0;
+            roomCond_.notify_all();
+            return true;
+        }
+    }
+    return false;
+}
+
+/* the frames no transport will take any more, the one partly sent included */
+void StreamSendScheduler::DropAll()
+{
+    if (current_.buffer != nullptr) {
+        current_ = Frame();
+        offset_ = 0;
+        dropNum_++;
+    }
+    for (auto &queue : queues_) {
+        dropNum_ += static_cast<uint32_t>(queue.size());
+        queue.clear();
+    }
+    roomCond_.notify_all();
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "send transport is broken, drop num = %u", dropNum_);
+}
+} // namespace SoftBus
+} // namespace Communication
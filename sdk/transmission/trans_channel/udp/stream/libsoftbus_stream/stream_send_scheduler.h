@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STREAM_SEND_SCHEDULER_H
+#define STREAM_SEND_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "i_stream.h"
+
+namespace Communication {
+namespace SoftBus {
+enum StreamSendPriority {
+    SEND_PRIORITY_KEY,
+    SEND_PRIORITY_NORMAL,
+    SEND_PRIORITY_NUM,
+};
+
+/*
+ * Packetized frames of a stream socket waiting for the transport. Key frames go before every other frame,
+ * a queued P frame older than a queued key frame is dropped, as the peer could only decode it before that
+ * key frame. With a max delay set, frames other than key frames are dropped once they are older than it,
+ * counted from their capture time as seen from the fastest frame so far, or from when they were queued
+ * if they have no timestamp. A frame partly taken by the transport is always finished. Once the transport
+ * is broken the queued frames are dropped and no frame is taken any more.
+ * A lossless scheduler, for byte streams that can not lose a frame, drops nothing while the transport works:
+ * frames keep their order, and a frame pushed into a full queue waits for room instead.
+ */
+class StreamSendScheduler {
+public:
+    static constexpr int DEFAULT_CAPACITY = 32; /* frames per priority */
+    static constexpr int DEFAULT_WAIT_TIME = 2000; /* ms a lossless push waits for room */
+
+    /* the bytes taken, 0 when the transport takes nothing now, -1 when it is broken */
+    using Transport = std::function<int(const char *buffer, int len)>;
+
+    explicit StreamSendScheduler(Transport transport, int capacity = DEFAULT_CAPACITY);
+    ~StreamSendScheduler() = default;
+
+    StreamSendScheduler(const StreamSendScheduler &) = delete;
+    StreamSendScheduler &operator=(const StreamSendScheduler &) = delete;
+
+    /* a push into a full lossless queue fails after waitMs */
+    void SetLossless(bool isLossless, int waitMs = DEFAULT_WAIT_TIME);
+    bool IsLossless() const;
+
+    /* 0 lets frames wait until the transport takes them, a lossless scheduler ignores it */
+    void SetMaxDelay(int delayMs);
+    int GetMaxDelay() const;
+
+    /*
+     * The timestamp is the capture time in ms on the clock of the application, 0 if it has none. False when
+     * the frame is not queued: the transport is broken, the frame is already older than the max delay, or a
+     * lossless queue stayed full.
+     */
+    bool Push(StreamBuffer frame, int frameLen, FrameType frameType, uint32_t timestamp, int64_t nowMs);
+    /* sends until the queues are empty or the transport takes nothing more, false once it is broken */
+    bool Flush(int64_t nowMs);
+
+    bool IsEmpty() const;
+    bool IsBroken() const;
+    /* the frame being sent is not counted */
+    int GetQueueDepth(StreamSendPriority priority) const;
+    uint32_t GetSentNum() const;
+    uint32_t GetDropNum() const;
+    uint32_t GetExpiredNum() const;
+
+    static int64_t NowMs();
+
+private:
+    struct Frame {
+        StreamBuffer buffer = nullptr;
+        int len = 0;
+        FrameType frameType = NONE;
+        int64_t captureTime = 0;
+    };
+
+    int64_t GetCaptureTime(uint32_t timestamp, int64_t nowMs);
+    void DropSuperseded();
+    void DropExpired(int64_t nowMs);
+    bool TakeNext(int64_t nowMs);
+    void DropAll();
+
+    mutable std::mutex lock_;
+    std::condition_variable roomCond_;
+    Transport transport_;
+    int capacity_ = DEFAULT_CAPACITY;
+    std::deque<Frame> queues_[SEND_PRIORITY_NUM];
+    Frame current_;
+    int offset_ = 0;
+    bool isBroken_ = false;
+    bool isLossless_ = false;
+    int waitTime_ = DEFAULT_WAIT_TIME;
+
+    int maxDelay_ = 0;
+    bool hasTimestamp_ = false;
+    uint32_t lastTimestamp_ = 0;
+    int64_t lastUnwrapped_ = 0;
+    int64_t minTransit_ = 0;
+
+    uint32_t sentNum_ = 0;
+    uint32_t dropNum_ = 0;
+    uint32_t expiredNum_ = 0;
+};
+} // namespace SoftBus
+} // namespace Communication
+
+#endif
@@ -15,7 +15,6 @@
 
 #include "vtp_stream_socket.h"
 
-#include <chrono>
 #include <ifaddrs.h>
 #include <memory>
 #include <netinet/in.h>
@@ -120,7 +119,8 @@ void VtpStreamSocket::InsertElementToFuncMap(int type, ValueType valueType, MySe
     optFuncMap_.insert(std::pair<int, OptionFunc>(type, fun));
 }
 
-VtpStreamSocket::VtpStreamSocket()
+VtpStreamSocket::VtpStreamSocket(std::shared_ptr<StreamReactor> reactor,
+    std::shared_ptr<StreamReactor> callbackReactor) : reactor_(reactor), callbackReactor_(callbackReactor)
 {
     InsertElementToFuncMap(TOS, INT_TYPE, &VtpStreamSocket::SetIpTos, &VtpStreamSocket::GetIpTos);
     InsertElementToFuncMap(FD, INT_TYPE, nullptr, &VtpStreamSocket::GetStreamSocketFd);
@@ -162,6 +162,18 @@ VtpStreamSocket::VtpStreamSocket()
     InsertElementToFuncMap(IS_SERVER, INT_TYPE, nullptr, &VtpStreamSocket::IsServer);
     InsertElementToFuncMap(SCENE, INT_TYPE, &VtpStreamSocket::SetStreamScene, nullptr);
     InsertElementToFuncMap(STREAM_HEADER_SIZE, INT_TYPE, &VtpStreamSocket::SetStreamHeaderSize, nullptr);
+    InsertElementToFuncMap(RECV_DROP_POLICY, INT_TYPE, &VtpStreamSocket::SetRecvQueueConfig,
+        &VtpStreamSocket::GetRecvQueueConfig);
+    InsertElementToFuncMap(RECV_PLAYOUT_DELAY, INT_TYPE, &VtpStreamSocket::SetRecvQueueConfig,
+        &VtpStreamSocket::GetRecvQueueConfig);
+    InsertElementToFuncMap(RECV_DROP_NUM, INT_TYPE, nullptr, &VtpStreamSocket::GetRecvQueueConfig);
+    InsertElementToFuncMap(RECV_LATE_NUM, INT_TYPE, nullptr, &VtpStreamSocket::GetRecvQueueConfig);
+    InsertElementToFuncMap(SEND_MAX_DELAY, INT_TYPE, &VtpStreamSocket::SetSendQueueConfig,
+        &VtpStreamSocket::GetSendQueueConfig);
+    InsertElementToFuncMap(SEND_KEY_QUEUE_DEPTH, INT_TYPE, nullptr, &VtpStreamSocket::GetSendQueueConfig);
+    InsertElementToFuncMap(SEND_NORMAL_QUEUE_DEPTH, INT_TYPE, nullptr, &VtpStreamSocket::GetSendQueueConfig);
+    InsertElementToFuncMap(SEND_DROP_NUM, INT_TYPE, nullptr, &VtpStreamSocket::GetSendQueueConfig);
+    InsertElementToFuncMap(SEND_EXPIRED_NUM, INT_TYPE, nullptr, &VtpStreamSocket::GetSendQueueConfig);
 
     scene_ = UNKNOWN_SCENE;
 }
@@ -169,6 +181,8 @@ VtpStreamSocket::VtpStreamSocket()
 VtpStreamSocket::~VtpStreamSocket()
 {
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "~VtpStreamSocket");
+    SoftBusUnrefCipherCtx(cipherCtx_);
+    cipherCtx_ = nullptr;
 }
 
 std::shared_ptr<VtpStreamSocket> VtpStreamSocket::GetSelf()
@@ -293,11 +307,11 @@ bool VtpStreamSocket::CreateClient(IpAndPort &local, int streamType, const std::
         return false;
     }
 
-    sessionKey_ = sessionKey;
+    SetSessionKey(sessionKey);
     streamType_ = streamType;
+    sendScheduler_.SetLossless(streamType_ == RAW_STREAM);
     std::lock_guard<std::mutex> guard(streamSocketLock_);
-    streamFd_ = fd;
-    configCv_.notify_all();
+    SetStreamFd(fd);
 
     SetDefaultConfig(fd);
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO,
@@ -344,49 +358,39 @@ bool VtpStreamSocket::CreateServer(IpAndPort &local, int streamType, const std::
         return false;
     }
 
-    epollFd_ = FtEpollCreate();
-    if (epollFd_ < 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Failed to create epoll fd:%d", FtGetErrno());
+    isStreamRecv_ = true;
+    streamType_ = streamType;
+    sendScheduler_.SetLossless(streamType_ == RAW_STREAM);
+    SetSessionKey(sessionKey);
+    StartStreamTasks();
+    /* the connection is accepted by the receive task once the listen fd is readable */
+    if (SetSocketEpollMode(listenFd_) != ERR_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "SetSocketEpollMode failed, fd = %d", listenFd_);
         DestroyStreamSocket();
         return false;
     }
-    isStreamRecv_ = true;
-    streamType_ = streamType;
-    sessionKey_ = sessionKey;
-    auto self = this->GetSelf();
-    std::thread([self]() { self->NotifyStreamListener(); }).detach();
-
-    std::thread([self]() {
-        if (!self->Accept()) {
-            self->DestroyStreamSocket();
-            return;
-        }
-        self->DoStreamRecv();
-        self->DestroyStreamSocket();
-    }).detach();
-
-    bool &isDestroyed = isDestroyed_;
-    std::thread([self, &isDestroyed]() {
-        while (!isDestroyed) {
-            self->FillpAppStatistics();
-            std::this_thread::sleep_for(std::chrono::seconds(FEED_BACK_PERIOD));
-        }
-    }).detach();
+    recvTask_->Schedule();
 
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO,
-        "CreateServer end, listenFd:%d, epollFd:%d, streamType:%d", listenFd_, epollFd_, streamType_);
+        "CreateServer end, listenFd:%d, streamType:%d", listenFd_, streamType_);
     return true;
 }
 
 void VtpStreamSocket::DestroyStreamSocket()
 {
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "DestroyStreamSocket start");
+    /* a receive run in progress must be done with the fd before it is closed, it takes the lock itself */
+    if (recvTask_ != nullptr) {
+        recvTask_->Stop();
+    }
     std::lock_guard<std::mutex> guard(streamSocketLock_);
     if (isDestroyed_) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "StreamSocket is already destroyed");
         return;
     }
+    callbackReactor_->CancelTimer(feedbackTimer_);
     if (listenFd_ != -1) {
+        reactor_->RemoveFd(listenFd_);
         FtClose(listenFd_);
         listenFd_ = -1;
     }
@@ -394,22 +398,23 @@ void VtpStreamSocket::DestroyStreamSocket()
     if (streamFd_ != -1) {
         RemoveStreamSocketLock(streamFd_); /* remove the socket lock from the map */
         RemoveStreamSocketListener(streamFd_); /* remove the socket listener from the map */
+        reactor_->RemoveFd(streamFd_);
         FtClose(streamFd_);
         streamFd_ = -1;
     }
 
-    if (epollFd_ != -1) {
-        FtClose(epollFd_);
-        epollFd_ = -1;
-    }
-
     if (streamReceiver_ != nullptr) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "DestroyStreamSocket receiver delete");
         streamReceiver_->OnStreamStatus(STREAM_CLOSED);
+        std::lock_guard<std::mutex> receiverGuard(receiverLock_);
         streamReceiver_.reset();
     }
 
     QuitStreamBuffer();
+    {
+        std::lock_guard<std::mutex> frameGuard(compatibleLock_);
+        compatibleFrames_.clear();
+    }
     vtpInstance_->UpdateSocketStreamCount(false);
     isDestroyed_ = true;
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "DestroyStreamSocket end");
@@ -439,36 +444,16 @@ bool VtpStreamSocket::Connect(const IpAndPort &remote)
         return false;
     }
 
-    epollFd_ = FtEpollCreate();
-    if (epollFd_ < 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Failed to create epoll fd:%d", FtGetErrno());
-        DestroyStreamSocket();
-        return false;
-    }
-
+    isStreamRecv_ = true;
+    StartStreamTasks();
     if (SetSocketEpollMode(streamFd_) != ERR_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "SetSocketEpollMode failed, fd = %d", streamFd_);
         DestroyStreamSocket();
         return false;
     }
-    isStreamRecv_ = true;
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "Success to connect remote, and create a thread to recv data.");
-
-    auto self = this->GetSelf();
-    std::thread([self]() { self->NotifyStreamListener(); }).detach();
-
-    std::thread([self]() {
-        self->DoStreamRecv();
-        self->DestroyStreamSocket();
-    }).detach();
-
-    bool &isDestroyed = isDestroyed_;
-    std::thread([self, &isDestroyed]() {
-        while (!isDestroyed) {
-            self->FillpAppStatistics();
-            std::this_thread::sleep_for(std::chrono::seconds(FEED_BACK_PERIOD));
-        }
-    }).detach();
+    /* data may have come before the fd was watched */
+    recvTask_->Schedule();
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "Success to connect remote, and start to recv data.");
     return true;
 }
 
@@ -477,48 +462,139 @@ bool VtpStreamSocket::Send(std::unique_ptr<IStream> stream)
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "send in..., streamType:%d, data size:%zd, ext size:%zd", streamType_,
         stream->GetBufferLen(), stream->GetExtBufferLen());
 
-    if (!isBlocked_) {
-        isBlocked_ = true;
-        if (!SetNonBlockMode(streamFd_, StreamAttr(false))) {
-            return false;
+    FrameType frameType = stream->GetFrameType();
+    uint32_t timestamp = stream->GetTimeStamp();
+    ssize_t len = 0;
+    StreamBuffer data = PacketizeFrame(std::move(stream), len);
+    if (data == nullptr) {
+        return false;
+    }
+
+    int64_t now = StreamSendScheduler::NowMs();
+    if (!sendScheduler_.Push(std::move(data), static_cast<int>(len), frameType, timestamp, now)) {
+        return false;
+    }
+    if (!FlushSendQueue()) {
+        return false;
+    }
+
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "send out..., streamType:%d, data size:%zd", streamType_, len);
+    return true;
+}
+
+bool VtpStreamSocket::FlushSendQueue()
+{
+    if (!sendScheduler_.Flush(StreamSendScheduler::NowMs())) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send failed, errorno: %d", FtGetErrno());
+        return false;
+    }
+    if (sendScheduler_.IsEmpty() || isSendRetrying_.exchange(true)) {
+        return true;
+    }
+
+    /* FillP has no room for the rest, it takes more once the peer has acknowledged some */
+    std::weak_ptr<VtpStreamSocket> weakSelf = GetSelf();
+    reactor_->AddTimer(SEND_RETRY_INTERVAL, [weakSelf]() {
+        auto self = weakSelf.lock();
+        if (self != nullptr && !self->isDestroyed_) {
+            self->isSendRetrying_ = false;
+            /* the frames lost here count as dropped, and every later Send fails */
+            (void)self->FlushSendQueue();
         }
+    });
+    return true;
+}
+
+int VtpStreamSocket::SendNonBlock(const char *buffer, int len)
+{
+    int ret = FtSend(streamFd_, buffer, len, MSG_DONTWAIT);
+    if (ret > 0) {
+        return ret;
     }
+    if (ret < 0 && (FtGetErrno() == EINTR || FtGetErrno() == FILLP_EAGAIN || FtGetErrno() == FILLP_ENOBUFS)) {
+        return 0;
+    }
+    return -1;
+}
 
-    std::unique_ptr<char[]> data = nullptr;
-    ssize_t len = 0;
+StreamBuffer VtpStreamSocket::PacketizeFrame(std::unique_ptr<IStream> stream, ssize_t &frameLen)
+{
     if (streamType_ == RAW_STREAM) {
-        data = stream->GetBuffer();
-        len = stream->GetBufferLen();
-    } else if (streamType_ == COMMON_VIDEO_STREAM || streamType_ == COMMON_AUDIO_STREAM) {
-        StreamPacketizer packet(streamType_, std::move(stream));
-
-        auto plainData = packet.PacketizeStream();
-        if (plainData == nullptr) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PacketizeStream failed");
-            return false;
-        }
-        len = packet.GetPacketLen() + GetEncryptOverhead();
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
-            "packet.GetPacketLen() = %zd, GetEncryptOverhead() = %zd", packet.GetPacketLen(), GetEncryptOverhead());
-        data = std::make_unique<char[]>(len + FRAME_HEADER_LEN);
-        ssize_t encLen = Encrypt(plainData.get(), packet.GetPacketLen(),
-            data.get() + FRAME_HEADER_LEN, len);
-        if (encLen != len) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
-                "encrypted failed, dataLen = %zd, encryptLen = %zd", len, encLen);
-            return false;
-        }
-        InsertBufferLength(len, FRAME_HEADER_LEN, reinterpret_cast<uint8_t *>(data.get()));
-        len += FRAME_HEADER_LEN;
+        frameLen = stream->GetBufferLen();
+        return stream->GetBuffer();
+    }
+    if (streamType_ != COMMON_VIDEO_STREAM && streamType_ != COMMON_AUDIO_STREAM) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "do not support type = %d", streamType_);
+        return nullptr;
     }
 
-    int ret = FtSend(streamFd_, data.get(), len, 0);
-    if (ret == -1) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "send failed, errorno: %d", FtGetErrno());
+    StreamPacketizer packet(streamType_, std::move(stream));
+    ssize_t len = packet.GetPacketLen() + GetEncryptOverhead();
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
+        "packet.GetPacketLen() = %zd, GetEncryptOverhead() = %zd", packet.GetPacketLen(), GetEncryptOverhead());
+    auto data = bufferPool_->Acquire(len + FRAME_HEADER_LEN);
+    if (data == nullptr) {
+        return nullptr;
+    }
+
+    char *plainData = data.get() + FRAME_HEADER_LEN + GCM_IV_LEN;
+    if (!packet.PacketizeStream(plainData, packet.GetPacketLen())) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PacketizeStream failed");
+        return nullptr;
+    }
+    ssize_t encLen = Encrypt(plainData, packet.GetPacketLen(), data.get() + FRAME_HEADER_LEN, len);
+    if (encLen != len) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+            "encrypted failed, dataLen = %zd, encryptLen = %zd", len, encLen);
+        return nullptr;
+    }
+    InsertBufferLength(len, FRAME_HEADER_LEN, reinterpret_cast<uint8_t *>(data.get()));
+    frameLen = len + FRAME_HEADER_LEN;
+    return data;
+}
+
+bool VtpStreamSocket::DepacketizeFrame(StreamBuffer frame, int frameLen, StreamData &data, StreamFrameInfo &info)
+{
+    if (frame == nullptr || frameLen <= 0) {
         return false;
     }
+    if (streamType_ != COMMON_VIDEO_STREAM && streamType_ != COMMON_AUDIO_STREAM) {
+        data.buffer = std::move(frame);
+        data.bufLen = frameLen;
+        return true;
+    }
 
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "send out..., streamType:%d, data size:%zd", streamType_, len);
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv common stream");
+    int plainDataLength = frameLen - GetEncryptOverhead();
+    if (plainDataLength < static_cast<int>(sizeof(CommonHeader))) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "frame too short, dataLength = %d", frameLen);
+        return false;
+    }
+    char *plainData = frame.get() + GCM_IV_LEN;
+    ssize_t decLen = Decrypt(frame.get(), frameLen, plainData, plainDataLength);
+    if (decLen != plainDataLength) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+            "Decrypt failed, dataLength = %d, decryptedLen = %zd", plainDataLength, decLen);
+        return false;
+    }
+    StreamDepacketizer decode(streamType_);
+    decode.DepacketizeHeader(plainData);
+    decode.DepacketizeBuffer(plainData + sizeof(CommonHeader), plainDataLength - sizeof(CommonHeader));
+    if (decode.GetDataLength() <= 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
+            "common depacketize error, dataLength = %d", decode.GetDataLength());
+        return false;
+    }
+
+    data.extBuffer = decode.GetUserExt();
+    data.extLen = decode.GetUserExtSize();
+    info.seqNum = decode.GetSeqNum();
+    info.streamId = decode.GetStreamId();
+    info.timestamp = decode.GetTimestamp();
+    info.frameType = decode.GetFrameType();
+    ssize_t offset = decode.GetData() - frame.get();
+    data.buffer = StreamBufferPool::SubBuffer(std::move(frame), offset);
+    data.bufLen = decode.GetDataLength();
     return true;
 }
 
@@ -588,6 +664,7 @@ bool VtpStreamSocket::SetStreamListener(std::shared_ptr<IStreamSocketListener> r
     }
 
     std::lock_guard<std::mutex> guard(streamSocketLock_);
+    std::lock_guard<std::mutex> receiverGuard(receiverLock_);
     streamReceiver_ = receiver;
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set receiver success");
     return true;
@@ -731,6 +808,10 @@ bool VtpStreamSocket::Accept()
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "accept start");
 
     auto fd = FtAccept(listenFd_, nullptr, nullptr);
+    if (fd == -1 && FtGetErrno() == FILLP_EAGAIN) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "no connection to accept yet");
+        return false;
+    }
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "accept streamFd:%d", fd);
     if (fd == -1) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "errorcode = %d", FtGetErrno());
@@ -767,13 +848,11 @@ bool VtpStreamSocket::Accept()
     }
 
     std::lock_guard<std::mutex> guard(streamSocketLock_);
-    streamFd_ = fd;
-    configCv_.notify_all();
+    SetStreamFd(fd);
 
-    if (streamReceiver_ != nullptr) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "notify stream connected!");
-        streamReceiver_->OnStreamStatus(STREAM_CONNECTED);
-    }
+    /* reported by the notify task, ahead of the first frame */
+    isConnectPending_ = true;
+    notifyTask_->Schedule();
 
     /* enable the bandwidth and CQE estimation algorithms for current ftsocket */
 #ifdef FILLP_SUPPORT_BW_DET
@@ -789,58 +868,37 @@ bool VtpStreamSocket::Accept()
     return true;
 }
 
-int VtpStreamSocket::EpollTimeout(int fd, int timeout)
-{
-    struct SpungeEpollEvent events[MAX_EPOLL_NUM];
-    (void)memset_s(events, sizeof(events), 0, sizeof(events));
-    while (true) {
-        FILLP_INT fdNum = FtEpollWait(epollFd_, events, MAX_EPOLL_NUM, timeout);
-        if (fdNum <= 0) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
-                "FtEpollWait failed, ret = %d, errno = %d", fdNum, FtGetErrno());
-            return -FtGetErrno();
-        }
-
-        for (FILLP_INT i = 0; i < fdNum; i++) {
-            if (events[i].data.fd != fd) {
-                continue;
-            }
-
-            if (events[i].events & (SPUNGE_EPOLLHUP | SPUNGE_EPOLLERR)) {
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
-                    "EpollTimeout, something may be wrong in this socket, fd = %d, events = %u", fd,
-                    (unsigned int)events[i].events);
-                return -1;
-            }
-
-            if (events[i].events & SPUNGE_EPOLLIN) {
-                return 0;
-            }
-        }
-    }
-}
-
 int VtpStreamSocket::SetSocketEpollMode(int fd)
 {
     if (!SetNonBlockMode(fd, StreamAttr(true))) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "SetNonBlockMode failed, errno = %d", FtGetErrno());
         return -1;
     }
-
-    struct SpungeEpollEvent event = {0};
-    event.events = SPUNGE_EPOLLIN;
-    event.data.fd = fd;
-
-    auto ret = FtEpollCtl(epollFd_, SPUNGE_EPOLL_CTL_ADD, fd, &event);
-    if (ret != ERR_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "FtEpollCtl failed, ret = %d, errno = %d", ret, FtGetErrno());
-        return ret;
+    if (!WatchFd(fd)) {
+        return -1;
     }
 
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "SetNonBlockMode success");
     return 0;
 }
 
+bool VtpStreamSocket::WatchFd(int fd)
+{
+    std::weak_ptr<SerialTask> weakTask = recvTask_;
+    auto handler = [weakTask](uint32_t events) {
+        static_cast<void>(events);
+        auto task = weakTask.lock();
+        if (task != nullptr) {
+            task->Schedule();
+        }
+    };
+    if (!reactor_->AddFd(fd, handler)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "add fd %d to reactor failed", fd);
+        return false;
+    }
+    return true;
+}
+
 void VtpStreamSocket::InsertBufferLength(int num, int length, uint8_t *output) const
 {
     for (int i = 0; i < length; i++) {
@@ -878,135 +936,226 @@ std::unique_ptr<IStream> VtpStreamSocket::MakeStreamData(StreamData &data, const
     return stream;
 }
 
-int VtpStreamSocket::RecvStreamLen()
+void VtpStreamSocket::StartStreamTasks()
 {
-    int hdrSize = FRAME_HEADER_LEN;
-    if (streamType_ == RAW_STREAM && scene_ == COMPATIBLE_SCENE) {
-        hdrSize = streamHdrSize_;
-    }
+    std::weak_ptr<VtpStreamSocket> weakSelf = GetSelf();
+    recvTask_ = std::make_shared<SerialTask>(reactor_, [weakSelf]() {
+        auto self = weakSelf.lock();
+        if (self != nullptr) {
+            self->DoStreamRecv();
+        }
+    });
+    notifyTask_ = std::make_shared<SerialTask>(callbackReactor_, [weakSelf]() {
+        auto self = weakSelf.lock();
+        if (self != nullptr) {
+            self->NotifyStreamListener();
+        }
+    });
+    /* it reports QoS to the listener */
+    feedbackTimer_ = callbackReactor_->AddTimer(0, [weakSelf]() {
+        auto self = weakSelf.lock();
+        if (self != nullptr && !self->isDestroyed_) {
+            self->FillpAppStatistics();
+        }
+    }, FEED_BACK_PERIOD * MS_PER_SECOND);
+}
 
-    int len = -1;
-    int timeout = -1;
-    auto buffer = std::make_unique<char[]>(hdrSize);
-    if (EpollTimeout(streamFd_, timeout) == 0) {
-        do {
-            len = FtRecv(streamFd_, buffer.get(), hdrSize, 0);
-        } while (len <= 0 && (FtGetErrno() == EINTR || FtGetErrno() == FILLP_EAGAIN));
+void VtpStreamSocket::DoStreamRecv()
+{
+    if (!isStreamRecv_) {
+        return;
     }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv frame header, len = %d, scene:%d", len, scene_);
-
-    if (len <= 0) {
-        return -1;
+    if (streamFd_ == -1 && !AcceptStream()) {
+        return;
+    }
+    if (!RecvFrames()) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "recv stream exit");
+        DestroyStreamSocket();
     }
+}
 
-    if (streamType_ == RAW_STREAM && scene_ == COMPATIBLE_SCENE) {
-        std::lock_guard<std::mutex> guard(streamSocketLock_);
-        if (streamReceiver_ != nullptr) {
-            return streamReceiver_->OnStreamHdrReceived(std::move(buffer), hdrSize);
+bool VtpStreamSocket::AcceptStream()
+{
+    if (listenFd_ == -1) {
+        return false;
+    }
+    if (!Accept()) {
+        if (FtGetErrno() != FILLP_EAGAIN) {
+            DestroyStreamSocket();
         }
+        return false;
     }
-
-    return ntohl(*reinterpret_cast<int *>(buffer.get()));
+    /* a server socket serves one connection */
+    reactor_->RemoveFd(listenFd_);
+    return true;
 }
 
-void VtpStreamSocket::DoStreamRecv()
+bool VtpStreamSocket::RecvFrames()
 {
     while (isStreamRecv_) {
-        std::unique_ptr<char[]> dataBuffer = nullptr;
-        std::unique_ptr<char[]> extBuffer = nullptr;
-        int extLen = 0;
-        StreamFrameInfo info = {};
-        int dataLength = 0;
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv stream");
-        dataLength = VtpStreamSocket::RecvStreamLen();
-        if (dataLength <= 0 || dataLength > MAX_STREAM_LEN) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "read frame length error, dataLength = %d", dataLength);
+        if (recvFrame_ == nullptr && IsCompatibleQueueFull() && !PauseRecv()) {
             break;
         }
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
-            "recv a new frame, dataLength = %d, stream type:%d", dataLength, streamType_);
-        dataBuffer = VtpStreamSocket::RecvStream(dataLength);
-
-        if (streamType_ == COMMON_VIDEO_STREAM || streamType_ == COMMON_AUDIO_STREAM) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv common stream");
-            int decryptedLength = dataLength;
-            auto decryptedBuffer = std::move(dataBuffer);
-
-            int plainDataLength = decryptedLength - GetEncryptOverhead();
-            std::unique_ptr<char[]> plainData = std::make_unique<char[]>(plainDataLength);
-            ssize_t decLen = Decrypt(decryptedBuffer.get(), decryptedLength, plainData.get(), plainDataLength);
-            if (decLen != plainDataLength) {
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
-                    "Decrypt failed, dataLength = %d, decryptedLen = %zd", plainDataLength, decLen);
-                break;
-            }
-            auto header = plainData.get();
-            StreamDepacketizer decode(streamType_);
-            decode.DepacketizeHeader(header);
-
-            auto buffer = plainData.get() + sizeof(CommonHeader);
-            decode.DepacketizeBuffer(buffer);
-
-            extBuffer = decode.GetUserExt();
-            extLen = decode.GetUserExtSize();
-            info.seqNum = decode.GetSeqNum();
-            info.streamId = decode.GetStreamId();
-            dataBuffer = decode.GetData();
-            dataLength = decode.GetDataLength();
-            if (dataLength <= 0) {
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
-                    "common depacketize error, dataLength = %d", dataLength);
-                break;
-            }
+        int ret = (recvFrame_ == nullptr) ? RecvFrameHeader() : RecvFrameBody();
+        if (ret < 0) {
+            return false;
         }
-
-        StreamData data = { std::move(dataBuffer), dataLength, std::move(extBuffer), extLen };
-        std::unique_ptr<IStream> stream = MakeStreamData(data, info);
-        if (stream == nullptr) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "MakeStreamData failed, stream == nullptr");
+        if (ret == 0) {
             break;
         }
+    }
+    return true;
+}
 
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
-            "recv frame done, dataLength = %d, stream type:%d", dataLength, streamType_);
+bool VtpStreamSocket::IsCompatibleQueueFull()
+{
+    if (streamType_ != RAW_STREAM || scene_ != COMPATIBLE_SCENE) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(compatibleLock_);
+    return compatibleFrames_.size() >= COMPATIBLE_QUEUE_SIZE;
+}
 
-        if (streamType_ == RAW_STREAM && scene_ == COMPATIBLE_SCENE) {
-            std::lock_guard<std::mutex> guard(streamSocketLock_);
-            if (streamReceiver_ != nullptr) {
-                streamReceiver_->OnStreamReceived(std::move(stream));
-                continue;
-            }
+bool VtpStreamSocket::PauseRecv()
+{
+    /*
+     * epoll reports the fd for as long as it has data, so it leaves the reactor until the notify task has made room.
+     * Whoever clears the pause flag first watches it again.
+     */
+    reactor_->RemoveFd(streamFd_);
+    isRecvPaused_ = true;
+    if (IsCompatibleQueueFull() || !isRecvPaused_.exchange(false)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv paused, listener is behind");
+        return false;
+    }
+    return WatchFd(streamFd_);
+}
+
+int VtpStreamSocket::RecvNonBlock(char *buffer, int len)
+{
+    int ret = FtRecv(streamFd_, buffer, len, MSG_DONTWAIT);
+    if (ret > 0) {
+        return ret;
+    }
+    if (ret < 0 && (FtGetErrno() == EINTR || FtGetErrno() == FILLP_EAGAIN)) {
+        return 0;
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "read frame failed, ret = %d, errno: %d", ret, FtGetErrno());
+    return -1;
+}
+
+int VtpStreamSocket::RecvFrameHeader()
+{
+    /* only the compatible scene hands the header over to the listener */
+    bool isCompatible = (streamType_ == RAW_STREAM && scene_ == COMPATIBLE_SCENE);
+    int hdrSize = isCompatible ? streamHdrSize_ : FRAME_HEADER_LEN;
+    if (hdrSize <= 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid header size %d", hdrSize);
+        return -1;
+    }
+    char *header = reinterpret_cast<char *>(&frameHeader_);
+    if (isCompatible) {
+        if (recvHeader_ == nullptr) {
+            recvHeader_ = std::make_unique<char[]>(hdrSize);
         }
+        header = recvHeader_.get();
+    }
+    int ret = RecvNonBlock(header + recvHeaderLen_, hdrSize - recvHeaderLen_);
+    if (ret <= 0) {
+        return ret;
+    }
+    recvHeaderLen_ += ret;
+    if (recvHeaderLen_ < hdrSize) {
+        return ret;
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv frame header, len = %d, scene:%d", hdrSize, scene_);
+
+    int dataLength = static_cast<int>(ntohl(frameHeader_));
+    if (isCompatible) {
+        /*
+         * not under the socket lock, a listener busy with a frame on the callback reactor holds it. Destroying
+         * the socket waits for this run, so the listener is not called after it was told the stream closed.
+         */
+        std::shared_ptr<IStreamSocketListener> receiver = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(receiverLock_);
+            receiver = streamReceiver_;
+        }
+        dataLength = static_cast<int>(ntohl(*reinterpret_cast<uint32_t *>(recvHeader_.get())));
+        if (receiver != nullptr) {
+            dataLength = receiver->OnStreamHdrReceived(std::move(recvHeader_), hdrSize);
+        }
+        recvHeader_ = nullptr;
+    }
+    recvHeaderLen_ = 0;
+    if (dataLength <= 0 || dataLength > MAX_STREAM_LEN) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "read frame length error, dataLength = %d", dataLength);
+        return -1;
+    }
 
-        PutStream(std::move(stream));
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
-            "put frame done, dataLength = %d, stream type:%d", dataLength, streamType_);
+    recvFrame_ = bufferPool_->Acquire(dataLength);
+    if (recvFrame_ == nullptr) {
+        return -1;
     }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "recv thread exit");
+    frameLen_ = dataLength;
+    recvFrameLen_ = 0;
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
+        "recv a new frame, dataLength = %d, stream type:%d", dataLength, streamType_);
+    return ret;
 }
 
-std::unique_ptr<char[]> VtpStreamSocket::RecvStream(int dataLength)
+int VtpStreamSocket::RecvFrameBody()
 {
-    auto buffer = std::make_unique<char[]>(dataLength);
-    int recvLen = 0;
-    while (recvLen < dataLength) {
-        int ret = -1;
-        int timeout = -1;
+    int ret = RecvNonBlock(recvFrame_.get() + recvFrameLen_, frameLen_ - recvFrameLen_);
+    if (ret <= 0) {
+        return ret;
+    }
+    recvFrameLen_ += ret;
+    if (recvFrameLen_ < frameLen_) {
+        return ret;
+    }
+    StreamBuffer frame = std::move(recvFrame_);
+    recvFrame_ = nullptr;
+    return HandleFrame(std::move(frame), frameLen_) ? ret : -1;
+}
 
-        if (EpollTimeout(streamFd_, timeout) == 0) {
-            do {
-                ret = FtRecv(streamFd_, (buffer.get() + recvLen), dataLength - recvLen, 0);
-            } while (ret < 0 && (FtGetErrno() == EINTR || FtGetErrno() == FILLP_EAGAIN));
-        }
+bool VtpStreamSocket::HandleFrame(StreamBuffer frame, int frameLen)
+{
+    StreamFrameInfo info = {};
+    StreamData data;
+    if (!DepacketizeFrame(std::move(frame), frameLen, data, info)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "recv frame failed, dataLength = %d", frameLen);
+        return false;
+    }
+    int dataLength = data.bufLen;
 
-        if (ret == -1) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "read frame failed, errno: %d", FtGetErrno());
-            return nullptr;
-        }
+    std::unique_ptr<IStream> stream = MakeStreamData(data, info);
+    if (stream == nullptr) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "MakeStreamData failed, stream == nullptr");
+        return false;
+    }
+
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
+        "recv frame done, dataLength = %d, stream type:%d", dataLength, streamType_);
 
-        recvLen += ret;
+    /*
+     * the header callback of the compatible scene stays on the I/O worker since it returns the frame length,
+     * the frame itself goes through the notify task like the others and may reach the listener after the next header
+     */
+    if (streamType_ == RAW_STREAM && scene_ == COMPATIBLE_SCENE) {
+        {
+            std::lock_guard<std::mutex> guard(compatibleLock_);
+            compatibleFrames_.push_back(std::move(stream));
+        }
+        notifyTask_->Schedule();
+        return true;
     }
-    return std::unique_ptr<char[]>(buffer.release());
+
+    PutStream(std::move(stream), info);
+    notifyTask_->Schedule();
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG,
+        "put frame done, dataLength = %d, stream type:%d", dataLength, streamType_);
+    return true;
 }
 
 void VtpStreamSocket::SetDefaultConfig(int fd)
@@ -1112,23 +1261,30 @@ bool VtpStreamSocket::SetSocketBindToDevices(int type, const StreamAttr &ip)
     return SetSocketBoundInner(streamFd_, boundIp);
 }
 
-bool VtpStreamSocket::SetVtpStackConfigDelayed(int type, const StreamAttr &value)
+void VtpStreamSocket::SetStreamFd(int fd)
 {
-    std::unique_lock<std::mutex> lock(streamSocketLock_);
-    if (streamFd_ == -1) {
-        configCv_.wait(lock, [this] { return streamFd_ != -1; });
+    std::vector<std::pair<int, StreamAttr>> configs;
+    {
+        std::lock_guard<std::mutex> guard(configLock_);
+        streamFd_ = fd;
+        configs.swap(pendingConfigs_);
+    }
+    for (const auto &config : configs) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set vtp stack config, streamFd = %d", fd);
+        SetVtpStackConfig(config.first, config.second);
     }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set vtp stack config, streamFd = %d", streamFd_);
-    return SetVtpStackConfig(type, value);
 }
 
 bool VtpStreamSocket::SetVtpStackConfig(int type, const StreamAttr &value)
 {
-    if (streamFd_ == -1) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set vtp stack config when streamFd is legal");
-        auto self = GetSelf();
-        std::thread([self, type, value]() { self->SetVtpStackConfigDelayed(type, value); }).detach();
-        return true;
+    {
+        std::lock_guard<std::mutex> guard(configLock_);
+        if (streamFd_ == -1) {
+            /* applied once the connection is accepted */
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set vtp stack config when streamFd is legal");
+            pendingConfigs_.emplace_back(type, value);
+            return true;
+        }
     }
 
     if (value.GetType() == INT_TYPE) {
@@ -1258,6 +1414,7 @@ bool VtpStreamSocket::SetStreamType(int type, const StreamAttr &value)
     }
 
     streamType_ = value.GetIntValue();
+    sendScheduler_.SetLossless(streamType_ == RAW_STREAM);
     return true;
 }
 
@@ -1292,20 +1449,98 @@ bool VtpStreamSocket::SetStreamHeaderSize(int type, const StreamAttr &value)
     return true;
 }
 
-void VtpStreamSocket::NotifyStreamListener()
+bool VtpStreamSocket::SetRecvQueueConfig(int type, const StreamAttr &value)
 {
-    while (isStreamRecv_) {
-        int streamNum = GetStreamNum();
-        if (streamNum >= STREAM_BUFFER_THRESHOLD) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "Too many data in receiver, num = %d", streamNum);
+    if (value.GetType() != INT_TYPE) {
+        return false;
+    }
+    int intValue = value.GetIntValue();
+    if (type == RECV_DROP_POLICY) {
+        if (intValue != DROP_OLDEST && intValue != DROP_UNTIL_KEY_FRAME) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid drop policy %d", intValue);
+            return false;
         }
+        streamReceiveBuffer_.SetDropPolicy(static_cast<StreamDropPolicy>(intValue));
+    } else if (type == RECV_PLAYOUT_DELAY) {
+        if (intValue < 0) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid playout delay %d", intValue);
+            return false;
+        }
+        streamReceiveBuffer_.SetPlayoutDelay(intValue);
+    } else {
+        return false;
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set receive queue option %d to %d", type, intValue);
+    return true;
+}
 
-        auto stream = TakeStream();
-        if (stream == nullptr) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Pop stream failed");
-            break;
+bool VtpStreamSocket::SetSendQueueConfig(int type, const StreamAttr &value)
+{
+    if (type != SEND_MAX_DELAY || value.GetType() != INT_TYPE) {
+        return false;
+    }
+    int intValue = value.GetIntValue();
+    if (intValue < 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid send max delay %d", intValue);
+        return false;
+    }
+    sendScheduler_.SetMaxDelay(intValue);
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "set send max delay to %d", intValue);
+    return true;
+}
+
+StreamAttr VtpStreamSocket::GetSendQueueConfig(int type) const
+{
+    switch (type) {
+        case SEND_MAX_DELAY:
+            return std::move(StreamAttr(sendScheduler_.GetMaxDelay()));
+        case SEND_KEY_QUEUE_DEPTH:
+            return std::move(StreamAttr(sendScheduler_.GetQueueDepth(SEND_PRIORITY_KEY)));
+        case SEND_NORMAL_QUEUE_DEPTH:
+            return std::move(StreamAttr(sendScheduler_.GetQueueDepth(SEND_PRIORITY_NORMAL)));
+        case SEND_DROP_NUM:
+            return std::move(StreamAttr(static_cast<int>(sendScheduler_.GetDropNum())));
+        case SEND_EXPIRED_NUM:
+            return std::move(StreamAttr(static_cast<int>(sendScheduler_.GetExpiredNum())));
+        default:
+            return std::move(StreamAttr());
+    }
+}
+
+StreamAttr VtpStreamSocket::GetRecvQueueConfig(int type) const
+{
+    switch (type) {
+        case RECV_DROP_POLICY:
+            return std::move(StreamAttr(static_cast<int>(streamReceiveBuffer_.GetDropPolicy())));
+        case RECV_PLAYOUT_DELAY:
+            return std::move(StreamAttr(streamReceiveBuffer_.GetPlayoutDelay()));
+        case RECV_DROP_NUM:
+            return std::move(StreamAttr(static_cast<int>(streamReceiveBuffer_.GetDropNum())));
+        case RECV_LATE_NUM:
+            return std::move(StreamAttr(static_cast<int>(streamReceiveBuffer_.GetLateNum())));
+        default:
+            return std::move(StreamAttr());
+    }
+}
+
+void VtpStreamSocket::NotifyStreamListener()
+{
+    if (isConnectPending_.exchange(false)) {
+        std::lock_guard<std::mutex> guard(streamSocketLock_);
+        if (streamReceiver_ != nullptr) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "notify stream connected!");
+            streamReceiver_->OnStreamStatus(STREAM_CONNECTED);
         }
+    }
+
+    NotifyCompatibleFrames();
 
+    int streamNum = GetStreamNum();
+    if (streamNum >= STREAM_BUFFER_THRESHOLD) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "Too many data in receiver, num = %d", streamNum);
+    }
+
+    for (auto stream = PollStream(); stream != nullptr; stream = PollStream()) {
         std::lock_guard<std::mutex> guard(streamSocketLock_);
         if (streamReceiver_ != nullptr) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "notify listener");
@@ -1313,7 +1548,52 @@ void VtpStreamSocket::NotifyStreamListener()
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "notify listener done.");
         }
     }
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "notify thread exit");
+
+    /* with a playout delay the next frame may not be due yet, come back when it is */
+    int64_t playoutTime = 0;
+    if (!streamReceiveBuffer_.GetFrontPlayoutTime(playoutTime)) {
+        return;
+    }
+    std::weak_ptr<SerialTask> weakTask = notifyTask_;
+    uint32_t timer = reactor_->AddTimer(static_cast<int>(playoutTime - StreamReceiveQueue::NowMs()), [weakTask]() {
+        auto task = weakTask.lock();
+        if (task != nullptr) {
+            task->Schedule();
+        }
+    });
+    reactor_->CancelTimer(playoutTimer_);
+    playoutTimer_ = timer;
+}
+
+void VtpStreamSocket::NotifyCompatibleFrames()
+{
+    while (true) {
+        std::unique_ptr<IStream> stream = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(compatibleLock_);
+            if (compatibleFrames_.empty()) {
+                break;
+            }
+            stream = std::move(compatibleFrames_.front());
+            compatibleFrames_.pop_front();
+        }
+        std::lock_guard<std::mutex> guard(streamSocketLock_);
+        if (streamReceiver_ != nullptr) {
+            streamReceiver_->OnStreamReceived(std::move(stream));
+        }
+    }
+
+    if (!isRecvPaused_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(streamSocketLock_);
+        if (isDestroyed_ || streamFd_ == -1 || !WatchFd(streamFd_)) {
+            return;
+        }
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_DBG, "recv resumed");
+    recvTask_->Schedule();
 }
 
 ssize_t VtpStreamSocket::GetEncryptOverhead() const
@@ -1321,6 +1601,17 @@ ssize_t VtpStreamSocket::GetEncryptOverhead() const
     return OVERHEAD_LEN;
 }
 
+void VtpStreamSocket::SetSessionKey(const std::string &sessionKey)
+{
+    sessionKey_ = sessionKey;
+    SoftBusUnrefCipherCtx(cipherCtx_);
+    cipherCtx_ = nullptr;
+    if (sessionKey_.length() >= SESSION_KEY_LENGTH) {
+        cipherCtx_ = SoftBusCreateCipherCtx(reinterpret_cast<const unsigned char *>(sessionKey_.c_str()),
+            SESSION_KEY_LENGTH);
+    }
+}
+
 ssize_t VtpStreamSocket::Encrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen) const
 {
     AesGcmCipherKey cipherKey = {0};
@@ -1330,6 +1621,16 @@ ssize_t VtpStreamSocket::Encrypt(const void *in, ssize_t inLen, void *out, ssize
         return SOFTBUS_ERR;
     }
 
+    if (cipherCtx_ != nullptr) {
+        int ret = SoftBusEncryptDataByCtx(cipherCtx_, (unsigned char *)in, inLen, (unsigned char *)out,
+            (unsigned int *)&outLen);
+        if (ret != SOFTBUS_OK || outLen != inLen + OVERHEAD_LEN) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Encrypt Data fail. %d", ret);
+            return SOFTBUS_ENCRYPT_ERR;
+        }
+        return outLen;
+    }
+
     cipherKey.keyLen = SESSION_KEY_LENGTH;
     if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey_.c_str(), SESSION_KEY_LENGTH) != EOK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
@@ -1354,6 +1655,16 @@ ssize_t VtpStreamSocket::Decrypt(const void *in, ssize_t inLen, void *out, ssize
         return SOFTBUS_ERR;
     }
 
+    if (cipherCtx_ != nullptr) {
+        int ret = SoftBusDecryptDataByCtx(cipherCtx_, (unsigned char *)in, inLen, (unsigned char *)out,
+            (unsigned int *)&outLen);
+        if (ret != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Decrypt Data fail. %d ", ret);
+            return SOFTBUS_DECRYPT_ERR;
+        }
+        return outLen;
+    }
+
     cipherKey.keyLen = SESSION_KEY_LENGTH; // 256 bit encryption
     if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey_.c_str(), SESSION_KEY_LENGTH) != EOK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
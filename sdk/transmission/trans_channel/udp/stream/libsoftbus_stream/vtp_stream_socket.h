@@ -16,19 +16,26 @@
 #ifndef VTP_STREAM_SOCKET_H
 #define VTP_STREAM_SOCKET_H
 
-#include <condition_variable>
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "fillpinc.h"
 
 #include "common_inner.h"
 #include "i_stream.h"
 #include "i_stream_socket.h"
+#include "softbus_adapter_crypto.h"
+#include "stream_buffer_pool.h"
 #include "stream_common.h"
+#include "stream_reactor.h"
+#include "stream_send_scheduler.h"
 #include "vtp_instance.h"
 
 namespace Communication {
@@ -48,8 +55,14 @@ public:
     static constexpr int FILLP_VTP_SEND_CACHE_SIZE = 500;
     static constexpr int FILLP_VTP_RECV_CACHE_SIZE = 500;
     static constexpr int FILLP_KEEP_ALIVE_TIME = 300000;
-
-    VtpStreamSocket();
+    static constexpr int SEND_RETRY_INTERVAL = 5; /* ms, how soon frames FillP could not take are tried again */
+    static constexpr size_t COMPATIBLE_QUEUE_SIZE = 32; /* received compatible scene frames the listener has not had */
+
+    /*
+     * all I/O of the socket runs on the reactor and the listener is called on the callback reactor, so a slow
+     * listener never holds up I/O. The sockets of a process share both.
+     */
+    VtpStreamSocket(std::shared_ptr<StreamReactor> reactor, std::shared_ptr<StreamReactor> callbackReactor);
     ~VtpStreamSocket() override;
     std::shared_ptr<VtpStreamSocket> GetSelf();
 
@@ -78,6 +91,15 @@ public:
 
     ssize_t Decrypt(const void *in, ssize_t inLen, void *out, ssize_t outLen) const;
 
+    /*
+     * A common stream frame is length(4) | iv(12) | packet | tag(16) in one pooled buffer, the packet is
+     * written right where the cipher text goes and encrypted in place. A raw stream frame is sent as is.
+     */
+    StreamBuffer PacketizeFrame(std::unique_ptr<IStream> stream, ssize_t &frameLen);
+
+    /* takes a frame without its length, decrypts it in place and hands out the payload inside the frame */
+    bool DepacketizeFrame(StreamBuffer frame, int frameLen, StreamData &data, StreamFrameInfo &info);
+
 private:
     using MySetFunc = bool (VtpStreamSocket::*)(int, const StreamAttr &);
     using MyGetFunc = StreamAttr (VtpStreamSocket::*)(int) const;
@@ -107,14 +129,31 @@ private:
     int CreateAndBindSocket(IpAndPort &local) override;
     bool Accept() override;
 
-    int EpollTimeout(int fd, int timeout) override;
     int SetSocketEpollMode(int fd) override;
+    bool WatchFd(int fd);
 
     void InsertBufferLength(int num, int length, uint8_t *output) const;
     std::unique_ptr<IStream> MakeStreamData(StreamData &data, const StreamFrameInfo &info) const;
-    int RecvStreamLen();
+
+    /* receive side, the tasks run on the reactor workers */
+    void StartStreamTasks();
     void DoStreamRecv();
-    std::unique_ptr<char[]> RecvStream(int dataLength) override;
+    bool AcceptStream();
+    bool RecvFrames();
+    /* stops reading while the listener is behind on compatible scene frames, false when recv has to wait */
+    bool PauseRecv();
+    bool IsCompatibleQueueFull();
+    void NotifyCompatibleFrames();
+    /* the bytes read, 0 once the socket has no more data, -1 when the stream is broken */
+    int RecvNonBlock(char *buffer, int len);
+    int RecvFrameHeader();
+    int RecvFrameBody();
+    bool HandleFrame(StreamBuffer frame, int frameLen);
+
+    /* send side, frames FillP cannot take at once wait in the send scheduler */
+    bool FlushSendQueue();
+    /* the bytes sent, 0 when FillP has no room now, -1 when the stream is broken */
+    int SendNonBlock(const char *buffer, int len);
 
     void SetDefaultConfig(int fd);
     bool SetIpTos(int fd, const StreamAttr &tos);
@@ -123,7 +162,7 @@ private:
     StreamAttr GetListenSocketFd(int type = -1) const;
     bool SetSocketBoundInner(int fd, std::string ip = "") const;
     bool SetSocketBindToDevices(int type, const StreamAttr &ip);
-    bool SetVtpStackConfigDelayed(int type, const StreamAttr &value);
+    void SetStreamFd(int fd);
     bool SetVtpStackConfig(int type, const StreamAttr &value);
     StreamAttr GetVtpStackConfig(int type) const;
     bool SetNonBlockMode(int type, const StreamAttr &value);
@@ -157,11 +196,17 @@ private:
 
     bool SetStreamScene(int type, const StreamAttr &value);
     bool SetStreamHeaderSize(int type, const StreamAttr &value);
+    bool SetRecvQueueConfig(int type, const StreamAttr &value);
+    StreamAttr GetRecvQueueConfig(int type) const;
+    bool SetSendQueueConfig(int type, const StreamAttr &value);
+    StreamAttr GetSendQueueConfig(int type) const;
 
     void NotifyStreamListener();
 
     void GetCryptErrorReason(void) const;
 
+    void SetSessionKey(const std::string &sessionKey);
+
     bool EnableBwEstimationAlgo(int streamFd, bool isServer) const;
 
     bool EnableJitterDetectionAlgo(int streamFd) const;
@@ -185,11 +230,38 @@ private:
 
     std::map<int, OptionFunc> optFuncMap_ {};
     static std::shared_ptr<VtpInstance> vtpInstance_;
-    std::condition_variable configCv_;
+    std::shared_ptr<StreamReactor> reactor_ = nullptr;
+    std::shared_ptr<StreamReactor> callbackReactor_ = nullptr;
+    std::shared_ptr<SerialTask> recvTask_ = nullptr;
+    /* one listener call of the socket at a time, on the callback reactor */
+    std::shared_ptr<SerialTask> notifyTask_ = nullptr;
+    std::atomic<bool> isConnectPending_ { false };
+    uint32_t feedbackTimer_ = 0;
+    uint32_t playoutTimer_ = 0;
+    std::mutex configLock_;
+    std::vector<std::pair<int, StreamAttr>> pendingConfigs_; /* set before the stream fd existed */
     std::mutex streamSocketLock_;
+    /* taken with the socket lock to change the listener, alone to read it where the socket lock may be held long */
+    std::mutex receiverLock_;
     int scene_ = UNKNOWN_SCENE;
     int streamHdrSize_ = 0;
     bool isDestroyed_ = false;
+    /* compatible scene frames are raw and must not be dropped, so they wait here rather than in the receive queue */
+    std::mutex compatibleLock_;
+    std::deque<std::unique_ptr<IStream>> compatibleFrames_;
+    std::atomic<bool> isRecvPaused_ { false };
+    SoftBusCipherCtx *cipherCtx_ = nullptr;
+    std::shared_ptr<StreamBufferPool> bufferPool_ = std::make_shared<StreamBufferPool>();
+    StreamSendScheduler sendScheduler_ { [this](const char *buffer, int len) { return SendNonBlock(buffer, len); } };
+    std::atomic<bool> isSendRetrying_ { false };
+
+    /* the frame being received, a frame may arrive over several read events */
+    uint32_t frameHeader_ = 0;
+    std::unique_ptr<char[]> recvHeader_ = nullptr; /* compatible scene only */
+    int recvHeaderLen_ = 0;
+    int frameLen_ = 0;
+    StreamBuffer recvFrame_ = nullptr;
+    int recvFrameLen_ = 0;
 };
 } // namespace SoftBus
 } // namespace Communication
@@ -13,8 +13,11 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "securec.h"
 #include "softbus_errcode.h"
 #include "softbus_adapter_crypto.h"
 
@@ -601,4 +604,187 @@ HWTEST_F(DsoftbusCryptoTest, SoftBusDecryptDataWithSeq004, TestSize.Level0)
                                     encryptLen, (unsigned char*)decryptData, nullptr, seqNum);
     EXPECT_EQ(SOFTBUS_INVALID_PARAM, ret);
 }
-}
\ No newline at end of file
+
+/*
+* @tc.name: SoftBusCipherCtx001
+* @tc.desc: context round trip, data encrypted by context is readable by the key based api and back
+* @tc.type: FUNC
+* @tc.require: 1
+*/
+HWTEST_F(DsoftbusCryptoTest, SoftBusCipherCtx001, TestSize.Level0)
+{
+    AesGcmCipherKey cipherKey = {0};
+    cipherKey.keyLen = SESSION_KEY_LENGTH;
+    ASSERT_EQ(SOFTBUS_OK, SoftBusGenerateRandomArray(cipherKey.key, SESSION_KEY_LENGTH));
+    SoftBusCipherCtx *ctx = SoftBusCreateCipherCtx(cipherKey.key, cipherKey.keyLen);
+    ASSERT_TRUE(ctx != nullptr);
+
+    unsigned char input[64] = "cipher context round trip";
+    unsigned char encryptData[64 + OVERHEAD_LEN] = {0};
+    unsigned char decryptData[64] = {0};
+    uint32_t encryptLen = sizeof(encryptData);
+    uint32_t decryptLen = sizeof(decryptData);
+    int32_t ret = SoftBusEncryptDataByCtx(ctx, input, sizeof(input), encryptData, &encryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(sizeof(input) + OVERHEAD_LEN, encryptLen);
+    ret = SoftBusDecryptData(&cipherKey, encryptData, encryptLen, decryptData, &decryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(0, memcmp(input, decryptData, sizeof(input)));
+
+    encryptLen = sizeof(encryptData);
+    decryptLen = sizeof(decryptData);
+    (void)memset_s(decryptData, sizeof(decryptData), 0, sizeof(decryptData));
+    ret = SoftBusEncryptData(&cipherKey, input, sizeof(input), encryptData, &encryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    ret = SoftBusDecryptDataByCtx(ctx, encryptData, encryptLen, decryptData, &decryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(sizeof(input), decryptLen);
+    EXPECT_EQ(0, memcmp(input, decryptData, sizeof(input)));
+
+    encryptData[GCM_IV_LEN] ^= 1;
+    ret = SoftBusDecryptDataByCtx(ctx, encryptData, encryptLen, decryptData, &decryptLen);
+    EXPECT_NE(SOFTBUS_OK, ret);
+    SoftBusUnrefCipherCtx(ctx);
+}
+
+/*
+* @tc.name: SoftBusCipherCtx002
+* @tc.desc: seq is carried in the iv, references keep the context alive, invalid parameters are rejected
+* @tc.type: FUNC
+* @tc.require: 1
+*/
+HWTEST_F(DsoftbusCryptoTest, SoftBusCipherCtx002, TestSize.Level0)
+{
+    unsigned char key[SESSION_KEY_LENGTH] = {0};
+    EXPECT_TRUE(SoftBusCreateCipherCtx(nullptr, SESSION_KEY_LENGTH) == nullptr);
+    EXPECT_TRUE(SoftBusCreateCipherCtx(key, 0) == nullptr);
+    EXPECT_TRUE(SoftBusCreateCipherCtx(key, SESSION_KEY_LENGTH + 1) == nullptr);
+
+    SoftBusCipherCtx *ctx = SoftBusCreateCipherCtx(key, SESSION_KEY_LENGTH);
+    ASSERT_TRUE(ctx != nullptr);
+    SoftBusCipherCtx *ref = SoftBusRefCipherCtx(ctx);
+    EXPECT_EQ(ctx, ref);
+    SoftBusUnrefCipherCtx(ctx);
+
+    unsigned char input[16] = {1, 2, 3};
+    unsigned char encryptData[16 + OVERHEAD_LEN] = {0};
+    unsigned char decryptData[16] = {0};
+    uint32_t encryptLen = sizeof(encryptData);
+    uint32_t decryptLen = sizeof(decryptData);
+    int32_t seqNum = 0x12345678;
+    int32_t ret = SoftBusEncryptDataWithSeqByCtx(ref, input, sizeof(input), encryptData, &encryptLen, seqNum);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(0, memcmp(encryptData, &seqNum, sizeof(seqNum)));
+    ret = SoftBusDecryptDataByCtx(ref, encryptData, encryptLen, decryptData, &decryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(0, memcmp(input, decryptData, sizeof(input)));
+
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, SoftBusEncryptDataByCtx(nullptr, input, sizeof(input),
+        encryptData, &encryptLen));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, SoftBusDecryptDataByCtx(ref, encryptData, OVERHEAD_LEN,
+        decryptData, &decryptLen));
+    SoftBusUnrefCipherCtx(ref);
+}
+
+/*
+* @tc.name: SoftBusCipherCtx003
+* @tc.desc: scatter encryption over uneven iovs decrypts like the contiguous form
+* @tc.type: FUNC
+* @tc.require: 1
+*/
+HWTEST_F(DsoftbusCryptoTest, SoftBusCipherCtx003, TestSize.Level0)
+{
+    const uint32_t dataLen = 1000;
+    const uint32_t splits[] = {7, 33, 16, 500, 1};
+    unsigned char key[SESSION_KEY_LENGTH] = {3};
+    unsigned char input[dataLen];
+    for (uint32_t i = 0; i < dataLen; i++) {
+        input[i] = (unsigned char)i;
+    }
+    unsigned char encryptData[dataLen + OVERHEAD_LEN] = {0};
+    unsigned char decryptData[dataLen] = {0};
+    SoftBusCryptoIov iov[sizeof(splits) / sizeof(splits[0]) + 1] = {};
+    uint32_t used = 0;
+    uint32_t iovCnt = 0;
+    for (uint32_t split : splits) {
+        iov[iovCnt].buf = encryptData + used;
+        iov[iovCnt++].len = split;
+        used += split;
+    }
+    iov[iovCnt].buf = encryptData + used;
+    iov[iovCnt++].len = sizeof(encryptData) - used;
+
+    SoftBusCipherCtx *ctx = SoftBusCreateCipherCtx(key, SESSION_KEY_LENGTH);
+    ASSERT_TRUE(ctx != nullptr);
+    int32_t seqNum = 0x0a0b0c0d;
+    int32_t ret = SoftBusEncryptDataWithSeqByCtxIov(ctx, input, dataLen, iov, iovCnt, seqNum, nullptr, nullptr);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(0, memcmp(encryptData, &seqNum, sizeof(seqNum)));
+    uint32_t decryptLen = sizeof(decryptData);
+    ret = SoftBusDecryptDataByCtx(ctx, encryptData, sizeof(encryptData), decryptData, &decryptLen);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(dataLen, decryptLen);
+    EXPECT_EQ(0, memcmp(input, decryptData, dataLen));
+
+    iov[iovCnt - 1].len--;
+    ret = SoftBusEncryptDataWithSeqByCtxIov(ctx, input, dataLen, iov, iovCnt, seqNum, nullptr, nullptr);
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ret);
+    SoftBusUnrefCipherCtx(ctx);
+}
+
+/*
+* @tc.name: SoftBusCipherCtx004
+* @tc.desc: every iov is reported once, in order, and only after it is final; a failing callback aborts
+* @tc.type: FUNC
+* @tc.require: 1
+*/
+struct IovDoneRecord {
+    const SoftBusCryptoIov *iov;
+    std::vector<uint32_t> order;
+    std::vector<std::vector<unsigned char>> snapshot;
+    uint32_t failAt;
+};
+
+static int32_t RecordIovDone(uint32_t index, void *arg)
+{
+    IovDoneRecord *record = static_cast<IovDoneRecord *>(arg);
+    if (index == record->failAt) {
+        return SOFTBUS_ERR;
+    }
+    record->order.push_back(index);
+    record->snapshot.emplace_back(record->iov[index].buf, record->iov[index].buf + record->iov[index].len);
+    return SOFTBUS_OK;
+}
+
+HWTEST_F(DsoftbusCryptoTest, SoftBusCipherCtx004, TestSize.Level0)
+{
+    const uint32_t dataLen = 300;
+    const uint32_t iovLen = 100;
+    unsigned char key[SESSION_KEY_LENGTH] = {4};
+    unsigned char input[dataLen] = {9};
+    unsigned char encryptData[dataLen + OVERHEAD_LEN] = {0};
+    const uint32_t iovCnt = (sizeof(encryptData) + iovLen - 1) / iovLen;
+    SoftBusCryptoIov iov[iovCnt] = {};
+    for (uint32_t i = 0; i < iovCnt; i++) {
+        iov[i].buf = encryptData + i * iovLen;
+        iov[i].len = (i == iovCnt - 1) ? (sizeof(encryptData) - i * iovLen) : iovLen;
+    }
+    SoftBusCipherCtx *ctx = SoftBusCreateCipherCtx(key, SESSION_KEY_LENGTH);
+    ASSERT_TRUE(ctx != nullptr);
+
+    IovDoneRecord record = {iov, {}, {}, iovCnt};
+    int32_t ret = SoftBusEncryptDataWithSeqByCtxIov(ctx, input, dataLen, iov, iovCnt, 1, RecordIovDone, &record);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    ASSERT_EQ(iovCnt, record.order.size());
+    for (uint32_t i = 0; i < iovCnt; i++) {
+        EXPECT_EQ(i, record.order[i]);
+        EXPECT_EQ(0, memcmp(record.snapshot[i].data(), iov[i].buf, iov[i].len));
+    }
+
+    IovDoneRecord failRecord = {iov, {}, {}, 1};
+    ret = SoftBusEncryptDataWithSeqByCtxIov(ctx, input, dataLen, iov, iovCnt, 1, RecordIovDone, &failRecord);
+    EXPECT_NE(SOFTBUS_OK, ret);
+    EXPECT_EQ(1U, failRecord.order.size());
+    SoftBusUnrefCipherCtx(ctx);
+}
+}
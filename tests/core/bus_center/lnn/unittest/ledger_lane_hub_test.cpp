@@ -13,8 +13,11 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <gtest/gtest.h>
 #include <securec.h>
+#include <thread>
+#include <vector>
 
 #include "bus_center_info_key.h"
 #include "lnn_distributed_net_ledger.h"
@@ -78,6 +81,9 @@ constexpr uint32_t LOCAL_MAX_SIZE = 128;
 constexpr uint32_t ALL_CAPACITY = 3;
 constexpr int32_t LANES_COUNT_MAX = 100;
 constexpr int32_t DEFAULT_PID = 0;
+constexpr int32_t LEDGER_INDEX_NODE_NUM = 256;
+constexpr int32_t LEDGER_READER_NUM = 8;
+constexpr int32_t LEDGER_WRITE_TIMES = 1000;
 
 class LedgerLaneHubTest : public testing::Test {
 public:
@@ -629,6 +635,55 @@ HWTEST_F(LedgerLaneHubTest, LEDGER_GetDistributedLedgerNode_Test_001, TestSize.L
     LnnRemoveNode(NODE2_UDID);
 }
 
+static void ConstructIndexNode(NodeInfo *info, int32_t i, const char *networkIdPrefix)
+{
+    (void)memset_s(info, sizeof(NodeInfo), 0, sizeof(NodeInfo));
+    char id[UDID_BUF_LEN] = {0};
+    EXPECT_TRUE(sprintf_s(id, sizeof(id), "index_udid_%d", i) > 0);
+    EXPECT_TRUE(LnnSetDeviceUdid(info, id) == SOFTBUS_OK);
+    EXPECT_TRUE(sprintf_s(info->networkId, NETWORK_ID_BUF_LEN, "%s_%d", networkIdPrefix, i) > 0);
+    EXPECT_TRUE(sprintf_s(info->uuid, UUID_BUF_LEN, "index_uuid_%d", i) > 0);
+    EXPECT_TRUE(LnnSetDiscoveryType(info, DISCOVERY_TYPE_BLE) == SOFTBUS_OK);
+}
+
+/*
+* @tc.name: LEDGER_GetDistributedLedgerNode_Test_002
+* @tc.desc: networkId and uuid lookups follow node add, networkId change and remove.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(LedgerLaneHubTest, LEDGER_GetDistributedLedgerNode_Test_002, TestSize.Level1)
+{
+    NodeInfo info;
+    for (int32_t i = 0; i < LEDGER_INDEX_NODE_NUM; i++) {
+        ConstructIndexNode(&info, i, "index_network");
+        LnnAddOnlineNode(&info);
+    }
+    for (int32_t i = 0; i < LEDGER_INDEX_NODE_NUM; i++) {
+        ConstructIndexNode(&info, i, "index_network");
+        NodeInfo *infoNetwork = LnnGetNodeInfoById(info.networkId, CATEGORY_NETWORK_ID);
+        NodeInfo *infoUuid = LnnGetNodeInfoById(info.uuid, CATEGORY_UUID);
+        NodeInfo *infoUdid = LnnGetNodeInfoById(LnnGetDeviceUdid(&info), CATEGORY_UDID);
+        EXPECT_TRUE(infoNetwork != nullptr && infoNetwork == infoUuid && infoNetwork == infoUdid);
+    }
+
+    ConstructIndexNode(&info, 0, "index_network");
+    char oldNetworkId[NETWORK_ID_BUF_LEN] = {0};
+    EXPECT_TRUE(strcpy_s(oldNetworkId, sizeof(oldNetworkId), info.networkId) == EOK);
+    ConstructIndexNode(&info, 0, "index_changed");
+    EXPECT_TRUE(LnnAddOnlineNode(&info) == REPORT_CHANGE);
+    EXPECT_TRUE(LnnGetNodeInfoById(oldNetworkId, CATEGORY_NETWORK_ID) == nullptr);
+    NodeInfo *changed = LnnGetNodeInfoById(info.networkId, CATEGORY_NETWORK_ID);
+    EXPECT_TRUE(changed != nullptr && changed == LnnGetNodeInfoById(info.uuid, CATEGORY_UUID));
+
+    for (int32_t i = 0; i < LEDGER_INDEX_NODE_NUM; i++) {
+        ConstructIndexNode(&info, i, (i == 0) ? "index_changed" : "index_network");
+        LnnRemoveNode(LnnGetDeviceUdid(&info));
+        EXPECT_TRUE(LnnGetNodeInfoById(info.networkId, CATEGORY_NETWORK_ID) == nullptr);
+        EXPECT_TRUE(LnnGetNodeInfoById(info.uuid, CATEGORY_UUID) == nullptr);
+    }
+}
+
 /*
 * @tc.name: LEDGER_GetDistributedLedgerInfo_Test_001
 * @tc.desc:  test of the LnnGetRemoteStrInfo LnnGetDLNumInfo function
@@ -662,6 +717,63 @@ HWTEST_F(LedgerLaneHubTest, LEDGER_GetDistributedLedgerInfo_Test_001, TestSize.L
     LnnRemoveNode(NODE1_UDID);
 }
 
+/*
+* @tc.name: LEDGER_GetDistributedLedgerInfo_Test_002
+* @tc.desc: LnnGetRemoteInfoBatch reads several keys at once, also while the node is being updated.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(LedgerLaneHubTest, LEDGER_GetDistributedLedgerInfo_Test_002, TestSize.Level1)
+{
+    char deviceName[DEVICE_NAME_BUF_LEN] = {0};
+    char macAddr[MAC_LEN] = {0};
+    int32_t cap = 0;
+    ConstructBRNode();
+    LnnAddOnlineNode(&g_nodeInfo[BR_NUM]);
+
+    LnnRemoteInfoItem items[] = {
+        { STRING_KEY_DEV_NAME, deviceName, sizeof(deviceName) },
+        { STRING_KEY_BT_MAC, macAddr, sizeof(macAddr) },
+        { NUM_KEY_NET_CAP, &cap, sizeof(cap) },
+    };
+    EXPECT_TRUE(LnnGetRemoteInfoBatch(NODE1_NETWORK_ID, items, sizeof(items) / sizeof(items[0])) == SOFTBUS_OK);
+    EXPECT_TRUE(strcmp(deviceName, NODE1_DEVICE_NAME) == 0);
+    EXPECT_TRUE(strcmp(macAddr, NODE1_BT_MAC) == 0);
+    EXPECT_TRUE((cap & (1 << BIT_BR)) != 0);
+    EXPECT_TRUE(LnnGetRemoteInfoBatch(NODE2_NETWORK_ID, items, sizeof(items) / sizeof(items[0])) != SOFTBUS_OK);
+    LnnRemoteInfoItem badItem = { STRING_KEY_END, deviceName, sizeof(deviceName) };
+    EXPECT_TRUE(LnnGetRemoteInfoBatch(NODE1_NETWORK_ID, &badItem, 1) == SOFTBUS_INVALID_PARAM);
+
+    std::atomic<bool> stop(false);
+    std::atomic<int32_t> failCnt(0);
+    std::vector<std::thread> readers;
+    for (int32_t i = 0; i < LEDGER_READER_NUM; i++) {
+        readers.emplace_back([&stop, &failCnt]() {
+            char name[DEVICE_NAME_BUF_LEN] = {0};
+            char mac[MAC_LEN] = {0};
+            LnnRemoteInfoItem readItems[] = {
+                { STRING_KEY_DEV_NAME, name, sizeof(name) },
+                { STRING_KEY_BT_MAC, mac, sizeof(mac) },
+            };
+            while (!stop) {
+                if (LnnGetRemoteInfoBatch(NODE1_NETWORK_ID, readItems, sizeof(readItems) / sizeof(readItems[0])) !=
+                    SOFTBUS_OK || (strcmp(name, NODE1_DEVICE_NAME) != 0 && strcmp(name, CHANGE_DEVICE_NAME) != 0)) {
+                    failCnt++;
+                }
+            }
+        });
+    }
+    for (int32_t i = 0; i < LEDGER_WRITE_TIMES; i++) {
+        EXPECT_TRUE(LnnSetDLDeviceInfoName(NODE1_UDID, (i % 2 == 0) ? CHANGE_DEVICE_NAME : NODE1_DEVICE_NAME));
+    }
+    stop = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failCnt, 0);
+    LnnRemoveNode(NODE1_UDID);
+}
+
 /*
 * @tc.name: LEDGER_DistributedLedgerChangeName_Test_001
 * @tc.desc:  test of the LnnGetRemoteStrInfo LnnSetDLDeviceInfoName function
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <securec.h>
+#include <string>
+#include <vector>
+
+#include "lnn_map.h"
+#include "softbus_errcode.h"
+
+namespace OHOS {
+using namespace testing::ext;
+constexpr int32_t MAP_TEST_NODE_NUM = 1000;
+constexpr int32_t MAP_BENCH_LOOKUP_NUM = 200000;
+constexpr int32_t MAP_BENCH_SIZES[] = { 10, 100, 1000 };
+
+struct MapTestValue {
+    int32_t id;
+    char name[65];
+};
+
+static std::string MakeKey(int32_t i)
+{
+    /* udid-like keys, long and sharing a common prefix */
+    char key[65] = {0};
+    (void)sprintf_s(key, sizeof(key), "7A1E3C5B9D2F4A6C8E0B1D3F5A7C9E1B3D5F7A9C1E3B5D7F9A1C3E5B7D%05d", i);
+    return std::string(key);
+}
+
+static volatile uintptr_t g_benchSink = 0;
+
+class LnnMapBenchmarkTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        LnnMapInit(&map_);
+    }
+    void TearDown() override
+    {
+        LnnMapDelete(&map_);
+    }
+
+protected:
+    Map map_;
+};
+
+/*
+* @tc.name: LNN_MAP_SetGetErase_Test_001
+* @tc.desc: values stay reachable and in place while the map grows, and erase keeps the rest findable.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(LnnMapBenchmarkTest, LNN_MAP_SetGetErase_Test_001, TestSize.Level1)
+{
+    MapTestValue value = {0};
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, LnnMapSet(&map_, nullptr, &value, sizeof(value)));
+    EXPECT_EQ(nullptr, LnnMapGet(&map_, MakeKey(0).c_str()));
+    EXPECT_NE(SOFTBUS_OK, LnnMapErase(&map_, MakeKey(0).c_str()));
+
+    value.id = 0;
+    ASSERT_EQ(SOFTBUS_OK, LnnMapSet(&map_, MakeKey(0).c_str(), &value, sizeof(value)));
+    void *first = LnnMapGet(&map_, MakeKey(0).c_str());
+    ASSERT_NE(nullptr, first);
+    for (int32_t i = 1; i < MAP_TEST_NODE_NUM; i++) {
+        value.id = i;
+        ASSERT_EQ(SOFTBUS_OK, LnnMapSet(&map_, MakeKey(i).c_str(), &value, sizeof(value)));
+    }
+    EXPECT_EQ(first, LnnMapGet(&map_, MakeKey(0).c_str()));
+    EXPECT_EQ(MapGetSize(&map_), (uint32_t)MAP_TEST_NODE_NUM);
+
+    value.id = -1;
+    EXPECT_EQ(SOFTBUS_OK, LnnMapSet(&map_, MakeKey(0).c_str(), &value, sizeof(value)));
+    EXPECT_EQ(first, LnnMapGet(&map_, MakeKey(0).c_str()));
+    EXPECT_EQ(-1, ((MapTestValue *)first)->id);
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, LnnMapSet(&map_, MakeKey(0).c_str(), &value, sizeof(value.id)));
+
+    for (int32_t i = 0; i < MAP_TEST_NODE_NUM; i += 2) {
+        EXPECT_EQ(SOFTBUS_OK, LnnMapErase(&map_, MakeKey(i).c_str()));
+    }
+    EXPECT_EQ(MapGetSize(&map_), (uint32_t)MAP_TEST_NODE_NUM / 2);
+    for (int32_t i = 0; i < MAP_TEST_NODE_NUM; i++) {
+        MapTestValue *got = (MapTestValue *)LnnMapGet(&map_, MakeKey(i).c_str());
+        if (i % 2 == 0) {
+            EXPECT_EQ(nullptr, got);
+        } else {
+            ASSERT_NE(nullptr, got);
+            EXPECT_EQ(i, got->id);
+        }
+    }
+}
+
+/*
+* @tc.name: LNN_MAP_Iterator_Test_001
+* @tc.desc: a stack iterator and a heap iterator both visit every node once.
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(LnnMapBenchmarkTest, LNN_MAP_Iterator_Test_001, TestSize.Level1)
+{
+    MapTestValue value = {0};
+    for (int32_t i = 0; i < MAP_TEST_NODE_NUM; i++) {
+        value.id = i;
+        ASSERT_EQ(SOFTBUS_OK, LnnMapSet(&map_, MakeKey(i).c_str(), &value, sizeof(value)));
+    }
+    std::vector<int32_t> seen(MAP_TEST_NODE_NUM, 0);
+    MapIterator it;
+    LnnMapResetIterator(&map_, &it);
+    while (LnnMapHasNext(&it)) {
+        (void)LnnMapNext(&it);
+        MapTestValue *got = (MapTestValue *)it.node->value;
+        EXPECT_EQ(MakeKey(got->id), std::string((const char *)it.node->key));
+        seen[got->id]++;
+    }
+    for (int32_t cnt : seen) {
+        EXPECT_EQ(1, cnt);
+    }
+
+    int32_t heapCnt = 0;
+    MapIterator *heapIt = LnnMapInitIterator(&map_);
+    ASSERT_NE(nullptr, heapIt);
+    while (LnnMapHasNext(heapIt)) {
+        heapIt = LnnMapNext(heapIt);
+        heapCnt++;
+    }
+    LnnMapDeinitIterator(heapIt);
+    EXPECT_EQ(MAP_TEST_NODE_NUM, heapCnt);
+}
+
+/*
+* @tc.name: LNN_MAP_Lookup_Benchmark_001
+* @tc.desc: lookup cost at 10, 100 and 1000 entries, against the strcmp scan the ledger used to do.
+* @tc.type: PERF
+* @tc.require:
+*/
+HWTEST_F(LnnMapBenchmarkTest, LNN_MAP_Lookup_Benchmark_001, TestSize.Level1)
+{
+    MapTestValue value = {0};
+    for (int32_t size : MAP_BENCH_SIZES) {
+        LnnMapDelete(&map_);
+        std::vector<std::string> keys;
+        std::vector<MapTestValue> scanList(size);
+        for (int32_t i = 0; i < size; i++) {
+            keys.push_back(MakeKey(i));
+            value.id = i;
+            ASSERT_EQ(SOFTBUS_OK, LnnMapSet(&map_, keys[i].c_str(), &value, sizeof(value)));
+            scanList[i].id = i;
+            (void)strcpy_s(scanList[i].name, sizeof(scanList[i].name), keys[i].c_str());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < MAP_BENCH_LOOKUP_NUM; i++) {
+            g_benchSink += (uintptr_t)LnnMapGet(&map_, keys[i % size].c_str());
+        }
+        double mapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+            MAP_BENCH_LOOKUP_NUM;
+
+        start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < MAP_BENCH_LOOKUP_NUM; i++) {
+            const char *key = keys[i % size].c_str();
+            for (int32_t j = 0; j < size; j++) {
+                if (strcmp(scanList[j].name, key) == 0) {
+                    g_benchSink += (uintptr_t)&scanList[j];
+                    break;
+                }
+            }
+        }
+        double scanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+            MAP_BENCH_LOOKUP_NUM;
+        printf("lnn map: %4d entries, map get %.1f ns, linear scan %.1f ns\n", size, mapNs, scanNs);
+        if (size >= MAP_TEST_NODE_NUM) {
+            EXPECT_LT(mapNs, scanNs);
+        }
+    }
+}
+} // namespace OHOS
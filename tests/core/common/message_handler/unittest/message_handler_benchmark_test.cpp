@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "message_handler.h"
+#include "softbus_adapter_mem.h"
+
+using namespace testing::ext;
+
+namespace {
+const int32_t BENCH_HANDLER_NUM = 64;
+const int32_t BENCH_WHAT_NUM = 8;
+const int32_t BENCH_MSG_NUM = 20000;
+const uint64_t BENCH_MAX_DELAY_MS = 600000;
+const uint64_t ORDER_DELAY_STEP_MS = 20;
+const int32_t ORDER_MSG_NUM = 5;
+const int32_t WAIT_DISPATCH_MS = 500;
+const int32_t WAIT_LOOPER_START_MS = 50;
+const int32_t BURST_PRODUCER_NUM = 4;
+const int32_t BURST_MSG_PER_PRODUCER = 50000;
+const int32_t BURST_WAIT_MAX_MS = 30000;
+const int32_t BURST_POLL_MS = 1;
+const int32_t BENCH_DUMP_LEN = 4096;
+
+std::atomic<int32_t> g_freeCnt(0);
+std::mutex g_orderLock;
+std::vector<int32_t> g_handledOrder;
+
+void CountFreeMessage(SoftBusMessage *msg)
+{
+    g_freeCnt++;
+    SoftBusFree(msg);
+}
+
+void RecordHandleMessage(SoftBusMessage *msg)
+{
+    std::lock_guard<std::mutex> guard(g_orderLock);
+    g_handledOrder.push_back(msg->what);
+}
+
+std::atomic<int32_t> g_burstHandled(0);
+std::atomic<int32_t> g_burstDisorder(0);
+uint64_t g_burstLastSeq[BURST_PRODUCER_NUM];
+
+void BurstHandleMessage(SoftBusMessage *msg)
+{
+    // arg1 is the producer index, arg2 the per producer sequence starting from 1
+    if (msg->arg2 != g_burstLastSeq[msg->arg1] + 1) {
+        g_burstDisorder++;
+    }
+    g_burstLastSeq[msg->arg1] = msg->arg2;
+    g_burstHandled++;
+}
+
+void PostCountedMessage(SoftBusHandler *handler, int32_t what, uint64_t delayMillis)
+{
+    SoftBusMessage *msg = MallocMessage();
+    ASSERT_TRUE(msg != nullptr);
+    msg->what = what;
+    msg->handler = handler;
+    msg->FreeMessage = CountFreeMessage;
+    handler->looper->PostMessageDelay(handler->looper, msg, delayMillis);
+}
+}
+
+namespace OHOS {
+class MessageHandlerBenchmarkTest : public testing::Test {
+public:
+    void SetUp()
+    {
+        g_freeCnt = 0;
+        g_handledOrder.clear();
+        g_burstHandled = 0;
+        g_burstDisorder = 0;
+        for (auto &seq : g_burstLastSeq) {
+            seq = 0;
+        }
+        looper = CreateNewLooper("Loop-bench");
+        ASSERT_TRUE(looper != nullptr);
+        SetLooperDumpable(looper, false);
+        // RemoveMessage is a no-op until the loop thread is running
+        std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_LOOPER_START_MS));
+    }
+    void TearDown()
+    {
+        DestroyLooper(looper);
+    }
+    SoftBusLooper *looper = nullptr;
+};
+
+/**
+ * @tc.name: MessageHandlerBenchmarkTest001
+ * @tc.desc: delayed messages run by time, posts with the same time keep FIFO order.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MessageHandlerBenchmarkTest, MessageHandlerBenchmarkTest001, TestSize.Level1)
+{
+    SoftBusHandler handler = { const_cast<char *>("orderHandler"), looper, RecordHandleMessage };
+    for (int32_t i = ORDER_MSG_NUM - 1; i >= 0; i--) {
+        PostCountedMessage(&handler, i, (uint64_t)i * ORDER_DELAY_STEP_MS);
+    }
+    PostCountedMessage(&handler, ORDER_MSG_NUM, ORDER_DELAY_STEP_MS * ORDER_MSG_NUM);
+    PostCountedMessage(&handler, ORDER_MSG_NUM + 1, ORDER_DELAY_STEP_MS * ORDER_MSG_NUM);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(ORDER_DELAY_STEP_MS * ORDER_MSG_NUM + WAIT_DISPATCH_MS));
+    std::lock_guard<std::mutex> guard(g_orderLock);
+    ASSERT_EQ(g_handledOrder.size(), (size_t)(ORDER_MSG_NUM + 2));
+    for (int32_t i = 0; i < ORDER_MSG_NUM + 2; i++) {
+        EXPECT_EQ(g_handledOrder[i], i);
+    }
+}
+
+/**
+ * @tc.name: MessageHandlerBenchmarkTest002
+ * @tc.desc: remove by handler and what only drops the matching messages.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MessageHandlerBenchmarkTest, MessageHandlerBenchmarkTest002, TestSize.Level1)
+{
+    SoftBusHandler handlerA = { const_cast<char *>("handlerA"), looper, RecordHandleMessage };
+    SoftBusHandler handlerB = { const_cast<char *>("handlerB"), looper, RecordHandleMessage };
+    for (int32_t what = 0; what < BENCH_WHAT_NUM; what++) {
+        PostCountedMessage(&handlerA, what, BENCH_MAX_DELAY_MS);
+        PostCountedMessage(&handlerB, what, BENCH_MAX_DELAY_MS);
+    }
+    looper->RemoveMessage(looper, &handlerA, 0);
+    EXPECT_EQ(g_freeCnt.load(), 1);
+    looper->RemoveMessage(looper, &handlerB, 0);
+    EXPECT_EQ(g_freeCnt.load(), 2);
+    looper->RemoveMessage(looper, &handlerA, BENCH_WHAT_NUM);
+    EXPECT_EQ(g_freeCnt.load(), 2);
+    for (int32_t what = 1; what < BENCH_WHAT_NUM; what++) {
+        looper->RemoveMessage(looper, &handlerA, what);
+    }
+    EXPECT_EQ(g_freeCnt.load(), BENCH_WHAT_NUM + 1);
+    DestroyLooper(looper);
+    looper = nullptr;
+    EXPECT_EQ(g_freeCnt.load(), BENCH_WHAT_NUM * 2);
+}
+
+/**
+ * @tc.name: MessageHandlerBenchmarkTest003
+ * @tc.desc: micro benchmark, post and remove many delayed messages spread over many handlers.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(MessageHandlerBenchmarkTest, MessageHandlerBenchmarkTest003, TestSize.Level2)
+{
+    std::vector<SoftBusHandler> handlers(BENCH_HANDLER_NUM);
+    for (auto &handler : handlers) {
+        handler.name = const_cast<char *>("benchHandler");
+        handler.looper = looper;
+        handler.HandleMessage = RecordHandleMessage;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_MSG_NUM; i++) {
+        uint64_t delay = BENCH_MAX_DELAY_MS / 2 + (uint64_t)(i * 7919) % (BENCH_MAX_DELAY_MS / 2);
+        PostCountedMessage(&handlers[i % BENCH_HANDLER_NUM], (i / BENCH_HANDLER_NUM) % BENCH_WHAT_NUM, delay);
+    }
+    auto posted = std::chrono::steady_clock::now();
+    for (auto &handler : handlers) {
+        for (int32_t what = 0; what < BENCH_WHAT_NUM; what++) {
+            looper->RemoveMessage(looper, &handler, what);
+        }
+    }
+    auto removed = std::chrono::steady_clock::now();
+    EXPECT_EQ(g_freeCnt.load(), BENCH_MSG_NUM);
+
+    double postNs = std::chrono::duration<double, std::nano>(posted - start).count() / BENCH_MSG_NUM;
+    double removeNs = std::chrono::duration<double, std::nano>(removed - posted).count() /
+        (BENCH_HANDLER_NUM * BENCH_WHAT_NUM);
+    printf("looper bench: %d msgs, post %.1f ns/msg, remove(handler, what) %.1f ns/call\n",
+        BENCH_MSG_NUM, postNs, removeNs);
+}
+
+/**
+ * @tc.name: MessageHandlerBenchmarkTest004
+ * @tc.desc: micro benchmark, several producers burst immediate messages, every message runs once
+ *           and each producer's messages keep their post order.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(MessageHandlerBenchmarkTest, MessageHandlerBenchmarkTest004, TestSize.Level2)
+{
+    SoftBusHandler handler = { const_cast<char *>("burstHandler"), looper, BurstHandleMessage };
+    const int32_t total = BURST_PRODUCER_NUM * BURST_MSG_PER_PRODUCER;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int32_t i = 0; i < BURST_PRODUCER_NUM; i++) {
+        producers.emplace_back([&handler, i]() {
+            for (int32_t seq = 1; seq <= BURST_MSG_PER_PRODUCER; seq++) {
+                SoftBusMessage *msg = MallocMessage();
+                if (msg == nullptr) {
+                    return;
+                }
+                msg->handler = &handler;
+                msg->arg1 = (uint64_t)i;
+                msg->arg2 = (uint64_t)seq;
+                handler.looper->PostMessage(handler.looper, msg);
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    for (int32_t waited = 0; g_burstHandled.load() < total && waited < BURST_WAIT_MAX_MS; waited += BURST_POLL_MS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(BURST_POLL_MS));
+    }
+    auto done = std::chrono::steady_clock::now();
+    EXPECT_EQ(g_burstHandled.load(), total);
+    EXPECT_EQ(g_burstDisorder.load(), 0);
+
+    double seconds = std::chrono::duration<double>(done - start).count();
+    printf("looper bench: %d producers, %d immediate msgs, %.0f msgs/s\n", BURST_PRODUCER_NUM, total,
+        total / seconds);
+}
+
+/**
+ * @tc.name: MessageHandlerBenchmarkTest005
+ * @tc.desc: looper stats count dispatches per handler and what, track depth and show up in the dump.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(MessageHandlerBenchmarkTest, MessageHandlerBenchmarkTest005, TestSize.Level1)
+{
+    SoftBusHandler handler = { const_cast<char *>("statHandler"), looper, RecordHandleMessage };
+    for (int32_t i = 0; i < ORDER_MSG_NUM; i++) {
+        PostCountedMessage(&handler, 0, ORDER_DELAY_STEP_MS);
+    }
+    SoftBusMessage *msg = MallocMessage();
+    ASSERT_TRUE(msg != nullptr);
+    msg->what = 1;
+    msg->handler = &handler;
+    looper->PostMessage(looper, msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(ORDER_DELAY_STEP_MS + WAIT_DISPATCH_MS));
+
+    SoftBusLooperStats stats;
+    ASSERT_EQ(GetLooperStats(looper, &stats), 0);
+    EXPECT_EQ(stats.dispatchCnt, (uint64_t)(ORDER_MSG_NUM + 1));
+    EXPECT_EQ(stats.curQueueDepth, 0U);
+    EXPECT_GE(stats.maxQueueDepth, (uint32_t)ORDER_MSG_NUM);
+    uint64_t drift = 0;
+    uint64_t wait = 0;
+    for (int32_t i = 0; i < LOOPER_HIST_BUCKET_NUM; i++) {
+        drift += stats.timerDriftHist[i];
+        wait += stats.queueWaitHist[i];
+    }
+    EXPECT_EQ(drift, (uint64_t)ORDER_MSG_NUM);
+    EXPECT_EQ(wait, 1U);
+
+    SoftBusLooperHandlerStats handlerStats[BENCH_WHAT_NUM];
+    uint32_t num = BENCH_WHAT_NUM;
+    ASSERT_EQ(GetLooperHandlerStats(looper, handlerStats, &num), 0);
+    ASSERT_EQ(num, 2U);
+    for (uint32_t i = 0; i < num; i++) {
+        EXPECT_STREQ(handlerStats[i].handlerName, "statHandler");
+        EXPECT_EQ(handlerStats[i].dispatchCnt, handlerStats[i].what == 0 ? (uint64_t)ORDER_MSG_NUM : 1U);
+    }
+
+    int32_t fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    DumpLooperStats(fds[1]);
+    close(fds[1]);
+    char dump[BENCH_DUMP_LEN] = {0};
+    ssize_t len = read(fds[0], dump, sizeof(dump) - 1);
+    close(fds[0]);
+    ASSERT_GT(len, 0);
+    EXPECT_TRUE(strstr(dump, "looper[Loop-bench]") != nullptr);
+    EXPECT_TRUE(strstr(dump, "handler=statHandler") != nullptr);
+
+    ResetLooperStats(looper);
+    ASSERT_EQ(GetLooperStats(looper, &stats), 0);
+    EXPECT_EQ(stats.dispatchCnt, 0U);
+}
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <regex.h>
+#include <string>
+#include <vector>
+
+#include "permission_entry.h"
+#include "softbus_errcode.h"
+
+using namespace testing::ext;
+
+namespace {
+const char *TEST_PERM_FILE = "/data/local/tmp/softbus_perm_test.json";
+const char *TEST_PERM_RELOAD_FILE = "/data/local/tmp/softbus_perm_reload_test.json";
+const char *TEST_PKG_NAME = "com.test.pkg";
+const int32_t TEST_UID = 1000;
+const int32_t TEST_PID = 2000;
+const int32_t TEST_BENCH_ENTRY_NUM = 48;
+const int32_t TEST_BENCH_CHECK_NUM = 2000;
+
+const char *TEST_PERM_JSON = R"([
+  {"SESSION_NAME": "com.test.exact", "SEC_LEVEL": "public",
+   "APP_INFO": [{"TYPE": "system_app", "ACTIONS": "create,open"}]},
+  {"SESSION_NAME": "com.test.re.*", "REGEXP": "true", "SEC_LEVEL": "private",
+   "APP_INFO": [{"TYPE": "system_app", "ACTIONS": "create,open"}]},
+  {"SESSION_NAME": "objectstoreDB-*", "REGEXP": "true",
+   "APP_INFO": [{"TYPE": "system_app", "ACTIONS": "create"}]},
+  {"SESSION_NAME": "bad[", "REGEXP": "true",
+   "APP_INFO": [{"TYPE": "system_app", "ACTIONS": "create"}]}
+])";
+
+/* loaded later, so it comes first and shadows the exact entry above */
+const char *TEST_PERM_RELOAD_JSON = R"([
+  {"SESSION_NAME": "com.test.*", "REGEXP": "true", "SEC_LEVEL": "private",
+   "APP_INFO": [{"TYPE": "normal_app", "ACTIONS": "create"}]}
+])";
+
+bool WriteFile(const char *path, const std::string &content)
+{
+    FILE *fp = fopen(path, "w");
+    if (fp == nullptr) {
+        return false;
+    }
+    bool ok = (fwrite(content.data(), 1, content.size(), fp) == content.size());
+    fclose(fp);
+    return ok;
+}
+
+int32_t Check(const char *sessionName, int32_t permType, uint32_t actions)
+{
+    SoftBusPermissionItem item = {permType, TEST_UID, TEST_PID, (char *)TEST_PKG_NAME, actions};
+    return CheckPermissionEntry(sessionName, &item);
+}
+
+std::string BenchPattern(int32_t i)
+{
+    return "ohos.bench.service" + std::to_string(i) + ".*";
+}
+} // namespace
+
+namespace OHOS {
+class PermissionEntryTest : public testing::Test {
+public:
+    void TearDown() override
+    {
+        DeinitPermissionJson();
+        (void)remove(TEST_PERM_FILE);
+        (void)remove(TEST_PERM_RELOAD_FILE);
+    }
+};
+
+/**
+ * @tc.name: PermissionEntryTest_Match_001
+ * @tc.desc: exact and regexp entries match as before, repeated checks give the same verdict.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PermissionEntryTest, PermissionEntryTest_Match_001, TestSize.Level1)
+{
+    ASSERT_TRUE(WriteFile(TEST_PERM_FILE, TEST_PERM_JSON));
+    ASSERT_EQ(SOFTBUS_OK, LoadPermissionJson(TEST_PERM_FILE));
+
+    for (int32_t round = 0; round < 2; round++) {
+        EXPECT_EQ(SYSTEM_APP, Check("com.test.exact", SYSTEM_APP, ACTION_CREATE));
+        EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("com.test.exact", NORMAL_APP, ACTION_CREATE));
+        EXPECT_EQ(SYSTEM_APP, Check("com.test.re.session", SYSTEM_APP, ACTION_OPEN));
+        /* an unanchored pattern matches anywhere in the name */
+        EXPECT_EQ(SYSTEM_APP, Check("prefix.com.test.re.session", SYSTEM_APP, ACTION_OPEN));
+        /* the '-' in front of '*' is optional, the literal filter must not require it */
+        EXPECT_EQ(SYSTEM_APP, Check("objectstoreDB", SYSTEM_APP, ACTION_CREATE));
+        EXPECT_EQ(SYSTEM_APP, Check("objectstoreDB---x", SYSTEM_APP, ACTION_CREATE));
+        EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("objectstoreDB", SYSTEM_APP, ACTION_OPEN));
+        EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("bad[", SYSTEM_APP, ACTION_CREATE));
+        EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("com.test.unknown", SYSTEM_APP, ACTION_CREATE));
+    }
+    EXPECT_TRUE(PermIsSecLevelPublic("com.test.exact"));
+    EXPECT_FALSE(PermIsSecLevelPublic("com.test.re.session"));
+    EXPECT_FALSE(PermIsSecLevelPublic("com.test.unknown"));
+}
+
+/**
+ * @tc.name: PermissionEntryTest_Reload_001
+ * @tc.desc: an entry loaded later takes over the names it matches, cached verdicts do not survive the load.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(PermissionEntryTest, PermissionEntryTest_Reload_001, TestSize.Level1)
+{
+    ASSERT_TRUE(WriteFile(TEST_PERM_FILE, TEST_PERM_JSON));
+    ASSERT_TRUE(WriteFile(TEST_PERM_RELOAD_FILE, TEST_PERM_RELOAD_JSON));
+    ASSERT_EQ(SOFTBUS_OK, LoadPermissionJson(TEST_PERM_FILE));
+    EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("com.test.exact", NORMAL_APP, ACTION_CREATE));
+    EXPECT_TRUE(PermIsSecLevelPublic("com.test.exact"));
+
+    ASSERT_EQ(SOFTBUS_OK, LoadPermissionJson(TEST_PERM_RELOAD_FILE));
+    EXPECT_EQ(NORMAL_APP, Check("com.test.exact", NORMAL_APP, ACTION_CREATE));
+    EXPECT_EQ(SOFTBUS_PERMISSION_DENIED, Check("com.test.exact", SYSTEM_APP, ACTION_OPEN));
+    EXPECT_FALSE(PermIsSecLevelPublic("com.test.exact"));
+    /* names the new entry does not match still go to the old ones */
+    EXPECT_EQ(SYSTEM_APP, Check("objectstoreDB-1", SYSTEM_APP, ACTION_CREATE));
+
+    DeinitPermissionJson();
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, Check("com.test.exact", NORMAL_APP, ACTION_CREATE));
+}
+
+/**
+ * @tc.name: PermissionEntryTest_Bench_001
+ * @tc.desc: check cost with many regexp entries, against compiling every pattern on each check.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(PermissionEntryTest, PermissionEntryTest_Bench_001, TestSize.Level1)
+{
+    std::string json = "[";
+    for (int32_t i = 0; i < TEST_BENCH_ENTRY_NUM; i++) {
+        json += std::string(i == 0 ? "" : ",") + R"({"SESSION_NAME":")" + BenchPattern(i) +
+            R"(","REGEXP":"true","APP_INFO":[{"TYPE":"system_app","ACTIONS":"create"}]})";
+    }
+    json += "]";
+    ASSERT_TRUE(WriteFile(TEST_PERM_FILE, json));
+    ASSERT_EQ(SOFTBUS_OK, LoadPermissionJson(TEST_PERM_FILE));
+
+    /* a name that only the first loaded entry matches, so every pattern is tried */
+    std::string sessionName = "ohos.bench.service0.session";
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < TEST_BENCH_CHECK_NUM; i++) {
+        std::string name = sessionName + std::to_string(i);
+        ASSERT_EQ(SYSTEM_APP, Check(name.c_str(), SYSTEM_APP, ACTION_CREATE));
+    }
+    double missUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        TEST_BENCH_CHECK_NUM;
+
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < TEST_BENCH_CHECK_NUM; i++) {
+        ASSERT_EQ(SYSTEM_APP, Check(sessionName.c_str(), SYSTEM_APP, ACTION_CREATE));
+    }
+    double hitUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        TEST_BENCH_CHECK_NUM;
+
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < TEST_BENCH_ENTRY_NUM; i++) {
+        regex_t regComp;
+        ASSERT_EQ(0, regcomp(&regComp, BenchPattern(i).c_str(), REG_EXTENDED | REG_NOSUB));
+        (void)regexec(&regComp, sessionName.c_str(), 0, NULL, 0);
+        regfree(&regComp);
+    }
+    double compileUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("permission check: %d regexp entries, uncached %.2f us, cached %.2f us, compiling per check %.2f us\n",
+        TEST_BENCH_ENTRY_NUM, missUs, hitUs, compileUs);
+    EXPECT_LT(missUs, compileUs);
+    EXPECT_LT(hitUs, missUs);
+}
+} // namespace OHOS
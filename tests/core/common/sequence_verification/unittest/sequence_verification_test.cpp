@@ -13,7 +13,10 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <cstdio>
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "softbus_sequence_verification.h"
 
@@ -21,6 +24,23 @@ using namespace testing::ext;
 
 namespace {
 const int32_t MAX_RECEIVE_SEQUENCE = 5;
+const int32_t SEQ_WINDOW_WORD_BITS = 64;
+const int32_t BENCH_PACKET_NUM = 1000000;
+const int32_t BENCH_REORDER_DEPTH = 512;
+
+/* in order seqs with every block of reorderDepth seqs sent back to front, as pipelined senders do */
+std::vector<int32_t> MakeReorderedSeqs(int32_t firstSeq, int32_t num, int32_t reorderDepth)
+{
+    std::vector<int32_t> seqs;
+    seqs.reserve(num);
+    for (int32_t block = 0; block < num; block += reorderDepth) {
+        int32_t end = (block + reorderDepth < num) ? block + reorderDepth : num;
+        for (int32_t i = end - 1; i >= block; i--) {
+            seqs.push_back((int32_t)((uint32_t)firstSeq + (uint32_t)i));
+        }
+    }
+    return seqs;
+}
 }
 
 namespace OHOS {
@@ -522,4 +542,104 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_LessThanMinCase_00
         }
     }
 }
-} // namespace OHOS
\ No newline at end of file
+
+/**
+ * @tc.name: Softbus_SeqWindowTest_Test_InvalidSize_001
+ * @tc.desc: Verify the window size must be a power of 2 in range.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqWindowTest_Test_InvalidSize_001, TestSize.Level0)
+{
+    EXPECT_TRUE(CreateSeqWindowInfo(SEQ_WINDOW_SIZE_MIN / 2, 0) == nullptr);
+    EXPECT_TRUE(CreateSeqWindowInfo(SEQ_WINDOW_SIZE_MAX * 2, 0) == nullptr);
+    EXPECT_TRUE(CreateSeqWindowInfo(SEQ_WINDOW_SIZE_DEFAULT + SEQ_WINDOW_WORD_BITS, 0) == nullptr);
+    EXPECT_FALSE(IsPassSeqWindowCheck(nullptr, 0));
+}
+
+/**
+ * @tc.name: Softbus_SeqWindowTest_Test_Disorder_001
+ * @tc.desc: Verify a pipelined burst deeper than MAX_SEQ_BIAS passes once, and replays fail.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqWindowTest_Test_Disorder_001, TestSize.Level0)
+{
+    SeqWindowInfo *windowInfo = CreateSeqWindowInfo(SEQ_WINDOW_SIZE_DEFAULT, 0);
+    ASSERT_TRUE(windowInfo != nullptr);
+    std::vector<int32_t> seqs = MakeReorderedSeqs(0, SEQ_WINDOW_SIZE_DEFAULT * 4, BENCH_REORDER_DEPTH);
+    for (int32_t seq : seqs) {
+        EXPECT_TRUE(IsPassSeqWindowCheck(windowInfo, seq));
+    }
+    int32_t lastSeq = SEQ_WINDOW_SIZE_DEFAULT * 4 - 1;
+    EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, lastSeq));
+    EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, lastSeq - BENCH_REORDER_DEPTH));
+    /* behind the window, even though never seen */
+    EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, -1));
+    EXPECT_TRUE(IsPassSeqWindowCheck(windowInfo, lastSeq + SEQ_WINDOW_SIZE_MAX));
+    EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, lastSeq + 1));
+    DestroySeqWindowInfo(windowInfo);
+}
+
+/**
+ * @tc.name: Softbus_SeqWindowTest_Test_Flip_001
+ * @tc.desc: Verify the window slides over the seq flip from INT32_MAX to INT32_MIN and through -1 to 0.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqWindowTest_Test_Flip_001, TestSize.Level0)
+{
+    const int32_t firstSeqs[] = { INT32_MAX - 100, -100 };
+    for (int32_t firstSeq : firstSeqs) {
+        SeqWindowInfo *windowInfo = CreateSeqWindowInfo(SEQ_WINDOW_SIZE_MIN, firstSeq);
+        ASSERT_TRUE(windowInfo != nullptr);
+        EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, (int32_t)((uint32_t)firstSeq - 1)));
+        std::vector<int32_t> seqs = MakeReorderedSeqs(firstSeq, 200, SEQ_WINDOW_SIZE_MIN - SEQ_WINDOW_WORD_BITS);
+        for (int32_t seq : seqs) {
+            EXPECT_TRUE(IsPassSeqWindowCheck(windowInfo, seq));
+            EXPECT_FALSE(IsPassSeqWindowCheck(windowInfo, seq));
+        }
+        DestroySeqWindowInfo(windowInfo);
+    }
+}
+
+/**
+ * @tc.name: Softbus_SeqWindowTest_Test_Benchmark_001
+ * @tc.desc: Print the verification cost per packet of the bitmap check and of the wide windows.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqWindowTest_Test_Benchmark_001, TestSize.Level1)
+{
+    std::vector<int32_t> inOrder = MakeReorderedSeqs(0, BENCH_PACKET_NUM, 1);
+    std::vector<int32_t> reordered = MakeReorderedSeqs(0, BENCH_PACKET_NUM, BENCH_REORDER_DEPTH);
+
+    SeqVerifyInfo seqInfo = {0};
+    auto start = std::chrono::steady_clock::now();
+    int32_t passNum = 0;
+    for (int32_t seq : inOrder) {
+        passNum += IsPassSeqCheck(&seqInfo, seq) ? 1 : 0;
+    }
+    double cost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(passNum, BENCH_PACKET_NUM);
+    printf("seq bitmap, in order:  %.2f ns/packet\n", cost / BENCH_PACKET_NUM);
+
+    const uint32_t windowSizes[] = { SEQ_WINDOW_SIZE_DEFAULT, SEQ_WINDOW_SIZE_MAX };
+    for (uint32_t windowSize : windowSizes) {
+        for (const std::vector<int32_t> *seqs : { &inOrder, &reordered }) {
+            SeqWindowInfo *windowInfo = CreateSeqWindowInfo(windowSize, 0);
+            ASSERT_TRUE(windowInfo != nullptr);
+            passNum = 0;
+            start = std::chrono::steady_clock::now();
+            for (int32_t seq : *seqs) {
+                passNum += IsPassSeqWindowCheck(windowInfo, seq) ? 1 : 0;
+            }
+            cost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            EXPECT_EQ(passNum, BENCH_PACKET_NUM);
+            printf("seq window %4u, %s: %.2f ns/packet\n", windowSize,
+                (seqs == &inOrder) ? "in order " : "reordered", cost / BENCH_PACKET_NUM);
+            DestroySeqWindowInfo(windowInfo);
+        }
+    }
+}
+} // namespace OHOS
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "softbus_errcode.h"
+#include "softbus_log.h"
+
+using namespace testing::ext;
+
+namespace {
+const int32_t TEST_FILTERED_LOG_NUM = 1000000;
+const int32_t TEST_LOG_BURST_NUM = 64;
+const int32_t TEST_LOG_BURST_CNT = 20;
+const int32_t TEST_LOG_THREAD_NUM = 4;
+
+int32_t g_evalCnt = 0;
+
+int32_t CountEval(void)
+{
+    return ++g_evalCnt;
+}
+
+double LogBurstCost(void)
+{
+    double cost = 0;
+    for (int32_t i = 0; i < TEST_LOG_BURST_CNT; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t j = 0; j < TEST_LOG_BURST_NUM; j++) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "log bench send slice, seq=%d, len=%u, name=%s",
+                j, (uint32_t)i, "bench");
+        }
+        cost += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        /* let the log thread catch up, so the next burst does not run out of records */
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return cost / (TEST_LOG_BURST_CNT * TEST_LOG_BURST_NUM);
+}
+} // namespace
+
+namespace OHOS {
+class SoftBusLogTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp() override
+    {
+        g_evalCnt = 0;
+        SoftBusLogSetLevel(SOFTBUS_LOG_DBG);
+    }
+    void TearDown() override
+    {
+        SoftBusLogAsyncStop();
+        SoftBusLogSetLevel(SOFTBUS_LOG_DBG);
+    }
+};
+
+/**
+ * @tc.name: SoftBusLogTest_LevelFilter_001
+ * @tc.desc: a log below the runtime level does not evaluate its arguments.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftBusLogTest, SoftBusLogTest_LevelFilter_001, TestSize.Level1)
+{
+    SoftBusLogSetLevel(SOFTBUS_LOG_ERROR);
+    EXPECT_FALSE(SOFTBUS_LOG_IS_ENABLED(SOFTBUS_LOG_INFO));
+    EXPECT_TRUE(SOFTBUS_LOG_IS_ENABLED(SOFTBUS_LOG_ERROR));
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG, "filtered %d", CountEval());
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "filtered %d", CountEval());
+    EXPECT_EQ(0, g_evalCnt);
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "printed %d", CountEval());
+    EXPECT_EQ(1, g_evalCnt);
+
+    SoftBusLogSetLevel(SOFTBUS_LOG_DBG);
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG, "printed %d", CountEval());
+    EXPECT_EQ(2, g_evalCnt);
+}
+
+/**
+ * @tc.name: SoftBusLogTest_Async_001
+ * @tc.desc: async logging from several threads, with formats the async path records and ones it hands back.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftBusLogTest, SoftBusLogTest_Async_001, TestSize.Level1)
+{
+    EXPECT_EQ(SOFTBUS_OK, SoftBusLogAsyncStart());
+    EXPECT_EQ(SOFTBUS_OK, SoftBusLogAsyncStart());
+    std::vector<std::thread> threads;
+    for (int32_t t = 0; t < TEST_LOG_THREAD_NUM; t++) {
+        threads.emplace_back([t]() {
+            for (int32_t i = 0; i < TEST_LOG_BURST_NUM * TEST_LOG_BURST_CNT; i++) {
+                SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "async t=%d i=%d ll=%lld zd=%zd s=%s null=%s %%",
+                    t, i, (long long)i << 32, (ssize_t)-i, "str", (const char *)nullptr);
+                SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "async %c %02x %.2f %p", 'a', i & 0xff, i / 3.0,
+                    (void *)&i);
+                SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "async unsupported %*d", 4, i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    SoftBusLogAsyncStop();
+    SoftBusLogAsyncStop();
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "sync again %d", CountEval());
+    EXPECT_EQ(1, g_evalCnt);
+}
+
+/**
+ * @tc.name: SoftBusLogTest_Bench_001
+ * @tc.desc: caller side cost of a filtered log, a sync log and an async log.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(SoftBusLogTest, SoftBusLogTest_Bench_001, TestSize.Level1)
+{
+    SoftBusLogSetLevel(SOFTBUS_LOG_ERROR);
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < TEST_FILTERED_LOG_NUM; i++) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "log bench send slice, seq=%d, name=%s", i, "bench");
+    }
+    double filteredNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+        TEST_FILTERED_LOG_NUM;
+
+    double syncNs = LogBurstCost();
+    ASSERT_EQ(SOFTBUS_OK, SoftBusLogAsyncStart());
+    double asyncNs = LogBurstCost();
+    SoftBusLogAsyncStop();
+
+    printf("softbus log: filtered %.1f ns, sync %.1f ns, async %.1f ns\n", filteredNs, syncNs, asyncNs);
+    EXPECT_LT(filteredNs, syncNs);
+    EXPECT_LT(asyncNs, syncNs);
+}
+} // namespace OHOS
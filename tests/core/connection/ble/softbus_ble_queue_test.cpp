@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "softbus_ble_queue.h"
+#include "softbus_conn_interface.h"
+#include "softbus_errcode.h"
+
+using namespace testing::ext;
+
+namespace {
+const uint32_t TEST_MSG_LEN = 100;
+const int32_t TEST_BACKLOG_NUM = 16;
+const int32_t TEST_PRODUCER_NUM = 8;
+const int32_t TEST_LIGHT_MSG_NUM = 500;
+const int32_t TEST_CHATTY_MSG_NUM = TEST_LIGHT_MSG_NUM * 8;
+/* while the light pids still send, a fair share of the chatty pid is about one light pid, allow twice that */
+const int32_t TEST_CHATTY_SHARE_BOUND = TEST_LIGHT_MSG_NUM * 2;
+const int32_t TEST_LINK_SEND_US = 10; /* the consumer stands for a link slower than the producers */
+
+BleQueueConfig g_defaultConfig;
+
+SendQueueNode *NewNode(int32_t pid, int32_t flag, int32_t seq)
+{
+    SendQueueNode *node = new SendQueueNode();
+    node->pid = pid;
+    node->flag = flag;
+    node->seq = seq;
+    node->len = TEST_MSG_LEN;
+    return node;
+}
+
+SendQueueNode *Dequeue()
+{
+    void *msg = nullptr;
+    if (BleDequeueNonBlock(&msg) != SOFTBUS_OK) {
+        return nullptr;
+    }
+    return (SendQueueNode *)msg;
+}
+
+void EnqueueRetry(SendQueueNode *node)
+{
+    while (BleEnqueueNonBlock(node) == SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) {
+        std::this_thread::yield();
+    }
+}
+} // namespace
+
+namespace OHOS {
+class SoftBusBleQueueTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        BleQueueGetConfig(&g_defaultConfig);
+    }
+    void SetUp() override
+    {
+        /* one message of TEST_MSG_LEN per weight unit and turn, so the order is easy to predict */
+        BleQueueConfig config = g_defaultConfig;
+        config.quantum = TEST_MSG_LEN;
+        ASSERT_EQ(SOFTBUS_OK, BleQueueSetConfig(&config));
+        ASSERT_EQ(SOFTBUS_OK, BleInnerQueueInit());
+    }
+    void TearDown() override
+    {
+        SendQueueNode *node = nullptr;
+        while ((node = Dequeue()) != nullptr) {
+            delete node;
+        }
+        BleInnerQueueDeinit();
+        (void)BleQueueSetConfig(&g_defaultConfig);
+    }
+};
+
+/**
+ * @tc.name: SoftBusBleQueueTest_Fair_001
+ * @tc.desc: a pid with a backlog does not hold back another pid, nor connection messages of pid 0.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftBusBleQueueTest, SoftBusBleQueueTest_Fair_001, TestSize.Level1)
+{
+    for (int32_t i = 0; i < TEST_BACKLOG_NUM; i++) {
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(1, CONN_MIDDLE, i)));
+    }
+    for (int32_t i = 0; i < 2; i++) {
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(2, CONN_MIDDLE, i)));
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(0, CONN_MIDDLE, i)));
+    }
+    /* pid 1 and 2 get two messages a turn, pid 0 four */
+    std::vector<int32_t> expectPids = {1, 1, 2, 2, 0, 0, 1, 1};
+    for (int32_t pid : expectPids) {
+        SendQueueNode *node = Dequeue();
+        ASSERT_NE(nullptr, node);
+        EXPECT_EQ(pid, node->pid);
+        delete node;
+    }
+    std::map<int32_t, int32_t> lastSeq;
+    int32_t left = 0;
+    SendQueueNode *node = nullptr;
+    while ((node = Dequeue()) != nullptr) {
+        EXPECT_EQ(1, node->pid);
+        EXPECT_GT(node->seq, lastSeq[node->pid]);
+        lastSeq[node->pid] = node->seq;
+        left++;
+        delete node;
+    }
+    EXPECT_EQ(TEST_BACKLOG_NUM - 4, left);
+}
+
+/**
+ * @tc.name: SoftBusBleQueueTest_Weight_001
+ * @tc.desc: backlogged flows share by priority weight, a long message waits for enough deficit.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftBusBleQueueTest, SoftBusBleQueueTest_Weight_001, TestSize.Level1)
+{
+    for (int32_t i = 0; i < TEST_BACKLOG_NUM; i++) {
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(1, CONN_HIGH, i)));
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(2, CONN_LOW, i)));
+    }
+    int32_t highCnt = 0;
+    for (int32_t i = 0; i < 10; i++) {
+        SendQueueNode *node = Dequeue();
+        ASSERT_NE(nullptr, node);
+        highCnt += (node->pid == 1) ? 1 : 0;
+        delete node;
+    }
+    EXPECT_EQ(8, highCnt);
+    SendQueueNode *node = nullptr;
+    while ((node = Dequeue()) != nullptr) {
+        delete node;
+    }
+
+    SendQueueNode *big = NewNode(1, CONN_LOW, 0);
+    big->len = TEST_MSG_LEN * 3;
+    ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(big));
+    for (int32_t i = 0; i < 3; i++) {
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(2, CONN_LOW, i)));
+    }
+    std::vector<int32_t> expectPids = {2, 2, 1, 2};
+    for (int32_t pid : expectPids) {
+        node = Dequeue();
+        ASSERT_NE(nullptr, node);
+        EXPECT_EQ(pid, node->pid);
+        delete node;
+    }
+}
+
+/**
+ * @tc.name: SoftBusBleQueueTest_Depth_001
+ * @tc.desc: a full flow rejects only its own pid and priority, an aged out pid queue comes back on demand.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftBusBleQueueTest, SoftBusBleQueueTest_Depth_001, TestSize.Level1)
+{
+    BleInnerQueueDeinit();
+    BleQueueConfig config = g_defaultConfig;
+    config.depth[2] = 3;
+    config.idleAgeMs = 0;
+    BleQueueConfig invalid = {};
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, BleQueueSetConfig(&invalid));
+    ASSERT_EQ(SOFTBUS_OK, BleQueueSetConfig(&config));
+    ASSERT_EQ(SOFTBUS_OK, BleInnerQueueInit());
+    EXPECT_NE(SOFTBUS_OK, BleQueueSetConfig(&config));
+
+    for (int32_t i = 0; i < 3; i++) {
+        ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(1, CONN_LOW, i)));
+    }
+    SendQueueNode *full = NewNode(1, CONN_LOW, 3);
+    EXPECT_EQ(SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL, BleEnqueueNonBlock(full));
+    delete full;
+    ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(1, CONN_HIGH, 0)));
+    ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(2, CONN_LOW, 0)));
+
+    int32_t cnt = 0;
+    SendQueueNode *node = nullptr;
+    while ((node = Dequeue()) != nullptr) {
+        cnt++;
+        delete node;
+    }
+    EXPECT_EQ(5, cnt);
+    /* past the aging interval both idle queues are freed on the next dequeue */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(nullptr, Dequeue());
+    ASSERT_EQ(SOFTBUS_OK, BleEnqueueNonBlock(NewNode(1, CONN_LOW, 4)));
+    node = Dequeue();
+    ASSERT_NE(nullptr, node);
+    EXPECT_EQ(4, node->seq);
+    delete node;
+}
+
+/**
+ * @tc.name: SoftBusBleQueueTest_Bench_001
+ * @tc.desc: many producers against one blocking consumer, the light pids are done before the chatty one
+ *          and it gets no more than a bounded share of the link meanwhile.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(SoftBusBleQueueTest, SoftBusBleQueueTest_Bench_001, TestSize.Level1)
+{
+    const int32_t total = TEST_CHATTY_MSG_NUM + (TEST_PRODUCER_NUM - 1) * TEST_LIGHT_MSG_NUM;
+    int32_t lightDoneNum = 0;
+    int32_t chattyNumAtLightDone = -1;
+    bool isChattyDoneFirst = false;
+    std::thread consumer([&, total]() {
+        std::vector<int32_t> received(TEST_PRODUCER_NUM + 1, 0);
+        for (int32_t i = 0; i < total; i++) {
+            void *msg = nullptr;
+            ASSERT_EQ(SOFTBUS_OK, BleDequeueBlock(&msg));
+            SendQueueNode *node = (SendQueueNode *)msg;
+            int32_t pid = node->pid;
+            delete node;
+            std::this_thread::sleep_for(std::chrono::microseconds(TEST_LINK_SEND_US));
+            int32_t expect = (pid == 1) ? TEST_CHATTY_MSG_NUM : TEST_LIGHT_MSG_NUM;
+            if (++received[pid] != expect) {
+                continue;
+            }
+            if (pid == 1) {
+                isChattyDoneFirst = (lightDoneNum < TEST_PRODUCER_NUM - 1);
+            } else if (++lightDoneNum == TEST_PRODUCER_NUM - 1) {
+                chattyNumAtLightDone = received[1];
+            }
+        }
+    });
+    /* the producers start together, so the chatty one is not alone in the queue while the others are created */
+    std::atomic<int32_t> readyNum(0);
+    std::vector<std::thread> producers;
+    for (int32_t pid = 1; pid <= TEST_PRODUCER_NUM; pid++) {
+        producers.emplace_back([pid, &readyNum]() {
+            readyNum++;
+            while (readyNum < TEST_PRODUCER_NUM) {
+                std::this_thread::yield();
+            }
+            int32_t num = (pid == 1) ? TEST_CHATTY_MSG_NUM : TEST_LIGHT_MSG_NUM;
+            for (int32_t i = 0; i < num; i++) {
+                EnqueueRetry(NewNode(pid, (i % 2 == 0) ? CONN_MIDDLE : CONN_LOW, i));
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+
+    EXPECT_FALSE(isChattyDoneFirst);
+    EXPECT_GE(chattyNumAtLightDone, 0);
+    EXPECT_LE(chattyNumAtLightDone, TEST_CHATTY_SHARE_BOUND);
+}
+} // namespace OHOS
@@ -13,8 +13,11 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
 #include <pthread.h>
+#include <sys/socket.h>
+#include <vector>
 
 #include "common_list.h"
 #include "softbus_base_listener.h"
@@ -391,6 +394,36 @@ HWTEST_F(SoftbusCommonTest, testTcpSocket004, TestSize.Level1)
     TcpShutDown(clientFd);
 };
 
+/*
+* @tc.name: testTcpSocket005
+* @tc.desc: test SendTcpData and SendTcpDataIov give up when the peer stops reading
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testTcpSocket005, TestSize.Level1)
+{
+    int fds[2] = {INVALID_FD, INVALID_FD};
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(0, fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK));
+    const size_t dataLen = 8 * 1024 * 1024;
+    std::vector<char> data(dataLen, 'a');
+
+    ssize_t bytes = SendTcpData(fds[0], data.data(), dataLen, 0);
+    EXPECT_GT(bytes, 0);
+    EXPECT_LT(bytes, (ssize_t)dataLen);
+
+    SoftBusIovec iov[2] = {};
+    iov[0].iovBase = data.data();
+    iov[0].iovLen = dataLen / 2;
+    iov[1].iovBase = data.data() + dataLen / 2;
+    iov[1].iovLen = dataLen / 2;
+    bytes = SendTcpDataIov(fds[0], iov, 2, 0);
+    EXPECT_EQ(-1, bytes);
+
+    close(fds[0]);
+    close(fds[1]);
+};
+
 /*
 * @tc.name: testThreadPool001
 * @tc.desc: test ThreadPoolInit invalid input param
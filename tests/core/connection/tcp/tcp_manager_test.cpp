@@ -53,6 +53,7 @@ static ConnectFuncInterface *g_interface = nullptr;
 static ConnectResult g_result;
 static ConnectCallback g_cb;
 static int g_receivedDatalength = 0;
+static int g_receivedFrameCnt = 0;
 
 void TcpOnConnected(uint32_t connectionId, const ConnectionInfo *info)
 {
@@ -67,6 +68,7 @@ void TcpOnDisConnect(uint32_t connectionId, const ConnectionInfo *info)
 void TcpDataReceived(uint32_t connectionId, ConnModule moduleId, int64_t seq, char *data, int length)
 {
     g_receivedDatalength = length;
+    g_receivedFrameCnt++;
     printf("nDataReceived with length:%d\n", length);
 }
 
@@ -109,6 +111,7 @@ void SoftbusTcpManagerTest::SetUp(void)
     g_result.OnConnectFailed = TcpOnConnectionFailed;
     g_connectionId = 0;
     g_receivedDatalength = 0;
+    g_receivedFrameCnt = 0;
 }
 
 void SoftbusTcpManagerTest::TearDown(void)
@@ -425,4 +428,114 @@ HWTEST_F(SoftbusTcpManagerTest, testTcpManager009, TestSize.Level1)
     EXPECT_EQ(SOFTBUS_OK, TcpStopListening(&info));
     EXPECT_EQ(0, TcpGetConnNum());
 }
+
+/*
+* @tc.name: testTcpManager010
+* @tc.desc: test frames arriving in fragments and back to back are reassembled
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusTcpManagerTest, testTcpManager010, TestSize.Level1)
+{
+    int port = 6666;
+    LocalListenerInfo info = {};
+    info.type = CONNECT_TCP;
+    info.info.ipListenerInfo.port = port;
+    info.info.ipListenerInfo.moduleId = PROXY;
+    (void)strcpy_s(info.info.ipListenerInfo.ip, IP_LEN, Ip);
+    EXPECT_EQ(port, TcpStartListening(&info));
+
+    ConnPktHead head = {0};
+    head.len = strlen(g_data);
+    uint32_t frameLen = sizeof(head) + head.len;
+    const int frameNum = 3;
+    char frames[frameNum * MAXLNE] = {0};
+    for (int i = 0; i < frameNum; i++) {
+        (void)memcpy_s(frames + i * frameLen, frameLen, &head, sizeof(head));
+        (void)memcpy_s(frames + i * frameLen + sizeof(head), head.len, g_data, head.len);
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, Ip, &addr.sin_addr);
+    ASSERT_EQ(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    sleep(1);
+    EXPECT_EQ(1, TcpGetConnNum());
+
+    uint32_t headPart = sizeof(head) / 2;
+    uint32_t bodyPart = sizeof(head) + head.len / 2;
+    EXPECT_EQ((ssize_t)headPart, send(fd, frames, headPart, 0));
+    sleep(1);
+    EXPECT_EQ(0, g_receivedFrameCnt);
+    EXPECT_EQ((ssize_t)(bodyPart - headPart), send(fd, frames + headPart, bodyPart - headPart, 0));
+    sleep(1);
+    EXPECT_EQ(0, g_receivedFrameCnt);
+    uint32_t left = frameNum * frameLen - bodyPart;
+    EXPECT_EQ((ssize_t)left, send(fd, frames + bodyPart, left, 0));
+    sleep(1);
+    EXPECT_EQ(frameNum, g_receivedFrameCnt);
+    EXPECT_EQ((int)frameLen, g_receivedDatalength);
+
+    close(fd);
+    sleep(1);
+    EXPECT_EQ(0, TcpGetConnNum());
+    EXPECT_EQ(SOFTBUS_OK, TcpStopListening(&info));
+}
+
+/*
+* @tc.name: testTcpManager011
+* @tc.desc: test a big frame grows the receive buffer and a small frame after it still arrives
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusTcpManagerTest, testTcpManager011, TestSize.Level1)
+{
+    int port = 6666;
+    LocalListenerInfo info = {};
+    info.type = CONNECT_TCP;
+    info.info.ipListenerInfo.port = port;
+    info.info.ipListenerInfo.moduleId = PROXY;
+    (void)strcpy_s(info.info.ipListenerInfo.ip, IP_LEN, Ip);
+    EXPECT_EQ(port, TcpStartListening(&info));
+
+    const uint32_t bigLen = 8000;
+    ConnPktHead bigHead = {0};
+    bigHead.len = bigLen;
+    ConnPktHead smallHead = {0};
+    smallHead.len = strlen(g_data);
+    uint32_t bigFrameLen = sizeof(bigHead) + bigHead.len;
+    uint32_t smallFrameLen = sizeof(smallHead) + smallHead.len;
+    char *frames = (char *)SoftBusCalloc(bigFrameLen + smallFrameLen);
+    ASSERT_TRUE(frames != NULL);
+    (void)memcpy_s(frames, bigFrameLen, &bigHead, sizeof(bigHead));
+    (void)memset_s(frames + sizeof(bigHead), bigHead.len, 0x1, bigHead.len);
+    (void)memcpy_s(frames + bigFrameLen, smallFrameLen, &smallHead, sizeof(smallHead));
+    (void)memcpy_s(frames + bigFrameLen + sizeof(smallHead), smallHead.len, g_data, smallHead.len);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, Ip, &addr.sin_addr);
+    ASSERT_EQ(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    sleep(1);
+    EXPECT_EQ(1, TcpGetConnNum());
+
+    EXPECT_EQ((ssize_t)bigFrameLen, send(fd, frames, bigFrameLen, 0));
+    sleep(1);
+    EXPECT_EQ(1, g_receivedFrameCnt);
+    EXPECT_EQ((int)bigFrameLen, g_receivedDatalength);
+    EXPECT_EQ((ssize_t)smallFrameLen, send(fd, frames + bigFrameLen, smallFrameLen, 0));
+    sleep(1);
+    EXPECT_EQ(2, g_receivedFrameCnt);
+    EXPECT_EQ((int)smallFrameLen, g_receivedDatalength);
+    SoftBusFree(frames);
+
+    close(fd);
+    sleep(1);
+    EXPECT_EQ(0, TcpGetConnNum());
+    EXPECT_EQ(SOFTBUS_OK, TcpStopListening(&info));
+}
 } // namespace OHOS
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <securec.h>
+
+#include "disc_found_cache.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+const uint32_t TEST_WINDOW_MS = 1000;
+const uint32_t TEST_BIT_A = 1U << 1;
+const uint32_t TEST_BIT_B = 1U << 3;
+const int32_t TEST_DENSE_DEVICE_NUM = 50;
+const int32_t TEST_DENSE_PERIOD_MS = 50;
+const int32_t TEST_DENSE_DURATION_MS = 10000;
+const int32_t TEST_MANY_DEVICE_NUM = 1000;
+
+static void InitDevice(DeviceInfo *device, int32_t id)
+{
+    (void)memset_s(device, sizeof(DeviceInfo), 0, sizeof(DeviceInfo));
+    (void)sprintf_s(device->devId, sizeof(device->devId), "9C3F0B7A2E51D46C8B%06d", id);
+    (void)strcpy_s(device->devName, sizeof(device->devName), "test device");
+    device->devType = SMART_PHONE;
+    device->addrNum = 1;
+    device->addr[0].type = CONNECTION_ADDR_WLAN;
+    (void)strcpy_s(device->addr[0].info.ip.ip, sizeof(device->addr[0].info.ip.ip), "192.168.1.10");
+    device->addr[0].info.ip.port = 8888;
+}
+
+class DiscFoundCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        DiscFoundCacheInit(TEST_WINDOW_MS);
+    }
+    void TearDown() override
+    {
+        DiscFoundCacheDeinit();
+    }
+};
+
+/*
+ * @tc.name: DiscFoundCacheTest_Dedup_001
+ * @tc.desc: an unchanged report inside the window is dropped, a changed one or one after the window is not.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DiscFoundCacheTest, DiscFoundCacheTest_Dedup_001, TestSize.Level1)
+{
+    DeviceInfo device;
+    InitDevice(&device, 0);
+    uint64_t now = 5000;
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&device, TEST_BIT_A, now));
+    EXPECT_EQ(0u, DiscFoundCacheFilter(&device, TEST_BIT_A, now + 1));
+    /* every capability is a report of its own */
+    EXPECT_EQ(TEST_BIT_B, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + 1));
+    EXPECT_EQ(0u, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + TEST_WINDOW_MS - 1));
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + TEST_WINDOW_MS));
+
+    (void)strcpy_s(device.addr[0].info.ip.ip, sizeof(device.addr[0].info.ip.ip), "192.168.1.11");
+    EXPECT_EQ(TEST_BIT_A | TEST_BIT_B, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + TEST_WINDOW_MS));
+    (void)strcpy_s(device.devName, sizeof(device.devName), "renamed device");
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&device, TEST_BIT_A, now + TEST_WINDOW_MS));
+    /* bytes past the name are not part of what subscribers see */
+    device.devName[sizeof(device.devName) - 1] = 'x';
+    EXPECT_EQ(0u, DiscFoundCacheFilter(&device, TEST_BIT_A, now + TEST_WINDOW_MS));
+
+    DeviceInfo other;
+    InitDevice(&other, 1);
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&other, TEST_BIT_A, now + TEST_WINDOW_MS));
+
+    DiscFoundCacheInit(0);
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&other, TEST_BIT_A, now + TEST_WINDOW_MS));
+    EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&other, TEST_BIT_A, now + TEST_WINDOW_MS));
+}
+
+/*
+ * @tc.name: DiscFoundCacheTest_Renew_001
+ * @tc.desc: a new subscriber of a capability gets the next report at once, other capabilities keep their window.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(DiscFoundCacheTest, DiscFoundCacheTest_Renew_001, TestSize.Level1)
+{
+    DeviceInfo device;
+    InitDevice(&device, 0);
+    uint64_t now = 5000;
+    EXPECT_EQ(TEST_BIT_A | TEST_BIT_B, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now));
+    DiscFoundCacheRenew(3);
+    EXPECT_EQ(TEST_BIT_B, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + 1));
+    EXPECT_EQ(0u, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + 2));
+    DiscFoundCacheRenewAll();
+    EXPECT_EQ(TEST_BIT_A | TEST_BIT_B, DiscFoundCacheFilter(&device, TEST_BIT_A | TEST_BIT_B, now + 3));
+}
+
+/*
+ * @tc.name: DiscFoundCacheTest_Dense_001
+ * @tc.desc: many devices reporting every 50 ms reach subscribers once a window each, and the filter stays cheap.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(DiscFoundCacheTest, DiscFoundCacheTest_Dense_001, TestSize.Level1)
+{
+    DeviceInfo devices[TEST_DENSE_DEVICE_NUM];
+    for (int32_t i = 0; i < TEST_DENSE_DEVICE_NUM; i++) {
+        InitDevice(&devices[i], i);
+    }
+    int32_t reportCnt = 0;
+    int32_t passCnt = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t now = TEST_DENSE_PERIOD_MS; now <= TEST_DENSE_DURATION_MS; now += TEST_DENSE_PERIOD_MS) {
+        for (int32_t i = 0; i < TEST_DENSE_DEVICE_NUM; i++) {
+            reportCnt++;
+            passCnt += (DiscFoundCacheFilter(&devices[i], TEST_BIT_A, now) != 0) ? 1 : 0;
+        }
+    }
+    double filterNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+        reportCnt;
+    printf("disc found cache: %d devices, %d reports, %d passed on, %.1f ns per report\n", TEST_DENSE_DEVICE_NUM,
+        reportCnt, passCnt, filterNs);
+    EXPECT_EQ(TEST_DENSE_DEVICE_NUM * (TEST_DENSE_DURATION_MS / (int32_t)TEST_WINDOW_MS), passCnt);
+
+    /* more devices than the cache holds are reported at worst once a report, never dropped wrongly */
+    DeviceInfo device;
+    for (int32_t i = 0; i < TEST_MANY_DEVICE_NUM; i++) {
+        InitDevice(&device, TEST_DENSE_DEVICE_NUM + i);
+        EXPECT_EQ(TEST_BIT_A, DiscFoundCacheFilter(&device, TEST_BIT_A, TEST_DENSE_DURATION_MS));
+    }
+}
+} // namespace OHOS
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "softbus_errcode.h"
+#include "trans_pending_pkt.h"
+
+using namespace testing::ext;
+
+namespace {
+const int32_t TEST_CHANNEL_ID = 2048;
+const int32_t TEST_MESSAGE_NUM = 200;
+const int32_t TEST_DEFAULT_WINDOW = 64;
+const auto TEST_LINK_DELAY = std::chrono::milliseconds(2);
+
+std::mutex g_doneLock;
+std::vector<int32_t> g_doneSeqs;
+std::vector<int32_t> g_doneResults;
+
+void OnPktDone(int32_t channelId, int32_t seq, int32_t result, void *cbArg)
+{
+    (void)channelId;
+    (void)cbArg;
+    std::lock_guard<std::mutex> guard(g_doneLock);
+    g_doneSeqs.push_back(seq);
+    g_doneResults.push_back(result);
+}
+
+size_t GetDoneCnt()
+{
+    std::lock_guard<std::mutex> guard(g_doneLock);
+    return g_doneSeqs.size();
+}
+
+/* acks every sent seq after a fixed one-way delay, like a peer on the other end of an ordered link */
+class DelayedAcker {
+public:
+    DelayedAcker() : worker_(&DelayedAcker::Run, this) {}
+    ~DelayedAcker()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        worker_.join();
+    }
+
+    void Sent(int32_t seq)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            acks_.push_back({seq, std::chrono::steady_clock::now() + TEST_LINK_DELAY});
+        }
+        cond_.notify_all();
+    }
+
+private:
+    struct Ack {
+        int32_t seq;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+        while (!stop_) {
+            if (acks_.empty()) {
+                cond_.wait(guard);
+                continue;
+            }
+            Ack ack = acks_.front();
+            if (cond_.wait_until(guard, ack.due) != std::cv_status::timeout) {
+                continue;
+            }
+            acks_.pop_front();
+            guard.unlock();
+            (void)SetPendingPacket(TEST_CHANNEL_ID, ack.seq, PENDING_TYPE_DIRECT);
+            guard.lock();
+        }
+    }
+
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::deque<Ack> acks_;
+    bool stop_ = false;
+    std::thread worker_;
+};
+} // namespace
+
+namespace OHOS {
+class TransPendingPktTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        ASSERT_EQ(SOFTBUS_OK, PendingInit(PENDING_TYPE_DIRECT));
+    }
+    static void TearDownTestCase()
+    {
+        PendingDeinit(PENDING_TYPE_DIRECT);
+    }
+    void SetUp() override
+    {
+        g_doneSeqs.clear();
+        g_doneResults.clear();
+    }
+    void TearDown() override
+    {
+        (void)DelPendingPacket(TEST_CHANNEL_ID, PENDING_TYPE_DIRECT);
+    }
+};
+
+/*
+ * @tc.name: ProcPendingPacket001
+ * @tc.desc: a sync waiter returns once its seq is acked, and an ack of another channel does not wake it.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, ProcPendingPacket001, TestSize.Level1)
+{
+    std::thread acker([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID + 1, 1, PENDING_TYPE_DIRECT));
+        EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT));
+    });
+    EXPECT_EQ(SOFTBUS_OK, ProcPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT));
+    acker.join();
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT));
+}
+
+/*
+ * @tc.name: ProcPendingPacket002
+ * @tc.desc: closing the channel releases a sync waiter without an ack.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, ProcPendingPacket002, TestSize.Level1)
+{
+    std::thread closer([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(SOFTBUS_OK, DelPendingPacket(TEST_CHANNEL_ID, PENDING_TYPE_DIRECT));
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(SOFTBUS_TIMOUT, ProcPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    closer.join();
+}
+
+/*
+ * @tc.name: AsyncPendingPacket001
+ * @tc.desc: an ack completes its own packet only, an older packet never acked is not reported as done.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, AsyncPendingPacket001, TestSize.Level1)
+{
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, AddAsyncPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT, nullptr, nullptr));
+    const int32_t sentNum = 8;
+    for (int32_t seq = 1; seq <= sentNum; seq++) {
+        ASSERT_EQ(SOFTBUS_OK, AddAsyncPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT, OnPktDone, nullptr));
+    }
+    EXPECT_NE(SOFTBUS_OK, AddAsyncPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT, OnPktDone, nullptr));
+
+    /* the peer dropped seq 3 and acked the others */
+    const int32_t droppedSeq = 3;
+    std::vector<int32_t> expectSeqs;
+    for (int32_t seq = sentNum; seq >= 1; seq--) {
+        if (seq == droppedSeq) {
+            continue;
+        }
+        EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT));
+        expectSeqs.push_back(seq);
+    }
+    EXPECT_EQ(g_doneSeqs, expectSeqs);
+    for (int32_t result : g_doneResults) {
+        EXPECT_EQ(SOFTBUS_OK, result);
+    }
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, sentNum, PENDING_TYPE_DIRECT));
+
+    RemoveAsyncPendingPacket(TEST_CHANNEL_ID, sentNum + 1, PENDING_TYPE_DIRECT);
+    EXPECT_EQ(SOFTBUS_OK, DelPendingPacket(TEST_CHANNEL_ID, PENDING_TYPE_DIRECT));
+    ASSERT_EQ(g_doneSeqs.size(), expectSeqs.size() + 1);
+    EXPECT_EQ(g_doneSeqs.back(), droppedSeq);
+    EXPECT_EQ(g_doneResults.back(), SOFTBUS_CONNECTION_ERR_CLOSED);
+}
+
+/*
+ * @tc.name: AsyncPendingPacket002
+ * @tc.desc: a full window blocks the next packet until an ack makes room.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, AsyncPendingPacket002, TestSize.Level1)
+{
+    int32_t seq = 1;
+    std::future<int32_t> adder;
+    for (;; seq++) {
+        adder = std::async(std::launch::async, [seq]() {
+            return AddAsyncPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT, OnPktDone, nullptr);
+        });
+        if (adder.wait_for(std::chrono::milliseconds(200)) != std::future_status::ready) {
+            break;
+        }
+        ASSERT_EQ(SOFTBUS_OK, adder.get());
+    }
+    EXPECT_EQ(seq - 1, TEST_DEFAULT_WINDOW);
+    EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, 1, PENDING_TYPE_DIRECT));
+    EXPECT_EQ(SOFTBUS_OK, adder.get());
+    EXPECT_EQ(GetDoneCnt(), 1u);
+}
+
+/*
+ * @tc.name: AsyncPendingPacket003
+ * @tc.desc: over a link with a fixed delay, pipelined messages are not paced by the round trip.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, AsyncPendingPacket003, TestSize.Level1)
+{
+    auto start = std::chrono::steady_clock::now();
+    {
+        DelayedAcker acker;
+        for (int32_t seq = 1; seq <= TEST_MESSAGE_NUM; seq++) {
+            ASSERT_EQ(SOFTBUS_OK, AddAsyncPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT, OnPktDone, nullptr));
+            acker.Sent(seq);
+        }
+        while (GetDoneCnt() < (size_t)TEST_MESSAGE_NUM &&
+            std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(GetDoneCnt(), (size_t)TEST_MESSAGE_NUM);
+    for (int32_t i = 0; i < TEST_MESSAGE_NUM; i++) {
+        EXPECT_EQ(g_doneSeqs[i], i + 1);
+        EXPECT_EQ(g_doneResults[i], SOFTBUS_OK);
+    }
+    /* a sync sender waits a whole delay for every message */
+    auto syncCost = TEST_LINK_DELAY * TEST_MESSAGE_NUM;
+    printf("pending pkt: %d async messages in %lld ms, at least %lld ms one by one\n", TEST_MESSAGE_NUM,
+        (long long)cost.count(), (long long)syncCost.count());
+    EXPECT_LT(cost * 4, syncCost);
+}
+
+/*
+ * @tc.name: AsyncPendingPacket004
+ * @tc.desc: two senders on one channel whose seqs reach the link out of order, each ack completes its own packet.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, AsyncPendingPacket004, TestSize.Level1)
+{
+    /* in every round the first sender takes its seq, the second takes the next one and writes it first */
+    const int32_t roundNum = TEST_DEFAULT_WINDOW / 2;
+    std::mutex lock;
+    std::condition_variable cond;
+    int32_t stage = 0;
+    int32_t nextSeq = 1;
+    std::vector<int32_t> link;
+    auto step = [&](int32_t from, bool isWrite, int32_t &seq) {
+        std::unique_lock<std::mutex> guard(lock);
+        cond.wait(guard, [&]() { return stage == from; });
+        if (isWrite) {
+            link.push_back(seq);
+        } else {
+            seq = nextSeq++;
+        }
+        stage = (stage + 1) % 4;
+        cond.notify_all();
+    };
+    auto sender = [&](int32_t takeStage, int32_t writeStage) {
+        for (int32_t i = 0; i < roundNum; i++) {
+            int32_t seq = 0;
+            step(takeStage, false, seq);
+            EXPECT_EQ(SOFTBUS_OK, AddAsyncPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT, OnPktDone, nullptr));
+            step(writeStage, true, seq);
+        }
+    };
+    std::thread first(sender, 0, 3);
+    std::thread second(sender, 1, 2);
+    first.join();
+    second.join();
+    ASSERT_EQ(link.size(), (size_t)TEST_DEFAULT_WINDOW);
+    EXPECT_EQ(link[0], 2);
+    EXPECT_EQ(link[1], 1);
+
+    /* the peer acks in link order; before each ack only the packets acked so far are done */
+    std::vector<int32_t> acked;
+    for (int32_t seq : link) {
+        EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_ID, seq, PENDING_TYPE_DIRECT));
+        acked.push_back(seq);
+        std::lock_guard<std::mutex> guard(g_doneLock);
+        EXPECT_EQ(g_doneSeqs, acked);
+    }
+    for (int32_t result : g_doneResults) {
+        EXPECT_EQ(SOFTBUS_OK, result);
+    }
+}
+} // namespace OHOS
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "securec.h"
+#include "softbus_adapter_crypto.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_conn_interface.h"
+#include "softbus_errcode.h"
+#include "softbus_proxychannel_session.h"
+
+using namespace testing::ext;
+
+namespace {
+const uint32_t SLICE_LEN = 1024;
+const uint32_t LARGE_SLICE_LEN = 64 * 1024;
+const uint32_t BENCH_DATA_LEN = 4 * 1024;
+const int32_t BENCH_ROUND = 2000;
+const int32_t TEST_SEQ = 0x11223344;
+const uint32_t PACKET_MAGIC = 0xBABEFACE;
+
+/* wire layout of the proxy slice and packet heads, as seen by the receiving side */
+typedef struct {
+    int32_t priority;
+    int32_t sliceNum;
+    int32_t sliceSeq;
+    int32_t reserved;
+} TestSliceHead;
+
+typedef struct {
+    int32_t magicNumber;
+    int32_t seq;
+    int32_t flags;
+    int32_t dataLen;
+} TestPacketHead;
+
+const uint32_t FRAME_HEAD_LEN = sizeof(ProxyMessageHead) + sizeof(TestSliceHead);
+
+std::vector<unsigned char> MakePayload(uint32_t len)
+{
+    std::vector<unsigned char> data(len);
+    for (uint32_t i = 0; i < len; i++) {
+        data[i] = (unsigned char)(i * 7 + 1);
+    }
+    return data;
+}
+
+/* the copy based packing the proxy used before: encrypt into a packed buffer, then copy every slice out */
+int32_t LegacyPackSlices(SoftBusCipherCtx *ctx, const ProxyMessageHead *msgHead, const std::vector<unsigned char> &data,
+    std::vector<ProxySliceFrame> &frames)
+{
+    uint32_t packLen = sizeof(TestPacketHead) + data.size() + OVERHEAD_LEN;
+    char *packed = (char *)SoftBusCalloc(packLen);
+    if (packed == nullptr) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    TestPacketHead pktHead = {(int32_t)PACKET_MAGIC, TEST_SEQ, PROXY_FLAG_BYTES, (int32_t)(data.size() + OVERHEAD_LEN)};
+    (void)memcpy_s(packed, packLen, &pktHead, sizeof(pktHead));
+    uint32_t outLen = packLen - sizeof(pktHead);
+    int32_t ret = SoftBusEncryptDataWithSeqByCtx(ctx, data.data(), data.size(),
+        (unsigned char *)packed + sizeof(pktHead), &outLen, TEST_SEQ);
+    if (ret != SOFTBUS_OK) {
+        SoftBusFree(packed);
+        return ret;
+    }
+    uint32_t connHeadLen = ConnGetHeadSize();
+    int32_t sliceNum = (int32_t)((packLen + SLICE_LEN - 1) / SLICE_LEN);
+    frames.resize(sliceNum);
+    for (int32_t i = 0; i < sliceNum; i++) {
+        uint32_t chunkLen = (i == sliceNum - 1) ? (packLen - i * SLICE_LEN) : SLICE_LEN;
+        TestSliceHead sliceHead = {PROXY_CHANNEL_PRORITY_BYTES, sliceNum, i, 0};
+        frames[i].len = (int32_t)(connHeadLen + FRAME_HEAD_LEN + chunkLen);
+        frames[i].buf = (char *)SoftBusCalloc(frames[i].len);
+        char *head = frames[i].buf + connHeadLen;
+        (void)memcpy_s(head, FRAME_HEAD_LEN, msgHead, sizeof(ProxyMessageHead));
+        (void)memcpy_s(head + sizeof(ProxyMessageHead), sizeof(sliceHead), &sliceHead, sizeof(sliceHead));
+        (void)memcpy_s(head + FRAME_HEAD_LEN, chunkLen, packed + i * SLICE_LEN, chunkLen);
+    }
+    SoftBusFree(packed);
+    return SOFTBUS_OK;
+}
+
+void FreeFrames(std::vector<ProxySliceFrame> &frames)
+{
+    for (auto &frame : frames) {
+        SoftBusFree(frame.buf);
+        frame.buf = nullptr;
+    }
+}
+
+/* join the slices back the way the receiver does and decrypt the packet */
+int32_t UnpackFrames(SoftBusCipherCtx *ctx, const std::vector<ProxySliceFrame> &frames,
+    std::vector<unsigned char> &out)
+{
+    uint32_t connHeadLen = ConnGetHeadSize();
+    std::vector<unsigned char> packed;
+    for (size_t i = 0; i < frames.size(); i++) {
+        const TestSliceHead *sliceHead = (const TestSliceHead *)(frames[i].buf + connHeadLen +
+            sizeof(ProxyMessageHead));
+        if (sliceHead->sliceNum != (int32_t)frames.size() || sliceHead->sliceSeq != (int32_t)i) {
+            return SOFTBUS_ERR;
+        }
+        const unsigned char *chunk = (const unsigned char *)frames[i].buf + connHeadLen + FRAME_HEAD_LEN;
+        packed.insert(packed.end(), chunk, chunk + frames[i].len - connHeadLen - FRAME_HEAD_LEN);
+    }
+    const TestPacketHead *pktHead = (const TestPacketHead *)packed.data();
+    if ((uint32_t)pktHead->magicNumber != PACKET_MAGIC || pktHead->seq != TEST_SEQ ||
+        pktHead->dataLen != (int32_t)(packed.size() - sizeof(TestPacketHead))) {
+        return SOFTBUS_ERR;
+    }
+    out.resize(pktHead->dataLen - OVERHEAD_LEN);
+    uint32_t outLen = out.size();
+    return SoftBusDecryptDataByCtx(ctx, packed.data() + sizeof(TestPacketHead), pktHead->dataLen,
+        out.data(), &outLen);
+}
+
+int32_t ZeroCopyPackSlices(SoftBusCipherCtx *ctx, const ProxyMessageHead *msgHead,
+    const std::vector<unsigned char> &data, std::vector<ProxySliceFrame> &frames, uint32_t sliceLen = SLICE_LEN)
+{
+    int32_t sliceNum = TransProxyGetPacketSliceNum(data.size(), sliceLen);
+    std::vector<SoftBusCryptoIov> iov(sliceNum);
+    frames.assign(sliceNum, ProxySliceFrame {nullptr, 0});
+    ProxyPacketInfo packet = {data.data(), (uint32_t)data.size(), TEST_SEQ, PROXY_FLAG_BYTES, sliceLen};
+    ProxySliceBatch batch = {frames.data(), iov.data(), sliceNum, nullptr, nullptr};
+    return TransProxyPackPacketSlices(msgHead, ctx, &packet, &batch);
+}
+
+/* takes every slice over as soon as it is ready, the way the send path posts it to the connection */
+struct SliceCollector {
+    ProxySliceFrame *frames;
+    std::vector<ProxySliceFrame> posted;
+    std::vector<uint32_t> order;
+};
+
+int32_t CollectReadySlice(uint32_t index, void *arg)
+{
+    SliceCollector *collector = static_cast<SliceCollector *>(arg);
+    collector->order.push_back(index);
+    collector->posted.push_back(collector->frames[index]);
+    collector->frames[index].buf = nullptr;
+    return SOFTBUS_OK;
+}
+} // namespace
+
+namespace OHOS {
+class TransProxyPackBenchmarkTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+    void SetUp() override
+    {
+        unsigned char key[SESSION_KEY_LENGTH] = {5};
+        ctx_ = SoftBusCreateCipherCtx(key, SESSION_KEY_LENGTH);
+        ASSERT_TRUE(ctx_ != nullptr);
+        msgHead_.myId = 1;
+        msgHead_.peerId = 2;
+    }
+    void TearDown() override
+    {
+        SoftBusUnrefCipherCtx(ctx_);
+    }
+
+protected:
+    SoftBusCipherCtx *ctx_ = nullptr;
+    ProxyMessageHead msgHead_ = {};
+};
+
+/*
+ * @tc.name: TransProxyPackPacketSlices001
+ * @tc.desc: slices packed in place carry the same packet as the copy based packing
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxyPackBenchmarkTest, TransProxyPackPacketSlices001, TestSize.Level1)
+{
+    const uint32_t lens[] = {1, 15, 16, SLICE_LEN - sizeof(TestPacketHead) - OVERHEAD_LEN,
+        SLICE_LEN - sizeof(TestPacketHead) - OVERHEAD_LEN + 1, 3 * SLICE_LEN + 5, BENCH_DATA_LEN};
+    for (uint32_t len : lens) {
+        std::vector<unsigned char> data = MakePayload(len);
+        std::vector<ProxySliceFrame> frames;
+        ASSERT_EQ(SOFTBUS_OK, ZeroCopyPackSlices(ctx_, &msgHead_, data, frames));
+        std::vector<ProxySliceFrame> legacy;
+        ASSERT_EQ(SOFTBUS_OK, LegacyPackSlices(ctx_, &msgHead_, data, legacy));
+        ASSERT_EQ(legacy.size(), frames.size());
+        for (size_t i = 0; i < frames.size(); i++) {
+            EXPECT_EQ(legacy[i].len, frames[i].len);
+        }
+        std::vector<unsigned char> out;
+        EXPECT_EQ(SOFTBUS_OK, UnpackFrames(ctx_, frames, out));
+        EXPECT_EQ(data, out);
+        FreeFrames(frames);
+        FreeFrames(legacy);
+    }
+}
+
+/*
+ * @tc.name: TransProxyPackPacketSlices002
+ * @tc.desc: invalid parameters are rejected and nothing is left allocated
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxyPackBenchmarkTest, TransProxyPackPacketSlices002, TestSize.Level1)
+{
+    std::vector<unsigned char> data = MakePayload(SLICE_LEN);
+    int32_t sliceNum = TransProxyGetPacketSliceNum(data.size(), SLICE_LEN);
+    std::vector<ProxySliceFrame> frames(sliceNum, ProxySliceFrame {nullptr, 0});
+    std::vector<SoftBusCryptoIov> iov(sliceNum);
+    ProxyPacketInfo packet = {data.data(), (uint32_t)data.size(), TEST_SEQ, PROXY_FLAG_BYTES, SLICE_LEN};
+    ProxySliceBatch batch = {frames.data(), iov.data(), sliceNum, nullptr, nullptr};
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TransProxyPackPacketSlices(nullptr, ctx_, &packet, &batch));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TransProxyPackPacketSlices(&msgHead_, nullptr, &packet, &batch));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TransProxyPackPacketSlices(&msgHead_, ctx_, &packet, nullptr));
+    batch.sliceNum = sliceNum - 1;
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TransProxyPackPacketSlices(&msgHead_, ctx_, &packet, &batch));
+    batch.sliceNum = sliceNum;
+    packet.sliceLen = SLICE_LEN - 1;
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TransProxyPackPacketSlices(&msgHead_, ctx_, &packet, &batch));
+    for (const auto &frame : frames) {
+        EXPECT_TRUE(frame.buf == nullptr);
+    }
+}
+
+/*
+ * @tc.name: TransProxyPackPacketSlices003
+ * @tc.desc: a large slice len packs the packet into fewer frames, ready slices are handed over in order
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxyPackBenchmarkTest, TransProxyPackPacketSlices003, TestSize.Level1)
+{
+    std::vector<unsigned char> data = MakePayload(BENCH_DATA_LEN);
+    EXPECT_EQ(1, TransProxyGetPacketSliceNum(data.size(), LARGE_SLICE_LEN));
+    EXPECT_EQ(5, TransProxyGetPacketSliceNum(data.size(), SLICE_LEN));
+
+    std::vector<ProxySliceFrame> frames;
+    ASSERT_EQ(SOFTBUS_OK, ZeroCopyPackSlices(ctx_, &msgHead_, data, frames, LARGE_SLICE_LEN));
+    ASSERT_EQ(1U, frames.size());
+    std::vector<unsigned char> out;
+    EXPECT_EQ(SOFTBUS_OK, UnpackFrames(ctx_, frames, out));
+    EXPECT_EQ(data, out);
+    FreeFrames(frames);
+
+    const uint32_t midSliceLen = 2 * SLICE_LEN;
+    int32_t sliceNum = TransProxyGetPacketSliceNum(data.size(), midSliceLen);
+    frames.assign(sliceNum, ProxySliceFrame {nullptr, 0});
+    std::vector<SoftBusCryptoIov> iov(sliceNum);
+    SliceCollector collector = {frames.data(), {}, {}};
+    ProxyPacketInfo packet = {data.data(), (uint32_t)data.size(), TEST_SEQ, PROXY_FLAG_BYTES, midSliceLen};
+    ProxySliceBatch batch = {frames.data(), iov.data(), sliceNum, CollectReadySlice, &collector};
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPackPacketSlices(&msgHead_, ctx_, &packet, &batch));
+    ASSERT_EQ((size_t)sliceNum, collector.order.size());
+    for (int32_t i = 0; i < sliceNum; i++) {
+        EXPECT_EQ((uint32_t)i, collector.order[i]);
+        EXPECT_TRUE(frames[i].buf == nullptr);
+    }
+    EXPECT_EQ(SOFTBUS_OK, UnpackFrames(ctx_, collector.posted, out));
+    EXPECT_EQ(data, out);
+    FreeFrames(collector.posted);
+}
+
+/*
+ * @tc.name: TransProxySliceLen001
+ * @tc.desc: peer slice len out of range falls back to the default, slow links keep the default
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxyPackBenchmarkTest, TransProxySliceLen001, TestSize.Level1)
+{
+    EXPECT_EQ(0U, TransProxyCheckPeerSliceLen(0));
+    EXPECT_EQ(0U, TransProxyCheckPeerSliceLen(SLICE_LEN - 1));
+    EXPECT_EQ(SLICE_LEN, TransProxyCheckPeerSliceLen(SLICE_LEN));
+    EXPECT_EQ(LARGE_SLICE_LEN, TransProxyCheckPeerSliceLen(LARGE_SLICE_LEN));
+    EXPECT_EQ(0U, TransProxyCheckPeerSliceLen(LARGE_SLICE_LEN + 1));
+    EXPECT_EQ(SLICE_LEN, TransProxyGetLinkSliceLen(CONNECT_BLE));
+    EXPECT_EQ(SLICE_LEN, TransProxyGetLinkSliceLen(CONNECT_BR));
+    EXPECT_EQ(SLICE_LEN, TransProxyGetLinkSliceLen(CONNECT_TYPE_MAX));
+    EXPECT_LE(TransProxyGetLinkSliceLen(CONNECT_TCP), LARGE_SLICE_LEN);
+}
+
+/*
+ * @tc.name: TransProxyPackBenchmark001
+ * @tc.desc: proxy send packing throughput, copy based packing against in place encryption
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(TransProxyPackBenchmarkTest, TransProxyPackBenchmark001, TestSize.Level2)
+{
+    std::vector<unsigned char> data = MakePayload(BENCH_DATA_LEN);
+    std::vector<ProxySliceFrame> frames;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_ROUND; i++) {
+        ASSERT_EQ(SOFTBUS_OK, LegacyPackSlices(ctx_, &msgHead_, data, frames));
+        FreeFrames(frames);
+    }
+    auto legacyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_ROUND; i++) {
+        ASSERT_EQ(SOFTBUS_OK, ZeroCopyPackSlices(ctx_, &msgHead_, data, frames));
+        FreeFrames(frames);
+    }
+    auto zeroCopyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < BENCH_ROUND; i++) {
+        ASSERT_EQ(SOFTBUS_OK, ZeroCopyPackSlices(ctx_, &msgHead_, data, frames, LARGE_SLICE_LEN));
+        FreeFrames(frames);
+    }
+    auto largeSliceUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    double totalMb = (double)BENCH_DATA_LEN * BENCH_ROUND / (1024 * 1024);
+    printf("proxy pack %u bytes x %d: copy %lld us (%.1f MB/s), in place %lld us (%.1f MB/s), "
+        "64K slice %lld us (%.1f MB/s)\n", BENCH_DATA_LEN, BENCH_ROUND,
+        (long long)legacyUs, totalMb * 1000000 / (legacyUs + 1),
+        (long long)zeroCopyUs, totalMb * 1000000 / (zeroCopyUs + 1),
+        (long long)largeSliceUs, totalMb * 1000000 / (largeSliceUs + 1));
+}
+} // namespace OHOS
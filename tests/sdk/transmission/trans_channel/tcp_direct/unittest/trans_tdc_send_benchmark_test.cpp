@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "client_trans_tcp_direct_callback.h"
+#include "client_trans_tcp_direct_manager.h"
+#include "client_trans_tcp_direct_message.h"
+#include "securec.h"
+#include "softbus_adapter_crypto.h"
+#include "softbus_errcode.h"
+
+using namespace testing::ext;
+
+namespace {
+const int32_t TEST_CHANNEL_ID = 1;
+const uint64_t TEST_BYTES_PER_SIZE = 32 * 1024 * 1024;
+const uint32_t TEST_MAX_MESSAGE_NUM = 20000;
+const double MIN_MESSAGE_RATE = 1000.0;
+
+int32_t g_localFd = -1;
+SoftBusCipherCtx *g_cipherCtx = nullptr;
+
+bool OpenLoopbackPair(int32_t *localFd, int32_t *peerFd)
+{
+    int32_t listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    (void)memset_s(&addr, sizeof(addr), 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr *)&addr, addrLen) != 0 || listen(listenFd, 1) != 0 ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &addrLen) != 0) {
+        close(listenFd);
+        return false;
+    }
+    *localFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(*localFd, (struct sockaddr *)&addr, addrLen) != 0) {
+        close(listenFd);
+        close(*localFd);
+        return false;
+    }
+    *peerFd = accept(listenFd, nullptr, nullptr);
+    close(listenFd);
+    return *peerFd >= 0;
+}
+} // namespace
+
+extern "C" {
+TcpDirectChannelInfo *TransTdcGetInfoById(int32_t channelId, TcpDirectChannelInfo *info)
+{
+    (void)memset_s(info, sizeof(TcpDirectChannelInfo), 0, sizeof(TcpDirectChannelInfo));
+    info->channelId = channelId;
+    info->detail.fd = g_localFd;
+    return info;
+}
+
+TcpDirectChannelInfo *TransTdcGetInfoByIdWithIncSeq(int32_t channelId, TcpDirectChannelInfo *info)
+{
+    static int32_t sequence = 0;
+    TransTdcGetInfoById(channelId, info);
+    info->detail.sequence = ++sequence;
+    return info;
+}
+
+SoftBusCipherCtx *TransTdcGetCipherCtxById(int32_t channelId)
+{
+    (void)channelId;
+    return SoftBusRefCipherCtx(g_cipherCtx);
+}
+
+int32_t ClientTransTdcOnDataReceived(int32_t channelId, const void *data, uint32_t len, SessionPktType type)
+{
+    (void)channelId;
+    (void)data;
+    (void)len;
+    (void)type;
+    return SOFTBUS_OK;
+}
+}
+
+namespace OHOS {
+class TransTdcSendBenchmarkTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        unsigned char key[SESSION_KEY_LENGTH] = {0};
+        g_cipherCtx = SoftBusCreateCipherCtx(key, sizeof(key));
+        ASSERT_NE(g_cipherCtx, nullptr);
+        ASSERT_EQ(SOFTBUS_OK, TransDataListInit());
+    }
+    static void TearDownTestCase()
+    {
+        TransDataListDeinit();
+        SoftBusUnrefCipherCtx(g_cipherCtx);
+        g_cipherCtx = nullptr;
+    }
+};
+
+/*
+ * @tc.name: TransTdcSendBytesBenchmark001
+ * @tc.desc: messages per second of TransTdcSendBytes over tcp loopback for 64B to 64KB payloads.
+ * @tc.type: PERF
+ * @tc.require:
+ */
+HWTEST_F(TransTdcSendBenchmarkTest, TransTdcSendBytesBenchmark001, TestSize.Level1)
+{
+    int32_t peerFd = -1;
+    ASSERT_TRUE(OpenLoopbackPair(&g_localFd, &peerFd));
+    ASSERT_EQ(SOFTBUS_OK, TransAddDataBufNode(TEST_CHANNEL_ID, g_localFd));
+
+    const uint32_t payloadSizes[] = { 64, 256, 1024, 4096, 16384, 65536 };
+    std::vector<char> payload(payloadSizes[sizeof(payloadSizes) / sizeof(payloadSizes[0]) - 1], 'a');
+    for (uint32_t len : payloadSizes) {
+        uint32_t msgNum = (uint32_t)std::min<uint64_t>(TEST_BYTES_PER_SIZE / len, TEST_MAX_MESSAGE_NUM);
+        uint64_t expectBytes = (uint64_t)msgNum * (len + DC_DATA_HEAD_SIZE + OVERHEAD_LEN);
+        uint64_t drained = 0;
+        uint32_t magic = 0;
+        std::thread drainer([peerFd, expectBytes, &drained, &magic]() {
+            std::vector<char> buf(256 * 1024);
+            while (drained < expectBytes) {
+                ssize_t n = recv(peerFd, buf.data(), buf.size(), 0);
+                if (n <= 0) {
+                    break;
+                }
+                if (drained == 0 && n >= (ssize_t)sizeof(magic)) {
+                    (void)memcpy_s(&magic, sizeof(magic), buf.data(), sizeof(magic));
+                }
+                drained += (uint64_t)n;
+            }
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < msgNum; i++) {
+            ASSERT_EQ(SOFTBUS_OK, TransTdcSendBytes(TEST_CHANNEL_ID, payload.data(), len));
+        }
+        drainer.join();
+        double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(drained, expectBytes);
+        EXPECT_EQ(magic, (uint32_t)MAGIC_NUMBER);
+
+        double rate = msgNum / cost;
+        printf("tdc send %6u B: %6u msgs, %10.0f msgs/s, %8.2f MB/s\n", len, msgNum, rate,
+            rate * len / (1024 * 1024));
+        EXPECT_GT(rate, MIN_MESSAGE_RATE);
+    }
+
+    EXPECT_EQ(SOFTBUS_OK, TransDelDataBufNode(TEST_CHANNEL_ID));
+    close(peerFd);
+    close(g_localFd);
+    g_localFd = -1;
+}
+} // namespace OHOS
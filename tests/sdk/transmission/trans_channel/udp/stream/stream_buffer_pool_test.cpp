@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "i_stream.h"
+#include "stream_buffer_pool.h"
+#include "stream_common.h"
+#include "stream_manager.h"
+#include "vtp_stream_socket.h"
+
+using namespace testing::ext;
+using Communication::SoftBus::IpAndPort;
+using Communication::SoftBus::IStream;
+using Communication::SoftBus::StreamBuffer;
+using Communication::SoftBus::StreamBufferPool;
+using Communication::SoftBus::StreamManager;
+using Communication::SoftBus::VtpStreamSocket;
+/* session.h has C structs of the same names */
+using InnerStreamData = Communication::SoftBus::StreamData;
+using InnerFrameInfo = Communication::SoftBus::StreamFrameInfo;
+
+namespace {
+const char *TEST_PKG_NAME = "com.test.stream.buffer";
+const std::string TEST_SESSION_KEY = "0123456789abcdef0123456789abcdef";
+const int TEST_FRAME_SIZES[] = { 100, 1400, 5000, 60000 };
+const int TEST_WARM_UP_FRAME_NUM = 16;
+const int TEST_FRAME_NUM = 1000;
+const int TEST_FRAME_HEADER_LEN = 4; /* big endian frame length in front of every frame */
+
+std::atomic<bool> g_countAlloc(false);
+std::atomic<int> g_allocCnt(0);
+
+void *CountedAlloc(size_t size)
+{
+    if (g_countAlloc.load(std::memory_order_relaxed)) {
+        g_allocCnt.fetch_add(1, std::memory_order_relaxed);
+    }
+    return malloc(size == 0 ? 1 : size);
+}
+
+std::unique_ptr<IStream> MakeFrame(int len, char fill, const char *ext)
+{
+    InnerStreamData data;
+    data.buffer = std::make_unique<char[]>(len);
+    data.bufLen = len;
+    for (int i = 0; i < len; i++) {
+        data.buffer[i] = static_cast<char>(fill + i);
+    }
+    if (ext != nullptr) {
+        data.extLen = static_cast<ssize_t>(strlen(ext));
+        data.extBuffer = std::make_unique<char[]>(data.extLen);
+        (void)memcpy(data.extBuffer.get(), ext, data.extLen);
+    }
+    InnerFrameInfo info;
+    info.seqNum = static_cast<uint32_t>(len);
+    info.frameType = Communication::SoftBus::VIDEO_I;
+    return IStream::MakeCommonStream(data, info);
+}
+
+/* what the receive task does with a frame read from the socket, minus its length */
+bool ReceiveFrame(VtpStreamSocket &socket, StreamBuffer frame, ssize_t frameLen, InnerStreamData &data,
+    InnerFrameInfo &info)
+{
+    return socket.DepacketizeFrame(StreamBufferPool::SubBuffer(std::move(frame), TEST_FRAME_HEADER_LEN),
+        static_cast<int>(frameLen - TEST_FRAME_HEADER_LEN), data, info);
+}
+} // namespace
+
+void *operator new(size_t size)
+{
+    void *ptr = CountedAlloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept
+{
+    static_cast<void>(size);
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t size) noexcept
+{
+    static_cast<void>(size);
+    free(ptr);
+}
+
+namespace OHOS {
+class StreamBufferPoolTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        ASSERT_TRUE(VtpStreamSocket::InitVtpInstance(TEST_PKG_NAME));
+    }
+    static void TearDownTestCase(void)
+    {
+        VtpStreamSocket::DestroyVtpInstance(TEST_PKG_NAME);
+    }
+    void SetUp() override
+    {
+        socket_ = std::make_shared<VtpStreamSocket>(StreamManager::GetStreamReactor(),
+            StreamManager::GetCallbackReactor());
+        IpAndPort local;
+        local.ip = "127.0.0.1";
+        local.port = 0;
+        ASSERT_TRUE(socket_->CreateClient(local, Communication::SoftBus::COMMON_VIDEO_STREAM, TEST_SESSION_KEY));
+    }
+    void TearDown() override
+    {
+        socket_->DestroyStreamSocket();
+        socket_ = nullptr;
+    }
+
+protected:
+    std::shared_ptr<VtpStreamSocket> socket_ = nullptr;
+};
+
+/**
+ * @tc.name: StreamBufferPoolTest_Pool_001
+ * @tc.desc: blocks are reused within their size class, a sub buffer gives back the whole block.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamBufferPoolTest, StreamBufferPoolTest_Pool_001, TestSize.Level1)
+{
+    auto pool = std::make_shared<StreamBufferPool>();
+    EXPECT_EQ(nullptr, pool->Acquire(0));
+
+    char *first = nullptr;
+    {
+        auto buffer = pool->Acquire(StreamBufferPool::MIN_BLOCK_SIZE);
+        ASSERT_NE(nullptr, buffer);
+        first = buffer.get();
+    }
+    EXPECT_EQ(1, pool->GetFreeBlockNum());
+    {
+        auto buffer = pool->Acquire(1);
+        EXPECT_EQ(first, buffer.get());
+        EXPECT_EQ(0, pool->GetFreeBlockNum());
+        auto bigger = pool->Acquire(StreamBufferPool::MIN_BLOCK_SIZE + 1);
+        EXPECT_NE(first, bigger.get());
+
+        auto payload = StreamBufferPool::SubBuffer(std::move(buffer), 100);
+        EXPECT_EQ(first + 100, payload.get());
+    }
+    EXPECT_EQ(2, pool->GetFreeBlockNum());
+
+    {
+        StreamBuffer buffers[StreamBufferPool::MAX_FREE_BLOCK_NUM + 2];
+        for (auto &buffer : buffers) {
+            buffer = pool->Acquire(1);
+        }
+        /* blocks bigger than the largest class are never cached */
+        auto huge = pool->Acquire((StreamBufferPool::MIN_BLOCK_SIZE << StreamBufferPool::SIZE_CLASS_NUM) + 1);
+        ASSERT_NE(nullptr, huge);
+    }
+    EXPECT_EQ(StreamBufferPool::MAX_FREE_BLOCK_NUM + 1, pool->GetFreeBlockNum());
+
+    /* a buffer handed to the application may outlive the socket and its pool */
+    auto kept = pool->Acquire(1);
+    pool = nullptr;
+    kept[0] = 'a';
+    kept = nullptr;
+
+    StreamBuffer plain = std::make_unique<char[]>(10);
+    auto plainPayload = StreamBufferPool::SubBuffer(std::move(plain), 4);
+    EXPECT_NE(nullptr, plainPayload);
+}
+
+/**
+ * @tc.name: StreamBufferPoolTest_Frame_001
+ * @tc.desc: a common stream frame round trips through the socket, a tampered frame is rejected.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamBufferPoolTest, StreamBufferPoolTest_Frame_001, TestSize.Level1)
+{
+    for (int size : TEST_FRAME_SIZES) {
+        for (const char *ext : { static_cast<const char *>(nullptr), "ext info" }) {
+            ssize_t frameLen = 0;
+            StreamBuffer frame = socket_->PacketizeFrame(MakeFrame(size, 'a', ext), frameLen);
+            ASSERT_NE(nullptr, frame);
+            EXPECT_EQ(static_cast<int>(frameLen - TEST_FRAME_HEADER_LEN),
+                static_cast<int>(ntohl(*reinterpret_cast<uint32_t *>(frame.get()))));
+
+            InnerStreamData data;
+            InnerFrameInfo info;
+            ASSERT_TRUE(ReceiveFrame(*socket_, std::move(frame), frameLen, data, info));
+            EXPECT_EQ(Communication::SoftBus::VIDEO_I, info.frameType);
+            EXPECT_NE(0u, info.timestamp);
+            ASSERT_EQ(size, data.bufLen);
+            for (int i = 0; i < size; i++) {
+                ASSERT_EQ(static_cast<char>('a' + i), data.buffer[i]);
+            }
+            if (ext == nullptr) {
+                EXPECT_EQ(0, data.extLen);
+            } else {
+                ASSERT_EQ(static_cast<ssize_t>(strlen(ext)), data.extLen);
+                EXPECT_EQ(0, memcmp(ext, data.extBuffer.get(), data.extLen));
+            }
+        }
+    }
+
+    ssize_t frameLen = 0;
+    StreamBuffer frame = socket_->PacketizeFrame(MakeFrame(TEST_FRAME_SIZES[0], 'a', nullptr), frameLen);
+    ASSERT_NE(nullptr, frame);
+    frame[frameLen / 2] ^= 1;
+    InnerStreamData data;
+    InnerFrameInfo info;
+    EXPECT_FALSE(ReceiveFrame(*socket_, std::move(frame), frameLen, data, info));
+}
+
+/**
+ * @tc.name: StreamBufferPoolTest_Alloc_001
+ * @tc.desc: once the pool is warm, packetizing, encrypting, decrypting and depacketizing a frame allocate nothing.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamBufferPoolTest, StreamBufferPoolTest_Alloc_001, TestSize.Level1)
+{
+    for (int size : TEST_FRAME_SIZES) {
+        g_allocCnt = 0;
+        for (int i = 0; i < TEST_WARM_UP_FRAME_NUM + TEST_FRAME_NUM; i++) {
+            std::unique_ptr<IStream> stream = MakeFrame(size, static_cast<char>(i), nullptr);
+            InnerStreamData data;
+            InnerFrameInfo info;
+            if (i >= TEST_WARM_UP_FRAME_NUM) {
+                g_countAlloc = true;
+            }
+            ssize_t frameLen = 0;
+            StreamBuffer frame = socket_->PacketizeFrame(std::move(stream), frameLen);
+            bool ret = ReceiveFrame(*socket_, std::move(frame), frameLen, data, info);
+            g_countAlloc = false;
+            ASSERT_TRUE(ret);
+            ASSERT_EQ(size, data.bufLen);
+            ASSERT_EQ(static_cast<char>(i), data.buffer[0]);
+        }
+        printf("stream frame of %d bytes: %.3f allocations per frame\n", size,
+            static_cast<double>(g_allocCnt.load()) / TEST_FRAME_NUM);
+        EXPECT_EQ(0, g_allocCnt.load());
+    }
+}
+} // namespace OHOS
@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "i_stream.h"
+#include "i_stream_manager.h"
+#include "securec.h"
+#include "stream_common.h"
+#include "stream_manager.h"
+#include "stream_reactor.h"
+#include "vtp_stream_socket.h"
+
+using namespace testing::ext;
+using Communication::SoftBus::IpAndPort;
+using Communication::SoftBus::IStream;
+using Communication::SoftBus::IStreamManager;
+using Communication::SoftBus::IStreamManagerListener;
+using Communication::SoftBus::StreamManager;
+using Communication::SoftBus::StreamReactor;
+using Communication::SoftBus::VtpStreamSocket;
+/* session.h has C structs of the same names */
+using InnerStreamData = Communication::SoftBus::StreamData;
+using InnerFrameInfo = Communication::SoftBus::StreamFrameInfo;
+
+namespace {
+const char *TEST_PKG_NAME = "com.test.stream.reactor";
+const std::string TEST_SESSION_KEY = "0123456789abcdef0123456789abcdef";
+const char *TEST_IP = "127.0.0.1";
+/* every channel is one end of a connection, FillP allows 100 sockets and a server end holds two */
+const int TEST_CHANNEL_NUM = 64;
+const int TEST_FRAME_NUM = 4;
+const int TEST_FRAME_SIZE = 1000;
+const int TEST_WAIT_TIMEOUT = 10000; /* ms */
+const int TEST_WAIT_STEP = 10; /* ms */
+const int TEST_PERIOD = 10; /* ms */
+const int TEST_BURST_NUM = 64; /* beyond the receive queue of the socket */
+const int TEST_HEADER_SIZE = 4; /* the compatible scene frame header, the body length in network order */
+const int TEST_RAW_FRAME_NUM = static_cast<int>(VtpStreamSocket::COMPATIBLE_QUEUE_SIZE) * 3;
+
+/* a slow listener holds its frame until released */
+std::atomic<int> g_blockedNum(0);
+std::atomic<bool> g_isReleased(false);
+
+int GetThreadNum()
+{
+    DIR *dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        return -1;
+    }
+    int num = 0;
+    for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            num++;
+        }
+    }
+    (void)closedir(dir);
+    return num;
+}
+
+bool WaitFor(const std::function<bool()> &done)
+{
+    for (int waited = 0; waited < TEST_WAIT_TIMEOUT; waited += TEST_WAIT_STEP) {
+        if (done()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(TEST_WAIT_STEP));
+    }
+    return done();
+}
+
+std::unique_ptr<IStream> MakeFrame(int seq)
+{
+    InnerStreamData data;
+    data.buffer = std::make_unique<char[]>(TEST_FRAME_SIZE);
+    data.bufLen = TEST_FRAME_SIZE;
+    for (int i = 0; i < TEST_FRAME_SIZE; i++) {
+        data.buffer[i] = static_cast<char>(seq + i);
+    }
+    InnerFrameInfo info;
+    info.seqNum = seq;
+    info.frameType = Communication::SoftBus::VIDEO_I;
+    return IStream::MakeCommonStream(data, info);
+}
+
+class TestListener : public IStreamManagerListener {
+public:
+    void OnStreamReceived(std::unique_ptr<IStream> stream) override
+    {
+        if (stream != nullptr && stream->GetBufferLen() == TEST_FRAME_SIZE) {
+            frameNum_++;
+        }
+        if (isSlow_) {
+            g_blockedNum++;
+            while (!g_isReleased) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(TEST_WAIT_STEP));
+            }
+            g_blockedNum--;
+        }
+    }
+    void OnStreamStatus(int status) override
+    {
+        if (status == Communication::SoftBus::STREAM_CONNECTED) {
+            isConnected_ = true;
+        }
+    }
+    void OnQosEvent(int32_t eventId, int32_t tvCount, const QosTv *tvList) override
+    {
+        static_cast<void>(eventId);
+        static_cast<void>(tvCount);
+        static_cast<void>(tvList);
+    }
+
+    std::atomic<int> frameNum_ {0};
+    std::atomic<bool> isConnected_ {false};
+    bool isSlow_ = false;
+};
+
+/* a compatible scene listener, the first frame blocks until released */
+class TestSocketListener : public Communication::SoftBus::IStreamSocketListener {
+public:
+    void OnStreamReceived(std::unique_ptr<IStream> stream) override
+    {
+        if (stream != nullptr && stream->GetBufferLen() > 0) {
+            auto buffer = stream->GetBuffer();
+            std::lock_guard<std::mutex> guard(lock_);
+            seqs_.push_back(static_cast<unsigned char>(buffer[0]));
+        }
+        while (!isReleased_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(TEST_WAIT_STEP));
+        }
+    }
+    void OnStreamStatus(int status) override
+    {
+        static_cast<void>(status);
+    }
+    int OnStreamHdrReceived(std::unique_ptr<char[]> header, int size) override
+    {
+        if (size != TEST_HEADER_SIZE) {
+            return -1;
+        }
+        uint32_t len = 0;
+        (void)memcpy_s(&len, sizeof(len), header.get(), TEST_HEADER_SIZE);
+        headerNum_++;
+        return static_cast<int>(ntohl(len));
+    }
+    void OnQosEvent(int32_t eventId, int32_t tvCount, const QosTv *tvList) const override
+    {
+        static_cast<void>(eventId);
+        static_cast<void>(tvCount);
+        static_cast<void>(tvList);
+    }
+
+    std::vector<int> GetSeqs()
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        return seqs_;
+    }
+
+    std::atomic<int> headerNum_ {0};
+    std::atomic<bool> isReleased_ {false};
+
+private:
+    std::mutex lock_;
+    std::vector<int> seqs_;
+};
+
+/* a compatible scene raw frame is sent as is, the header in front of a body whose first byte is the seq */
+std::unique_ptr<IStream> MakeRawFrame(int seq)
+{
+    const int bodyLen = TEST_FRAME_SIZE + seq;
+    std::vector<char> frame(TEST_HEADER_SIZE + bodyLen, static_cast<char>(seq));
+    uint32_t len = htonl(static_cast<uint32_t>(bodyLen));
+    (void)memcpy_s(frame.data(), frame.size(), &len, TEST_HEADER_SIZE);
+    InnerFrameInfo info;
+    return IStream::MakeRawStream(frame.data(), frame.size(), info, Communication::SoftBus::COMPATIBLE_SCENE);
+}
+
+struct TestChannel {
+    std::shared_ptr<TestListener> listener;
+    std::shared_ptr<IStreamManager> manager;
+};
+
+TestChannel MakeChannel(bool isSlow = false)
+{
+    TestChannel channel;
+    channel.listener = std::make_shared<TestListener>();
+    channel.listener->isSlow_ = isSlow;
+    channel.manager = IStreamManager::GetInstance(nullptr, channel.listener);
+    return channel;
+}
+
+/* a loopback server and client channel, false if they could not be set up */
+bool ConnectChannels(TestChannel &server, TestChannel &client)
+{
+    IpAndPort local;
+    local.ip = TEST_IP;
+    local.port = 0;
+    int port = server.manager->CreateStreamServerChannel(local, Communication::SoftBus::VTP,
+        Communication::SoftBus::COMMON_VIDEO_STREAM, TEST_SESSION_KEY);
+    if (port <= 0) {
+        return false;
+    }
+    IpAndPort clientLocal;
+    clientLocal.ip = TEST_IP;
+    clientLocal.port = 0;
+    IpAndPort remote;
+    remote.ip = TEST_IP;
+    remote.port = port;
+    return client.manager->CreateStreamClientChannel(clientLocal, remote, Communication::SoftBus::VTP,
+        Communication::SoftBus::COMMON_VIDEO_STREAM, TEST_SESSION_KEY) > 0;
+}
+} // namespace
+
+namespace OHOS {
+class StreamReactorTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        ASSERT_TRUE(MakeChannel().manager->PrepareEnvironment(TEST_PKG_NAME));
+    }
+    static void TearDownTestCase(void)
+    {
+        MakeChannel().manager->DestroyEnvironment(TEST_PKG_NAME);
+    }
+};
+
+/**
+ * @tc.name: StreamReactorTest_Timer_001
+ * @tc.desc: posted tasks and due timers run, cancelled timers stop, a serial task runs again when scheduled meanwhile.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReactorTest, StreamReactorTest_Timer_001, TestSize.Level1)
+{
+    auto reactor = std::make_shared<StreamReactor>(2);
+    EXPECT_EQ(2, reactor->GetThreadNum());
+
+    std::atomic<int> postNum(0);
+    reactor->Post([&postNum]() { postNum++; });
+    EXPECT_TRUE(WaitFor([&postNum]() { return postNum == 1; }));
+
+    std::atomic<int> onceNum(0);
+    std::atomic<int> cancelledNum(0);
+    std::atomic<int> periodNum(0);
+    reactor->AddTimer(TEST_PERIOD, [&onceNum]() { onceNum++; });
+    uint32_t cancelled = reactor->AddTimer(TEST_PERIOD * 5, [&cancelledNum]() { cancelledNum++; });
+    uint32_t period = reactor->AddTimer(0, [&periodNum]() { periodNum++; }, TEST_PERIOD);
+    reactor->CancelTimer(cancelled);
+    EXPECT_TRUE(WaitFor([&periodNum]() { return periodNum >= 5; }));
+    reactor->CancelTimer(period);
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_PERIOD * 10));
+    int stopped = periodNum;
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_PERIOD * 5));
+    EXPECT_EQ(stopped, periodNum.load());
+    EXPECT_EQ(1, onceNum.load());
+    EXPECT_EQ(0, cancelledNum.load());
+
+    std::atomic<int> running(0);
+    std::atomic<int> runNum(0);
+    std::atomic<bool> isOverlapped(false);
+    auto serial = std::make_shared<Communication::SoftBus::SerialTask>(reactor, [&]() {
+        if (running.fetch_add(1) != 0) {
+            isOverlapped = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        runNum++;
+        running--;
+    });
+    for (int i = 0; i < 100; i++) {
+        serial->Schedule();
+    }
+    EXPECT_TRUE(WaitFor([&runNum]() { return runNum >= 1; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_PERIOD * 10));
+    EXPECT_FALSE(isOverlapped.load());
+    EXPECT_LE(runNum.load(), 100);
+}
+
+/**
+ * @tc.name: StreamReactorTest_Sessions_001
+ * @tc.desc: 64 loopback stream channels exchange frames while the thread number of the process stays fixed.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReactorTest, StreamReactorTest_Sessions_001, TestSize.Level1)
+{
+    auto reactor = StreamManager::GetStreamReactor();
+    auto callbackReactor = StreamManager::GetCallbackReactor();
+    int baseThreadNum = GetThreadNum();
+    ASSERT_GT(baseThreadNum, 0);
+
+    std::vector<TestChannel> servers;
+    std::vector<TestChannel> clients;
+    for (int i = 0; i < TEST_CHANNEL_NUM / 2; i++) {
+        TestChannel server = MakeChannel();
+        TestChannel client = MakeChannel();
+        ASSERT_TRUE(ConnectChannels(server, client));
+        servers.push_back(server);
+        clients.push_back(client);
+    }
+    for (auto &server : servers) {
+        ASSERT_TRUE(WaitFor([&server]() { return server.listener->isConnected_.load(); }));
+    }
+
+    for (int i = 0; i < TEST_FRAME_NUM; i++) {
+        for (size_t j = 0; j < servers.size(); j++) {
+            EXPECT_TRUE(clients[j].manager->Send(MakeFrame(i)));
+            EXPECT_TRUE(servers[j].manager->Send(MakeFrame(i)));
+        }
+    }
+    for (size_t j = 0; j < servers.size(); j++) {
+        EXPECT_TRUE(WaitFor([&servers, j]() { return servers[j].listener->frameNum_ == TEST_FRAME_NUM; }));
+        EXPECT_TRUE(WaitFor([&clients, j]() { return clients[j].listener->frameNum_ == TEST_FRAME_NUM; }));
+    }
+
+    /* the epoll thread is the only one the channels added */
+    int threadNum = GetThreadNum();
+    printf("%d stream channels, threads before %d, after %d\n", TEST_CHANNEL_NUM, baseThreadNum, threadNum);
+    EXPECT_EQ(StreamReactor::DEFAULT_WORKER_NUM + 1, reactor->GetThreadNum());
+    EXPECT_EQ(StreamReactor::DEFAULT_WORKER_NUM, callbackReactor->GetThreadNum());
+    EXPECT_LE(threadNum, baseThreadNum + 1);
+
+    for (size_t j = 0; j < servers.size(); j++) {
+        EXPECT_TRUE(clients[j].manager->DestroyStreamDataChannel());
+        EXPECT_TRUE(servers[j].manager->DestroyStreamDataChannel());
+    }
+    EXPECT_TRUE(WaitFor([&reactor]() { return reactor->GetThreadNum() == StreamReactor::DEFAULT_WORKER_NUM; }));
+}
+
+/**
+ * @tc.name: StreamReactorTest_SlowListener_001
+ * @tc.desc: listeners holding every callback worker hold up neither the reactor nor the receiving of other sockets.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReactorTest, StreamReactorTest_SlowListener_001, TestSize.Level1)
+{
+    g_isReleased = false;
+    std::vector<TestChannel> servers;
+    std::vector<TestChannel> clients;
+    for (int i = 0; i <= StreamReactor::DEFAULT_WORKER_NUM; i++) {
+        /* the last one only has to wait for a callback worker */
+        TestChannel server = MakeChannel(i < StreamReactor::DEFAULT_WORKER_NUM);
+        TestChannel client = MakeChannel();
+        ASSERT_TRUE(ConnectChannels(server, client));
+        servers.push_back(server);
+        clients.push_back(client);
+    }
+    for (size_t i = 0; i < servers.size() - 1; i++) {
+        EXPECT_TRUE(clients[i].manager->Send(MakeFrame(0)));
+    }
+    ASSERT_TRUE(WaitFor([]() { return g_blockedNum == StreamReactor::DEFAULT_WORKER_NUM; }));
+
+    std::atomic<bool> isPostRun(false);
+    StreamManager::GetStreamReactor()->Post([&isPostRun]() { isPostRun = true; });
+    EXPECT_TRUE(WaitFor([&isPostRun]() { return isPostRun.load(); }));
+
+    /* the frames are still read off the socket, the receive queue drops the oldest ones */
+    TestChannel &last = servers.back();
+    for (int i = 0; i < TEST_BURST_NUM; i++) {
+        EXPECT_TRUE(clients.back().manager->Send(MakeFrame(i)));
+    }
+    EXPECT_TRUE(WaitFor([&last]() {
+        return last.manager->GetOption(Communication::SoftBus::RECV_DROP_NUM).GetIntValue() > 0;
+    }));
+    EXPECT_EQ(0, last.listener->frameNum_.load());
+
+    g_isReleased = true;
+    EXPECT_TRUE(WaitFor([&last]() { return last.listener->frameNum_ > 0; }));
+    for (size_t i = 0; i < servers.size(); i++) {
+        EXPECT_TRUE(clients[i].manager->DestroyStreamDataChannel());
+        EXPECT_TRUE(servers[i].manager->DestroyStreamDataChannel());
+    }
+}
+
+/**
+ * @tc.name: StreamReactorTest_CompatibleScene_001
+ * @tc.desc: compatible scene frames reach a blocked listener off the I/O workers, reading pauses and none is lost.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReactorTest, StreamReactorTest_CompatibleScene_001, TestSize.Level1)
+{
+    auto server = std::make_shared<VtpStreamSocket>(StreamManager::GetStreamReactor(),
+        StreamManager::GetCallbackReactor());
+    auto client = std::make_shared<VtpStreamSocket>(StreamManager::GetStreamReactor(),
+        StreamManager::GetCallbackReactor());
+    auto listener = std::make_shared<TestSocketListener>();
+    listener->isReleased_ = true;
+    ASSERT_TRUE(server->SetStreamListener(listener));
+    ASSERT_TRUE(client->SetStreamListener(std::make_shared<TestSocketListener>()));
+    ASSERT_TRUE(server->SetOption(Communication::SoftBus::SCENE,
+        Communication::SoftBus::StreamAttr(Communication::SoftBus::COMPATIBLE_SCENE)));
+    ASSERT_TRUE(server->SetOption(Communication::SoftBus::STREAM_HEADER_SIZE,
+        Communication::SoftBus::StreamAttr(TEST_HEADER_SIZE)));
+
+    IpAndPort local;
+    local.ip = TEST_IP;
+    local.port = 0;
+    ASSERT_TRUE(server->CreateServer(local, Communication::SoftBus::RAW_STREAM, TEST_SESSION_KEY));
+    IpAndPort clientLocal;
+    clientLocal.ip = TEST_IP;
+    clientLocal.port = 0;
+    IpAndPort remote;
+    remote.ip = TEST_IP;
+    remote.port = local.port;
+    ASSERT_TRUE(client->CreateClient(clientLocal, remote, Communication::SoftBus::RAW_STREAM, TEST_SESSION_KEY));
+
+    /* the first frame holds the listener */
+    listener->isReleased_ = false;
+    for (int i = 0; i < TEST_RAW_FRAME_NUM; i++) {
+        EXPECT_TRUE(client->Send(MakeRawFrame(i)));
+    }
+    ASSERT_TRUE(WaitFor([&listener]() { return listener->GetSeqs().size() == 1; }));
+    std::atomic<bool> isPostRun(false);
+    StreamManager::GetStreamReactor()->Post([&isPostRun]() { isPostRun = true; });
+    EXPECT_TRUE(WaitFor([&isPostRun]() { return isPostRun.load(); }));
+
+    /* the waiting frames fill the queue, then reading stops instead of dropping */
+    int queued = static_cast<int>(VtpStreamSocket::COMPATIBLE_QUEUE_SIZE);
+    EXPECT_TRUE(WaitFor([&listener, queued]() { return listener->headerNum_ > queued; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_PERIOD * 10));
+    EXPECT_LE(listener->headerNum_.load(), queued + 1);
+
+    listener->isReleased_ = true;
+    EXPECT_TRUE(WaitFor([&listener]() { return listener->GetSeqs().size() == TEST_RAW_FRAME_NUM; }));
+    std::vector<int> seqs = listener->GetSeqs();
+    for (size_t i = 0; i < seqs.size(); i++) {
+        EXPECT_EQ(static_cast<int>(i), seqs[i]);
+    }
+    EXPECT_EQ(TEST_RAW_FRAME_NUM, listener->headerNum_.load());
+
+    client->DestroyStreamSocket();
+    server->DestroyStreamSocket();
+}
+} // namespace OHOS
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "i_stream.h"
+#include "stream_receive_queue.h"
+
+using namespace testing::ext;
+using Communication::SoftBus::DROP_UNTIL_KEY_FRAME;
+using Communication::SoftBus::FrameType;
+using Communication::SoftBus::IStream;
+using Communication::SoftBus::StreamReceiveQueue;
+/* session.h has C structs of the same names */
+using InnerStreamData = Communication::SoftBus::StreamData;
+using InnerFrameInfo = Communication::SoftBus::StreamFrameInfo;
+
+namespace {
+const int TEST_CAPACITY = 4;
+const int TEST_BURST_NUM = 10;
+const int TEST_DELAY = 50;
+const int64_t TEST_START = 100000;
+const uint32_t TEST_SENDER_START = 7000;
+
+struct TestFrame {
+    uint16_t seq;
+    FrameType type;
+    uint32_t timestamp;
+};
+
+InnerFrameInfo MakeInfo(const TestFrame &frame)
+{
+    InnerFrameInfo info;
+    info.seqNum = frame.seq;
+    info.frameType = frame.type;
+    info.timestamp = frame.timestamp;
+    return info;
+}
+
+std::unique_ptr<IStream> MakeStream(const TestFrame &frame)
+{
+    InnerStreamData data;
+    data.buffer = std::make_unique<char[]>(1);
+    data.bufLen = 1;
+    return IStream::MakeCommonStream(data, MakeInfo(frame));
+}
+
+bool Put(StreamReceiveQueue &queue, const TestFrame &frame, int64_t nowMs)
+{
+    return queue.Put(MakeStream(frame), MakeInfo(frame), nowMs);
+}
+
+std::vector<int> PollAll(StreamReceiveQueue &queue, int64_t nowMs)
+{
+    std::vector<int> seqs;
+    for (auto stream = queue.Poll(nowMs); stream != nullptr; stream = queue.Poll(nowMs)) {
+        seqs.push_back(stream->GetSeqNum());
+    }
+    return seqs;
+}
+} // namespace
+
+namespace OHOS {
+class StreamReceiveQueueTest : public testing::Test {
+};
+
+/**
+ * @tc.name: StreamReceiveQueueTest_DropOldest_001
+ * @tc.desc: a burst beyond the capacity keeps the newest frames and counts the dropped ones.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReceiveQueueTest, StreamReceiveQueueTest_DropOldest_001, TestSize.Level1)
+{
+    StreamReceiveQueue queue(TEST_CAPACITY);
+    for (int i = 0; i < TEST_BURST_NUM; i++) {
+        EXPECT_TRUE(Put(queue, { static_cast<uint16_t>(i), Communication::SoftBus::VIDEO_P, 0 }, TEST_START));
+        EXPECT_LE(queue.Size(), TEST_CAPACITY);
+    }
+    EXPECT_EQ(static_cast<uint32_t>(TEST_BURST_NUM - TEST_CAPACITY), queue.GetDropNum());
+    EXPECT_EQ(std::vector<int>({ 6, 7, 8, 9 }), PollAll(queue, TEST_START));
+    EXPECT_EQ(0u, queue.GetLateNum());
+}
+
+/**
+ * @tc.name: StreamReceiveQueueTest_DropKeyFrame_001
+ * @tc.desc: on overflow the P frames of a dropped key frame go too, a refused P frame never pushes out a queued one.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReceiveQueueTest, StreamReceiveQueueTest_DropKeyFrame_001, TestSize.Level1)
+{
+    const FrameType I = Communication::SoftBus::VIDEO_I;
+    const FrameType P = Communication::SoftBus::VIDEO_P;
+    StreamReceiveQueue queue(TEST_CAPACITY);
+    queue.SetDropPolicy(DROP_UNTIL_KEY_FRAME);
+
+    /* a key frame further in the queue survives */
+    for (const TestFrame &frame : std::vector<TestFrame>({ { 0, I, 0 }, { 1, P, 0 }, { 2, I, 0 }, { 3, P, 0 } })) {
+        EXPECT_TRUE(Put(queue, frame, TEST_START));
+    }
+    EXPECT_TRUE(Put(queue, { 4, P, 0 }, TEST_START));
+    EXPECT_EQ(2u, queue.GetDropNum());
+    EXPECT_EQ(std::vector<int>({ 2, 3, 4 }), PollAll(queue, TEST_START));
+
+    /* no key frame behind the oldest, the incoming P frames go up to the next I frame and the queued group stays */
+    for (const TestFrame &frame : std::vector<TestFrame>({ { 10, I, 0 }, { 11, P, 0 }, { 12, P, 0 }, { 13, P, 0 } })) {
+        EXPECT_TRUE(Put(queue, frame, TEST_START));
+    }
+    EXPECT_FALSE(Put(queue, { 14, P, 0 }, TEST_START));
+    EXPECT_FALSE(Put(queue, { 15, P, 0 }, TEST_START));
+    EXPECT_EQ(TEST_CAPACITY, queue.Size());
+    EXPECT_EQ(2u + 2u, queue.GetDropNum());
+    EXPECT_EQ(std::vector<int>({ 10, 11, 12, 13 }), PollAll(queue, TEST_START));
+    EXPECT_FALSE(Put(queue, { 16, P, 0 }, TEST_START));
+    EXPECT_TRUE(Put(queue, { 17, I, 0 }, TEST_START));
+    EXPECT_TRUE(Put(queue, { 18, P, 0 }, TEST_START));
+    EXPECT_EQ(2u + 3u, queue.GetDropNum());
+    EXPECT_EQ(std::vector<int>({ 17, 18 }), PollAll(queue, TEST_START));
+
+    /* frames of unknown type, such as those of older peers, never wait for a key frame */
+    for (int i = 0; i < TEST_BURST_NUM; i++) {
+        EXPECT_TRUE(Put(queue, { static_cast<uint16_t>(20 + i), Communication::SoftBus::NONE, 0 }, TEST_START));
+    }
+    EXPECT_EQ(TEST_CAPACITY, queue.Size());
+}
+
+/**
+ * @tc.name: StreamReceiveQueueTest_Jitter_001
+ * @tc.desc: out of order frames come out in timestamp order after the playout delay, late frames are dropped.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReceiveQueueTest, StreamReceiveQueueTest_Jitter_001, TestSize.Level1)
+{
+    const FrameType P = Communication::SoftBus::VIDEO_P;
+    StreamReceiveQueue queue(TEST_CAPACITY * 2);
+    queue.SetPlayoutDelay(TEST_DELAY);
+
+    /* sender clock runs 20 ms per frame, frame 1 takes 15 ms longer than frame 0 and 2 */
+    const uint32_t s = TEST_SENDER_START;
+    EXPECT_TRUE(Put(queue, { 0, P, s }, TEST_START));
+    EXPECT_TRUE(Put(queue, { 2, P, s + 40 }, TEST_START + 40));
+    EXPECT_TRUE(Put(queue, { 1, P, s + 20 }, TEST_START + 35));
+    EXPECT_TRUE(queue.Poll(TEST_START + TEST_DELAY - 1) == nullptr);
+    EXPECT_EQ(std::vector<int>({ 0 }), PollAll(queue, TEST_START + TEST_DELAY));
+    EXPECT_EQ(std::vector<int>({ 1 }), PollAll(queue, TEST_START + TEST_DELAY + 20));
+    EXPECT_EQ(std::vector<int>({ 2 }), PollAll(queue, TEST_START + TEST_DELAY + 40));
+
+    /* a frame arriving after a later one was played is late */
+    EXPECT_FALSE(Put(queue, { 3, P, s + 30 }, TEST_START + 100));
+    EXPECT_EQ(1u, queue.GetLateNum());
+    EXPECT_EQ(0u, queue.GetDropNum());
+
+    /* a stall and then a burst, the overdue frames go at once and in order */
+    const int64_t burst = TEST_START + 200;
+    EXPECT_TRUE(Put(queue, { 6, P, s + 120 }, burst));
+    EXPECT_TRUE(Put(queue, { 4, P, s + 80 }, burst));
+    EXPECT_TRUE(Put(queue, { 7, P, s + 140 }, burst));
+    EXPECT_TRUE(Put(queue, { 5, P, s + 100 }, burst));
+    EXPECT_TRUE(Put(queue, { 8, P, s + 160 }, burst));
+    EXPECT_EQ(std::vector<int>({ 4, 5, 6, 7 }), PollAll(queue, burst));
+    EXPECT_EQ(std::vector<int>({ 8 }), PollAll(queue, TEST_START + TEST_DELAY + 160));
+
+    /* the sender clock wraps around */
+    StreamReceiveQueue wrapQueue(TEST_CAPACITY);
+    wrapQueue.SetPlayoutDelay(TEST_DELAY);
+    EXPECT_TRUE(Put(wrapQueue, { 0, P, 0xFFFFFFF0u }, TEST_START));
+    EXPECT_TRUE(Put(wrapQueue, { 1, P, 0x10 }, TEST_START + 32));
+    EXPECT_EQ(std::vector<int>({ 0, 1 }), PollAll(wrapQueue, TEST_START + TEST_DELAY + 32));
+}
+
+/**
+ * @tc.name: StreamReceiveQueueTest_Quit_001
+ * @tc.desc: a blocked take returns once the queue is quit, frames put after that are refused.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamReceiveQueueTest, StreamReceiveQueueTest_Quit_001, TestSize.Level1)
+{
+    StreamReceiveQueue queue(TEST_CAPACITY);
+    queue.SetPlayoutDelay(TEST_DELAY);
+    EXPECT_TRUE(queue.Put(MakeStream({ 0, Communication::SoftBus::VIDEO_I, TEST_SENDER_START }),
+        MakeInfo({ 0, Communication::SoftBus::VIDEO_I, TEST_SENDER_START })));
+    auto stream = queue.Take();
+    ASSERT_NE(nullptr, stream);
+    EXPECT_EQ(0, stream->GetSeqNum());
+
+    std::thread taker([&queue]() { EXPECT_EQ(nullptr, queue.Take()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_DELAY));
+    queue.Quit();
+    taker.join();
+    EXPECT_FALSE(Put(queue, { 1, Communication::SoftBus::VIDEO_I, 0 }, TEST_START));
+    EXPECT_EQ(0, queue.Size());
+}
+} // namespace OHOS
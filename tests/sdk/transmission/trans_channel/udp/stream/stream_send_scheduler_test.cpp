@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "i_stream.h"
+#include "stream_send_scheduler.h"
+
+using namespace testing::ext;
+using Communication::SoftBus::FrameType;
+using Communication::SoftBus::SEND_PRIORITY_KEY;
+using Communication::SoftBus::SEND_PRIORITY_NORMAL;
+using Communication::SoftBus::StreamBuffer;
+using Communication::SoftBus::StreamSendScheduler;
+
+namespace {
+const int TEST_FRAME_LEN = 100;
+const int TEST_CHUNK_LEN = 30;
+const int TEST_CAPACITY = 8;
+const int TEST_GOP_NUM = 10;
+const int TEST_GOP_LEN = 5;
+const int TEST_MAX_DELAY = 50;
+const int TEST_FRAME_INTERVAL = 20; /* ms */
+const int TEST_SHORT_WAIT = 100; /* ms */
+const int TEST_LONG_WAIT = 5000; /* ms */
+const int64_t TEST_START = 100000;
+const uint32_t TEST_APP_START = 7000;
+const FrameType I = Communication::SoftBus::VIDEO_I;
+const FrameType P = Communication::SoftBus::VIDEO_P;
+
+/* takes at most budget bytes until it is given more, in chunks like FillP packets */
+class ThrottledTransport {
+public:
+    int Send(const char *buffer, int len)
+    {
+        if (isBroken_) {
+            return -1;
+        }
+        int taken = std::min(std::min(len, TEST_CHUNK_LEN), budget_);
+        budget_ -= taken;
+        bytes_.insert(bytes_.end(), buffer, buffer + taken);
+        return taken;
+    }
+
+    /* every frame is TEST_FRAME_LEN bytes of its id */
+    std::vector<int> GetFrameIds() const
+    {
+        std::vector<int> ids;
+        for (size_t i = 0; i + TEST_FRAME_LEN <= bytes_.size(); i += TEST_FRAME_LEN) {
+            for (size_t j = i; j < i + TEST_FRAME_LEN; j++) {
+                EXPECT_EQ(bytes_[i], bytes_[j]);
+            }
+            ids.push_back(static_cast<unsigned char>(bytes_[i]));
+        }
+        return ids;
+    }
+
+    int budget_ = 0;
+    bool isBroken_ = false;
+    std::vector<char> bytes_;
+};
+
+StreamSendScheduler::Transport Bind(ThrottledTransport &transport)
+{
+    return [&transport](const char *buffer, int len) { return transport.Send(buffer, len); };
+}
+
+bool Push(StreamSendScheduler &scheduler, int id, FrameType type, uint32_t timestamp, int64_t nowMs)
+{
+    StreamBuffer frame = std::make_unique<char[]>(TEST_FRAME_LEN);
+    for (int i = 0; i < TEST_FRAME_LEN; i++) {
+        frame[i] = static_cast<char>(id);
+    }
+    return scheduler.Push(std::move(frame), TEST_FRAME_LEN, type, timestamp, nowMs);
+}
+} // namespace
+
+namespace OHOS {
+class StreamSendSchedulerTest : public testing::Test {
+};
+
+/**
+ * @tc.name: StreamSendSchedulerTest_KeyFrame_001
+ * @tc.desc: on a link slower than the stream every key frame goes out, ahead of the P frames it makes useless.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamSendSchedulerTest, StreamSendSchedulerTest_KeyFrame_001, TestSize.Level1)
+{
+    ThrottledTransport transport;
+    StreamSendScheduler scheduler(Bind(transport), TEST_CAPACITY);
+
+    /* the link carries two frames per gop of five */
+    std::vector<int> keyIds;
+    int64_t now = TEST_START;
+    for (int gop = 0; gop < TEST_GOP_NUM; gop++) {
+        for (int i = 0; i < TEST_GOP_LEN; i++) {
+            int id = gop * TEST_GOP_LEN + i;
+            FrameType type = (i == 0) ? I : P;
+            if (type == I) {
+                keyIds.push_back(id);
+            }
+            EXPECT_TRUE(Push(scheduler, id, type, 0, now));
+            transport.budget_ += TEST_FRAME_LEN * 2 / TEST_GOP_LEN;
+            EXPECT_TRUE(scheduler.Flush(now));
+            EXPECT_LE(scheduler.GetQueueDepth(SEND_PRIORITY_NORMAL), TEST_CAPACITY);
+            now += TEST_FRAME_INTERVAL;
+        }
+    }
+    EXPECT_EQ(0, scheduler.GetQueueDepth(SEND_PRIORITY_KEY));
+    EXPECT_GT(scheduler.GetQueueDepth(SEND_PRIORITY_NORMAL), 0);
+
+    transport.budget_ = TEST_FRAME_LEN * TEST_GOP_NUM * TEST_GOP_LEN;
+    EXPECT_TRUE(scheduler.Flush(now));
+    EXPECT_TRUE(scheduler.IsEmpty());
+
+    /* each key frame is sent, and no P frame goes after a later key frame */
+    std::vector<int> ids = transport.GetFrameIds();
+    std::vector<int> sentKeyIds;
+    int lastKeyId = -1;
+    for (int id : ids) {
+        if (id % TEST_GOP_LEN == 0) {
+            sentKeyIds.push_back(id);
+            lastKeyId = id;
+        } else {
+            EXPECT_GT(id, lastKeyId);
+        }
+    }
+    EXPECT_EQ(keyIds, sentKeyIds);
+    EXPECT_EQ(ids.size(), scheduler.GetSentNum());
+    EXPECT_EQ(static_cast<uint32_t>(TEST_GOP_NUM * TEST_GOP_LEN), ids.size() + scheduler.GetDropNum());
+    printf("%zu of %d frames sent, %u dropped\n", ids.size(), TEST_GOP_NUM * TEST_GOP_LEN, scheduler.GetDropNum());
+
+    /* a queued key frame goes first, the P frames queued before it are dropped */
+    ThrottledTransport idle;
+    StreamSendScheduler queued(Bind(idle), TEST_CAPACITY);
+    EXPECT_TRUE(Push(queued, 1, P, 0, now));
+    EXPECT_TRUE(Push(queued, 2, Communication::SoftBus::NONE, 0, now));
+    EXPECT_TRUE(Push(queued, 3, P, 0, now));
+    EXPECT_TRUE(Push(queued, 4, I, 0, now));
+    EXPECT_TRUE(Push(queued, 5, P, 0, now));
+    EXPECT_EQ(1, queued.GetQueueDepth(SEND_PRIORITY_KEY));
+    EXPECT_EQ(2, queued.GetQueueDepth(SEND_PRIORITY_NORMAL));
+    EXPECT_EQ(2u, queued.GetDropNum());
+    idle.budget_ = TEST_FRAME_LEN * TEST_CAPACITY;
+    EXPECT_TRUE(queued.Flush(now));
+    EXPECT_EQ(std::vector<int>({ 4, 2, 5 }), idle.GetFrameIds());
+}
+
+/**
+ * @tc.name: StreamSendSchedulerTest_Deadline_001
+ * @tc.desc: frames older than the max delay are discarded before the transport, key frames and started frames are not.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamSendSchedulerTest, StreamSendSchedulerTest_Deadline_001, TestSize.Level1)
+{
+    ThrottledTransport transport;
+    StreamSendScheduler scheduler(Bind(transport), TEST_CAPACITY);
+    scheduler.SetMaxDelay(TEST_MAX_DELAY);
+    EXPECT_EQ(TEST_MAX_DELAY, scheduler.GetMaxDelay());
+
+    /* the application clock runs 20 ms per frame, frames 1 to 3 were handed over 40 ms after capture */
+    const uint32_t a = TEST_APP_START;
+    EXPECT_TRUE(Push(scheduler, 0, I, a, TEST_START));
+    EXPECT_TRUE(Push(scheduler, 1, P, a + 20, TEST_START + 60));
+    EXPECT_TRUE(Push(scheduler, 2, P, a + 40, TEST_START + 80));
+    EXPECT_TRUE(Push(scheduler, 3, P, a + 60, TEST_START + 100));
+    EXPECT_TRUE(Push(scheduler, 4, Communication::SoftBus::NONE, 0, TEST_START + 100));
+
+    /* key frame 0 was captured 100 ms ago, frame 1 80 ms ago, frame 2 60 ms ago, frame 3 40 ms ago */
+    transport.budget_ = TEST_FRAME_LEN * TEST_CAPACITY;
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 100));
+    EXPECT_EQ(std::vector<int>({ 0, 3, 4 }), transport.GetFrameIds());
+    EXPECT_EQ(2u, scheduler.GetExpiredNum());
+    EXPECT_EQ(0u, scheduler.GetDropNum());
+
+    /* a frame half sent is finished even when it expires meanwhile, the next one is not started */
+    transport.bytes_.clear();
+    transport.budget_ = TEST_FRAME_LEN / 2;
+    EXPECT_TRUE(Push(scheduler, 5, P, a + 100, TEST_START + 120));
+    EXPECT_TRUE(Push(scheduler, 6, P, a + 120, TEST_START + 120));
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 120));
+    EXPECT_FALSE(scheduler.IsEmpty());
+    transport.budget_ = TEST_FRAME_LEN * TEST_CAPACITY;
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 200));
+    EXPECT_EQ(std::vector<int>({ 5 }), transport.GetFrameIds());
+    EXPECT_EQ(3u, scheduler.GetExpiredNum());
+    EXPECT_TRUE(scheduler.IsEmpty());
+
+    /* a key frame waits as long as it takes */
+    transport.bytes_.clear();
+    transport.budget_ = 0;
+    EXPECT_TRUE(Push(scheduler, 7, I, a + 200, TEST_START + 200));
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 1000));
+    transport.budget_ = TEST_FRAME_LEN;
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 2000));
+    EXPECT_EQ(std::vector<int>({ 7 }), transport.GetFrameIds());
+
+    /* without a max delay nothing expires */
+    scheduler.SetMaxDelay(0);
+    transport.bytes_.clear();
+    transport.budget_ = TEST_FRAME_LEN;
+    EXPECT_TRUE(Push(scheduler, 8, P, a + 220, TEST_START + 220));
+    EXPECT_TRUE(scheduler.Flush(TEST_START + 5000));
+    EXPECT_EQ(std::vector<int>({ 8 }), transport.GetFrameIds());
+
+    /* a frame already older than the max delay is refused, unless it is a key frame */
+    scheduler.SetMaxDelay(TEST_MAX_DELAY);
+    EXPECT_FALSE(Push(scheduler, 9, P, a + 240, TEST_START + 5000));
+    EXPECT_EQ(4u, scheduler.GetExpiredNum());
+    EXPECT_TRUE(Push(scheduler, 10, I, a + 260, TEST_START + 5000));
+    EXPECT_EQ(1, scheduler.GetQueueDepth(SEND_PRIORITY_KEY));
+    EXPECT_EQ(0, scheduler.GetQueueDepth(SEND_PRIORITY_NORMAL));
+}
+
+/**
+ * @tc.name: StreamSendSchedulerTest_Overflow_001
+ * @tc.desc: a full queue drops its oldest frame, a broken transport drops every queued frame and fails the rest.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamSendSchedulerTest, StreamSendSchedulerTest_Overflow_001, TestSize.Level1)
+{
+    ThrottledTransport transport;
+    StreamSendScheduler scheduler(Bind(transport), TEST_CAPACITY);
+    EXPECT_FALSE(scheduler.Push(nullptr, TEST_FRAME_LEN, P, 0, TEST_START));
+    for (int i = 0; i < TEST_CAPACITY + 2; i++) {
+        EXPECT_TRUE(Push(scheduler, i, I, 0, TEST_START));
+        EXPECT_LE(scheduler.GetQueueDepth(SEND_PRIORITY_KEY), TEST_CAPACITY);
+    }
+    EXPECT_EQ(2u, scheduler.GetDropNum());
+
+    transport.budget_ = TEST_FRAME_LEN + 1;
+    EXPECT_TRUE(scheduler.Flush(TEST_START));
+    EXPECT_EQ(std::vector<int>({ 2 }), transport.GetFrameIds());
+    EXPECT_EQ(1u, scheduler.GetSentNum());
+
+    /* frame 3 partly sent and frames 4 to 9 queued are lost */
+    transport.isBroken_ = true;
+    transport.budget_ = TEST_FRAME_LEN * TEST_CAPACITY;
+    EXPECT_FALSE(scheduler.IsBroken());
+    EXPECT_FALSE(scheduler.Flush(TEST_START));
+    EXPECT_TRUE(scheduler.IsBroken());
+    EXPECT_TRUE(scheduler.IsEmpty());
+    EXPECT_EQ(2u + 1u + 6u, scheduler.GetDropNum());
+
+    EXPECT_FALSE(Push(scheduler, TEST_CAPACITY + 2, I, 0, TEST_START));
+    EXPECT_FALSE(scheduler.Flush(TEST_START));
+    EXPECT_EQ(1u, scheduler.GetSentNum());
+}
+
+/**
+ * @tc.name: StreamSendSchedulerTest_Lossless_001
+ * @tc.desc: a full lossless queue, as a raw stream uses, makes the push wait and then fail, it drops no frame.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(StreamSendSchedulerTest, StreamSendSchedulerTest_Lossless_001, TestSize.Level1)
+{
+    const FrameType raw = Communication::SoftBus::NONE;
+    ThrottledTransport transport;
+    StreamSendScheduler scheduler(Bind(transport), TEST_CAPACITY);
+    scheduler.SetLossless(true, TEST_SHORT_WAIT);
+    EXPECT_TRUE(scheduler.IsLossless());
+    scheduler.SetMaxDelay(TEST_MAX_DELAY);
+
+    /* stale frames are kept as well */
+    for (int i = 0; i < TEST_CAPACITY; i++) {
+        EXPECT_TRUE(Push(scheduler, i, raw, TEST_APP_START + i * TEST_MAX_DELAY, TEST_START));
+    }
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(Push(scheduler, TEST_CAPACITY, raw, 0, TEST_START));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_SHORT_WAIT));
+    EXPECT_EQ(TEST_CAPACITY, scheduler.GetQueueDepth(SEND_PRIORITY_NORMAL));
+
+    /* a waiting push goes in once the transport takes a frame */
+    scheduler.SetLossless(true, TEST_LONG_WAIT);
+    auto waiting = std::async(std::launch::async, [&scheduler]() {
+        return Push(scheduler, TEST_CAPACITY, Communication::SoftBus::NONE, 0, TEST_START);
+    });
+    EXPECT_EQ(std::future_status::timeout, waiting.wait_for(std::chrono::milliseconds(TEST_SHORT_WAIT)));
+    transport.budget_ = TEST_FRAME_LEN;
+    EXPECT_TRUE(scheduler.Flush(TEST_START + TEST_LONG_WAIT));
+    EXPECT_TRUE(waiting.get());
+
+    transport.budget_ = TEST_FRAME_LEN * (TEST_CAPACITY + 1);
+    EXPECT_TRUE(scheduler.Flush(TEST_START + TEST_LONG_WAIT));
+    std::vector<int> ids;
+    for (int i = 0; i <= TEST_CAPACITY; i++) {
+        ids.push_back(i);
+    }
+    EXPECT_EQ(ids, transport.GetFrameIds());
+    EXPECT_EQ(0u, scheduler.GetDropNum());
+    EXPECT_EQ(0u, scheduler.GetExpiredNum());
+
+    /* a broken transport fails a waiting push at once */
+    transport.budget_ = 0;
+    for (int i = 0; i < TEST_CAPACITY; i++) {
+        EXPECT_TRUE(Push(scheduler, i, raw, 0, TEST_START));
+    }
+    waiting = std::async(std::launch::async, [&scheduler]() {
+        return Push(scheduler, TEST_CAPACITY, Communication::SoftBus::NONE, 0, TEST_START);
+    });
+    EXPECT_EQ(std::future_status::timeout, waiting.wait_for(std::chrono::milliseconds(TEST_SHORT_WAIT)));
+    transport.isBroken_ = true;
+    start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(scheduler.Flush(TEST_START));
+    EXPECT_FALSE(waiting.get());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(TEST_LONG_WAIT));
+}
+} // namespace OHOS